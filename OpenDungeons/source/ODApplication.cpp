@@ -34,6 +34,7 @@
 #include "utils/LogSinkConsole.h"
 #include "utils/LogSinkFile.h"
 #include "utils/LogSinkOgre.h"
+#include "utils/Profiler.h"
 #include "utils/Random.h"
 #include "utils/ResourceManager.h"
 
@@ -64,23 +65,29 @@
 #include <sstream>
 #include <fstream>
 
-void ODApplication::startGame(boost::program_options::variables_map& options)
+int ODApplication::startGame(boost::program_options::variables_map& options)
 {
     ResourceManager resMgr(options);
 
     LogManager logMgr;
     logMgr.setLevel(resMgr.getLogLevel());
 
-    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+    // The benchmark results can be written on the standard output. In this case, the
+    // logs go to the error output to keep the results readable
+    bool isBenchmark = resMgr.isServerMode() && (resMgr.getBenchmarkNbTurns() > 0);
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole(isBenchmark)));
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkFile(resMgr.getLogFile())));
 
-    if(resMgr.isServerMode())
-        startServer();
-    else
+    if(!resMgr.isServerMode())
+    {
         startClient();
+        return 0;
+    }
+
+    return startServer() ? 0 : 1;
 }
 
-void ODApplication::startServer()
+bool ODApplication::startServer()
 {
     ResourceManager& resMgr = ResourceManager::getSingleton();
 
@@ -93,20 +100,34 @@ void ODApplication::startServer()
     const std::string& creator = resMgr.getServerModeCreator();
 
     ODServer server;
+    server.setMetricsFile(resMgr.getServerMetricsFile());
+    server.setRandomSeed(resMgr.getServerRandomSeed());
+    if(resMgr.getBenchmarkNbTurns() > 0)
+    {
+        if(!server.runBenchmark(resMgr.getServerModeLevel(), resMgr.getBenchmarkNbTurns(), resMgr.getBenchmarkFile()))
+        {
+            OD_LOG_ERR("Could not run benchmark !!!");
+            return false;
+        }
+
+        return true;
+    }
+
     if(!server.startServer(creator, resMgr.getServerModeLevel(), ServerMode::ModeGameMultiPlayer, !creator.empty()))
     {
         OD_LOG_ERR("Could not start server !!!");
-        return;
+        return false;
     }
 
     if(!server.waitEndGame())
     {
         OD_LOG_ERR("Could not wait for end of game !!!");
-        return;
+        return false;
     }
 
     OD_LOG_INF("Stopping server...");
     server.stopServer();
+    return true;
 }
 
 void ODApplication::startClient()
@@ -240,31 +261,42 @@ void ODApplication::startClient()
 
     ogreRoot.addFrameListener(&frameListener);
 
+    Profiler::setThreadName("Main");
 #ifdef OD_USE_SFML_WINDOW
     bool running = true;
     while(running)
     {
-        sf::Event event;
-        while (sfmlWindow.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-            {
-                frameListener.requestExit();
-                break;
-            }
-            else
-            {
-                if (event.type == sf::Event::Resized)
+        OD_PROFILE_ZONE("Frame");
+        {
+            OD_PROFILE_ZONE("Input");
+            sf::Event event;
+            while (sfmlWindow.pollEvent(event)) {
+                if (event.type == sf::Event::Closed)
                 {
-                    renderWindow->resize(event.size.width, event.size.height);
-                    frameListener.windowResized(renderWindow);
+                    frameListener.requestExit();
+                    break;
+                }
+                else
+                {
+                    if (event.type == sf::Event::Resized)
+                    {
+                        renderWindow->resize(event.size.width, event.size.height);
+                        frameListener.windowResized(renderWindow);
+                    }
+                    frameListener.getModeManager()->getInputManager().handleSFMLEvent(event);
                 }
-                frameListener.getModeManager()->getInputManager().handleSFMLEvent(event);
             }
         }
         sfmlWindow.clear();
-        // If renderOneFrame returns false, it indicates that an exit has been requested
-        running = ogreRoot.renderOneFrame();
-        sfmlWindow.display();
+        {
+            OD_PROFILE_ZONE("Render");
+            // If renderOneFrame returns false, it indicates that an exit has been requested
+            running = ogreRoot.renderOneFrame();
+        }
+        {
+            OD_PROFILE_ZONE("Present");
+            sfmlWindow.display();
+        }
     }
 #else /* OD_USE_SFML_WINDOW */
     ogreRoot.startRendering();
@@ -47,8 +47,9 @@ public:
     ~ODApplication()
     {}
 
-    //! \brief Initializes the Application along with the ResourceManager
-    void startGame(boost::program_options::variables_map& options);
+    //! \brief Initializes the Application along with the ResourceManager. Returns the exit
+    //! status of the process
+    int startGame(boost::program_options::variables_map& options);
 
     static double turnsPerSecond;
     static const std::string VERSION;
@@ -62,8 +63,9 @@ private:
 
     //! \brief Normal launch mode. Creates everything to be client and server
     void startClient();
-    //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui
-    void startServer();
+    //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui.
+    //! Returns false if the server or the benchmark failed
+    bool startServer();
 };
 
 #endif // ODAPPLICATION_H
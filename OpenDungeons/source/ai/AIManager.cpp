@@ -19,9 +19,17 @@
 
 #include "ai/AIFactory.h"
 #include "ai/BaseAI.h"
+#include "game/Player.h"
+#include "game/Seat.h"
+
+#include <sstream>
+
+//! \brief Default number of tiles an AI can scan per turn
+const uint32_t DEFAULT_TURN_BUDGET_TILES = 4096;
 
 AIManager::AIManager(GameMap& gameMap)
-    : mGameMap(gameMap)
+    : mGameMap(gameMap),
+      mTurnBudgetTiles(DEFAULT_TURN_BUDGET_TILES)
 {
 }
 
@@ -44,7 +52,9 @@ bool AIManager::doTurn(double timeSinceLastTurn)
 {
     for(BaseAI* ai : mAiList)
     {
+        ai->startTurn(mTurnBudgetTiles);
         ai->doTurn(timeSinceLastTurn);
+        ai->addTaskTime("doTurn", ai->getTurnElapsedMicroseconds());
     }
     return true;
 }
@@ -57,3 +67,30 @@ void AIManager::clearAIList()
     }
     mAiList.clear();
 }
+
+std::string AIManager::getStatsString() const
+{
+    std::stringstream ss;
+    ss << "AI turn budget: " << mTurnBudgetTiles << " tiles";
+    for(BaseAI* ai : mAiList)
+    {
+        const Player& player = ai->getPlayer();
+        ss << "\nAI seatId=" << player.getSeat()->getId() << " (" << player.getNick() << ")";
+        for(const std::pair<const std::string, BaseAI::TaskStats>& p : ai->getTaskStats())
+        {
+            const BaseAI::TaskStats& stats = p.second;
+            uint64_t average = stats.mNbCalls > 0 ? stats.mTotalMicroseconds / stats.mNbCalls : 0;
+            ss << "\n\t" << p.first << ": calls=" << stats.mNbCalls
+                << ", total=" << stats.mTotalMicroseconds << " us"
+                << ", avg=" << average << " us"
+                << ", max=" << stats.mMaxMicroseconds << " us";
+        }
+    }
+    return ss.str();
+}
+
+void AIManager::resetStats()
+{
+    for(BaseAI* ai : mAiList)
+        ai->resetTaskStats();
+}
@@ -18,6 +18,8 @@
 #ifndef AIMANAGER_H
 #define AIMANAGER_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 class BaseAI;
@@ -39,9 +41,22 @@ public:
     bool doTurn(double timeSinceLastTurn);
     void clearAIList();
 
+    //! \brief Number of tiles each AI is allowed to scan per turn. Expensive searches
+    //! exceeding it are continued on next turn. 0 means no limit
+    inline uint32_t getTurnBudget() const
+    { return mTurnBudgetTiles; }
+
+    inline void setTurnBudget(uint32_t budgetTiles)
+    { mTurnBudgetTiles = budgetTiles; }
+
+    //! \brief Returns a human readable summary of the CPU time used by each AI, per task
+    std::string getStatsString() const;
+    void resetStats();
+
 private:
     GameMap& mGameMap;
     AIList mAiList;
+    uint32_t mTurnBudgetTiles;
 };
 
 #endif // AIMANAGER_H
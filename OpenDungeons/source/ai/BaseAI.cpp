@@ -38,10 +38,65 @@ const int32_t handicapPerTileOffset = 20;
 
 BaseAI::BaseAI(GameMap& gameMap, Player& player):
     mGameMap(gameMap),
-    mPlayer(player)
+    mPlayer(player),
+    mTurnBudgetTiles(0),
+    mTurnWorkTiles(0)
 {
 }
 
+BaseAI::~BaseAI()
+{
+    if(!mRoomPlacementMap.isInitialized())
+        return;
+
+    for(int yy = 0; yy < mRoomPlacementMap.getSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < mRoomPlacementMap.getSizeX(); ++xx)
+        {
+            Tile* tile = mGameMap.getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->removeTileStateListener(mRoomPlacementMap);
+        }
+    }
+}
+
+void BaseAI::startTurn(uint32_t budgetTiles)
+{
+    mTurnBudgetTiles = budgetTiles;
+    mTurnWorkTiles = 0;
+    mTurnTimer.reset();
+}
+
+bool BaseAI::isTurnBudgetExhausted() const
+{
+    if(mTurnBudgetTiles == 0)
+        return false;
+
+    return mTurnWorkTiles >= mTurnBudgetTiles;
+}
+
+void BaseAI::addTaskTime(const std::string& task, uint64_t microseconds)
+{
+    TaskStats& stats = mTaskStats[task];
+    ++stats.mNbCalls;
+    stats.mTotalMicroseconds += microseconds;
+    if(microseconds > stats.mMaxMicroseconds)
+        stats.mMaxMicroseconds = microseconds;
+}
+
+void BaseAI::RoomPlaceSearch::reset()
+{
+    mOffset = 0;
+    mHandicap = 0;
+    mBestPoints = 0;
+    mBestDistance = 0;
+    mBestX = 0;
+    mBestY = 0;
+    mIsFound = false;
+}
+
 Room* BaseAI::getDungeonTemple()
 {
     std::vector<Room*> dt = mGameMap.getRoomsByTypeAndSeat(RoomType::dungeonTemple, mPlayer.getSeat());
@@ -101,9 +156,39 @@ bool BaseAI::shouldWallTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* mPl
     return false;
 }
 
+void BaseAI::refreshRoomPlacementMap(Seat* playerSeat)
+{
+    if(!mRoomPlacementMap.isInitialized())
+    {
+        mRoomPlacementMap.resize(mGameMap.getMapSizeX(), mGameMap.getMapSizeY());
+        for(int yy = 0; yy < mGameMap.getMapSizeY(); ++yy)
+        {
+            for(int xx = 0; xx < mGameMap.getMapSizeX(); ++xx)
+            {
+                Tile* tile = mGameMap.getTile(xx, yy);
+                tile->addTileStateListener(mRoomPlacementMap);
+            }
+        }
+    }
+
+    int sizeX = mRoomPlacementMap.getSizeX();
+    for(uint32_t index : mRoomPlacementMap.getDirtyTiles())
+    {
+        int xx = static_cast<int>(index) % sizeX;
+        int yy = static_cast<int>(index) / sizeX;
+        Tile* tile = mGameMap.getTile(xx, yy);
+        if(tile == nullptr)
+            continue;
+
+        mRoomPlacementMap.setGroundTile(xx, yy, shouldGroundTileBeConsideredForBestPlaceForRoom(tile, playerSeat));
+        mRoomPlacementMap.setWallTile(xx, yy, shouldWallTileBeConsideredForBestPlaceForRoom(tile, playerSeat));
+    }
+    mRoomPlacementMap.clearDirtyTiles();
+}
+
 //! To find the position, we try every square of the wantedSize width around the given tile for each possible distance
 bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedSize, bool useWalls,
-    int32_t& bestX, int32_t& bestY)
+    RoomPlaceSearch& search)
 {
     // We use a point system to find the best position. Once we find a valid position, we will set a handicap
     // that will increase as we go away from the given tile. Once the handicap is > to the max points we can get minus
@@ -121,23 +206,43 @@ bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
             maxPointsPossible += nbCentralActiveSpots * 4 * pointsPerWallSpot;
     }
 
-    bool isFound = false;
-    int32_t handicap = 0;
-    int32_t bestPoints = 0;
-    int32_t bestDistance = 0;
+    // The search state is kept in search so that we can resume where we stopped if the turn
+    // budget gets exhausted
+    if(!search.isRunning())
+    {
+        search.reset();
+        search.mOffset = 1;
+    }
+
+    int32_t& handicap = search.mHandicap;
+    int32_t& bestPoints = search.mBestPoints;
+    int32_t& bestDistance = search.mBestDistance;
+    int32_t& bestX = search.mBestX;
+    int32_t& bestY = search.mBestY;
+    bool& isFound = search.mIsFound;
     int32_t maxOffset = std::max(mGameMap.getMapSizeX(), mGameMap.getMapSizeY());
+    int32_t firstOffset = search.mOffset;
+
+    // The map is refreshed once per call. Then, checking if a square is constructible is done in constant time
+    refreshRoomPlacementMap(mPlayerSeat);
 
-    for(int32_t offset = 1; offset < maxOffset; ++offset)
+    for(int32_t& offset = search.mOffset; offset < maxOffset; ++offset)
     {
+        // We always process at least one ring per call to make sure the search progresses
+        if((offset > firstOffset) && isTurnBudgetExhausted())
+            return false;
+
         int32_t points = 0;
         int32_t nbTiles = offset * 2 + wantedSize - 1;
+        // Each ring scans nbTiles tiles on every side
+        addTurnWork(static_cast<uint32_t>(nbTiles * 4));
         for(int32_t k = 0; k < nbTiles; ++k)
         {
             Tile* t;
             // North
             t  = mGameMap.getTile(tile->getX() - offset - wantedSize + 2 + k, tile->getY() + offset);
             if((t != nullptr) &&
-               computePointsForRoom(t, mPlayerSeat, wantedSize, true, useWalls, points))
+               computePointsForRoomFromMap(t->getX(), t->getY(), wantedSize, true, useWalls, points))
             {
                 points -= handicap;
                 int32_t centerX = t->getX() + (wantedSize / 2);
@@ -157,7 +262,7 @@ bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
             // East
             t  = mGameMap.getTile(tile->getX() + offset, tile->getY() - k + offset);
             if((t != nullptr) &&
-               computePointsForRoom(t, mPlayerSeat, wantedSize, true, useWalls, points))
+               computePointsForRoomFromMap(t->getX(), t->getY(), wantedSize, true, useWalls, points))
             {
                 points -= handicap;
                 int32_t centerX = t->getX() + (wantedSize / 2);
@@ -177,7 +282,7 @@ bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
             // South
             t  = mGameMap.getTile(tile->getX() + offset + wantedSize - 2 - k, tile->getY() - offset);
             if((t != nullptr) &&
-               computePointsForRoom(t, mPlayerSeat, wantedSize, false, useWalls, points))
+               computePointsForRoomFromMap(t->getX(), t->getY(), wantedSize, false, useWalls, points))
             {
                 points -= handicap;
                 int32_t centerX = t->getX() - (wantedSize / 2);
@@ -197,7 +302,7 @@ bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
             // West
             t  = mGameMap.getTile(tile->getX() - offset, tile->getY() - offset + k);
             if((t != nullptr) &&
-               computePointsForRoom(t, mPlayerSeat, wantedSize, false, useWalls, points))
+               computePointsForRoomFromMap(t->getX(), t->getY(), wantedSize, false, useWalls, points))
             {
                 points -= handicap;
                 int32_t centerX = t->getX() - (wantedSize / 2);
@@ -224,48 +329,28 @@ bool BaseAI::findBestPlaceForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
                 break;
         }
     }
-    return isFound;
+
+    // The search is over. We reset the offset to allow the next call to start a new search
+    search.mOffset = 0;
+    return true;
 }
 
 bool BaseAI::computePointsForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedSize,
     bool bottomLeft2TopRight, bool useWalls, int32_t& points)
 {
-    int tileX = tile->getX();
-    int tileY = tile->getY();
-    bool isOk = true;
+    refreshRoomPlacementMap(mPlayerSeat);
+    return computePointsForRoomFromMap(tile->getX(), tile->getY(), wantedSize, bottomLeft2TopRight, useWalls, points);
+}
 
-    // We check if the tile is reachable. No need to compute if the tile is behind rocks
+bool BaseAI::computePointsForRoomFromMap(int tileX, int tileY, int32_t wantedSize,
+    bool bottomLeft2TopRight, bool useWalls, int32_t& points)
+{
     points = 0;
-    // We start by searching for a place fitting the min size. If we find it,
-    // we increase tile by tile until the max size. If not, no need to continue
-    for(int32_t xx = 0; xx < wantedSize; ++xx)
-    {
-        for(int32_t yy = 0; yy < wantedSize; ++yy)
-        {
-            Tile* t;
-            if(bottomLeft2TopRight)
-                t  = mGameMap.getTile(tileX + xx, tileY + yy);
-            else
-                t  = mGameMap.getTile(tileX - xx, tileY - yy);
 
-            if(t == nullptr)
-            {
-                isOk = false;
-                break;
-            }
-
-            if(!shouldGroundTileBeConsideredForBestPlaceForRoom(t, mPlayerSeat))
-            {
-                isOk = false;
-                break;
-            }
-        }
-
-        if(!isOk)
-            break;
-    }
-
-    if(!isOk)
+    // We check if every tile of the room is constructible
+    int32_t x1 = bottomLeft2TopRight ? tileX : tileX - wantedSize + 1;
+    int32_t y1 = bottomLeft2TopRight ? tileY : tileY - wantedSize + 1;
+    if(!mRoomPlacementMap.isGroundSquare(x1, y1, wantedSize))
         return false;
 
     // If we don't want to consider walls, we stop here (for example for rooms that do not have bonus
@@ -273,123 +358,29 @@ bool BaseAI::computePointsForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
     if(!useWalls)
         return true;
 
-    // We search points for first wall. That's not exactly how the activespots will be computed but it will be enough (especially
+    // We search points for each wall. That's not exactly how the activespots will be computed but it will be enough (especially
     // when the room size is even)
-    int nbConsecutiveTiles;
-    int nbActiveWallSpots;
-    // We search points for first wall
-    nbConsecutiveTiles = 0;
-    nbActiveWallSpots = 0;
-    for(int32_t kk = 0; kk < wantedSize; ++kk)
-    {
-        Tile* t;
-        if(bottomLeft2TopRight)
-            t  = mGameMap.getTile(tileX - 1, tileY + kk);
-        else
-            t  = mGameMap.getTile(tileX + 1, tileY - kk);
-        if(t == nullptr)
-            continue;
+    int dir = bottomLeft2TopRight ? 1 : -1;
+    points += countActiveWallSpots(tileX - dir, tileY, 0, dir, wantedSize) * pointsPerWallSpot;
+    points += countActiveWallSpots(tileX + dir * wantedSize, tileY, 0, dir, wantedSize) * pointsPerWallSpot;
+    points += countActiveWallSpots(tileX, tileY - dir, dir, 0, wantedSize) * pointsPerWallSpot;
+    points += countActiveWallSpots(tileX, tileY + dir * wantedSize, dir, 0, wantedSize) * pointsPerWallSpot;
 
-        if(shouldWallTileBeConsideredForBestPlaceForRoom(t, mPlayerSeat))
-            ++nbConsecutiveTiles;
-        else
-            nbConsecutiveTiles = 0;
-
-        if(nbActiveWallSpots == 0)
-        {
-            if(nbConsecutiveTiles >= 3)
-            {
-                nbConsecutiveTiles = 0;
-                ++nbActiveWallSpots;
-            }
-        }
-        else if(nbConsecutiveTiles >= 2)
-        {
-            nbConsecutiveTiles = 0;
-            ++nbActiveWallSpots;
-        }
-    }
-    points += nbActiveWallSpots * pointsPerWallSpot;
-    // We search points for second wall
-    nbConsecutiveTiles = 0;
-    nbActiveWallSpots = 0;
-    for(int32_t kk = 0; kk < wantedSize; ++kk)
-    {
-        Tile* t;
-        if(bottomLeft2TopRight)
-            t = mGameMap.getTile(tileX + wantedSize, tileY + kk);
-        else
-            t = mGameMap.getTile(tileX - wantedSize, tileY - kk);
-        if(t == nullptr)
-            continue;
-
-        if(shouldWallTileBeConsideredForBestPlaceForRoom(t, mPlayerSeat))
-            ++nbConsecutiveTiles;
-        else
-            nbConsecutiveTiles = 0;
-
-        if(nbActiveWallSpots == 0)
-        {
-            if(nbConsecutiveTiles >= 3)
-            {
-                nbConsecutiveTiles = 0;
-                ++nbActiveWallSpots;
-            }
-        }
-        else if(nbConsecutiveTiles >= 2)
-        {
-            nbConsecutiveTiles = 0;
-            ++nbActiveWallSpots;
-        }
-    }
-    points += nbActiveWallSpots * pointsPerWallSpot;
-    // We search points for first wall
-    nbConsecutiveTiles = 0;
-    nbActiveWallSpots = 0;
-    for(int32_t kk = 0; kk < wantedSize; ++kk)
-    {
-        Tile* t;
-        if(bottomLeft2TopRight)
-            t = mGameMap.getTile(tileX + kk, tileY - 1);
-        else
-            t = mGameMap.getTile(tileX - kk, tileY + 1);
-        if(t == nullptr)
-            continue;
-
-        if(shouldWallTileBeConsideredForBestPlaceForRoom(t, mPlayerSeat))
-            ++nbConsecutiveTiles;
-        else
-            nbConsecutiveTiles = 0;
+    return true;
+}
 
-        if(nbActiveWallSpots == 0)
-        {
-            if(nbConsecutiveTiles >= 3)
-            {
-                nbConsecutiveTiles = 0;
-                ++nbActiveWallSpots;
-            }
-        }
-        else if(nbConsecutiveTiles >= 2)
-        {
-            nbConsecutiveTiles = 0;
-            ++nbActiveWallSpots;
-        }
-    }
-    points += nbActiveWallSpots * pointsPerWallSpot;
-    // We search points for first wall
-    nbConsecutiveTiles = 0;
-    nbActiveWallSpots = 0;
+int32_t BaseAI::countActiveWallSpots(int x, int y, int dx, int dy, int32_t wantedSize) const
+{
+    int nbConsecutiveTiles = 0;
+    int nbActiveWallSpots = 0;
     for(int32_t kk = 0; kk < wantedSize; ++kk)
     {
-        Tile* t;
-        if(bottomLeft2TopRight)
-            t = mGameMap.getTile(tileX + kk, tileY + wantedSize);
-        else
-            t = mGameMap.getTile(tileX - kk, tileY - wantedSize);
-        if(t == nullptr)
+        int xx = x + kk * dx;
+        int yy = y + kk * dy;
+        if(!mRoomPlacementMap.isInMap(xx, yy))
             continue;
 
-        if(shouldWallTileBeConsideredForBestPlaceForRoom(t, mPlayerSeat))
+        if(mRoomPlacementMap.isWallTile(xx, yy))
             ++nbConsecutiveTiles;
         else
             nbConsecutiveTiles = 0;
@@ -408,9 +399,7 @@ bool BaseAI::computePointsForRoom(Tile* tile, Seat* mPlayerSeat, int32_t wantedS
             ++nbActiveWallSpots;
         }
     }
-    points += nbActiveWallSpots * pointsPerWallSpot;
-
-    return true;
+    return nbActiveWallSpots;
 }
 
 bool BaseAI::digWayToTile(Tile* tileStart, Tile* tileEnd)
@@ -425,6 +414,7 @@ bool BaseAI::digWayToTile(Tile* tileStart, Tile* tileEnd)
         return false;
 
     std::list<Tile*> pathToDig = mGameMap.path(tileEnd, tileStart, worker, seat, true);
+    addTurnWork(static_cast<uint32_t>(pathToDig.size()));
     if (pathToDig.empty())
         return false;
 
@@ -18,9 +18,14 @@
 #ifndef BASEAI_H
 #define BASEAI_H
 
+#include "ai/RoomPlacementMap.h"
+
+#include <OgreTimer.h>
+
+#include <cstdint>
+#include <map>
 #include <string>
 #include <vector>
-#include <cstdint>
 
 class GameMap;
 class Player;
@@ -33,8 +38,44 @@ enum class KeeperAIType;
 class BaseAI
 {
 public:
-    virtual ~BaseAI()
-    {}
+    //! \brief CPU time consumed by one of the AI tasks since the stats were last reset
+    struct TaskStats
+    {
+        TaskStats() :
+            mNbCalls(0),
+            mTotalMicroseconds(0),
+            mMaxMicroseconds(0)
+        {}
+
+        uint64_t mNbCalls;
+        uint64_t mTotalMicroseconds;
+        uint64_t mMaxMicroseconds;
+    };
+
+    virtual ~BaseAI();
+
+    //! \brief Called by the AIManager before doTurn. budgetTiles is the number of tiles the
+    //! AI is allowed to scan during the coming turn (0 means unlimited). Long searches should
+    //! count the tiles they scan with addTurnWork, check isTurnBudgetExhausted and resume where
+    //! they stopped on next turn. Since the budget does not depend on the time, the AI does the
+    //! same thing at each turn on any computer
+    void startTurn(uint32_t budgetTiles);
+
+    //! \brief Time spent since startTurn was called. Only used for the stats
+    inline uint64_t getTurnElapsedMicroseconds()
+    { return mTurnTimer.getMicroseconds(); }
+
+    //! \brief Adds the given time to the stats of the given task
+    void addTaskTime(const std::string& task, uint64_t microseconds);
+
+    inline const std::map<std::string, TaskStats>& getTaskStats() const
+    { return mTaskStats; }
+
+    inline void resetTaskStats()
+    { mTaskStats.clear(); }
+
+    inline const Player& getPlayer() const
+    { return mPlayer; }
 
      /** \brief This is the function that will be called each turn for the ai.
      *  This is the function that will be called each turn for the ai.
@@ -45,16 +86,65 @@ public:
     virtual bool doTurn(double timeSinceLastTurn) = 0;
 
 protected:
+    //! \brief Measures the time spent in a task until it goes out of scope
+    class TaskTimer
+    {
+    public:
+        TaskTimer(BaseAI& ai, const char* task) :
+            mAI(ai),
+            mTask(task)
+        {}
+
+        ~TaskTimer()
+        { mAI.addTaskTime(mTask, mTimer.getMicroseconds()); }
+
+    private:
+        BaseAI& mAI;
+        const char* mTask;
+        Ogre::Timer mTimer;
+    };
+
+    //! \brief State of a findBestPlaceForRoom search. Keeping it between calls allows to
+    //! spread a search on several turns.
+    struct RoomPlaceSearch
+    {
+        RoomPlaceSearch()
+        { reset(); }
+
+        void reset();
+
+        inline bool isRunning() const
+        { return mOffset > 0; }
+
+        int32_t mOffset;
+        int32_t mHandicap;
+        int32_t mBestPoints;
+        int32_t mBestDistance;
+        int32_t mBestX;
+        int32_t mBestY;
+        bool mIsFound;
+    };
+
     BaseAI(GameMap& gameMap, Player& player);
 
     Room* getDungeonTemple();
 
+    //! \brief Counts nbTiles more tiles scanned during this turn
+    inline void addTurnWork(uint32_t nbTiles)
+    { mTurnWorkTiles += nbTiles; }
+
+    //! \brief Returns true if the AI has scanned all the tiles it was given for this turn
+    bool isTurnBudgetExhausted() const;
+
     //! \brief Searches for the best place where to place a room around the given tile. It will take
-    //! into account any constructible tile (even if not digged yet). On success, it returns true and bestX
-    //! and bestY will be set accordingly. It will return false if no constructible square of wantedSize
-    //! is found
+    //! into account any constructible tile (even if not digged yet). The search goes through rings
+    //! of increasing distance around the tile and stops when the turn budget is exhausted. In this
+    //! case, false is returned and the search can be resumed by calling again with the same search
+    //! state. Once the search is over, true is returned and search.mIsFound tells if a constructible
+    //! square of wantedSize was found at (search.mBestX, search.mBestY). The search state is then
+    //! ready for a new search.
     bool findBestPlaceForRoom(Tile* tile, Seat* playerSeat, int32_t wantedSize, bool useWalls,
-        int32_t& bestX, int32_t& bestY);
+        RoomPlaceSearch& search);
 
     bool digWayToTile(Tile* tileStart, Tile* tileEnd);
     bool computePointsForRoom(Tile* tile, Seat* playerSeat, int32_t wantedSize,
@@ -64,6 +154,26 @@ protected:
     Player& mPlayer;
 
 private:
+    Ogre::Timer mTurnTimer;
+    uint32_t mTurnBudgetTiles;
+    uint32_t mTurnWorkTiles;
+    std::map<std::string, TaskStats> mTaskStats;
+
+    //! \brief Constructible ground and wall tiles for the AI seat. Used to speed up the room
+    //! placement search
+    RoomPlacementMap mRoomPlacementMap;
+
+    //! \brief Creates the room placement map if needed and updates the tiles that changed since last call
+    void refreshRoomPlacementMap(Seat* playerSeat);
+
+    //! \brief Same as computePointsForRoom but expects the room placement map to be up to date
+    bool computePointsForRoomFromMap(int tileX, int tileY, int32_t wantedSize,
+        bool bottomLeft2TopRight, bool useWalls, int32_t& points);
+
+    //! \brief Counts the active spots a wall of the given size starting at (x,y) and going in the
+    //! given direction would give
+    int32_t countActiveWallSpots(int x, int y, int dx, int dy, int32_t wantedSize) const;
+
     bool shouldGroundTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
     bool shouldWallTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
 };
@@ -33,6 +33,8 @@
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
+#include <cmath>
+#include <deque>
 #include <vector>
 
 // Contains the rooms the AI will try to build. It will try to build them in the given order
@@ -85,31 +87,72 @@ bool KeeperAI::doTurn(double timeSinceLastTurn)
         handleFirstTurn();
     }
 
-    saveWoundedCreatures();
+    // Saving creatures and defending are always done. The other tasks are only
+    // done if the searches did not scan all the tiles of the turn budget
+    {
+        TaskTimer timer(*this, "saveWoundedCreatures");
+        saveWoundedCreatures();
+    }
 
-    handleDefense();
+    {
+        TaskTimer timer(*this, "handleDefense");
+        handleDefense();
+    }
 
-    if (handleWorkers())
-        return true;
+    {
+        TaskTimer timer(*this, "handleWorkers");
+        if (handleWorkers())
+            return true;
+    }
 
-    if (checkTreasury())
+    if(isTurnBudgetExhausted())
         return true;
 
-    if (handleRooms())
-        return true;
+    {
+        TaskTimer timer(*this, "checkTreasury");
+        if (checkTreasury())
+            return true;
+    }
 
-    if (lookForGold())
+    if(isTurnBudgetExhausted())
         return true;
 
-    if (repairRooms())
-        return true;
+    {
+        TaskTimer timer(*this, "handleRooms");
+        if (handleRooms())
+            return true;
+    }
 
-    if(handleTiredCreatures())
+    if(isTurnBudgetExhausted())
         return true;
 
-    if(handleHungryCreatures())
+    {
+        TaskTimer timer(*this, "lookForGold");
+        if (lookForGold())
+            return true;
+    }
+
+    if(isTurnBudgetExhausted())
         return true;
 
+    {
+        TaskTimer timer(*this, "repairRooms");
+        if (repairRooms())
+            return true;
+    }
+
+    {
+        TaskTimer timer(*this, "handleTiredCreatures");
+        if(handleTiredCreatures())
+            return true;
+    }
+
+    {
+        TaskTimer timer(*this, "handleHungryCreatures");
+        if(handleHungryCreatures())
+            return true;
+    }
+
     return true;
 }
 
@@ -283,6 +326,10 @@ bool KeeperAI::checkTreasury()
 
 bool KeeperAI::handleRooms()
 {
+    // If we are searching for a place, we continue the search
+    if(mRoomPlaceSearch.isRunning())
+        return searchRoomPlace();
+
     if(mCooldownLookingForRooms > 0)
     {
         --mCooldownLookingForRooms;
@@ -318,15 +365,25 @@ bool KeeperAI::handleRooms()
         return false;
     }
 
+    return searchRoomPlace();
+}
+
+bool KeeperAI::searchRoomPlace()
+{
     Tile* central = getDungeonTemple()->getCentralTile();
-    int32_t bestX = 0;
-    int32_t bestY = 0;
-    if(!findBestPlaceForRoom(central, mPlayer.getSeat(), 5, true, bestX, bestY))
+    if(!findBestPlaceForRoom(central, mPlayer.getSeat(), 5, true, mRoomPlaceSearch))
+    {
+        // The search is not over. It will be continued next turn. We return true because
+        // the turn budget has been used
+        return true;
+    }
+
+    if(!mRoomPlaceSearch.mIsFound)
         return false;
 
     mRoomSize = 5;
-    mRoomPosX = bestX;
-    mRoomPosY = bestY;
+    mRoomPosX = mRoomPlaceSearch.mBestX;
+    mRoomPosY = mRoomPlaceSearch.mBestY;
 
     Tile* tileDest = mGameMap.getTile(mRoomPosX, mRoomPosY);
     if(tileDest == nullptr)
@@ -382,96 +439,47 @@ bool KeeperAI::lookForGold()
     if(emptyStorage < 100)
         return false;
 
-    Tile* central = getDungeonTemple()->getCentralTile();
-    int widerSide = mGameMap.getMapSizeX() > mGameMap.getMapSizeY() ?
-        mGameMap.getMapSizeX() : mGameMap.getMapSizeY();
+    Seat* seat = mPlayer.getSeat();
+    Creature* worker = mGameMap.getWorkerForPathFinding(seat);
+    if (worker == nullptr)
+        return false;
 
-    // We search for the closest gold tile
-    Tile* firstGoldTile = nullptr;
-    for(int32_t distance = 1; distance < widerSide; ++distance)
+    // A gold tile is reachable if a worker can walk or dig its way to it from the temple. The
+    // tiles reachable that way are flooded from the temple only as far as needed to check
+    // the candidates returned by the index
+    Tile* central = getDungeonTemple()->getCentralTile();
+    int mapSizeX = mGameMap.getMapSizeX();
+    std::vector<uint8_t> isDigReached(static_cast<uint32_t>(mapSizeX * mGameMap.getMapSizeY()), 0);
+    std::deque<Tile*> tilesToFlood;
+    isDigReached[central->getX() + central->getY() * mapSizeX] = 1;
+    tilesToFlood.push_back(central);
+    auto isDigReachable = [&](Tile* goldTile)
     {
-        for(int k = 0; k <= distance; ++k)
+        uint8_t& isGoldTileReached = isDigReached[goldTile->getX() + goldTile->getY() * mapSizeX];
+        while((isGoldTileReached == 0) && !tilesToFlood.empty())
         {
-            Tile* t;
-            // North-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() + distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                // If we already have a tile at same distance, we randomly change to
-                // try to not be too predictable
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // North-West
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() - k, central->getY() + distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // South-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() - distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // South-West
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() - k, central->getY() - distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // East-North
-            t = mGameMap.getTile(central->getX() + distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // East-South
-            if(k > 0)
-            {
-                t = mGameMap.getTile(central->getX() + distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
-            // West-North
-            t = mGameMap.getTile(central->getX() - distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-            {
-                if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
-            }
-            // West-South
-            if(k > 0)
+            Tile* tile = tilesToFlood.front();
+            tilesToFlood.pop_front();
+            addTurnWork(1);
+            for(Tile* neigh : tile->getAllNeighbors())
             {
-                t = mGameMap.getTile(central->getX() - distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
-                {
-                    if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
-                }
-            }
+                uint8_t& isNeighReached = isDigReached[neigh->getX() + neigh->getY() * mapSizeX];
+                if(isNeighReached != 0)
+                    continue;
+                if(!worker->canGoThroughTile(neigh) && !neigh->isDiggable(seat))
+                    continue;
 
-            if(firstGoldTile != nullptr)
-                break;
+                isNeighReached = 1;
+                tilesToFlood.push_back(neigh);
+            }
         }
+        return isGoldTileReached != 0;
+    };
 
-        // If we found a tile, no need to continue
-        if(firstGoldTile != nullptr)
-            break;
-    }
+    // We search for the closest reachable gold tile
+    TileIndex& tileIndex = mGameMap.getTileIndex();
+    Tile* firstGoldTile = tileIndex.findClosestTile(TileIndexKind::gold, nullptr,
+        central->getX(), central->getY(), -1, isDigReachable);
 
     // No more gold
     if (firstGoldTile == nullptr)
@@ -480,6 +488,25 @@ bool KeeperAI::lookForGold()
         return false;
     }
 
+    // If other reachable gold tiles are at the same distance, we randomly pick one to try to
+    // not be too predictable
+    int diffX = firstGoldTile->getX() - central->getX();
+    int diffY = firstGoldTile->getY() - central->getY();
+    int distSquared = diffX * diffX + diffY * diffY;
+    std::vector<Tile*> goldTiles;
+    tileIndex.getTilesInRadius(TileIndexKind::gold, nullptr, central->getX(), central->getY(),
+        static_cast<int>(std::ceil(std::sqrt(static_cast<double>(distSquared)))), goldTiles);
+    std::vector<Tile*> closestGoldTiles;
+    for(Tile* tile : goldTiles)
+    {
+        diffX = tile->getX() - central->getX();
+        diffY = tile->getY() - central->getY();
+        if((diffX * diffX + diffY * diffY == distSquared) && isDigReachable(tile))
+            closestGoldTiles.push_back(tile);
+    }
+    if(closestGoldTiles.size() > 1)
+        firstGoldTile = closestGoldTiles[Random::Uint(0, static_cast<uint32_t>(closestGoldTiles.size()) - 1)];
+
     if(!digWayToTile(central, firstGoldTile))
     {
         mNoMoreReachableGold = true;
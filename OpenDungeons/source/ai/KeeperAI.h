@@ -42,9 +42,14 @@ protected:
     //! Returns true if the action has been done and false if nothing has been done
     bool handleRooms();
 
-    //! \brief Look for gold and make way up to it.
-    //! \brief Returns whether the action could succeed.
-    //! It will also return false once it's done.
+    //! \brief Searches (or continues searching) a place for a new room and marks it for digging
+    //! once found. Returns true if the action has been done or is still in progress
+    bool searchRoomPlace();
+
+    //! \brief Looks for the closest gold tile a worker can walk or dig its way to from the
+    //! dungeon temple and marks the tiles to dig up to it (and the gold tiles around it).
+    //! The search is done in one pass. Returns true if tiles were marked for digging and false
+    //! if nothing was done (cooldown, enough gold storage, no worker or no reachable gold left).
     bool lookForGold();
 
     //! \brief Picks up wounded creatures and drops then in the dungeon temple
@@ -91,6 +96,7 @@ private:
     int mRoomPosX;
     int mRoomPosY;
     int mRoomSize;
+    RoomPlaceSearch mRoomPlaceSearch;
     bool mNoMoreReachableGold;
     int mCooldownLookingForGold;
     int mCooldownDefense;
@@ -0,0 +1,144 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/RoomPlacementMap.h"
+
+#include <algorithm>
+
+RoomPlacementMap::RoomPlacementMap() :
+    mSizeX(0),
+    mSizeY(0),
+    mIsSummedAreaDirty(false)
+{
+}
+
+void RoomPlacementMap::resize(int sizeX, int sizeY)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    uint32_t nbTiles = static_cast<uint32_t>(sizeX * sizeY);
+    mGround.assign(nbTiles, 0);
+    mWall.assign(nbTiles, 0);
+    mSummedArea.assign(static_cast<uint32_t>((sizeX + 1) * (sizeY + 1)), 0);
+    mIsSummedAreaDirty = false;
+
+    mIsTileDirty.assign(nbTiles, 1);
+    mDirtyTiles.resize(nbTiles);
+    for(uint32_t i = 0; i < nbTiles; ++i)
+        mDirtyTiles[i] = i;
+}
+
+void RoomPlacementMap::setGroundTile(int x, int y, bool isGround)
+{
+    if(!isInMap(x, y))
+        return;
+
+    uint8_t value = isGround ? 1 : 0;
+    uint8_t& current = mGround[x + y * mSizeX];
+    if(current == value)
+        return;
+
+    current = value;
+    mIsSummedAreaDirty = true;
+}
+
+void RoomPlacementMap::setWallTile(int x, int y, bool isWall)
+{
+    if(!isInMap(x, y))
+        return;
+
+    mWall[x + y * mSizeX] = isWall ? 1 : 0;
+}
+
+int32_t RoomPlacementMap::countGroundTiles(int x1, int y1, int x2, int y2)
+{
+    x1 = std::max(x1, 0);
+    y1 = std::max(y1, 0);
+    x2 = std::min(x2, mSizeX - 1);
+    y2 = std::min(y2, mSizeY - 1);
+    if((x1 > x2) || (y1 > y2))
+        return 0;
+
+    if(mIsSummedAreaDirty)
+        computeSummedAreaTable();
+
+    int stride = mSizeX + 1;
+    return mSummedArea[(x2 + 1) + (y2 + 1) * stride]
+        - mSummedArea[x1 + (y2 + 1) * stride]
+        - mSummedArea[(x2 + 1) + y1 * stride]
+        + mSummedArea[x1 + y1 * stride];
+}
+
+bool RoomPlacementMap::isGroundSquare(int x, int y, int size)
+{
+    if(!isInMap(x, y) || !isInMap(x + size - 1, y + size - 1))
+        return false;
+
+    return countGroundTiles(x, y, x + size - 1, y + size - 1) == size * size;
+}
+
+void RoomPlacementMap::setTileDirty(int x, int y)
+{
+    for(int yy = y - 1; yy <= y + 1; ++yy)
+    {
+        for(int xx = x - 1; xx <= x + 1; ++xx)
+        {
+            if(!isInMap(xx, yy))
+                continue;
+
+            uint32_t index = static_cast<uint32_t>(xx + yy * mSizeX);
+            if(mIsTileDirty[index] != 0)
+                continue;
+
+            mIsTileDirty[index] = 1;
+            mDirtyTiles.push_back(index);
+        }
+    }
+}
+
+void RoomPlacementMap::clearDirtyTiles()
+{
+    for(uint32_t index : mDirtyTiles)
+        mIsTileDirty[index] = 0;
+
+    mDirtyTiles.clear();
+}
+
+void RoomPlacementMap::tileStateChanged(Tile& tile)
+{
+    setTileDirty(tile.getX(), tile.getY());
+}
+
+void RoomPlacementMap::computeSummedAreaTable()
+{
+    // The first row and column stay at 0. Each row is computed from the row below: the running
+    // sum of the current row is added to the column sums which is easily vectorized
+    int stride = mSizeX + 1;
+    for(int y = 0; y < mSizeY; ++y)
+    {
+        const uint8_t* ground = &mGround[y * mSizeX];
+        const int32_t* below = &mSummedArea[y * stride];
+        int32_t* current = &mSummedArea[(y + 1) * stride];
+        int32_t rowSum = 0;
+        for(int x = 0; x < mSizeX; ++x)
+        {
+            rowSum += ground[x];
+            current[x + 1] = below[x + 1] + rowSum;
+        }
+    }
+    mIsSummedAreaDirty = false;
+}
@@ -0,0 +1,98 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROOMPLACEMENTMAP_H
+#define ROOMPLACEMENTMAP_H
+
+#include "entities/Tile.h"
+
+#include <cstdint>
+#include <vector>
+
+//! \brief Keeps, for one seat, the tiles a room could be built on (ground tiles) and the tiles
+//! that would give active spots if next to a room (wall tiles). A summed-area table of the ground
+//! tiles allows to know in constant time if a square area is fully constructible.
+//! The map listens to the tiles state changes. Tiles that changed (and their neighbors because
+//! the constructible state depends on them) are kept in a dirty list that the owner is expected
+//! to process before querying the map.
+class RoomPlacementMap : public TileStateListener
+{
+public:
+    RoomPlacementMap();
+
+    //! \brief Resizes the map and sets every tile as not constructible and dirty
+    void resize(int sizeX, int sizeY);
+
+    inline bool isInitialized() const
+    { return mSizeX > 0; }
+
+    inline bool isInMap(int x, int y) const
+    { return (x >= 0) && (y >= 0) && (x < mSizeX) && (y < mSizeY); }
+
+    void setGroundTile(int x, int y, bool isGround);
+    void setWallTile(int x, int y, bool isWall);
+
+    inline bool isWallTile(int x, int y) const
+    { return isInMap(x, y) && (mWall[x + y * mSizeX] != 0); }
+
+    //! \brief Returns the number of ground tiles in the rectangle [x1,x2]x[y1,y2]. The rectangle
+    //! is clipped to the map
+    int32_t countGroundTiles(int x1, int y1, int x2, int y2);
+
+    //! \brief Returns true if every tile in the square of the given size with (x,y) as bottom left
+    //! corner is inside the map and is a ground tile
+    bool isGroundSquare(int x, int y, int size);
+
+    //! \brief Marks the given tile and its neighbors as dirty
+    void setTileDirty(int x, int y);
+
+    //! \brief Tiles which state might have changed since the last call to clearDirtyTiles
+    //! (coordinates are stored as x + y * sizeX)
+    inline const std::vector<uint32_t>& getDirtyTiles() const
+    { return mDirtyTiles; }
+
+    void clearDirtyTiles();
+
+    inline int getSizeX() const
+    { return mSizeX; }
+
+    inline int getSizeY() const
+    { return mSizeY; }
+
+    void tileStateChanged(Tile& tile) override;
+
+private:
+    //! \brief Recomputes the summed-area table in one pass over the ground mask
+    void computeSummedAreaTable();
+
+    int mSizeX;
+    int mSizeY;
+
+    //! \brief 1 if the tile can be used to build a room and 0 otherwise
+    std::vector<uint8_t> mGround;
+    //! \brief 1 if the tile is a wall that can give active spots to a room and 0 otherwise
+    std::vector<uint8_t> mWall;
+    //! \brief Summed-area table of mGround. Its size is (mSizeX + 1) * (mSizeY + 1). The value at
+    //! (x + 1, y + 1) is the number of ground tiles in [0,x]x[0,y]
+    std::vector<int32_t> mSummedArea;
+    bool mIsSummedAreaDirty;
+
+    std::vector<uint8_t> mIsTileDirty;
+    std::vector<uint32_t> mDirtyTiles;
+};
+
+#endif // ROOMPLACEMENTMAP_H
@@ -19,10 +19,11 @@
 #define CREATUREACTION_H
 
 #include "entities/CreatureMoodValues.h"
+#include "utils/ObjectPool.h"
 
 #include <cstdint>
-#include <functional>
 #include <istream>
+#include <string>
 
 class Creature;
 
@@ -54,9 +55,17 @@ enum class CreatureActionType
     nb // Must be the last value of this enum
 };
 
+//! \brief Actions are created and destroyed very often by the creatures. They are allocated
+//! in the ObjectPool so that pushing and popping actions does not allocate memory
 class CreatureAction
 {
 public:
+    static void* operator new(std::size_t size)
+    { return ObjectPool::allocate(size); }
+
+    static void operator delete(void* ptr, std::size_t size)
+    { ObjectPool::deallocate(ptr, size); }
+
     CreatureAction(Creature& creature) :
         mCreature(creature),
         mNbTurns(0),
@@ -80,11 +89,12 @@ public:
     inline int32_t getNbTurnsActive() const
     { return mNbTurnsActive; }
 
-    //! Returns a pointer to the given action from CreatureAction class. Note that
-    //! we don't want to do stuff in the child classes because many actions will
-    //! pop themselves which might result in errors. Instead, we expect every action
-    //! to call the expected action from CreatureAction with the good parameters.
-    virtual std::function<bool()> action() = 0;
+    //! Executes the action. Returns true if the creature should process its next action
+    //! during this turn. Note that many actions will pop themselves, which destroys the
+    //! action while it is executed. That's why we don't want to do stuff in the child
+    //! classes. Instead, every action calls a static handler with copies of the needed
+    //! members (the action members should not be used after it might have been popped).
+    virtual bool execute() = 0;
 
     //! \brief Returns the mood value modifier that should be applied to the creature
     //! when this action is in its list. The value should be used as defined
@@ -35,7 +35,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::carryEntity; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     std::string getListenerName() const override;
     bool notifyDead(GameEntity* entity) override;
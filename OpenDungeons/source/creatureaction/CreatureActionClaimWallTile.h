@@ -31,7 +31,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::claimWallTile; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleClaimWallTile(Creature& creature, Tile& tileClaim);
 
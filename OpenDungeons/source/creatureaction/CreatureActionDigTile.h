@@ -31,7 +31,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::digTile; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleDigTile(Creature& creature, Tile& tileDig, Tile& tilePos);
 
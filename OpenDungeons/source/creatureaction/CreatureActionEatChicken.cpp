@@ -46,10 +46,9 @@ CreatureActionEatChicken::~CreatureActionEatChicken()
     }
 }
 
-std::function<bool()> CreatureActionEatChicken::action()
+bool CreatureActionEatChicken::execute()
 {
-    return std::bind(&CreatureActionEatChicken::handleEatChicken,
-        std::ref(mCreature), mChicken);
+    return handleEatChicken(mCreature, mChicken);
 }
 
 bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntity* chicken)
@@ -45,10 +45,10 @@ CreatureActionFightFriendly::~CreatureActionFightFriendly()
         mEntityAttack->removeGameEntityListener(this);
 }
 
-std::function<bool()> CreatureActionFightFriendly::action()
+bool CreatureActionFightFriendly::execute()
 {
-    return std::bind(&CreatureActionFightFriendly::handleFight,
-        std::ref(mCreature), mEntityAttack, mKoOpponent, mTilesFilter, mNotifyPlayerIfHit);
+    // tilesFilter is a reference to our member. It is only read before this action can be popped
+    return handleFight(mCreature, mEntityAttack, mKoOpponent, mTilesFilter, mNotifyPlayerIfHit);
 }
 
 bool CreatureActionFightFriendly::handleFight(Creature& creature, GameEntity* entityAttack, bool koOpponent, const std::vector<Tile*>& tilesFilter, bool notifyPlayerIfHit)
@@ -29,12 +29,9 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 
-#include <functional>
-
-std::function<bool()> CreatureActionFindHome::action()
+bool CreatureActionFindHome::execute()
 {
-    return std::bind(&CreatureActionFindHome::handleFindHome,
-        std::ref(mCreature), mForced);
+    return handleFindHome(mCreature, mForced);
 }
 
 bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
@@ -100,7 +97,7 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
 
     // Check to see if we can walk to a dormitory that does have an open tile.
     std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat());
-    std::vector<Tile*> availableDormitories;
+    std::vector<Building*> availableDormitories;
     for (Room* room : tempRooms)
     {
         if(room->getType() != RoomType::dormitory)
@@ -114,15 +111,13 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
         if(tile == nullptr)
             continue;
 
-        // Check if the room is accessible
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
-
-        availableDormitories.push_back(tile);
+        availableDormitories.push_back(dormitory);
     }
 
-    // If we found a valid path to an open room in a dormitory, then start walking along it.
-    if (availableDormitories.empty())
+    // We walk to the closest dormitory with an open tile. Once there, we will look for the bed location
+    std::list<Tile*> tempPath;
+    Building* chosenDormitory = creature.getGameMap()->findClosestBuilding(&creature, myTile, availableDormitories, &tempPath);
+    if (chosenDormitory == nullptr)
     {
         // If we got here there are no reachable dormitory that are unclaimed so we quit trying to find one.
         if((creature.getSeat()->getPlayer() != nullptr) &&
@@ -135,8 +130,6 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
         return true;
     }
 
-    Tile* choosenTile = nullptr;
-    std::list<Tile*> tempPath = creature.getGameMap()->findBestPath(&creature, myTile, availableDormitories, choosenTile);
     std::vector<Ogre::Vector3> path;
     creature.tileToVector3(tempPath, path, true, 0.0);
     creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
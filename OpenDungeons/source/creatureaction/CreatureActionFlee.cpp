@@ -29,10 +29,9 @@
 
 static const int NB_TURN_FLEE_MAX = 5;
 
-std::function<bool()> CreatureActionFlee::action()
+bool CreatureActionFlee::execute()
 {
-    return std::bind(&CreatureActionFlee::handleFlee,
-        std::ref(mCreature), getNbTurns());
+    return handleFlee(mCreature, getNbTurns());
 }
 
 bool CreatureActionFlee::handleFlee(Creature& creature, int32_t nbTurns)
@@ -31,10 +31,9 @@
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
 
-std::function<bool()> CreatureActionGetFee::action()
+bool CreatureActionGetFee::execute()
 {
-    return std::bind(&CreatureActionGetFee::handleGetFee,
-        std::ref(mCreature));
+    return handleGetFee(mCreature);
 }
 
 bool CreatureActionGetFee::handleGetFee(Creature& creature)
@@ -75,7 +74,7 @@ bool CreatureActionGetFee::handleGetFee(Creature& creature)
     }
 
     // We try to go to some treasury were there is still some gold
-    std::vector<Tile*> availableTreasuries;
+    std::vector<Building*> availableTreasuries;
     for(Room* room : creature.getGameMap()->getRooms())
     {
         if(room->getSeat() != creature.getSeat())
@@ -87,25 +86,14 @@ bool CreatureActionGetFee::handleGetFee(Creature& creature)
         if(room->numCoveredTiles() <= 0)
             continue;
 
-        Tile* tile = room->getCoveredTile(0);
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
-
-        availableTreasuries.push_back(tile);
-    }
-
-    if(availableTreasuries.empty())
-    {
-        // No available treasury
-        creature.popAction();
-        return true;
+        availableTreasuries.push_back(room);
     }
 
-    Tile* chosenTile = nullptr;
-    std::list<Tile*> tilePath = creature.getGameMap()->findBestPath(&creature, myTile,
-        availableTreasuries, chosenTile);
+    std::list<Tile*> tilePath;
+    Building* chosenTreasury = creature.getGameMap()->findClosestBuilding(&creature, myTile,
+        availableTreasuries, &tilePath);
 
-    if(tilePath.empty() || (chosenTile == nullptr))
+    if(tilePath.empty() || (chosenTreasury == nullptr))
     {
         // No available treasury
         creature.popAction();
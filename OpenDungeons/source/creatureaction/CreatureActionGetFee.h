@@ -36,7 +36,7 @@ public:
     uint32_t updateMoodModifier() const override
     { return CreatureMoodValues::GetFee; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleGetFee(Creature& creature);
 };
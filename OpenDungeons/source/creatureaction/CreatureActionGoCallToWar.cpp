@@ -19,12 +19,9 @@
 
 #include "entities/Creature.h"
 
-#include <functional>
-
-std::function<bool()> CreatureActionGoCallToWar::action()
+bool CreatureActionGoCallToWar::execute()
 {
-    return std::bind(&CreatureActionGoCallToWar::handleWalkToTile,
-        std::ref(mCreature));
+    return handleWalkToTile(mCreature);
 }
 
 bool CreatureActionGoCallToWar::handleWalkToTile(Creature& creature)
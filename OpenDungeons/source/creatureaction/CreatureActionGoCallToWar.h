@@ -34,7 +34,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::goCallToWar; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     uint32_t updateMoodModifier() const override
     { return CreatureMoodValues::GoToCallToWar; }
@@ -43,10 +43,9 @@ CreatureActionGrabEntity::~CreatureActionGrabEntity()
     }
 }
 
-std::function<bool()> CreatureActionGrabEntity::action()
+bool CreatureActionGrabEntity::execute()
 {
-    return std::bind(&CreatureActionGrabEntity::handleGrabEntity,
-        std::ref(mCreature), std::ref(mEntityToCarry));
+    return handleGrabEntity(mCreature, mEntityToCarry);
 }
 
 bool CreatureActionGrabEntity::handleGrabEntity(Creature& creature, GameEntity* entityToCarry)
@@ -85,40 +84,28 @@ bool CreatureActionGrabEntity::handleGrabEntity(Creature& creature, GameEntity*
 
     // We try to find a building that wants the entity
     std::vector<Building*> buildings = creature.getGameMap()->getReachableBuildingsPerSeat(creature.getSeat(), myTile, &creature);
-    std::vector<Tile*> tilesDest;
+    std::vector<Building*> buildingsDest;
     for(Building* building : buildings)
     {
         if(building->hasCarryEntitySpot(entityToCarry))
-        {
-            Tile* tile = building->getCoveredTile(0);
-            tilesDest.push_back(tile);
-        }
+            buildingsDest.push_back(building);
     }
 
-    if(tilesDest.empty())
+    if(buildingsDest.empty())
     {
         // No building wants this entity
         creature.popAction();
         return true;
     }
 
-    Tile* tileBuilding = nullptr;
-    creature.getGameMap()->findBestPath(&creature, myTile, tilesDest, tileBuilding);
-    if(tileBuilding == nullptr)
+    Building* buildingWants = creature.getGameMap()->findClosestBuilding(&creature, myTile, buildingsDest, nullptr);
+    if(buildingWants == nullptr)
     {
         // We couldn't find a way to the building
         creature.popAction();
         return true;
     }
 
-    Building* buildingWants = tileBuilding->getCoveringBuilding();
-    if(buildingWants == nullptr)
-    {
-        OD_LOG_ERR("creature=" + creature.getName() + ", entityToCarry=" + entityToCarry->getName() + ", tileBuilding=" + Tile::displayAsString(tileBuilding));
-        creature.popAction();
-        return false;
-    }
-
     creature.popAction();
     creature.pushAction(Utils::make_unique<CreatureActionCarryEntity>(creature, *entityToCarry, *buildingWants));
     return true;
@@ -37,7 +37,7 @@ public:
     uint32_t updateMoodModifier() const override
     { return CreatureMoodValues::LeaveDungeon; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleLeaveDungeon(Creature& creature);
 };
@@ -41,10 +41,9 @@ CreatureActionSearchEntityToCarry::~CreatureActionSearchEntityToCarry()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchEntityToCarry::action()
+bool CreatureActionSearchEntityToCarry::execute()
 {
-    return std::bind(&CreatureActionSearchEntityToCarry::handleSearchEntityToCarry,
-        std::ref(mCreature), mForced);
+    return handleSearchEntityToCarry(mCreature, mForced);
 }
 
 bool CreatureActionSearchEntityToCarry::handleSearchEntityToCarry(Creature& creature, bool forced)
@@ -34,10 +34,9 @@
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
 
-std::function<bool()> CreatureActionSearchFood::action()
+bool CreatureActionSearchFood::execute()
 {
-    return std::bind(&CreatureActionSearchFood::handleSearchFood,
-        std::ref(mCreature), mForced);
+    return handleSearchFood(mCreature, mForced);
 }
 
 bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
@@ -108,8 +107,8 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
         return true;
     }
 
-    // Pick a hatchery where we can eat and try to walk to it.
-    std::vector<Tile*> hatcheriesTiles;
+    // Pick the closest hatchery where we can eat
+    std::vector<Building*> availableHatcheries;
     for(Room* hatcheryRoom : hatcheries)
     {
         if(hatcheryRoom->numCoveredTiles() <= 0)
@@ -118,20 +117,11 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
         if(!hatcheryRoom->hasOpenCreatureSpot(&creature))
             continue;
 
-        Tile* tile = hatcheryRoom->getCoveredTile(0);
-        if(tile == nullptr)
-        {
-            OD_LOG_ERR("creature=" + creature.getName() + ", hatchery=" + hatcheryRoom->getName());
-            continue;
-        }
-
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
-
-        hatcheriesTiles.push_back(tile);
+        availableHatcheries.push_back(hatcheryRoom);
     }
 
-    if(hatcheriesTiles.empty())
+    Building* chosenHatchery = creature.getGameMap()->findClosestBuilding(&creature, myTile, availableHatcheries, nullptr);
+    if(chosenHatchery == nullptr)
     {
         if((creature.getSeat()->getPlayer() != nullptr) &&
             creature.getSeat()->getPlayer()->getIsHuman() &&
@@ -143,26 +133,8 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
         return true;
     }
 
-    Tile* chosenTile = nullptr;
-    std::list<Tile*> pathToHatchery = creature.getGameMap()->findBestPath(&creature, myTile, hatcheriesTiles, chosenTile);
-    if(chosenTile == nullptr)
-    {
-        // We couldn't find a path !
-        OD_LOG_ERR("creature=" + creature.getName());
-        creature.popAction();
-        return true;
-    }
-
-    // Sanity check: check that the covering room is a hatchery as it should be
-    if(!chosenTile->checkCoveringRoomType(RoomType::hatchery))
-    {
-        OD_LOG_ERR("creature=" + creature.getName() + ", tile=" + Tile::displayAsString(chosenTile));
-        creature.popAction();
-        return true;
-    }
-
-    // Now, we let the hatchery handle the creature
+    // Now, we let the hatchery handle the creature. Only hatcheries were given so the chosen building is one
     creature.popAction();
-    creature.pushAction(Utils::make_unique<CreatureActionUseRoom>(creature, *chosenTile->getCoveringRoom(), forced));
+    creature.pushAction(Utils::make_unique<CreatureActionUseRoom>(creature, *static_cast<Room*>(chosenHatchery), forced));
     return true;
 }
@@ -34,7 +34,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::searchFood; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleSearchFood(Creature& creature, bool forced);
 
@@ -19,11 +19,13 @@
 
 #include "creatureaction/CreatureActionClaimGroundTile.h"
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
 #include "entities/Tile.h"
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/TileIndex.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -40,10 +42,9 @@ CreatureActionSearchGroundTileToClaim::~CreatureActionSearchGroundTileToClaim()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchGroundTileToClaim::action()
+bool CreatureActionSearchGroundTileToClaim::execute()
 {
-    return std::bind(&CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return handleSearchGroundTileToClaim(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creature& creature, int32_t nbTurns, bool forced)
@@ -126,9 +127,13 @@ bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creatu
     }
 
     // If we still haven't found a tile to claim, we try to take the closest one
+    // We only consider the tiles of the index that are within sight radius
+    std::vector<Tile*> candidates;
+    creature.getGameMap()->getTileIndex().getTilesInRadius(TileIndexKind::claimableGround, creature.getSeat(),
+        myTile->getX(), myTile->getY(), creature.getDefinition()->getSightRadius(), candidates);
     float distBest = -1;
     Tile* tileToClaim = nullptr;
-    for (Tile* tile : creature.getTilesWithinSightRadius())
+    for (Tile* tile : candidates)
     {
         // if this tile is not fully claimed yet or the tile is of another player's color
         if(tile == nullptr)
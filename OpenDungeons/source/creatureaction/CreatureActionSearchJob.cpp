@@ -35,10 +35,9 @@
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
 
-std::function<bool()> CreatureActionSearchJob::action()
+bool CreatureActionSearchJob::execute()
 {
-    return std::bind(&CreatureActionSearchJob::handleSearchJob,
-        std::ref(mCreature), mForced);
+    return handleSearchJob(mCreature, mForced);
 }
 
 bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
@@ -167,7 +166,7 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
 
         // We are not in a room of the good type or we couldn't use it. We check if there is a reachable room
         // of the good type
-        std::vector<Tile*> rooms;
+        std::vector<Building*> rooms;
         for(Room* room : creature.getGameMap()->getRooms())
         {
             if(room->getSeat() != creature.getSeat())
@@ -183,20 +182,16 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
             if((affinity.getEfficiency() > 0) && !room->hasOpenCreatureSpot(&creature))
                 continue;
 
-            Tile* tile = room->getCoveredTile(0);
-            if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-                continue;
-
-            rooms.push_back(tile);
+            rooms.push_back(room);
         }
 
         if(rooms.empty())
             continue;
 
-        Tile* chosenTile = nullptr;
-        std::list<Tile*> tilePath = creature.getGameMap()->findBestPath(&creature, myTile, rooms, chosenTile);
+        std::list<Tile*> tilePath;
+        Building* chosenRoom = creature.getGameMap()->findClosestBuilding(&creature, myTile, rooms, &tilePath);
 
-        if(tilePath.empty() || (chosenTile == nullptr))
+        if(tilePath.empty() || (chosenRoom == nullptr))
             continue;
 
         std::vector<Ogre::Vector3> vectorPath;
@@ -20,12 +20,14 @@
 #include "creatureaction/CreatureActionDigTile.h"
 #include "creatureaction/CreatureActionGrabEntity.h"
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
 #include "entities/Tile.h"
 #include "entities/TreasuryObject.h"
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/TileIndex.h"
 #include "rooms/Room.h"
 #include "utils/Helper.h"
 #include "utils/MakeUnique.h"
@@ -43,10 +45,9 @@ CreatureActionSearchTileToDig::~CreatureActionSearchTileToDig()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchTileToDig::action()
+bool CreatureActionSearchTileToDig::execute()
 {
-    return std::bind(&CreatureActionSearchTileToDig::handleSearchTileToDig,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return handleSearchTileToDig(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, int32_t nbTurns, bool forced)
@@ -109,10 +110,14 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
     }
 
     // Find the closest tile to dig
+    // We only consider the tiles of the index that are within sight radius
+    std::vector<Tile*> candidates;
+    creature.getGameMap()->getTileIndex().getTilesInRadius(TileIndexKind::markedForDigging, creature.getSeat(),
+        myTile->getX(), myTile->getY(), creature.getDefinition()->getSightRadius(), candidates);
     float distBest = -1;
     Tile* tileToDig = nullptr;
     Tile* tilePos = nullptr;
-    for (Tile* tile : creature.getTilesWithinSightRadius())
+    for (Tile* tile : candidates)
     {
         // Check to see whether the tile is marked for digging
         if(!tile->getMarkedForDigging(tempPlayer))
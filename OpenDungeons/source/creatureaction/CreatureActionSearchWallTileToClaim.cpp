@@ -19,11 +19,13 @@
 
 #include "creatureaction/CreatureActionClaimWallTile.h"
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
 #include "entities/Tile.h"
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/TileIndex.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -39,10 +41,9 @@ CreatureActionSearchWallTileToClaim::~CreatureActionSearchWallTileToClaim()
 {
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
-std::function<bool()> CreatureActionSearchWallTileToClaim::action()
+bool CreatureActionSearchWallTileToClaim::execute()
 {
-    return std::bind(&CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return handleSearchWallTileToClaim(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim(Creature& creature, int32_t nbTurns, bool forced)
@@ -85,9 +86,13 @@ bool CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim(Creature&
     }
 
     // Find paths to all of the neighbor tiles for all of the visible wall tiles.
+    // We only consider the tiles of the index that are within sight radius
+    std::vector<Tile*> candidates;
+    creature.getGameMap()->getTileIndex().getTilesInRadius(TileIndexKind::claimableWall, creature.getSeat(),
+        myTile->getX(), myTile->getY(), creature.getDefinition()->getSightRadius(), candidates);
     float distBest = -1;
     Tile* tileToClaim = nullptr;
-    for(Tile* tile : creature.getTilesWithinSightRadius())
+    for(Tile* tile : candidates)
     {
         // Check to see whether the tile is a claimable wall
         if(tile->getMarkedForDigging(tempPlayer))
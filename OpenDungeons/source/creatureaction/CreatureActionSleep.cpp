@@ -27,10 +27,11 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 
-std::function<bool()> CreatureActionSleep::action()
+const double CreatureActionSleep::WAKEFULNESS_GAINED_PER_TURN = 1.5;
+
+bool CreatureActionSleep::execute()
 {
-    return std::bind(&CreatureActionSleep::handleSleep,
-        std::ref(mCreature), getNbTurnsActive());
+    return handleSleep(mCreature, getNbTurnsActive());
 }
 
 bool CreatureActionSleep::handleSleep(Creature& creature, int32_t nbTurnsActive)
@@ -72,7 +73,7 @@ bool CreatureActionSleep::handleSleep(Creature& creature, int32_t nbTurnsActive)
         }
 
         // Improve wakefulness
-        creature.increaseWakefulness(1.5);
+        creature.increaseWakefulness(WAKEFULNESS_GAINED_PER_TURN);
         creature.setHP(creature.getHP() + creature.getDefinition()->getSleepHeal());
 
         creature.computeCreatureOverlayHealthValue();
@@ -33,9 +33,12 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::sleep; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleSleep(Creature& creature, int32_t nbTurnsActive);
+
+    //! \brief Wakefulness recovered per turn while sleeping
+    static const double WAKEFULNESS_GAINED_PER_TURN;
 };
 
 #endif // CREATUREACTIONSLEEP_H
@@ -33,7 +33,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::walkToTile; }
 
-    std::function<bool()> action() override;
+    bool execute() override;
 
     static bool handleWalkToTile(Creature& creature);
 };
@@ -22,8 +22,7 @@
 #include <iosfwd>
 #include <string>
 
-class Creature;
-class GameMap;
+class CreatureMoodInputs;
 
 enum class CreatureMoodLevel
 {
@@ -46,8 +45,13 @@ public:
 
     virtual const std::string& getModifierName() const = 0;
 
-    //! \brief Computes the creature mood for this modifier
-    virtual int32_t computeMood(const Creature& creature) const = 0;
+    //! \brief Returns the creature value this modifier depends on. The mood of the modifier
+    //! is only computed again when this value changes (see CreatureMoodCache). So, it should
+    //! not change when the mood does not (for example, below a threshold)
+    virtual int32_t getMoodInput(const CreatureMoodInputs& inputs) const = 0;
+
+    //! \brief Computes the creature mood for this modifier from the value returned by getMoodInput
+    virtual int32_t computeMood(int32_t moodInput) const = 0;
 
     //! \brief This function should return a copy of the current class
     virtual CreatureMood* clone() const = 0;
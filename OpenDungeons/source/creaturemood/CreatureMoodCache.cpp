@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "creaturemood/CreatureMoodCache.h"
+
+#include "creaturemood/CreatureMood.h"
+
+void CreatureMoodInputs::clearVisibleAlliedCreatures()
+{
+    mVisibleAlliedCreatures.clear();
+}
+
+void CreatureMoodInputs::addVisibleAlliedCreature(const std::string& className)
+{
+    for(std::pair<const std::string*, uint32_t>& count : mVisibleAlliedCreatures)
+    {
+        if((count.first != &className) && (*count.first != className))
+            continue;
+
+        ++count.second;
+        return;
+    }
+
+    mVisibleAlliedCreatures.emplace_back(&className, 1);
+}
+
+uint32_t CreatureMoodInputs::getNbVisibleAlliedCreatures(const std::string& className) const
+{
+    for(const std::pair<const std::string*, uint32_t>& count : mVisibleAlliedCreatures)
+    {
+        if(*count.first == className)
+            return count.second;
+    }
+
+    return 0;
+}
+
+int32_t CreatureMoodCache::computeMoodModifiers(const std::vector<const CreatureMood*>& moods, const CreatureMoodInputs& inputs)
+{
+    if((mMoods != &moods) || (mInputs.size() != moods.size()))
+    {
+        mMoods = &moods;
+        mInputs.resize(moods.size());
+        mMoodValues.resize(moods.size());
+        mMoodModifiersPoints = 0;
+        for(uint32_t i = 0; i < moods.size(); ++i)
+        {
+            mInputs[i] = moods[i]->getMoodInput(inputs);
+            mMoodValues[i] = moods[i]->computeMood(mInputs[i]);
+            mMoodModifiersPoints += mMoodValues[i];
+        }
+        mNbMoodsComputed += moods.size();
+        return mMoodModifiersPoints;
+    }
+
+    for(uint32_t i = 0; i < moods.size(); ++i)
+    {
+        int32_t input = moods[i]->getMoodInput(inputs);
+        if(input == mInputs[i])
+            continue;
+
+        int32_t moodValue = moods[i]->computeMood(input);
+        mMoodModifiersPoints += moodValue - mMoodValues[i];
+        mInputs[i] = input;
+        mMoodValues[i] = moodValue;
+        ++mNbMoodsComputed;
+    }
+
+    return mMoodModifiersPoints;
+}
+
+void CreatureMoodCache::clear()
+{
+    mMoods = nullptr;
+    mInputs.clear();
+    mMoodValues.clear();
+    mMoodModifiersPoints = 0;
+}
+
+int32_t CreatureMoodCache::computeAllMoodModifiers(const std::vector<const CreatureMood*>& moods, const CreatureMoodInputs& inputs)
+{
+    int32_t moodModifiersPoints = 0;
+    for(const CreatureMood* mood : moods)
+        moodModifiersPoints += mood->computeMood(mood->getMoodInput(inputs));
+
+    return moodModifiersPoints;
+}
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CREATUREMOODCACHE_H
+#define CREATUREMOODCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CreatureMood;
+
+//! \brief Creature values the mood modifiers depend on. They are gathered once by the creature
+//! when its mood is computed so that the modifiers do not have to look at the game map
+class CreatureMoodInputs
+{
+public:
+    CreatureMoodInputs() :
+        mOwedGold(0),
+        mHunger(0),
+        mWakefulness(0),
+        mHpLost(0),
+        mNbTurnsWithoutBattle(0)
+    {}
+
+    //! \brief Gold the creature wants on top of its fee for the current pay day
+    int32_t mOwedGold;
+    int32_t mHunger;
+    int32_t mWakefulness;
+    int32_t mHpLost;
+    int32_t mNbTurnsWithoutBattle;
+
+    //! \brief Resets the visible allied creatures counts
+    void clearVisibleAlliedCreatures();
+
+    //! \brief Counts a visible allied creature of the given class. The string should live
+    //! as long as the inputs are used (like the class name of a CreatureDefinition)
+    void addVisibleAlliedCreature(const std::string& className);
+
+    //! \brief Returns the number of visible allied creatures of the given class
+    uint32_t getNbVisibleAlliedCreatures(const std::string& className) const;
+
+private:
+    //! \brief Number of visible allied creatures by class. There are only a few classes
+    //! so a vector is faster than a map
+    std::vector<std::pair<const std::string*, uint32_t>> mVisibleAlliedCreatures;
+};
+
+//! \brief Keeps the mood of each modifier of a creature. When the mood is computed again, only
+//! the modifiers whose input changed (see CreatureMood::getMoodInput) are computed. For example,
+//! the hunger modifier is computed again only when the creature is hungry enough and its hunger
+//! changes, or the fee modifier when the creature gets paid.
+class CreatureMoodCache
+{
+public:
+    CreatureMoodCache() :
+        mMoods(nullptr),
+        mMoodModifiersPoints(0),
+        mNbMoodsComputed(0)
+    {}
+
+    //! \brief Returns the sum of the given mood modifiers. If the modifiers are not the same as in
+    //! the last call (the creature definition changed), everything is computed again
+    int32_t computeMoodModifiers(const std::vector<const CreatureMood*>& moods, const CreatureMoodInputs& inputs);
+
+    //! \brief Forgets the cached values. The next call to computeMoodModifiers will compute every modifier
+    void clear();
+
+    //! \brief Number of modifiers computed since the start (for statistics)
+    inline uint64_t getNbMoodsComputed() const
+    { return mNbMoodsComputed; }
+
+    //! \brief Computes every modifier without any cache
+    static int32_t computeAllMoodModifiers(const std::vector<const CreatureMood*>& moods, const CreatureMoodInputs& inputs);
+
+private:
+    const std::vector<const CreatureMood*>* mMoods;
+    std::vector<int32_t> mInputs;
+    std::vector<int32_t> mMoodValues;
+    int32_t mMoodModifiersPoints;
+    uint64_t mNbMoodsComputed;
+};
+
+#endif // CREATUREMOODCACHE_H
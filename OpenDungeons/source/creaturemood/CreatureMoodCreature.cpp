@@ -17,11 +17,8 @@
 
 #include "creaturemood/CreatureMoodCreature.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
-#include "entities/CreatureDefinition.h"
-#include "entities/GameEntityType.h"
-#include "gamemap/GameMap.h"
 #include "utils/LogManager.h"
 
 static const std::string CreatureMoodCreatureName = "Creature";
@@ -48,26 +45,14 @@ const std::string& CreatureMoodCreature::getModifierName() const
     return CreatureMoodCreatureName;
 }
 
-int32_t CreatureMoodCreature::computeMood(const Creature& creature) const
+int32_t CreatureMoodCreature::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    std::vector<GameEntity*> alliedCreatures = creature.getGameMap()->getVisibleCreatures(creature.getVisibleTiles(),
-        creature.getSeat(), false);
-    int nbCreatures = 0;
-    for(GameEntity* entity : alliedCreatures)
-    {
-        if(entity->getObjectType() != GameEntityType::creature)
-            continue;
-
-        if(&creature == entity)
-            continue;
-
-        Creature* alliedCreature = static_cast<Creature*>(entity);
-        if(alliedCreature->getDefinition()->getClassName() != mCreatureClass)
-            continue;
+    return static_cast<int32_t>(inputs.getNbVisibleAlliedCreatures(mCreatureClass));
+}
 
-        ++nbCreatures;
-    }
-    return nbCreatures * mMoodModifier;
+int32_t CreatureMoodCreature::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodCreature* CreatureMoodCreature::clone() const
@@ -17,9 +17,8 @@
 
 #include "creaturemood/CreatureMoodFee.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
-#include "entities/CreatureDefinition.h"
 #include "utils/Helper.h"
 
 static const std::string CreatureMoodFeeName = "Fee";
@@ -46,14 +45,17 @@ const std::string& CreatureMoodFee::getModifierName() const
     return CreatureMoodFeeName;
 }
 
-int32_t CreatureMoodFee::computeMood(const Creature& creature) const
+int32_t CreatureMoodFee::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    int32_t owedGold = creature.getGoldFee() - creature.getDefinition()->getFee(creature.getLevel());
-    if(owedGold < 100)
+    if(inputs.mOwedGold < 100)
         return 0;
 
-    owedGold = Helper::round(static_cast<double>(owedGold) * 0.01);
-    return owedGold * mMoodModifier;
+    return Helper::round(static_cast<double>(inputs.mOwedGold) * 0.01);
+}
+
+int32_t CreatureMoodFee::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodFee* CreatureMoodFee::clone() const
@@ -17,9 +17,10 @@
 
 #include "creaturemood/CreatureMoodHpLoss.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
-#include "utils/Helper.h"
+
+#include <sstream>
 
 static const std::string CreatureMoodHpLossName = "HpLoss";
 
@@ -45,14 +46,17 @@ const std::string& CreatureMoodHpLoss::getModifierName() const
     return CreatureMoodHpLossName;
 }
 
-int32_t CreatureMoodHpLoss::computeMood(const Creature& creature) const
+int32_t CreatureMoodHpLoss::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    int32_t hpLost = creature.getMaxHp() - creature.getHP();
-    if(hpLost <= 0)
+    if(inputs.mHpLost <= 0)
         return 0;
 
-    hpLost = Helper::round(static_cast<float>(hpLost));
-    return hpLost * mMoodModifier;
+    return inputs.mHpLost;
+}
+
+int32_t CreatureMoodHpLoss::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodHpLoss* CreatureMoodHpLoss::clone() const
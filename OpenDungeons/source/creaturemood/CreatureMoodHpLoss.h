@@ -32,7 +32,9 @@ public:
 
     const std::string& getModifierName() const override;
 
-    virtual int32_t computeMood(const Creature& creature) const override;
+    virtual int32_t getMoodInput(const CreatureMoodInputs& inputs) const override;
+
+    virtual int32_t computeMood(int32_t moodInput) const override;
 
     inline CreatureMoodHpLoss* clone() const override;
 
@@ -17,8 +17,8 @@
 
 #include "creaturemood/CreatureMoodHunger.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
 
 #include <sstream>
 
@@ -46,13 +46,17 @@ const std::string& CreatureMoodHunger::getModifierName() const
     return CreatureMoodHungerName;
 }
 
-int32_t CreatureMoodHunger::computeMood(const Creature& creature) const
+int32_t CreatureMoodHunger::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    int32_t hunger = static_cast<int32_t>(creature.getHunger());
-    if(hunger < mStartHunger)
+    if(inputs.mHunger < mStartHunger)
         return 0;
 
-    return (hunger - mStartHunger) * mMoodModifier;
+    return inputs.mHunger - mStartHunger;
+}
+
+int32_t CreatureMoodHunger::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodHunger* CreatureMoodHunger::clone() const
@@ -18,8 +18,6 @@
 #include "creaturemood/CreatureMoodManager.h"
 
 #include "creaturemood/CreatureMood.h"
-#include "entities/Creature.h"
-#include "entities/CreatureDefinition.h"
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
@@ -72,17 +70,6 @@ CreatureMoodLevel CreatureMoodManager::getCreatureMoodLevel(int32_t moodModifier
     return CreatureMoodLevel::Furious;
 }
 
-int32_t CreatureMoodManager::computeCreatureMoodModifiers(const Creature& creature)
-{
-    int32_t moodValue = 0;
-    for(const CreatureMood* mood : creature.getDefinition()->getCreatureMoods())
-    {
-        moodValue += mood->computeMood(creature);
-    }
-
-    return moodValue;
-}
-
 CreatureMood* CreatureMoodManager::clone(const CreatureMood* mood)
 {
     return mood->clone();
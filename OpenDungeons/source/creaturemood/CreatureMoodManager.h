@@ -22,7 +22,6 @@
 #include <iosfwd>
 #include <string>
 
-class Creature;
 class CreatureMood;
 
 enum class CreatureMoodLevel;
@@ -52,8 +51,6 @@ public:
 
     static CreatureMoodLevel getCreatureMoodLevel(int32_t moodModifiersPoints);
 
-    static int32_t computeCreatureMoodModifiers(const Creature& creature);
-
     static CreatureMood* clone(const CreatureMood* mood);
 
     static CreatureMood* load(std::istream& defFile);
@@ -17,10 +17,11 @@
 
 #include "creaturemood/CreatureMoodTurnsWithoutFight.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
-#include "entities/CreatureDefinition.h"
-#include "utils/Helper.h"
+
+#include <algorithm>
+#include <sstream>
 
 static const std::string CreatureMoodTurnsWithoutFightName = "TurnsWithoutFight";
 
@@ -46,14 +47,17 @@ const std::string& CreatureMoodTurnsWithoutFight::getModifierName() const
     return CreatureMoodTurnsWithoutFightName;
 }
 
-int32_t CreatureMoodTurnsWithoutFight::computeMood(const Creature& creature) const
+int32_t CreatureMoodTurnsWithoutFight::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    int32_t turns = creature.getNbTurnsWithoutBattle();
-    if(turns < mTurnsWithoutFightMin)
+    if(inputs.mNbTurnsWithoutBattle < mTurnsWithoutFightMin)
         return 0;
 
-    turns = std::min(turns - mTurnsWithoutFightMin, mTurnsWithoutFightMax);
-    return turns * mMoodModifier;
+    return std::min(inputs.mNbTurnsWithoutBattle - mTurnsWithoutFightMin, mTurnsWithoutFightMax);
+}
+
+int32_t CreatureMoodTurnsWithoutFight::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodTurnsWithoutFight* CreatureMoodTurnsWithoutFight::clone() const
@@ -34,7 +34,9 @@ public:
 
     const std::string& getModifierName() const override;
 
-    virtual int32_t computeMood(const Creature& creature) const override;
+    virtual int32_t getMoodInput(const CreatureMoodInputs& inputs) const override;
+
+    virtual int32_t computeMood(int32_t moodInput) const override;
 
     inline CreatureMoodTurnsWithoutFight* clone() const override;
 
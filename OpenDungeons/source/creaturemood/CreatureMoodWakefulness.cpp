@@ -17,8 +17,8 @@
 
 #include "creaturemood/CreatureMoodWakefulness.h"
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "creaturemood/CreatureMoodManager.h"
-#include "entities/Creature.h"
 
 #include <sstream>
 
@@ -46,13 +46,17 @@ const std::string& CreatureMoodWakefulness::getModifierName() const
     return CreatureMoodWakefulnessName;
 }
 
-int32_t CreatureMoodWakefulness::computeMood(const Creature& creature) const
+int32_t CreatureMoodWakefulness::getMoodInput(const CreatureMoodInputs& inputs) const
 {
-    int32_t wakefulness = static_cast<int32_t>(creature.getWakefulness());
-    if(wakefulness > mStartWakefulness)
+    if(inputs.mWakefulness > mStartWakefulness)
         return 0;
 
-    return (mStartWakefulness - wakefulness) * mMoodModifier;
+    return mStartWakefulness - inputs.mWakefulness;
+}
+
+int32_t CreatureMoodWakefulness::computeMood(int32_t moodInput) const
+{
+    return moodInput * mMoodModifier;
 }
 
 CreatureMoodWakefulness* CreatureMoodWakefulness::clone() const
@@ -85,9 +85,7 @@ bool CreatureSkillMeleeFight::tryUseFight(GameMap& gameMap, Creature* creature,
         magAtk *= modifier;
         eleAtk *= modifier;
     }
-    attackedObject->takeDamage(creature, 0.0, phyAtk, magAtk, eleAtk, attackedTile, ko);
-    if(notifyPlayerIfHit)
-        attackedObject->notifyFightPlayer(attackedTile);
+    gameMap.dealCombatDamage(creature, attackedObject, 0.0, phyAtk, magAtk, eleAtk, attackedTile, ko, notifyPlayerIfHit);
 
     return true;
 }
@@ -47,6 +47,7 @@
 #include "entities/ChickenEntity.h"
 #include "entities/CreatureDefinition.h"
 #include "entities/CreatureMoodValues.h"
+#include "entities/CreatureSleepUpkeep.h"
 #include "entities/GameEntityType.h"
 #include "entities/Tile.h"
 #include "entities/TreasuryObject.h"
@@ -57,7 +58,9 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/StateHash.h"
 #include "giftboxes/GiftBoxSkill.h"
+#include "goals/Goal.h"
 #include "network/ODClient.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
@@ -96,6 +99,38 @@
 #endif
 
 static const Ogre::Real CANNON_MISSILE_HEIGHT = 0.3;
+//! Actions stack depth that is reserved when the first action is pushed. Actions are pushed
+//! and popped every turn so we want the stack to be allocated once
+static const uint32_t NB_ACTIONS_RESERVED = 8;
+
+//! Maximum number of upkeeps a sleeping creature can skip in a row. Enemies in sight are checked
+//! at every turn so the creature still reacts immediately
+static const uint32_t NB_UPKEEPS_SKIPPED_MAX = 3;
+
+namespace
+{
+//! Changes done by a sleeping turn of the given creature (see Creature::doUpkeep and CreatureActionSleep)
+CreatureSleepUpkeep::Rates getSleepUpkeepRates(const Creature& creature)
+{
+    CreatureSleepUpkeep::Rates rates;
+    const CreatureDefinition* def = creature.getDefinition();
+    rates.mMaxHp = creature.getMaxHp();
+    rates.mHpPerTurn = def->getHpHealPerTurn() + def->getSleepHeal();
+    rates.mWakefulnessGainedPerTurn = CreatureActionSleep::WAKEFULNESS_GAINED_PER_TURN;
+    // Rogue creatures are not affected by wakefulness/hunger
+    if(creature.getSeat()->isRogueSeat())
+    {
+        rates.mWakefulnessLostPerTurn = 0.0;
+        rates.mHungerPerTurn = 0.0;
+    }
+    else
+    {
+        rates.mWakefulnessLostPerTurn = def->getWakefulnessLostPerTurn();
+        rates.mHungerPerTurn = def->getHungerGrowthPerTurn();
+    }
+    return rates;
+}
+}
 
 const int32_t Creature::NB_TURNS_BEFORE_CHECKING_TASK = 15;
 const uint32_t Creature::NB_OVERLAY_HEALTH_VALUES = 8;
@@ -149,6 +184,9 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mDigRate                 (0.0),
     mClaimRate               (0.0),
     mDeathCounter            (0),
+    mAggregatesSeat          (nullptr),
+    mAggregatesIsWorker      (false),
+    mIsCountedInSeat         (false),
     mJobCooldown             (0),
     mGoldFee                 (0),
     mGoldCarried             (0),
@@ -171,7 +209,11 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mNbUpkeepsToSkip         (0),
+    mNbUpkeepsSkipped        (0),
+    mSkippedUpkeepHp         (0.0),
+    mSkippedUpkeepWakefulness(0.0)
 
 {
     //TODO: This should be set in initialiser list in parent classes
@@ -227,6 +269,9 @@ Creature::Creature(GameMap* gameMap) :
     mDigRate                 (0.0),
     mClaimRate               (0.0),
     mDeathCounter            (0),
+    mAggregatesSeat          (nullptr),
+    mAggregatesIsWorker      (false),
+    mIsCountedInSeat         (false),
     mJobCooldown             (0),
     mGoldFee                 (0),
     mGoldCarried             (0),
@@ -249,7 +294,11 @@ Creature::Creature(GameMap* gameMap) :
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mNbUpkeepsToSkip         (0),
+    mNbUpkeepsSkipped        (0),
+    mSkippedUpkeepHp         (0.0),
+    mSkippedUpkeepWakefulness(0.0)
 {
 }
 
@@ -321,6 +370,8 @@ void Creature::addToGameMap()
         return;
 
     getGameMap()->addActiveObject(this);
+    mIsCountedInSeat = true;
+    updateSeatAggregates();
 }
 
 void Creature::removeFromGameMap()
@@ -334,6 +385,9 @@ void Creature::removeFromGameMap()
     if(!getIsOnServerMap())
         return;
 
+    mIsCountedInSeat = false;
+    updateSeatAggregates();
+
     // If the creature has a homeTile where it sleeps, its bed needs to be destroyed.
     if (getHomeTile() != nullptr)
     {
@@ -345,6 +399,26 @@ void Creature::removeFromGameMap()
     getGameMap()->removeActiveObject(this);
 }
 
+void Creature::updateSeatAggregates()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = (mIsCountedInSeat && !hasDied()) ? getSeat() : nullptr;
+    bool isWorker = getDefinition()->isWorker();
+    if((seat == mAggregatesSeat) && (isWorker == mAggregatesIsWorker))
+        return;
+
+    if(mAggregatesSeat != nullptr)
+        mAggregatesSeat->updateCreatureAggregates(mAggregatesIsWorker, -1);
+
+    if(seat != nullptr)
+        seat->updateCreatureAggregates(isWorker, 1);
+
+    mAggregatesSeat = seat;
+    mAggregatesIsWorker = isWorker;
+}
+
 std::string Creature::getCreatureStreamFormat()
 {
     std::string format = MovableGameEntity::getMovableGameEntityStreamFormat();
@@ -639,6 +713,12 @@ void Creature::setHP(double nHP)
     computeCreatureOverlayHealthValue();
 }
 
+void Creature::setHomeTile(Tile* ht)
+{
+    stopSkippingUpkeep();
+    mHomeTile = ht;
+}
+
 void Creature::heal(double hp)
 {
     mHp = std::min(mHp + hp, mMaxHP);
@@ -669,10 +749,17 @@ void Creature::update(Ogre::Real timeSinceLastFrame)
         computeVisualDebugEntities();
     }
 
+    // The overlays of culled creatures are hidden and not updated until they are visible again
+    if((getOverlayStatus() != nullptr) && isCulled())
+        getOverlayStatus()->setVisible(false);
+}
+
+void Creature::updateVisuals(Ogre::Real timeSinceLastUpdate)
+{
+    MovableGameEntity::updateVisuals(timeSinceLastUpdate);
+
     if(getOverlayStatus() != nullptr)
-    {
-        getOverlayStatus()->update(timeSinceLastFrame);
-    }
+        getOverlayStatus()->update(timeSinceLastUpdate);
 }
 
 void Creature::computeVisibleTiles()
@@ -837,6 +924,7 @@ void Creature::doUpkeep()
         if (mDeathCounter == 0)
         {
             OD_LOG_INF("Creature=" + getName() + " RIP");
+            getGameMap()->notifyGoalEvent(GoalEvent::creatures);
 
             dropCarriedEquipment();
         }
@@ -849,6 +937,10 @@ void Creature::doUpkeep()
         }
 
         ++mDeathCounter;
+        // Dead creatures are not counted anymore in their seat
+        if(mDeathCounter == 1)
+            updateSeatAggregates();
+
         return;
     }
 
@@ -877,6 +969,15 @@ void Creature::doUpkeep()
         return;
     }
 
+    // Creatures sleeping in their bed are not fully upkept every turn
+    if((mNbUpkeepsToSkip > 0) && canKeepSkippingUpkeep())
+    {
+        --mNbUpkeepsToSkip;
+        ++mNbUpkeepsSkipped;
+        return;
+    }
+    stopSkippingUpkeep();
+
     // Check to see if we have earned enough experience to level up.
     checkLevelUp();
 
@@ -995,8 +1096,7 @@ void Creature::doUpkeep()
             // We save the action type here because the action may be removed after calling
             // the action function
             CreatureActionType actType = act->getType();
-            std::function<bool()> func = act->action();
-            loopBack = func();
+            loopBack = act->execute();
             OD_LOG_DBG("creature=" + getName() + " trying action=" + CreatureAction::toString(actType) + ", result=" + std::string(loopBack?"1":"0"));
         }
     } while (loopBack && loops < 20);
@@ -1012,6 +1112,87 @@ void Creature::doUpkeep()
         OD_LOG_INF("> 20 loops in Creature::doUpkeep name:" + getName() +
                 " seat id: " + Helper::toString(getSeat()->getId()) + ". Breaking out..");
     }
+
+    startSkippingUpkeep();
+}
+
+void Creature::startSkippingUpkeep()
+{
+    mNbUpkeepsToSkip = 0;
+
+    // Only creatures sleeping in their bed skip upkeeps
+    if(mActions.empty() || (mActions.back()->getType() != CreatureActionType::sleep))
+        return;
+
+    if((mHomeTile == nullptr) || (getPositionTile() != mHomeTile))
+        return;
+
+    if(!mVisibleEnemyObjects.empty())
+        return;
+
+    // Furious creatures count the turns before becoming rogue
+    if(mMoodValue >= CreatureMoodLevel::Furious)
+        return;
+
+    // Skills warming up prevent the creature from doing anything
+    for(const CreatureSkillData& skillData : mSkillData)
+    {
+        if(skillData.mWarmup > 0)
+            return;
+    }
+
+    CreatureSleepUpkeep::State state = {mHp, mWakefulness, mHunger};
+    mNbUpkeepsToSkip = CreatureSleepUpkeep::computeNbTurnsToSkip(state, getSleepUpkeepRates(*this), NB_UPKEEPS_SKIPPED_MAX);
+    mSkippedUpkeepHp = mHp;
+    mSkippedUpkeepWakefulness = mWakefulness;
+}
+
+bool Creature::canKeepSkippingUpkeep()
+{
+    // Effects (like heal) or damage change hp
+    if((mHp != mSkippedUpkeepHp) || (mWakefulness != mSkippedUpkeepWakefulness))
+        return false;
+
+    if(mActions.empty() || (mActions.back()->getType() != CreatureActionType::sleep))
+        return false;
+
+    // If the dormitory was destroyed, the creature has no home anymore
+    if((mHomeTile == nullptr) || (getPositionTile() != mHomeTile))
+        return false;
+
+    // Enemies in sight wake the creature up. The visible tiles are computed at every turn
+    mVisibleEnemyObjects = getVisibleEnemyObjects();
+    return mVisibleEnemyObjects.empty();
+}
+
+void Creature::stopSkippingUpkeep()
+{
+    mNbUpkeepsToSkip = 0;
+    if(mNbUpkeepsSkipped == 0)
+        return;
+
+    uint32_t nbTurns = mNbUpkeepsSkipped;
+    mNbUpkeepsSkipped = 0;
+
+    CreatureSleepUpkeep::State state = {mHp, mWakefulness, mHunger};
+    CreatureSleepUpkeep::applyTurns(state, getSleepUpkeepRates(*this), nbTurns);
+    mHp = state.mHp;
+    mWakefulness = state.mWakefulness;
+    mHunger = state.mHunger;
+    computeCreatureOverlayHealthValue();
+
+    // The mood will be computed at the next upkeep if its cooldown is over
+    mMoodCooldownTurns = std::max(0, mMoodCooldownTurns - static_cast<int32_t>(nbTurns));
+    mNbTurnsWithoutBattle += nbTurns;
+    for(CreatureSkillData& skillData : mSkillData)
+        skillData.mCooldown -= std::min(skillData.mCooldown, nbTurns);
+
+    for(uint32_t i = 0; i < nbTurns; ++i)
+    {
+        mActions.back()->increaseNbTurnActive();
+        for(std::unique_ptr<CreatureAction>& creatureAction : mActions)
+            creatureAction.get()->increaseNbTurn();
+    }
 }
 
 void Creature::decidePrioritaryAction()
@@ -1274,7 +1455,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         std::vector<Tile*> coveredTiles = entity->getCoveredTiles();
         for(Tile* tile : coveredTiles)
         {
-            if(std::find(mVisibleTiles.begin(), mVisibleTiles.end(), tile) == mVisibleTiles.end())
+            if(!isTileVisible(tile))
                 continue;
 
             int dist = Pathfinding::squaredDistanceTile(*tile, *myTile);
@@ -1648,6 +1829,14 @@ void Creature::updateTilesInSight()
 
     // Only the tiles the creature can "see".
     mVisibleTiles = getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    mVisibleTilesMask.reset(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    for(Tile* tile : mVisibleTiles)
+        mVisibleTilesMask.set(tile->getX(), tile->getY());
+}
+
+bool Creature::isTileVisible(const Tile* tile) const
+{
+    return mVisibleTilesMask.isSet(tile->getX(), tile->getY());
 }
 
 std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
@@ -1901,6 +2090,13 @@ void Creature::updateStatsWindow(const std::string& txt)
     textWindow->setText(txt);
 }
 
+uint64_t Creature::getStateHashValue() const
+{
+    int seatId = (getSeat() == nullptr) ? -1 : getSeat()->getId();
+    const Ogre::Vector3& destination = getWalkDestination();
+    return StateHash::hashValues({seatId, mLevel, Helper::round(destination.x), Helper::round(destination.y)});
+}
+
 std::string Creature::getStatsText()
 {
     // The creatures are not refreshed at each turn so this information is relevant in the server
@@ -1962,12 +2158,19 @@ std::string Creature::getStatsText()
 double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
         Tile *tileTakingDamage, bool ko)
 {
-    mNbTurnsWithoutBattle = 0;
+    stopSkippingUpkeep();
     physicalDamage = std::max(physicalDamage - getPhysicalDefense(), 0.0);
     magicalDamage = std::max(magicalDamage - getMagicalDefense(), 0.0);
     elementDamage = std::max(elementDamage - getElementDefense(), 0.0);
     double damageDone = std::min(mHp, absoluteDamage + physicalDamage + magicalDamage + elementDamage);
-    mHp -= damageDone;
+    applyDamage(attacker, mHp - damageDone, ko);
+    return damageDone;
+}
+
+void Creature::applyDamage(GameEntity* attacker, double hpLeft, bool ko)
+{
+    mNbTurnsWithoutBattle = 0;
+    mHp = hpLeft;
     if(mHp <= 0)
     {
         // If the attacking entity is a creature and its seat is configured to KO creatures
@@ -1976,7 +2179,7 @@ double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double
         {
             mHp = 1.0;
             mKoTurnCounter = -ConfigManager::getSingleton().getNbTurnsKoCreatureAttacked();
-            OD_LOG_INF("creature=" + getName() + " has been KO by " + attacker->getName());
+            OD_LOG_INF("creature=" + getName() + " has been KO by " + (attacker != nullptr ? attacker->getName() : std::string("unknown")));
             dropCarriedEquipment();
         }
     }
@@ -1988,16 +2191,16 @@ double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double
         fireEntityDead();
 
     if(!getIsOnServerMap())
-        return damageDone;
+        return;
 
     Player* player = getGameMap()->getPlayerBySeat(getSeat());
     if (player == nullptr)
-        return damageDone;
+        return;
 
     // If we are a worker attacked by a worker, we fight. Otherwise, we flee (if it is a fighter, a trap,
     // or whatever)
     if(!getDefinition()->isWorker())
-        return damageDone;
+        return;
 
     bool shouldFlee = true;
     if((attacker != nullptr) &&
@@ -2012,11 +2215,7 @@ double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double
     }
 
     if(shouldFlee)
-    {
         flee();
-        return damageDone;
-    }
-    return damageDone;
 }
 
 void Creature::receiveExp(double experience)
@@ -2066,6 +2265,7 @@ bool Creature::isActionInList(CreatureActionType action) const
 
 void Creature::clearActionQueue()
 {
+    stopSkippingUpkeep();
     mActions.clear();
 }
 
@@ -2079,6 +2279,13 @@ bool Creature::hasActionBeenTried(CreatureActionType actionType) const
 
 void Creature::pushAction(std::unique_ptr<CreatureAction>&& action)
 {
+    stopSkippingUpkeep();
+    if(mActions.capacity() == 0)
+    {
+        mActions.reserve(NB_ACTIONS_RESERVED);
+        mActionTry.reserve(NB_ACTIONS_RESERVED);
+    }
+
     CreatureActionType actionType = action.get()->getType();
     if(std::find(mActionTry.begin(), mActionTry.end(), actionType) == mActionTry.end())
     {
@@ -2090,6 +2297,7 @@ void Creature::pushAction(std::unique_ptr<CreatureAction>&& action)
 
 void Creature::popAction()
 {
+    stopSkippingUpkeep();
     if(mActions.empty())
     {
         OD_LOG_ERR("name=" + getName() + ", trying to pop empty action list");
@@ -2503,6 +2711,7 @@ void Creature::slap()
         return;
 
     fireCreatureSound(CreatureSound::Slap);
+    stopSkippingUpkeep();
 
     // In editor mode, we remove the creature
     if(getGameMap()->isInEditorMode())
@@ -2842,7 +3051,25 @@ void Creature::decreaseWakefulness(double value)
 
 void Creature::computeMood()
 {
-    mMoodPoints = CreatureMoodManager::computeCreatureMoodModifiers(*this);
+    // The visible allied objects are computed at every upkeep before the mood
+    mMoodInputs.mOwedGold = mGoldFee - mDefinition->getFee(getLevel());
+    mMoodInputs.mHunger = static_cast<int32_t>(mHunger);
+    mMoodInputs.mWakefulness = static_cast<int32_t>(mWakefulness);
+    mMoodInputs.mHpLost = static_cast<int32_t>(getMaxHp() - getHP());
+    mMoodInputs.mNbTurnsWithoutBattle = mNbTurnsWithoutBattle;
+    mMoodInputs.clearVisibleAlliedCreatures();
+    for(GameEntity* entity : mVisibleAlliedObjects)
+    {
+        if(entity->getObjectType() != GameEntityType::creature)
+            continue;
+
+        if(entity == this)
+            continue;
+
+        Creature* alliedCreature = static_cast<Creature*>(entity);
+        mMoodInputs.addVisibleAlliedCreature(alliedCreature->getDefinition()->getClassName());
+    }
+    mMoodPoints = mMoodCache.computeMoodModifiers(mDefinition->getCreatureMoods(), mMoodInputs);
 
     CreatureMoodLevel oldMoodValue = mMoodValue;
     mMoodValue = CreatureMoodManager::getCreatureMoodLevel(mMoodPoints);
@@ -3220,6 +3447,8 @@ void Creature::changeSeat(Seat* newSeat)
     OD_LOG_INF("creature=" + getName() + " changes side from seatId=" + Helper::toString(getSeat()->getId()) + " to seatId=" + Helper::toString(newSeat->getId()));
     OD_ASSERT_TRUE_MSG(getSeat() != newSeat, "creature=" + getName() + ", seatId=" + Helper::toString(newSeat->getId()));
     setSeat(newSeat);
+    updateSeatAggregates();
+    getGameMap()->notifyGoalEvent(GoalEvent::creatures);
     mMoodValue = CreatureMoodLevel::Neutral;
     mMoodPoints = 0;
     mWakefulness = 100;
@@ -21,7 +21,9 @@
 #ifndef CREATURE_H
 #define CREATURE_H
 
+#include "creaturemood/CreatureMoodCache.h"
 #include "entities/MovableGameEntity.h"
+#include "gamemap/TileWindowMask.h"
 
 #include <OgreVector2.h>
 #include <OgreVector3.h>
@@ -136,11 +138,24 @@ public:
     inline unsigned int getLevel() const
     { return mLevel; }
 
+    //! \brief Value of the creature in the StateHash shared by the server and the client. It only
+    //! depends on what the client is notified about: seat, level and the tile where the creature goes
+    uint64_t getStateHashValue() const;
+
     inline double getHP(Tile *tile) const override
     { return mHp; }
 
     bool isAlive() const;
 
+    //! \brief Returns true once the creature death has been handled during its upkeep. Dead
+    //! creatures stay on the map for a few turns before being removed
+    inline bool hasDied() const
+    { return mDeathCounter > 0; }
+
+    //! \brief Updates the seat worker/fighter counts with the current state of the creature. Should be
+    //! called when the creature is added/removed, dies or changes seat. Used on server side only
+    void updateSeatAggregates();
+
     //! \brief Gets the maximum HP the creature can have currently
     inline double getMaxHp() const
     { return mMaxHP; }
@@ -213,8 +228,7 @@ public:
 
     void heal(double hp);
 
-    inline void setHomeTile(Tile* ht)
-    { mHomeTile = ht; }
+    void setHomeTile(Tile* ht);
 
     //! \brief Set the level of the creature
     void setLevel(unsigned int level);
@@ -290,6 +304,12 @@ public:
     double takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
         Tile *tileTakingDamage, bool ko) override;
 
+    //! \brief Sets the HP left after taking damage (already lowered by the defenses) and reacts to it
+    //! (KO, death, fleeing...). It is used by takeDamage and by the CombatResolver that applies all the
+    //! damage a creature took during a turn at once. If ko is true and the creature has no HP left, it
+    //! is KO instead of dying
+    void applyDamage(GameEntity* attacker, double hpLeft, bool ko);
+
     //! \brief Conform: AttackableObject - Adds experience to this creature.
     void receiveExp(double experience);
 
@@ -401,6 +421,19 @@ public:
     inline const std::vector<Tile*>& getTilesWithinSightRadius() const
     { return mTilesWithinSightRadius; }
 
+    //! \brief Creatures sleeping in their bed are not fully upkept every turn (see CreatureSleepUpkeep).
+    //! This function applies the skipped turns and the creature will be fully upkept from its next
+    //! upkeep. It should be called when something happens to the creature (attacked, slapped, picked
+    //! up, actions changed, ...)
+    void stopSkippingUpkeep();
+
+    inline bool isSkippingUpkeep() const
+    { return mNbUpkeepsToSkip > 0; }
+
+    //! \brief Returns true if the given tile is in the visible tiles. Unlike searching
+    //! in getVisibleTiles, it is done in constant time
+    bool isTileVisible(const Tile* tile) const;
+
     inline const std::vector<GameEntity*>& getVisibleEnemyObjects() const
     { return mVisibleEnemyObjects; }
 
@@ -598,6 +631,9 @@ protected:
     virtual void destroyMeshLocal() override;
     virtual void fireAddEntity(Seat* seat, bool async) override;
     virtual void fireRemoveEntity(Seat* seat) override;
+
+    //! \brief Updates the animation and the creature overlays
+    virtual void updateVisuals(Ogre::Real timeSinceLastUpdate) override;
 private:
     enum ForceAction
     {
@@ -661,6 +697,13 @@ private:
 
     //! \brief Counter to let the creature stay some turns after its death
     unsigned int    mDeathCounter;
+
+    //! \brief Seat the creature is currently counted in (nullptr if not counted) and whether it
+    //! is counted as a worker
+    Seat*           mAggregatesSeat;
+    bool            mAggregatesIsWorker;
+    //! \brief true if the creature is in the gamemap and should be counted in its seat aggregates
+    bool            mIsCountedInSeat;
     int             mJobCooldown;
 
     //! \brief At pay day, mGoldFee will be set to the creature fee and decreased when the creature gets gold
@@ -684,6 +727,9 @@ private:
     //! used for actions linked to enemies.
     std::vector<Tile*>              mVisibleTiles;
 
+    //! \brief Same tiles as mVisibleTiles in a bitmap centered on the creature
+    TileWindowMask                  mVisibleTilesMask;
+
     std::vector<GameEntity*>        mVisibleEnemyObjects;
     std::vector<GameEntity*>        mVisibleAlliedObjects;
     std::vector<GameEntity*>        mReachableAlliedObjects;
@@ -706,6 +752,11 @@ private:
     //! should not be used to check mood. If the mood is to be tested, mMoodValue should be used
     int32_t                         mMoodPoints;
 
+    //! \brief Values the mood modifiers depend on and mood of each modifier. Only the modifiers
+    //! whose values changed are computed
+    CreatureMoodInputs              mMoodInputs;
+    CreatureMoodCache               mMoodCache;
+
     //! \brief Counts turns the creature is furious. If it stays like this for too long, it will become rogue
     int32_t                         mNbTurnFurious;
 
@@ -761,6 +812,24 @@ private:
     //! \brief Skills the creature can use
     std::vector<CreatureSkillData> mSkillData;
 
+    //! \brief Number of upkeeps the creature will skip if nothing happens to it
+    uint32_t                        mNbUpkeepsToSkip;
+
+    //! \brief Number of upkeeps skipped that have not been applied yet
+    uint32_t                        mNbUpkeepsSkipped;
+
+    //! \brief HP and wakefulness when the creature started skipping upkeeps. If they change,
+    //! something happened to the creature and it should be upkept
+    double                          mSkippedUpkeepHp;
+    double                          mSkippedUpkeepWakefulness;
+
+    //! \brief Called at the end of the upkeep. If the creature is sleeping in its bed, computes
+    //! how many of the next upkeeps it can skip
+    void startSkippingUpkeep();
+
+    //! \brief Called during skipped upkeeps. Returns true if nothing happened to the creature
+    bool canKeepSkippingUpkeep();
+
     //! \brief A sub-function called by doTurn()
     //! This one checks if there is something prioritary to do (like fighting). If it is the case,
     //! it should empty the action list before adding what to do.
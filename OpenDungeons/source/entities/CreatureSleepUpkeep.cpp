@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entities/CreatureSleepUpkeep.h"
+
+#include <algorithm>
+
+namespace CreatureSleepUpkeep
+{
+
+bool canSkipTurns(const State& state, const Rates& rates)
+{
+    if(rates.mHpPerTurn < 0.0)
+        return false;
+
+    if(rates.mHungerPerTurn < 0.0)
+        return false;
+
+    if(rates.mWakefulnessLostPerTurn < 0.0)
+        return false;
+
+    if(rates.mWakefulnessGainedPerTurn < rates.mWakefulnessLostPerTurn)
+        return false;
+
+    // Wakefulness is lost before it is gained. If there is not enough, it would be capped at 0
+    if(state.mWakefulness < rates.mWakefulnessLostPerTurn)
+        return false;
+
+    return true;
+}
+
+void applyTurns(State& state, const Rates& rates, uint32_t nbTurns)
+{
+    if(nbTurns == 0)
+        return;
+
+    double nbTurnsDouble = static_cast<double>(nbTurns);
+    state.mHp = std::min(rates.mMaxHp, state.mHp + nbTurnsDouble * rates.mHpPerTurn);
+    state.mWakefulness = std::min(MAX_WAKEFULNESS, state.mWakefulness
+        + nbTurnsDouble * (rates.mWakefulnessGainedPerTurn - rates.mWakefulnessLostPerTurn));
+    state.mHunger = std::min(MAX_HUNGER, state.mHunger + nbTurnsDouble * rates.mHungerPerTurn);
+}
+
+bool isRested(const State& state, const Rates& rates)
+{
+    return (state.mWakefulness >= MAX_WAKEFULNESS) && (state.mHp >= rates.mMaxHp);
+}
+
+uint32_t computeNbTurnsToSkip(const State& state, const Rates& rates, uint32_t nbTurnsMax)
+{
+    if(!canSkipTurns(state, rates))
+        return 0;
+
+    for(uint32_t nbTurns = 1; nbTurns <= nbTurnsMax; ++nbTurns)
+    {
+        State nextState = state;
+        applyTurns(nextState, rates, nbTurns);
+        if(isRested(nextState, rates))
+            return nbTurns - 1;
+    }
+
+    return nbTurnsMax;
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CREATURESLEEPUPKEEP_H
+#define CREATURESLEEPUPKEEP_H
+
+#include <cstdint>
+
+//! \brief A creature sleeping in its bed does the same thing every turn until it is rested: it
+//! heals, gets hungrier and recovers wakefulness. To save the full upkeep of such creatures (mood,
+//! skills, behaviours, reachable allies, ...), they are only fully upkept every few turns and the
+//! skipped turns are applied at once with the functions below. They only depend on the creature
+//! values so that a given game always ends in the same state.
+//! The values are computed as if Creature::doUpkeep and CreatureActionSleep were called once per
+//! turn. Values are capped like they are during a turn.
+namespace CreatureSleepUpkeep
+{
+    //! \brief Values changed by a sleeping turn
+    struct State
+    {
+        double mHp;
+        double mWakefulness;
+        double mHunger;
+    };
+
+    //! \brief Changes done by a sleeping turn
+    struct Rates
+    {
+        double mMaxHp;
+        //! \brief Heal per turn plus heal from sleeping
+        double mHpPerTurn;
+        double mWakefulnessLostPerTurn;
+        double mWakefulnessGainedPerTurn;
+        double mHungerPerTurn;
+    };
+
+    const double MAX_WAKEFULNESS = 100.0;
+    const double MAX_HUNGER = 100.0;
+
+    //! \brief Returns true if sleeping turns can be applied at once. It is the case if no value
+    //! decreases while sleeping (otherwise, the min/max caps would have to be checked every turn)
+    bool canSkipTurns(const State& state, const Rates& rates);
+
+    //! \brief Applies the given number of sleeping turns
+    void applyTurns(State& state, const Rates& rates, uint32_t nbTurns);
+
+    //! \brief Returns true if the creature is rested and will stop sleeping
+    bool isRested(const State& state, const Rates& rates);
+
+    //! \brief Returns how many turns can be skipped after the current one (at most nbTurnsMax). The turn
+    //! when the creature gets rested is never skipped so that it wakes up when it would have without
+    //! skipping turns
+    uint32_t computeNbTurnsToSkip(const State& state, const Rates& rates, uint32_t nbTurnsMax);
+}
+
+#endif // CREATURESLEEPUPKEEP_H
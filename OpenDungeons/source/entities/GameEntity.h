@@ -326,6 +326,10 @@ class GameEntity
     //! \brief Called each turn with the list of seats that have vision on the tile where the entity is. It should handle
     //! messages to notify players that gain/lose vision
     virtual void notifySeatsWithVision(const std::vector<Seat*>& seats);
+    //! \brief Seats that have been notified about this entity (server side)
+    inline const std::vector<Seat*>& getSeatsWithVisionNotified() const
+    { return mSeatsWithVisionNotified; }
+
     //! \brief Functions to add/remove a seat with vision
     virtual void addSeatWithVision(Seat* seat, bool async);
     virtual void removeSeatWithVision(Seat* seat);
@@ -391,6 +395,11 @@ class GameEntity
     //! entity (culling, if the entity is carried, ...)
     void setParentNodeDetachFlags(uint32_t mask, bool value);
 
+    //! \brief Client side. Returns true if the entity is detached from the scene because it
+    //! is on a culled tile
+    inline bool isCulled() const
+    { return (mEntityParentNodeAttach & EntityParentNodeAttach::DETACH_CULLING) != 0; }
+
     static void exportToStream(GameEntity* entity, std::ostream& os);
 
   protected:
@@ -24,12 +24,24 @@
 #include "entities/Tile.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/GridTraversal.h"
 #include "network/ODPacket.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 #include <iostream>
 
+namespace
+{
+//! Creatures on the tile the missile is crossing. Missiles are only updated during the server
+//! turn so the same vector can be reused by every missile, without allocating for each tile
+std::vector<GameEntity*>& getCreaturesOnTileBuffer()
+{
+    static std::vector<GameEntity*> creatures;
+    return creatures;
+}
+}
+
 MissileObject::MissileObject(GameMap* gameMap, Seat* seat, const std::string& senderName, const std::string& meshName,
         const Ogre::Vector3& direction, double speed, GameEntity* entityTarget, bool damageAllies, bool koEnemyCreature) :
     RenderedMovableEntity(gameMap, senderName, meshName, 0.0f, false),
@@ -96,26 +108,32 @@ void MissileObject::doUpkeep()
     Ogre::Vector3 position = getPosition();
     double moveDist = getMoveSpeed();
     Ogre::Vector3 destination;
-    std::list<Tile*> tiles;
-    mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+    GridTraversal traversal;
+    mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, traversal);
 
     std::vector<Ogre::Vector3> path;
+    std::vector<GameEntity*>& creatures = getCreaturesOnTileBuffer();
     Tile* lastTile = nullptr;
-    while(!tiles.empty() && mIsMissileAlive)
+    int tileX;
+    int tileY;
+    while(mIsMissileAlive && traversal.next(tileX, tileY))
     {
-        Tile* tmpTile = tiles.front();
-        tiles.pop_front();
-
+        Tile* tmpTile = getGameMap()->getTile(tileX, tileY);
+        // We stop when we get out of the map. computeDestination has already set the destination
         if(tmpTile == nullptr)
-        {
-            OD_LOG_ERR("Unexpected null tile when reading missile path name=" + getName() + ", lastTile=" + (lastTile == nullptr ? std::string("nullptr") : Tile::displayAsString(lastTile)));
-            continue;
-        }
+            break;
 
         if(tmpTile->getFullness() > 0.0)
         {
             Ogre::Vector3 nextDirection;
             OD_LOG_INF("missile name=" + getName() + ", hit wall on tile=" + Tile::displayAsString(tmpTile));
+            if(lastTile == nullptr)
+            {
+                // The missile is in a wall
+                mIsMissileAlive = false;
+                destination = position;
+                break;
+            }
             mIsMissileAlive = wallHitNextDirection(mDirection, lastTile, nextDirection);
             if(!mIsMissileAlive)
             {
@@ -130,7 +148,7 @@ void MissileObject::doUpkeep()
                 path.push_back(position);
                 // We compute next position
                 mDirection = nextDirection;
-                mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+                mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, traversal);
                 continue;
             }
         }
@@ -165,35 +183,27 @@ void MissileObject::doUpkeep()
             }
         }
 
-        std::vector<Tile*> tileVector;
-        tileVector.push_back(tmpTile);
-        std::vector<GameEntity*> enemyCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), true);
-        for(std::vector<GameEntity*>::iterator it = enemyCreatures.begin(); it != enemyCreatures.end(); ++it)
+        // Most tiles crossed are empty
+        if(tmpTile->numEntitiesInTile() == 0)
+            continue;
+
+        creatures.clear();
+        tmpTile->fillWithEntities(creatures, SelectionEntityWanted::creatureAliveEnemyAttackable, getSeat()->getPlayer());
+        if(!hitCreaturesOnTile(tmpTile, creatures))
         {
-            GameEntity* creature = *it;
-            OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
-            if(!hitCreature(tmpTile, creature))
-            {
-                destination -= moveDist * mDirection;
-                mIsMissileAlive = false;
-                break;
-            }
+            destination -= moveDist * mDirection;
+            mIsMissileAlive = false;
         }
 
         if(!mDamageAllies || !mIsMissileAlive)
             continue;
 
-        std::vector<GameEntity*> alliedCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), false);
-        for(std::vector<GameEntity*>::iterator it = alliedCreatures.begin(); it != alliedCreatures.end(); ++it)
+        creatures.clear();
+        tmpTile->fillWithEntities(creatures, SelectionEntityWanted::creatureAliveAllied, getSeat()->getPlayer());
+        if(!hitCreaturesOnTile(tmpTile, creatures))
         {
-            GameEntity* creature = *it;
-            OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
-            if(!hitCreature(tmpTile, creature))
-            {
-                destination -= moveDist * mDirection;
-                mIsMissileAlive = false;
-                break;
-            }
+            destination -= moveDist * mDirection;
+            mIsMissileAlive = false;
         }
     }
 
@@ -202,35 +212,60 @@ void MissileObject::doUpkeep()
 }
 
 bool MissileObject::computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles)
+        Ogre::Vector3& destination, GridTraversal& traversal)
 {
     destination = position + (moveDist * direction);
-    tiles = getGameMap()->tilesBetween(Helper::round(position.x),
-        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y));
-    if(tiles.empty())
-    {
-        OD_LOG_ERR("missile=" + getName() + " has unexpected empty tiles destination");
-        return false;
-    }
+    traversal.init(position.x, position.y, destination.x, destination.y);
 
-    // If we get out of the map, we take the last tile as the destination
+    // If we get out of the map, we take the last tile on the map as the destination
     if((direction.x > 0.0 && destination.x > static_cast<Ogre::Real>(getGameMap()->getMapSizeX() - 1)) ||
        (direction.x < 0.0 && destination.x < 0.0) ||
        (direction.y > 0 && destination.y > static_cast<Ogre::Real>(getGameMap()->getMapSizeY() - 1)) ||
        (direction.y < 0 && destination.y < 0))
     {
-        Tile* lastTile = tiles.back();
+        GridTraversal tilesOnMap = traversal;
+        Tile* lastTile = nullptr;
+        uint32_t nbTiles = 0;
+        int tileX;
+        int tileY;
+        while(tilesOnMap.next(tileX, tileY))
+        {
+            Tile* tile = getGameMap()->getTile(tileX, tileY);
+            if(tile == nullptr)
+                break;
+
+            lastTile = tile;
+            ++nbTiles;
+        }
+
+        if(lastTile == nullptr)
+        {
+            OD_LOG_ERR("missile=" + getName() + " has unexpected empty tiles destination");
+            return false;
+        }
+
         destination.x = static_cast<Ogre::Real>(lastTile->getX());
         destination.y = static_cast<Ogre::Real>(lastTile->getY());
 
         // We are in the last position, we can die
-        if(tiles.size() <= 1)
+        if(nbTiles <= 1)
             return false;
     }
 
     return true;
 }
 
+bool MissileObject::hitCreaturesOnTile(Tile* tile, const std::vector<GameEntity*>& creatures)
+{
+    for(GameEntity* creature : creatures)
+    {
+        OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tile));
+        if(!hitCreature(tile, creature))
+            return false;
+    }
+    return true;
+}
+
 bool MissileObject::notifyDead(GameEntity* entity)
 {
     if(entity == mEntityTarget)
@@ -25,6 +25,7 @@
 
 class Building;
 class Creature;
+class GridTraversal;
 class Room;
 class GameMap;
 class Tile;
@@ -103,8 +104,15 @@ protected:
     void importFromPacket(ODPacket& is) override;
 
 private:
+    //! \brief Computes the destination after moving moveDist from position and initializes traversal
+    //! with the tiles crossed to go there. If the destination is out of the map, it is set to the last
+    //! tile on the map. Returns false if the missile cannot move anymore
     bool computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles);
+        Ogre::Vector3& destination, GridTraversal& traversal);
+
+    //! \brief Hits the creatures in creatures. Returns false if the missile stopped
+    bool hitCreaturesOnTile(Tile* tile, const std::vector<GameEntity*>& creatures);
+
     Ogre::Vector3 mDirection;
     bool mIsMissileAlive;
     GameEntity* mEntityTarget;
@@ -52,18 +52,16 @@ MissileOneHit::MissileOneHit(GameMap* gameMap) :
 
 bool MissileOneHit::hitCreature(Tile* tile, GameEntity* entity)
 {
-    entity->takeDamage(this, 0.0, mPhysicalDamage, mMagicalDamage, mElementDamage, tile, getKoEnemyCreature());
-    if(mNotifyPlayerIfHit)
-        entity->notifyFightPlayer(tile);
+    getGameMap()->dealCombatDamage(this, entity, 0.0, mPhysicalDamage, mMagicalDamage, mElementDamage, tile,
+        getKoEnemyCreature(), mNotifyPlayerIfHit);
 
     return false;
 }
 
 void MissileOneHit::hitTargetEntity(Tile* tile, GameEntity* entityTarget)
 {
-    entityTarget->takeDamage(this, 0.0, mPhysicalDamage, mMagicalDamage, mElementDamage, tile, getKoEnemyCreature());
-    if(mNotifyPlayerIfHit)
-        entityTarget->notifyFightPlayer(tile);
+    getGameMap()->dealCombatDamage(this, entityTarget, 0.0, mPhysicalDamage, mMagicalDamage, mElementDamage, tile,
+        getKoEnemyCreature(), mNotifyPlayerIfHit);
 }
 
 MissileOneHit* MissileOneHit::getMissileOneHitFromStream(GameMap* gameMap, std::istream& is)
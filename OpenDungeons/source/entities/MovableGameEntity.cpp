@@ -39,7 +39,10 @@ MovableGameEntity::MovableGameEntity(GameMap* gameMap) :
     mDestinationPlayIdleWhenAnimationEnds(false),
     mDestinationAnimationDirection(Ogre::Vector3::ZERO),
     mWalkDirection(Ogre::Vector3::ZERO),
-    mAnimationTime(0.0)
+    mAnimationTime(0.0),
+    mVisualUpdateNeeded(true),
+    mPendingAnimationTime(0.0),
+    mTimeSinceVisualUpdate(0.0f)
 {
 }
 
@@ -48,6 +51,14 @@ bool MovableGameEntity::isMoving()
     return !mWalkQueue.empty();
 }
 
+const Ogre::Vector3& MovableGameEntity::getWalkDestination() const
+{
+    if(mWalkQueue.empty())
+        return getPosition();
+
+    return mWalkQueue.back();
+}
+
 void MovableGameEntity::tileToVector3(const std::list<Tile*>& tiles, std::vector<Ogre::Vector3>& path,
     bool skipFirst, Ogre::Real z)
 {
@@ -213,13 +224,17 @@ void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
          * static_cast<double>(timeSinceLastFrame)
          * getAnimationSpeedFactor());
     mAnimationTime += addedTime;
-    if (!getIsOnServerMap() && getAnimationState() != nullptr)
+    if (!getIsOnServerMap())
     {
-        // If the animation has stopped we set it to idle if we have to
-        if(mDestinationPlayIdleWhenAnimationEnds && getAnimationState()->hasEnded())
-            RenderManager::getSingleton().rrSetObjectAnimationState(this, EntityAnimation::idle_anim, true);
-        else
-            getAnimationState()->addTime(static_cast<Ogre::Real>(addedTime));
+        // Culled or distant entities are not updated every frame. The elapsed time is kept
+        // until the next visual update
+        mPendingAnimationTime += addedTime;
+        mTimeSinceVisualUpdate += timeSinceLastFrame;
+        if(mVisualUpdateNeeded)
+        {
+            updateVisuals(mTimeSinceVisualUpdate);
+            mTimeSinceVisualUpdate = 0.0f;
+        }
     }
 
     if (mWalkQueue.empty())
@@ -268,6 +283,21 @@ void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
     setPosition(newPosition);
 }
 
+void MovableGameEntity::updateVisuals(Ogre::Real)
+{
+    if (getAnimationState() == nullptr)
+        return;
+
+    Ogre::Real animationTime = static_cast<Ogre::Real>(mPendingAnimationTime);
+    mPendingAnimationTime = 0.0;
+
+    // If the animation has stopped we set it to idle if we have to
+    if(mDestinationPlayIdleWhenAnimationEnds && getAnimationState()->hasEnded())
+        RenderManager::getSingleton().rrSetObjectAnimationState(this, EntityAnimation::idle_anim, true);
+    else
+        getAnimationState()->addTime(animationTime);
+}
+
 void MovableGameEntity::setPosition(const Ogre::Vector3& v)
 {
     Tile* oldTile = nullptr;
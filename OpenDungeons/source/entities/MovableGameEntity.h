@@ -50,6 +50,10 @@ public:
     //! \brief Checks if the destination queue is empty
     bool isMoving();
 
+    //! \brief Returns the position where the entity will stop walking (its position if it is not moving).
+    //! Unlike the position, it does not depend on the frame rate so it is the same on server and client sides
+    const Ogre::Vector3& getWalkDestination() const;
+
 
     /*! \brief Replaces an object's current walk queue with a new path. During the
      * walk, the entity will play walkAnim (looped). When it gets to the wanted position,
@@ -98,13 +102,22 @@ public:
     virtual void setPosition(const Ogre::Vector3& v) override;
 
     inline void setAnimationState(Ogre::AnimationState* animationState)
-    { mAnimationState = animationState; }
+    {
+        mAnimationState = animationState;
+        mPendingAnimationTime = 0.0;
+    }
 
     inline Ogre::AnimationState* getAnimationState() const
     { return mAnimationState; }
 
     virtual void restoreEntityState() override;
 
+    //! \brief Client side. When false, update() keeps moving the entity but does not update its
+    //! animation and overlays. The elapsed time is kept and applied at the next update where it
+    //! is true so that the animation is resynced. It is set each frame by GameMap::updateAnimations
+    inline void setVisualUpdateNeeded(bool needed)
+    { mVisualUpdateNeeded = needed; }
+
     static std::string getMovableGameEntityStreamFormat();
 
 protected:
@@ -113,6 +126,10 @@ protected:
     virtual void exportToPacket(ODPacket& os, const Seat* seat) const override;
     virtual void importFromPacket(ODPacket& is) override;
 
+    //! \brief Client side. Updates the animation and what is displayed with the entity
+    //! \param timeSinceLastUpdate the elapsed time since the last call in seconds.
+    virtual void updateVisuals(Ogre::Real timeSinceLastUpdate);
+
     std::deque<Ogre::Vector3> mWalkQueue;
     std::string mPrevAnimationState;
     bool mPrevAnimationStateLoop;
@@ -126,6 +143,11 @@ private:
     Ogre::Vector3 mDestinationAnimationDirection;
     Ogre::Vector3 mWalkDirection;
     double mAnimationTime;
+
+    bool mVisualUpdateNeeded;
+    //! Animation time to apply at the next visual update
+    double mPendingAnimationTime;
+    Ogre::Real mTimeSinceVisualUpdate;
 };
 
 
@@ -25,6 +25,8 @@
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/StateHash.h"
+#include "goals/Goal.h"
 #include "network/ODPacket.h"
 #include "render/RenderManager.h"
 #include "rooms/Room.h"
@@ -67,7 +69,8 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mHasBridge          (false),
     mLocalPlayerHasVision   (false),
     mTileCulling        (CullingType::HIDE),
-    mNbWorkersClaiming(0)
+    mNbWorkersClaiming(0),
+    mClaimedAggregateSeat(nullptr)
 {
     computeTileVisual();
 }
@@ -399,6 +402,8 @@ void Tile::setMarkedForDigging(bool ss, const Player *pp)
         addPlayerMarkingTile(pp);
     else
         removePlayerMarkingTile(pp);
+
+    fireTileStateChanged();
 }
 
 bool Tile::getMarkedForDigging(const Player *p) const
@@ -560,6 +565,7 @@ void Tile::resetFloodFill()
             floodFillValue = NO_FLOODFILL;
         }
     }
+    getGameMap()->notifyFloodFillChanged();
 }
 
 bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
@@ -600,6 +606,7 @@ bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
     }
 
     values[intType] = tile->getFloodFillValue(seat, type);
+    getGameMap()->notifyFloodFillChanged(seat->getTeamIndex(), type, NO_FLOODFILL, values[intType]);
     return true;
 }
 
@@ -633,6 +640,10 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
         return;
     }
 
+    if(values[intType] == newValue)
+        return;
+
+    getGameMap()->notifyFloodFillChanged(seat->getTeamIndex(), type, values[intType], newValue);
     values[intType] = newValue;
 }
 
@@ -662,6 +673,7 @@ void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
             values[intType] = valuesToCopy[intType];
 
     }
+    getGameMap()->notifyFloodFillChanged();
 }
 
 void Tile::logFloodFill() const
@@ -877,6 +889,7 @@ uint32_t Tile::getFloodFillValue(Seat* seat, FloodFillType type) const
 void Tile::setTeamsNumber(uint32_t nbTeams)
 {
     mFloodFillColor = std::vector<std::vector<uint32_t>>(nbTeams, std::vector<uint32_t>(static_cast<uint32_t>(FloodFillType::nbValues), NO_FLOODFILL));
+    getGameMap()->notifyFloodFillChanged();
 }
 
 bool Tile::shouldColorTileMesh() const
@@ -920,6 +933,9 @@ void Tile::setFullness(double f)
                 getGameMap()->refreshFloodFill(seat, this);
         }
     }
+
+    if ((oldFullness > 0.0) != (mFullness > 0.0))
+        fireTileStateChanged();
 }
 
 void Tile::createMeshLocal()
@@ -1000,6 +1016,8 @@ void Tile::setCoveringBuilding(Building *building)
         setSeat(mCoveringBuilding->getSeat());
         mClaimedPercentage = 1.0;
     }
+
+    fireTileStateChanged();
 }
 
 bool Tile::isGroundClaimable(Seat* seat) const
@@ -1153,6 +1171,7 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
         return;
     t->setSeat(seat);
     t->mClaimedPercentage = 1.0;
+    t->updateSeatAggregates();
 }
 
 void Tile::refreshMesh()
@@ -1235,6 +1254,9 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
     if(getFullness() > 0)
         nDanceRate *= ConfigManager::getSingleton().getClaimingWallPenalty();
 
+    bool wasClaimed = isClaimed();
+    Seat* oldSeat = getSeat();
+
     // If the seat is allied, we add to it. If it is an enemy seat, we subtract from it.
     if (getSeat() != nullptr && getSeat()->isAlliedSeat(seat))
     {
@@ -1257,6 +1279,9 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
         }
     }
 
+    if((wasClaimed != isClaimed()) || (oldSeat != getSeat()))
+        fireTileStateChanged();
+
     if ((getSeat() != nullptr) && (mClaimedPercentage >= 1.0) &&
         (getSeat()->isAlliedSeat(seat)))
     {
@@ -1963,6 +1988,9 @@ void Tile::setTileCullingFlags(uint32_t mask, bool value)
     // We save the current state. If the result is different, we refresh culling
     mTileCulling = (value ? mTileCulling | mask : mTileCulling & ~mask);
 
+    // The static tile mesh is rendered by the tile chunk
+    RenderManager::getSingleton().rrSetTileCulled(*this, mTileCulling == CullingType::HIDE);
+
     if(mTileCulling == CullingType::HIDE)
     {
         // We cull the tile
@@ -1997,10 +2025,36 @@ bool Tile::removeTileStateListener(TileStateListener& listener)
 
 void Tile::fireTileStateChanged()
 {
+    updateSeatAggregates();
+
     for(TileStateListener* stateListener : mStateListeners)
         stateListener->tileStateChanged(*this);
 }
 
+void Tile::updateSeatAggregates()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = isClaimed() ? getSeat() : nullptr;
+    if(seat == mClaimedAggregateSeat)
+        return;
+
+    if(mClaimedAggregateSeat != nullptr)
+    {
+        mClaimedAggregateSeat->decrementNumClaimedTiles();
+        mClaimedAggregateSeat->notifyGoalEvent(GoalEvent::claimedTiles);
+    }
+
+    if(seat != nullptr)
+    {
+        seat->incrementNumClaimedTiles();
+        seat->notifyGoalEvent(GoalEvent::claimedTiles);
+    }
+
+    mClaimedAggregateSeat = seat;
+}
+
 std::string Tile::displayAsString(const Tile* tile)
 {
     if(tile == nullptr)
@@ -2009,3 +2063,8 @@ std::string Tile::displayAsString(const Tile* tile)
     return "[" + Helper::toString(tile->getX()) + ","
          + Helper::toString(tile->getY())+ "]";
 }
+
+uint64_t Tile::getStateHashValue(TileVisual tileVisual, int seatId)
+{
+    return StateHash::hashValues({static_cast<int64_t>(tileVisual), seatId});
+}
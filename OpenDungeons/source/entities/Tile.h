@@ -246,6 +246,9 @@ public:
     //! \brief Tells whether the tile is selected for digging by any player/AI.
     bool isMarkedForDiggingByAnySeat();
 
+    inline uint32_t getNbPlayersMarkingTile() const
+    { return static_cast<uint32_t>(mPlayersMarkingTile.size()); }
+
     //! \brief Add/Remove a player to the vector of players who have marked this tile for digging.
     void addPlayerMarkingTile(const Player *p);
     void removePlayerMarkingTile(const Player *p);
@@ -356,6 +359,10 @@ public:
 
     static std::string displayAsString(const Tile* tile);
 
+    //! \brief Value of a tile in the StateHash shared by the server and the client. It depends on
+    //! what is notified to the client (see Seat::exportTileToPacket)
+    static uint64_t getStateHashValue(TileVisual tileVisual, int seatId);
+
     //! \brief fills the given vector with the carryable entities on this tile
     void fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>& entities);
     uint32_t countEntitiesOnTile(GameEntityType entityType) const;
@@ -551,7 +558,13 @@ private:
     uint32_t mNbWorkersClaiming;
     std::vector<TileStateListener*> mStateListeners;
 
+    //! \brief Seat in which this tile is counted as claimed (nullptr if not counted). Used on server side only
+    Seat* mClaimedAggregateSeat;
+
     void fireTileStateChanged();
+
+    //! \brief Updates the claimed tiles count of the seats if the claimed state of the tile changed
+    void updateSeatAggregates();
 };
 
 #endif // TILE_H
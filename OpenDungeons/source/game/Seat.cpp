@@ -71,6 +71,7 @@ Seat::Seat(GameMap* gameMap) :
     mGameMap(gameMap),
     mPlayer(nullptr),
     mGoldMined(0),
+    mPendingGoalEvents(GoalEvent::all),
     mDefaultWorkerClass(nullptr),
     mTeamIndex(0),
     mIsDebuggingVision(false),
@@ -87,6 +88,9 @@ Seat::Seat(GameMap* gameMap) :
 void Seat::addGoal(Goal* g)
 {
     mUncompleteGoals.push_back(g);
+
+    // The new goal has to be checked whatever it depends on
+    mPendingGoalEvents = GoalEvent::all;
 }
 
 unsigned int Seat::numUncompleteGoals()
@@ -140,12 +144,26 @@ Goal* Seat::getFailedGoal(unsigned int index)
     return mFailedGoals[index];
 }
 
+void Seat::addGoldMined(int quantity)
+{
+    mGoldMined += quantity;
+    notifyGoalEvent(GoalEvent::goldMined);
+}
+
 unsigned int Seat::checkAllCompletedGoals()
 {
     // Loop over the goals vector and move any goals that have been met to the completed goals vector.
+    // Only the goals depending on something that happened since last check are checked
+    uint32_t goalEvents = mPendingGoalEvents | GoalEvent::polling;
     std::vector<Goal*>::iterator currentGoal = mCompletedGoals.begin();
     while (currentGoal != mCompletedGoals.end())
     {
+        if(((*currentGoal)->getGoalEvents() & goalEvents) == 0)
+        {
+            ++currentGoal;
+            continue;
+        }
+
         // Start by checking if this previously met goal has now been unmet.
         if ((*currentGoal)->isUnmet(*this, *mGameMap))
         {
@@ -512,11 +530,20 @@ void Seat::setMapSize(int x, int y)
 unsigned int Seat::checkAllGoals()
 {
     // Loop over the goals vector and move any goals that have been met to the completed goals vector.
+    // Only the goals depending on something that happened since last check are checked
     std::vector<Goal*> goalsToAdd;
+    uint32_t goalEvents = mPendingGoalEvents | GoalEvent::polling;
+    mPendingGoalEvents = GoalEvent::none;
     std::vector<Goal*>::iterator currentGoal = mUncompleteGoals.begin();
     while (currentGoal != mUncompleteGoals.end())
     {
         Goal* goal = *currentGoal;
+        if((goal->getGoalEvents() & goalEvents) == 0)
+        {
+            ++currentGoal;
+            continue;
+        }
+
         // Start by checking if the goal has been met by this seat.
         if (goal->isMet(*this, *mGameMap))
         {
@@ -589,7 +616,7 @@ unsigned int Seat::checkAllGoals()
     for(std::vector<Goal*>::iterator it = goalsToAdd.begin(); it != goalsToAdd.end(); ++it)
     {
         Goal* goal = *it;
-        mUncompleteGoals.push_back(goal);
+        addGoal(goal);
     }
 
     return numUncompleteGoals();
@@ -802,30 +829,27 @@ void Seat::sendVisibleTiles()
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
-void Seat::computeSeatBeginTurn()
+void Seat::updateRoomAggregates(RoomType roomType, int nbRooms, int gold, int goldMax)
 {
-    if(mPlayer != nullptr)
+    uint32_t index = static_cast<uint32_t>(roomType);
+    if(index >= mNbRooms.size())
     {
-        std::fill(mNbRooms.begin(), mNbRooms.end(), 0);
-        for(Room* room : mGameMap->getRooms())
-        {
-            if(room->getSeat() != this)
-                continue;
-
-            if(room->getHP(nullptr) <= 0.0)
-                continue;
-
-            uint32_t index = static_cast<uint32_t>(room->getType());
-            if(index >= mNbRooms.size())
-            {
-                OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(mNbRooms.size()));
-                return;
-            }
-            ++mNbRooms[index];
-        }
+        OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(mNbRooms.size()));
+        return;
     }
+
+    mNbRooms[index] += nbRooms;
+    mGold += gold;
+    mGoldMax += goldMax;
 }
 
+void Seat::updateCreatureAggregates(bool isWorker, int nbCreatures)
+{
+    if(isWorker)
+        mNumCreaturesWorkers += nbCreatures;
+    else
+        mNumCreaturesFighters += nbCreatures;
+}
 
 Seat* Seat::createRogueSeat(GameMap* gameMap)
 {
@@ -1729,6 +1753,8 @@ void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
     os << tileSeatId;
     os << meshName;
     os << tileState.mTileVisual;
+
+    mStateHash.setTile(tile->getX(), tile->getY(), Tile::getStateHashValue(tileState.mTileVisual, tileSeatId));
 }
 
 void Seat::notifyBuildingRemovedFromGameMap(Building* building, Tile* tile)
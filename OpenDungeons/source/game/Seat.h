@@ -19,6 +19,7 @@
 #define SEAT_H
 
 #include "game/SeatData.h"
+#include "gamemap/StateHash.h"
 
 #include <OgreVector3.h>
 #include <OgreColourValue.h>
@@ -164,8 +165,12 @@ public:
     inline Ogre::Vector3 getStartingPosition() const
     { return Ogre::Vector3(static_cast<Ogre::Real>(mStartingX), static_cast<Ogre::Real>(mStartingY), 0); }
 
-    inline void addGoldMined(int quantity)
-    { mGoldMined += quantity; }
+    void addGoldMined(int quantity);
+
+    //! \brief Notifies the seat that the given GoalEvent happened. The goals depending
+    //! on it will be checked at next goals check
+    inline void notifyGoalEvent(uint32_t goalEvents)
+    { mPendingGoalEvents |= goalEvents; }
 
     inline bool getIsDebuggingVision()
     { return mIsDebuggingVision; }
@@ -225,7 +230,13 @@ public:
     inline const std::vector<Seat*>& getAlliedSeats()
     { return mAlliedSeats; }
 
-    void computeSeatBeginTurn();
+    //! \brief Adds the given values to the economy aggregates of this seat. Called by the rooms
+    //! when their contribution changes (see Room::updateSeatAggregates)
+    void updateRoomAggregates(RoomType roomType, int nbRooms, int gold, int goldMax);
+
+    //! \brief Adds the given value to the number of workers or fighters. Called by the creatures
+    //! when their contribution changes (see Creature::updateSeatAggregates)
+    void updateCreatureAggregates(bool isWorker, int nbCreatures);
 
     //! \brief Gets whether a skill is being done
     bool isSkilling() const
@@ -300,6 +311,11 @@ public:
     void exportTileToPacket(ODPacket& os, const Tile* tile,
         bool hideSeatId) const;
 
+    //! \brief Server side. Hash of the tiles notified to the seat player. The creatures are
+    //! set by GameMap::fillStateHashCreatures when a turn is started
+    inline StateHash& getStateHash()
+    { return mStateHash; }
+
     static bool sortForMapSave(Seat* s1, Seat* s2);
 
     static Seat* createRogueSeat(GameMap* gameMap);
@@ -345,6 +361,9 @@ private:
     //! \brief Currently failed goals which cannot possibly be met in the future.
     std::vector<Goal*> mFailedGoals;
 
+    //! \brief GoalEvent flags that happened since the goals were last checked
+    uint32_t mPendingGoalEvents;
+
     //! \brief Contains all the seats allied with the current one, not including it. Used on server side only.
     std::vector<Seat*> mAlliedSeats;
 
@@ -363,6 +382,10 @@ private:
 
     std::map<std::pair<int, int>, TileStateNotified> mTilesStateLoaded;
 
+    //! \brief Hash of what was notified to the seat player. The tiles are set when exported
+    //! by exportTileToPacket, which is why it is mutable
+    mutable StateHash mStateHash;
+
     std::vector<Tile*> mVisualDebugEntityTiles;
 
     //! \brief Index of the team in the gamemap (from 0 to N). Must be set when the seat is added to the gamemap
@@ -56,6 +56,9 @@ public:
     inline void incrementNumClaimedTiles()
     { ++mNumClaimedTiles; }
 
+    inline void decrementNumClaimedTiles()
+    { --mNumClaimedTiles; }
+
     void setTeamId(int teamId);
 
     inline const std::vector<int>& getAvailableTeamIds() const
@@ -148,7 +151,7 @@ protected:
     //! \brief Team ids this seat can use defined in the level file.
     std::vector<int> mAvailableTeamIds;
 
-    //! \brief How many tiles have been claimed by this seat, updated in GameMap::doTurn().
+    //! \brief How many tiles have been claimed by this seat. Updated on server side when a tile claimed state changes.
     unsigned int mNumClaimedTiles;
 
     bool mHasGoalsChanged;
@@ -159,8 +162,8 @@ protected:
     //! \brief The total amount of gold coins that the keeper treasuries can have.
     int mGoldMax;
 
-    //! \brief The number of rooms the player owns (room index being room type).
-    //! Useful to display the first free tile on client side for example
+    //! \brief The number of rooms the player owns (room index being room type). Updated on server side when a
+    //! room is added, removed, destroyed or claimed. Useful to display the first free tile on client side for example
     std::vector<uint32_t> mNbRooms;
 
     //! \brief Skills not allowed. Used on server side only
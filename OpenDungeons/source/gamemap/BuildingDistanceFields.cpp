@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/BuildingDistanceFields.h"
+
+#include "entities/Building.h"
+#include "entities/Tile.h"
+#include "game/Seat.h"
+#include "gamemap/GameMap.h"
+
+#include <algorithm>
+
+BuildingDistanceFields::BuildingDistanceFields(GameMap& gameMap) :
+    mGameMap(gameMap),
+    mNbFieldsBuilt(0)
+{
+}
+
+Building* BuildingDistanceFields::findClosestBuilding(Seat* seat, FloodFillType type, Tile* tileStart,
+    const std::vector<Building*>& buildings, std::list<Tile*>* path)
+{
+    if(path != nullptr)
+        path->clear();
+
+    if((seat == nullptr) || (tileStart == nullptr))
+        return nullptr;
+
+    Building* closestBuilding = nullptr;
+    const DistanceField* closestField = nullptr;
+    float closestDist = DistanceField::UNREACHABLE;
+    for(Building* building : buildings)
+    {
+        const DistanceField& field = getField(building, seat, type);
+        float dist = field.getDistance(tileStart->getX(), tileStart->getY());
+        if(dist >= closestDist)
+            continue;
+
+        closestBuilding = building;
+        closestField = &field;
+        closestDist = dist;
+    }
+
+    if((closestField == nullptr) || (path == nullptr))
+        return closestBuilding;
+
+    std::vector<int> tiles;
+    closestField->getPathToSource(tileStart->getX(), tileStart->getY(), tiles);
+    int sizeX = closestField->getSizeX();
+    for(int index : tiles)
+        path->push_back(mGameMap.getTile(index % sizeX, index / sizeX));
+
+    return closestBuilding;
+}
+
+const DistanceField& BuildingDistanceFields::getField(Building* building, Seat* seat, FloodFillType type)
+{
+    FieldKey key(building, seat->getTeamIndex(), static_cast<uint32_t>(type));
+    Field& field = mFields[key];
+    std::vector<Tile*> sources = building->getCoveredTiles();
+    if(isFieldValid(field, sources, seat, type))
+        return field.mDistanceField;
+
+    std::vector<int> sourceIndexes;
+    sourceIndexes.reserve(sources.size());
+    field.mRegions.clear();
+    for(Tile* tile : sources)
+    {
+        sourceIndexes.push_back(tile->getX() + tile->getY() * mGameMap.getMapSizeX());
+        uint32_t region = tile->getFloodFillValue(seat, type);
+        if(std::find(field.mRegions.begin(), field.mRegions.end(), region) == field.mRegions.end())
+            field.mRegions.push_back(region);
+    }
+
+    // Tiles with the same floodfill value are connected
+    field.mDistanceField.build(mGameMap.getMapSizeX(), mGameMap.getMapSizeY(), sourceIndexes,
+        [this, seat, type](int x, int y)
+        {
+            Tile* tile = mGameMap.getTile(x, y);
+            if(tile == nullptr)
+                return Tile::NO_FLOODFILL;
+
+            return tile->getFloodFillValue(seat, type);
+        });
+    field.mSources = sources;
+    field.mFloodFillVersion = mGameMap.getFloodFillVersions().getVersion();
+    ++mNbFieldsBuilt;
+    return field.mDistanceField;
+}
+
+bool BuildingDistanceFields::isFieldValid(const Field& field, const std::vector<Tile*>& sources,
+    Seat* seat, FloodFillType type) const
+{
+    if((field.mDistanceField.getSizeX() != mGameMap.getMapSizeX()) ||
+       (field.mDistanceField.getSizeY() != mGameMap.getMapSizeY()) ||
+       (field.mSources != sources))
+    {
+        return false;
+    }
+
+    // The distances only depend on the tiles of the sources regions. Other regions do not matter
+    // as long as no tile enters or leaves the sources ones
+    const FloodFillVersions& versions = mGameMap.getFloodFillVersions();
+    for(uint32_t region : field.mRegions)
+    {
+        if(versions.hasRegionChanged(seat->getTeamIndex(), type, region, field.mFloodFillVersion))
+            return false;
+    }
+
+    return true;
+}
+
+void BuildingDistanceFields::removeBuilding(const Building* building)
+{
+    auto it = mFields.lower_bound(FieldKey(building, 0, 0));
+    while((it != mFields.end()) && (std::get<0>(it->first) == building))
+        it = mFields.erase(it);
+}
+
+void BuildingDistanceFields::clear()
+{
+    mFields.clear();
+}
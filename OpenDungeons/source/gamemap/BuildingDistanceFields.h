@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUILDINGDISTANCEFIELDS_H
+#define BUILDINGDISTANCEFIELDS_H
+
+#include "gamemap/DistanceField.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class Building;
+class GameMap;
+class Seat;
+class Tile;
+
+enum class FloodFillType;
+
+//! \brief Distance fields to the buildings creatures walk to (hatcheries, dormitories, treasuries, temple...).
+//! There is one field per building, team and floodfill type, seeded from every tile covered by the building.
+//! Moving is allowed between tiles with the same floodfill value for the team so that the fields follow
+//! the same rules as GameMap::pathExists (closed doors, bridges, water, lava).
+//! Fields are only computed when queried. They are computed again when the building covered tiles changed
+//! or when a tile entered or left the floodfill region of one of them (digging, doors, bridges). Changes in
+//! regions the building cannot reach do not affect its fields. It is meant to be used on the server game map.
+class BuildingDistanceFields
+{
+public:
+    BuildingDistanceFields(GameMap& gameMap);
+
+    //! \brief Returns the building from buildings that is the closest to walk to from tileStart
+    //! for the given seat team and floodfill type. nullptr if none can be reached. If several
+    //! buildings are at the same distance, the first one is returned.
+    //! If path is not null, it is filled with the tiles from tileStart to the closest tile of
+    //! the returned building (both included)
+    Building* findClosestBuilding(Seat* seat, FloodFillType type, Tile* tileStart,
+        const std::vector<Building*>& buildings, std::list<Tile*>* path);
+
+    //! \brief Removes the fields of the given building. Should be called when the building
+    //! is removed from the game map
+    void removeBuilding(const Building* building);
+
+    void clear();
+
+    //! \brief Number of fields computed since the game map was created
+    inline uint64_t getNbFieldsBuilt() const
+    { return mNbFieldsBuilt; }
+
+private:
+    struct Field
+    {
+        DistanceField mDistanceField;
+        //! Tiles covered by the building when the field was built
+        std::vector<Tile*> mSources;
+        //! Floodfill values of the sources when the field was built. Only the tiles in these
+        //! regions can be reached
+        std::vector<uint32_t> mRegions;
+        uint64_t mFloodFillVersion;
+    };
+
+    //! Key is the building, the team index and the floodfill type
+    typedef std::tuple<const Building*, uint32_t, uint32_t> FieldKey;
+
+    GameMap& mGameMap;
+    std::map<FieldKey, Field> mFields;
+    uint64_t mNbFieldsBuilt;
+
+    //! \brief Returns the field for the given parameters. It is built if needed
+    const DistanceField& getField(Building* building, Seat* seat, FloodFillType type);
+
+    //! \brief Returns true if the given field was built for the current map, sources and regions
+    bool isFieldValid(const Field& field, const std::vector<Tile*>& sources, Seat* seat, FloodFillType type) const;
+};
+
+#endif // BUILDINGDISTANCEFIELDS_H
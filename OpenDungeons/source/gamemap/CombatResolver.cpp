@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/CombatResolver.h"
+
+#include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
+#include "entities/GameEntityType.h"
+#include "utils/Profiler.h"
+
+namespace
+{
+//! Workers attacked by workers fight back. Attacked by anything else, they flee (see Creature::applyDamage).
+//! When a creature is hit several times, we keep the attacker that makes it flee, if any
+bool isWorkerAttacker(GameEntity* attacker)
+{
+    if((attacker == nullptr) || (attacker->getObjectType() != GameEntityType::creature))
+        return false;
+
+    return static_cast<Creature*>(attacker)->getDefinition()->isWorker();
+}
+}
+
+CombatResolver::CombatResolver() :
+    mIsCollecting(false),
+    mNbHitsResolved(0)
+{
+}
+
+void CombatResolver::startCollecting()
+{
+    clear();
+    mIsCollecting = true;
+}
+
+void CombatResolver::dealDamage(GameEntity* attacker, Creature* target, double absoluteDamage, double physicalDamage,
+    double magicalDamage, double elementDamage, Tile* tileTakingDamage, bool ko, bool notifyPlayerIfHit)
+{
+    // A sleeping creature getting attacked should react at its next upkeep
+    target->stopSkippingUpkeep();
+
+    uint32_t targetIndex;
+    auto it = mTargetIndexes.find(target);
+    if(it != mTargetIndexes.end())
+    {
+        targetIndex = it->second;
+        Target& data = mTargets[targetIndex];
+        if(isWorkerAttacker(data.mAttacker) && !isWorkerAttacker(attacker))
+            data.mAttacker = attacker;
+        data.mNotifyPlayer = data.mNotifyPlayer || notifyPlayerIfHit;
+    }
+    else
+    {
+        // The target values are set when resolving
+        targetIndex = mDamageBatch.addTarget(0.0, 0.0, 0.0, 0.0);
+        mTargetIndexes.emplace(target, targetIndex);
+        mTargets.push_back({target, attacker, tileTakingDamage, notifyPlayerIfHit});
+    }
+
+    mDamageBatch.addHit(targetIndex, absoluteDamage, physicalDamage, magicalDamage, elementDamage, ko);
+}
+
+void CombatResolver::resolve()
+{
+    OD_PROFILE_ZONE("Combat");
+    mIsCollecting = false;
+    // The HP and defenses of the creatures might have changed since they were hit (damage outside
+    // fights, effects...). We use their current values
+    for(uint32_t i = 0; i < mTargets.size(); ++i)
+    {
+        Creature* creature = mTargets[i].mCreature;
+        mDamageBatch.updateTarget(i, creature->getHP(), creature->getPhysicalDefense(),
+            creature->getMagicalDefense(), creature->getElementDefense());
+    }
+
+    mDamageBatch.resolve();
+    mNbHitsResolved = mDamageBatch.getNbHits();
+    for(uint32_t i = 0; i < mTargets.size(); ++i)
+    {
+        Target& target = mTargets[i];
+        // The creature might have died or been removed from the gamemap after being hit (it is
+        // only deleted once the turn is over)
+        if(!target.mCreature->getIsOnMap() || !target.mCreature->isAlive())
+            continue;
+
+        target.mCreature->applyDamage(target.mAttacker, mDamageBatch.getHpLeft(i), mDamageBatch.isKo(i));
+        if(target.mNotifyPlayer)
+            target.mCreature->notifyFightPlayer(target.mTile);
+    }
+    clear();
+}
+
+void CombatResolver::clear()
+{
+    mDamageBatch.clear();
+    mTargets.clear();
+    mTargetIndexes.clear();
+}
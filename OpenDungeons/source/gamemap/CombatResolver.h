@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMBATRESOLVER_H
+#define COMBATRESOLVER_H
+
+#include "gamemap/DamageBatch.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Creature;
+class GameEntity;
+class Tile;
+
+//! \brief Resolves the fights of a turn at once. While the entities upkeep is done, the damage dealt
+//! to creatures in fights (melee attacks and missiles) is collected instead of being applied. Once every
+//! entity has done its upkeep, the damage is resolved in a DamageBatch and applied to each creature
+//! once: overlay values, death, KO and fight notifications are processed once per creature and per turn
+//! instead of once per hit.
+//! The hits are resolved in the order they were dealt, which is the order of the entities upkeep, so
+//! the result is deterministic.
+//! Damage dealt to buildings or outside fights (traps, rooms, effects) is still applied immediately.
+class CombatResolver
+{
+public:
+    CombatResolver();
+
+    //! \brief Damage dealt by dealDamage will be collected until resolve is called
+    void startCollecting();
+
+    inline bool isCollecting() const
+    { return mIsCollecting; }
+
+    //! \brief Collects the damage dealt to the given creature. The parameters are the same as
+    //! GameEntity::takeDamage. If notifyPlayerIfHit is true, the player owning the creature
+    //! will be notified of the fight when the damage is applied
+    void dealDamage(GameEntity* attacker, Creature* target, double absoluteDamage, double physicalDamage,
+        double magicalDamage, double elementDamage, Tile* tileTakingDamage, bool ko, bool notifyPlayerIfHit);
+
+    //! \brief Applies the damage collected since startCollecting and stops collecting
+    void resolve();
+
+    //! \brief Removes the collected damage without applying it
+    void clear();
+
+    //! \brief Number of hits resolved during the last call to resolve
+    inline uint32_t getNbHitsResolved() const
+    { return mNbHitsResolved; }
+
+private:
+    struct Target
+    {
+        Creature* mCreature;
+        //! Attacker given to the creature when the damage is applied
+        GameEntity* mAttacker;
+        Tile* mTile;
+        bool mNotifyPlayer;
+    };
+
+    bool mIsCollecting;
+    uint32_t mNbHitsResolved;
+    DamageBatch mDamageBatch;
+    std::vector<Target> mTargets;
+    std::unordered_map<const Creature*, uint32_t> mTargetIndexes;
+};
+
+#endif // COMBATRESOLVER_H
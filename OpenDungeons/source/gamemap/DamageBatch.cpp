@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/DamageBatch.h"
+
+#include <algorithm>
+
+DamageBatch::DamageBatch()
+{
+}
+
+void DamageBatch::clear()
+{
+    mTargetHp.clear();
+    mTargetPhysicalDefense.clear();
+    mTargetMagicalDefense.clear();
+    mTargetElementDefense.clear();
+    mTargetHpLeft.clear();
+    mTargetKo.clear();
+
+    mHitTargets.clear();
+    mHitAbsoluteDamages.clear();
+    mHitPhysicalDamages.clear();
+    mHitMagicalDamages.clear();
+    mHitElementDamages.clear();
+    mHitKo.clear();
+    mHitDamages.clear();
+}
+
+uint32_t DamageBatch::addTarget(double hp, double physicalDefense, double magicalDefense, double elementDefense)
+{
+    uint32_t target = getNbTargets();
+    mTargetHp.push_back(hp);
+    mTargetPhysicalDefense.push_back(physicalDefense);
+    mTargetMagicalDefense.push_back(magicalDefense);
+    mTargetElementDefense.push_back(elementDefense);
+    mTargetHpLeft.push_back(hp);
+    mTargetKo.push_back(0);
+    return target;
+}
+
+void DamageBatch::updateTarget(uint32_t target, double hp, double physicalDefense, double magicalDefense, double elementDefense)
+{
+    mTargetHp[target] = hp;
+    mTargetPhysicalDefense[target] = physicalDefense;
+    mTargetMagicalDefense[target] = magicalDefense;
+    mTargetElementDefense[target] = elementDefense;
+}
+
+void DamageBatch::addHit(uint32_t target, double absoluteDamage, double physicalDamage, double magicalDamage,
+    double elementDamage, bool ko)
+{
+    mHitTargets.push_back(target);
+    mHitAbsoluteDamages.push_back(absoluteDamage);
+    mHitPhysicalDamages.push_back(physicalDamage);
+    mHitMagicalDamages.push_back(magicalDamage);
+    mHitElementDamages.push_back(elementDamage);
+    mHitKo.push_back(ko ? 1 : 0);
+}
+
+void DamageBatch::resolve()
+{
+    uint32_t nbHits = getNbHits();
+    mHitDamages.resize(nbHits);
+    mTargetHpLeft = mTargetHp;
+    std::fill(mTargetKo.begin(), mTargetKo.end(), 0);
+
+    // Damage after defenses. Hits do not depend on each other here. Note that the sum is done
+    // in the same order as Creature::takeDamage to get the same values
+    const uint32_t* targets = mHitTargets.data();
+    const double* physicalDefenses = mTargetPhysicalDefense.data();
+    const double* magicalDefenses = mTargetMagicalDefense.data();
+    const double* elementDefenses = mTargetElementDefense.data();
+    for(uint32_t hit = 0; hit < nbHits; ++hit)
+    {
+        uint32_t target = targets[hit];
+        double physical = std::max(mHitPhysicalDamages[hit] - physicalDefenses[target], 0.0);
+        double magical = std::max(mHitMagicalDamages[hit] - magicalDefenses[target], 0.0);
+        double element = std::max(mHitElementDamages[hit] - elementDefenses[target], 0.0);
+        mHitDamages[hit] = mHitAbsoluteDamages[hit] + physical + magical + element;
+    }
+
+    // Damage taken, in the order the hits were added
+    for(uint32_t hit = 0; hit < nbHits; ++hit)
+    {
+        uint32_t target = targets[hit];
+        double& hpLeft = mTargetHpLeft[target];
+        if((mTargetKo[target] != 0) || (hpLeft <= 0.0))
+        {
+            mHitDamages[hit] = 0.0;
+            continue;
+        }
+
+        double damage = std::min(hpLeft, mHitDamages[hit]);
+        mHitDamages[hit] = damage;
+        hpLeft -= damage;
+        if((mHitKo[hit] != 0) && (hpLeft <= 0.0))
+            mTargetKo[target] = 1;
+    }
+}
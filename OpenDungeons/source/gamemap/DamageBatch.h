@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DAMAGEBATCH_H
+#define DAMAGEBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+//! \brief Collects the hits of a turn and resolves them all at once. Targets and hits are stored
+//! as arrays of values (one array per field) so that the damage after defenses can be computed in
+//! a single loop without dependencies between hits.
+//! The damage is then applied in the order the hits were added so that the result only depends on
+//! that order: a target cannot lose more HP than it has and, if the hit that brings its HP to 0
+//! is a KO hit, the target is KO and the following hits are ignored.
+//! Memory is kept when cleared so that a batch can be reused every turn without allocating.
+class DamageBatch
+{
+public:
+    DamageBatch();
+
+    void clear();
+
+    //! \brief Adds a target and returns its index
+    uint32_t addTarget(double hp, double physicalDefense, double magicalDefense, double elementDefense);
+
+    //! \brief Changes the values of a target already added
+    void updateTarget(uint32_t target, double hp, double physicalDefense, double magicalDefense, double elementDefense);
+
+    //! \brief Adds a hit on the given target. Like GameEntity::takeDamage, absoluteDamage ignores
+    //! the defenses while the other damages are lowered by the corresponding defense
+    void addHit(uint32_t target, double absoluteDamage, double physicalDamage, double magicalDamage,
+        double elementDamage, bool ko);
+
+    //! \brief Computes the damage done by each hit and taken by each target
+    void resolve();
+
+    inline uint32_t getNbTargets() const
+    { return static_cast<uint32_t>(mTargetHp.size()); }
+
+    inline uint32_t getNbHits() const
+    { return static_cast<uint32_t>(mHitTargets.size()); }
+
+    //! \brief HP of the target after the last resolve. The damage of each hit is subtracted
+    //! one after the other, like successive calls to takeDamage would do
+    inline double getHpLeft(uint32_t target) const
+    { return mTargetHpLeft[target]; }
+
+    //! \brief Returns true if a KO hit brought the target HP to 0 during the last resolve
+    inline bool isKo(uint32_t target) const
+    { return mTargetKo[target] != 0; }
+
+    inline uint32_t getHitTarget(uint32_t hit) const
+    { return mHitTargets[hit]; }
+
+    //! \brief Damage actually done by the hit during the last resolve
+    inline double getHitDamage(uint32_t hit) const
+    { return mHitDamages[hit]; }
+
+private:
+    std::vector<double> mTargetHp;
+    std::vector<double> mTargetPhysicalDefense;
+    std::vector<double> mTargetMagicalDefense;
+    std::vector<double> mTargetElementDefense;
+    std::vector<double> mTargetHpLeft;
+    std::vector<uint8_t> mTargetKo;
+
+    std::vector<uint32_t> mHitTargets;
+    std::vector<double> mHitAbsoluteDamages;
+    std::vector<double> mHitPhysicalDamages;
+    std::vector<double> mHitMagicalDamages;
+    std::vector<double> mHitElementDamages;
+    std::vector<uint8_t> mHitKo;
+    std::vector<double> mHitDamages;
+};
+
+#endif // DAMAGEBATCH_H
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/DistanceField.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+const float DistanceField::UNREACHABLE = std::numeric_limits<float>::max();
+
+namespace
+{
+    const float DIAGONAL_COST = std::sqrt(2.0f);
+
+    //! Offsets of the 4 adjacent tiles followed by the 4 diagonal ones. Diagonal i (4 to 7) needs
+    //! the adjacent tiles DIAGONAL_ADJACENTS[i - 4] to be walkable
+    const int OFFSETS[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    const int DIAGONAL_ADJACENTS[4][2] = {{0, 2}, {0, 3}, {1, 2}, {1, 3}};
+}
+
+DistanceField::DistanceField() :
+    mSizeX(0),
+    mSizeY(0),
+    mNbTilesReached(0)
+{
+}
+
+void DistanceField::clear()
+{
+    mSizeX = 0;
+    mSizeY = 0;
+    mNbTilesReached = 0;
+    mDistances.clear();
+    mNextTiles.clear();
+}
+
+void DistanceField::build(int sizeX, int sizeY, const std::vector<int>& sources,
+    const std::function<uint32_t(int, int)>& getRegion)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    mNbTilesReached = 0;
+    uint32_t nbTiles = static_cast<uint32_t>(sizeX * sizeY);
+    mDistances.assign(nbTiles, UNREACHABLE);
+    mNextTiles.assign(nbTiles, -1);
+    mRegions.resize(nbTiles);
+    for(int yy = 0; yy < sizeY; ++yy)
+    {
+        for(int xx = 0; xx < sizeX; ++xx)
+            mRegions[xx + yy * sizeX] = getRegion(xx, yy);
+    }
+
+    // Ties are broken by tile index so that the result does not depend on the queue implementation
+    typedef std::pair<float, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> openList;
+    for(int source : sources)
+    {
+        if((source < 0) || (source >= static_cast<int>(nbTiles)))
+            continue;
+
+        if(mRegions[source] == 0)
+            continue;
+
+        mDistances[source] = 0.0f;
+        openList.push(Entry(0.0f, source));
+    }
+
+    while(!openList.empty())
+    {
+        Entry entry = openList.top();
+        openList.pop();
+        int index = entry.second;
+        // The tile was already processed with a shorter distance
+        if(entry.first > mDistances[index])
+            continue;
+
+        ++mNbTilesReached;
+        int xx = index % sizeX;
+        int yy = index / sizeX;
+        uint32_t region = mRegions[index];
+        bool areTilesWalkable[4] = {false, false, false, false};
+        for(int i = 0; i < 8; ++i)
+        {
+            if((i >= 4) &&
+               (!areTilesWalkable[DIAGONAL_ADJACENTS[i - 4][0]] || !areTilesWalkable[DIAGONAL_ADJACENTS[i - 4][1]]))
+            {
+                continue;
+            }
+
+            int neighX = xx + OFFSETS[i][0];
+            int neighY = yy + OFFSETS[i][1];
+            if((neighX < 0) || (neighX >= sizeX) || (neighY < 0) || (neighY >= sizeY))
+                continue;
+
+            int neighIndex = neighX + neighY * sizeX;
+            if(mRegions[neighIndex] != region)
+                continue;
+
+            if(i < 4)
+                areTilesWalkable[i] = true;
+
+            float dist = entry.first + ((i < 4) ? 1.0f : DIAGONAL_COST);
+            if(dist >= mDistances[neighIndex])
+                continue;
+
+            mDistances[neighIndex] = dist;
+            mNextTiles[neighIndex] = index;
+            openList.push(Entry(dist, neighIndex));
+        }
+    }
+}
+
+float DistanceField::getDistance(int x, int y) const
+{
+    if((x < 0) || (x >= mSizeX) || (y < 0) || (y >= mSizeY))
+        return UNREACHABLE;
+
+    return mDistances[x + y * mSizeX];
+}
+
+void DistanceField::getPathToSource(int x, int y, std::vector<int>& path) const
+{
+    path.clear();
+    if(!isReachable(x, y))
+        return;
+
+    int index = x + y * mSizeX;
+    while(index != -1)
+    {
+        path.push_back(index);
+        index = mNextTiles[index];
+    }
+}
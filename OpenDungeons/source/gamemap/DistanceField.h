@@ -0,0 +1,83 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//! \brief Walking distance from every tile of a grid to the closest of a set of source tiles.
+//! It is computed with a multi source Dijkstra. Each tile belongs to a region (0 means the
+//! tile cannot be walked) and moving is only possible between tiles of the same region.
+//! Like GameMap::path, diagonal moves are only allowed if the 2 adjacent tiles can be walked.
+//! Once built, the closest source and the path to it are found by following the gradient
+//! from any tile, without any search.
+//! Tiles are identified by their index x + y * sizeX.
+class DistanceField
+{
+public:
+    static const float UNREACHABLE;
+
+    DistanceField();
+
+    //! \brief Computes the distances from the given sources. getRegion(x, y) is called once
+    //! per tile. Sources that cannot be walked are ignored
+    void build(int sizeX, int sizeY, const std::vector<int>& sources,
+        const std::function<uint32_t(int, int)>& getRegion);
+
+    void clear();
+
+    inline int getSizeX() const
+    { return mSizeX; }
+
+    inline int getSizeY() const
+    { return mSizeY; }
+
+    //! \brief Returns the walking distance (in tiles) from (x, y) to the closest source or
+    //! UNREACHABLE if no source can be reached
+    float getDistance(int x, int y) const;
+
+    inline bool isReachable(int x, int y) const
+    { return getDistance(x, y) != UNREACHABLE; }
+
+    //! \brief Returns the tile to go to from the given tile to get closer to the closest
+    //! source. -1 if the tile is a source or cannot reach any
+    inline int32_t getNextTile(int index) const
+    { return mNextTiles[index]; }
+
+    //! \brief Fills path with the tiles from (x, y) to the closest source (both included).
+    //! path is empty if no source can be reached
+    void getPathToSource(int x, int y, std::vector<int>& path) const;
+
+    //! \brief Number of tiles whose distance was computed by the last build
+    inline uint32_t getNbTilesReached() const
+    { return mNbTilesReached; }
+
+private:
+    int mSizeX;
+    int mSizeY;
+    uint32_t mNbTilesReached;
+    std::vector<float> mDistances;
+    std::vector<int32_t> mNextTiles;
+
+    //! \brief Regions of the tiles during the build. Kept to avoid reallocating it
+    std::vector<uint32_t> mRegions;
+};
+
+#endif // DISTANCEFIELD_H
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/FloodFillVersions.h"
+
+FloodFillVersions::FloodFillVersions() :
+    mVersion(0),
+    mAllChangedVersion(0)
+{
+}
+
+void FloodFillVersions::notifyRegionChanged(uint32_t teamIndex, FloodFillType type, uint32_t oldColor, uint32_t newColor)
+{
+    ++mVersion;
+    uint32_t intType = static_cast<uint32_t>(type);
+    mRegionVersions[RegionKey(teamIndex, intType, oldColor)] = mVersion;
+    mRegionVersions[RegionKey(teamIndex, intType, newColor)] = mVersion;
+}
+
+void FloodFillVersions::notifyAllChanged()
+{
+    ++mVersion;
+    mAllChangedVersion = mVersion;
+    mRegionVersions.clear();
+}
+
+bool FloodFillVersions::hasRegionChanged(uint32_t teamIndex, FloodFillType type, uint32_t color, uint64_t version) const
+{
+    if(mAllChangedVersion > version)
+        return true;
+
+    auto it = mRegionVersions.find(RegionKey(teamIndex, static_cast<uint32_t>(type), color));
+    if(it == mRegionVersions.end())
+        return false;
+
+    return it->second > version;
+}
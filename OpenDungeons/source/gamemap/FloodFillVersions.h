@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLOODFILLVERSIONS_H
+#define FLOODFILLVERSIONS_H
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+enum class FloodFillType;
+
+//! \brief Keeps track of when each floodfill region last changed so that data computed from the
+//! tiles of some regions (like the building distance fields) can know if it is still valid.
+//! A region is identified by the team index, the floodfill type and the floodfill color.
+//! The version is incremented each time a floodfill value changes
+class FloodFillVersions
+{
+public:
+    FloodFillVersions();
+
+    inline uint64_t getVersion() const
+    { return mVersion; }
+
+    //! \brief To be called when a tile floodfill value changed from oldColor to newColor for the
+    //! given team and type. Both regions are changed. A tile without floodfill is in no region but
+    //! its color is kept track of like the others so that data computed from tiles without
+    //! floodfill can know when one gets a region
+    void notifyRegionChanged(uint32_t teamIndex, FloodFillType type, uint32_t oldColor, uint32_t newColor);
+
+    //! \brief To be called when every floodfill value may have changed
+    void notifyAllChanged();
+
+    //! \brief Returns true if the given region changed since the given version
+    bool hasRegionChanged(uint32_t teamIndex, FloodFillType type, uint32_t color, uint64_t version) const;
+
+private:
+    //! Key is the team index, the floodfill type and the color
+    typedef std::tuple<uint32_t, uint32_t, uint32_t> RegionKey;
+
+    uint64_t mVersion;
+
+    //! \brief Version when every value last changed
+    uint64_t mAllChangedVersion;
+
+    //! \brief Version when each region last changed. Cleared when every value changes
+    std::map<RegionKey, uint64_t> mRegionVersions;
+};
+
+#endif // FLOODFILLVERSIONS_H
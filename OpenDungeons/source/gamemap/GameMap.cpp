@@ -40,6 +40,7 @@
 #include "game/Seat.h"
 #include "gamemap/MapHandler.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/StateHash.h"
 #include "gamemap/TileSet.h"
 #include "goals/Goal.h"
 #include "modes/ModeManager.h"
@@ -59,6 +60,8 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/Profiler.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
 
 #include <OgreTimer.h>
@@ -73,6 +76,11 @@
 
 const std::string DEFAULT_NICK = "You";
 
+//! \brief Distances from the camera above which the entities animations are updated
+//! every 2 frames and every 4 frames
+const Ogre::Real ANIMATION_REDUCED_RATE_DIST = 25.0;
+const Ogre::Real ANIMATION_REDUCED_RATE_FAR_DIST = 40.0;
+
 using namespace std;
 
 /*! \brief A helper class for the A* search in the GameMap::path function.
@@ -161,7 +169,12 @@ GameMap::GameMap(bool isServerGameMap) :
         mFloodFillEnabled(false),
         mIsFOWActivated(true),
         mNumCallsTo_path(0),
+        mAnimationFrameNumber(0),
+        mNbAnimatedObjectsUpdated(0),
+        mNbAnimatedObjectsReduced(0),
+        mNbAnimatedObjectsCulled(0),
         mAiManager(*this),
+        mBuildingDistanceFields(*this),
         mTileSet(nullptr)
 {
     resetUniqueNumbers();
@@ -257,6 +270,10 @@ void GameMap::setAllFullnessAndNeighbors()
 
 void GameMap::clearAll()
 {
+    // NOTE : the AI and the tile index may listen to tile changes. They should be cleared before the tiles
+    clearAiManager();
+    clearTileIndex();
+
     clearCreatures();
     clearClasses();
     clearWeapons();
@@ -264,6 +281,8 @@ void GameMap::clearAll()
 
     clearMapLights();
     clearRooms();
+    mBuildingDistanceFields.clear();
+    mCombatResolver.clear();
     // NOTE : clearRenderedMovableEntities should be called after clearRooms because clearRooms will try to remove the objects from the room
     clearRenderedMovableEntities();
     clearSpells();
@@ -278,8 +297,6 @@ void GameMap::clearAll()
     mLocalPlayer = nullptr;
     clearPlayers();
 
-    clearAiManager();
-
     mLocalPlayerNick = DEFAULT_NICK;
     mTurnNumber = -1;
     resetUniqueNumbers();
@@ -343,6 +360,25 @@ void GameMap::clearAiManager()
    mAiManager.clearAIList();
 }
 
+void GameMap::clearTileIndex()
+{
+    if(!mTileIndex.isInitialized())
+        return;
+
+    for(int yy = 0; yy < getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < getMapSizeX(); ++xx)
+        {
+            Tile* tile = getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->removeTileStateListener(mTileIndex);
+        }
+    }
+    mTileIndex.clear();
+}
+
 void GameMap::clearClasses()
 {
     for (std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
@@ -490,6 +526,7 @@ void GameMap::addCreature(Creature *cc)
         + ", seatId=" + (cc->getSeat() != nullptr ? Helper::toString(cc->getSeat()->getId()) : std::string("null")));
 
     mCreatures.push_back(cc);
+    notifyGoalEvent(GoalEvent::creatures);
 }
 
 void GameMap::removeCreature(Creature *c)
@@ -504,6 +541,7 @@ void GameMap::removeCreature(Creature *c)
     }
 
     mCreatures.erase(it);
+    notifyGoalEvent(GoalEvent::creatures);
 }
 
 void GameMap::queueEntityForDeletion(GameEntity *ge)
@@ -1079,6 +1117,7 @@ void GameMap::doTurn(double timeSinceLastTurn)
 
     uint32_t miscUpkeepTime = doMiscUpkeep(timeSinceLastTurn);
 
+    ProfilerZone playerUpkeepZone("Player upkeep");
     for (Seat* seat : mSeats)
     {
         if(seat->getPlayer() == nullptr)
@@ -1086,6 +1125,7 @@ void GameMap::doTurn(double timeSinceLastTurn)
 
         seat->getPlayer()->upkeepPlayer(timeSinceLastTurn);
     }
+    playerUpkeepZone.end();
 
     OD_LOG_INF("During this turn there were " + Helper::toString(mNumCallsTo_path - numCallsTo_path_atStart)
         + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
@@ -1093,12 +1133,74 @@ void GameMap::doTurn(double timeSinceLastTurn)
 
 void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 {
+    OD_PROFILE_ZONE("AI");
+    // The AI uses its own random numbers so that changing what it does during a turn
+    // does not change the simulation ones
+    Random::StreamScope randomScope(Random::Stream::ai);
     mAiManager.doTurn(timeSinceLastTurn);
 }
 
+void GameMap::checkSeatAggregates()
+{
+    for (Seat* seat : mSeats)
+    {
+        int gold = 0;
+        int goldMax = 0;
+        std::vector<uint32_t> nbRooms(static_cast<uint32_t>(RoomType::nbRooms), 0);
+        for (Room* room : mRooms)
+        {
+            if(room->getSeat() != seat)
+                continue;
+
+            gold += room->getTotalGoldStored();
+            goldMax += room->getTotalGoldStorage();
+            if(room->getHP(nullptr) > 0.0)
+                ++nbRooms[static_cast<uint32_t>(room->getType())];
+        }
+
+        int nbWorkers = 0;
+        int nbFighters = 0;
+        for (Creature* creature : mCreatures)
+        {
+            if(creature->getSeat() != seat)
+                continue;
+            if(creature->hasDied())
+                continue;
+
+            if(creature->getDefinition()->isWorker())
+                ++nbWorkers;
+            else
+                ++nbFighters;
+        }
+
+        unsigned int nbClaimedTiles = 0;
+        for (int jj = 0; jj < getMapSizeY(); ++jj)
+        {
+            for (int ii = 0; ii < getMapSizeX(); ++ii)
+            {
+                Tile* tile = getTile(ii, jj);
+                if(tile->isClaimed() && (tile->getSeat() == seat))
+                    ++nbClaimedTiles;
+            }
+        }
+
+        if((gold != seat->mGold) || (goldMax != seat->mGoldMax) || (nbRooms != seat->mNbRooms) ||
+           (nbWorkers != seat->mNumCreaturesWorkers) || (nbFighters != seat->mNumCreaturesFighters) ||
+           (nbClaimedTiles != seat->mNumClaimedTiles))
+        {
+            OD_LOG_ERR("Wrong aggregates for seatId=" + Helper::toString(seat->getId())
+                + ", gold=" + Helper::toString(seat->mGold) + "/" + Helper::toString(gold)
+                + ", goldMax=" + Helper::toString(seat->mGoldMax) + "/" + Helper::toString(goldMax)
+                + ", workers=" + Helper::toString(seat->mNumCreaturesWorkers) + "/" + Helper::toString(nbWorkers)
+                + ", fighters=" + Helper::toString(seat->mNumCreaturesFighters) + "/" + Helper::toString(nbFighters)
+                + ", claimedTiles=" + Helper::toString(seat->mNumClaimedTiles) + "/" + Helper::toString(nbClaimedTiles));
+        }
+    }
+}
+
 unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
 {
-    Tile *tempTile;
+    OD_PROFILE_ZONE("Misc upkeep");
     Ogre::Timer stopwatch;
     unsigned long int timeTaken;
 
@@ -1160,31 +1262,10 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             addWinningSeat(seat);
 
         seat->mNumCreaturesFightersMax = getMaxNumberCreatures(seat);
-
-        // Set the creatures count to 0. It will be reset by the next count in doTurn()
-        seat->mNumCreaturesFighters = 0;
-        seat->mNumCreaturesWorkers = 0;
-    }
-
-    // Count how many creatures the player controls
-    for(Creature* creature : mCreatures)
-    {
-        // Check to see if the creature has died.
-        if (!creature->isAlive())
-            continue;
-
-        Seat *tempSeat = creature->getSeat();
-        if(tempSeat == nullptr)
-            continue;
-
-        // We only count fighters
-        if (creature->getDefinition()->isWorker())
-            ++(tempSeat->mNumCreaturesWorkers);
-        else
-            ++(tempSeat->mNumCreaturesFighters);
     }
 
     // At each upkeep, we re-compute tiles with vision
+    ProfilerZone visionZone("Vision");
     for (Seat* seat : mSeats)
         seat->clearTilesWithVision();
 
@@ -1227,13 +1308,19 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
     // We send to each seat the list of tiles he has vision on
     for (Seat* seat : mSeats)
         seat->sendVisibleTiles();
+    visionZone.end();
 
     // Carry out the upkeep round of all the active objects in the game.
     // Here, we work on a copy of the active objects list because they might
     // try to remove themselves which would break the iterator
+    // Damage dealt to creatures in fights is applied once every entity has done its upkeep
+    ProfilerZone entityUpkeepZone("Entity upkeep");
     std::vector<GameEntity*> activeObjects = mActiveObjects;
+    mCombatResolver.startCollecting();
     for(GameEntity* ge : activeObjects)
         ge->doUpkeep();
+    entityUpkeepZone.end();
+    mCombatResolver.resolve();
 
     // Carry out the upkeep round for each seat. This means recomputing how much gold is
     // available in their treasuries, how much mana they gain/lose during this turn, etc.
@@ -1242,8 +1329,6 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
         if(seat->getPlayer() == nullptr)
             continue;
 
-        seat->computeSeatBeginTurn();
-
         // Add the amount of mana this seat accrued this turn if the player has a dungeon temple
         if(seat->getNbRooms(RoomType::dungeonTemple) == 0)
         {
@@ -1258,56 +1343,73 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             if (seat->mMana > maxMana)
                 seat->mMana = maxMana;
         }
-
-        // Update the count on how much gold is available in all of the treasuries claimed by the given seat.
-        seat->mGold = 0;
-        seat->mGoldMax = 0;
-        for (Room* room : getRooms())
-        {
-            if(room->getSeat() != seat)
-                continue;
-
-            seat->mGold += room->getTotalGoldStored();
-            seat->mGoldMax += room->getTotalGoldStorage();
-        }
     }
 
-    // Determine the number of tiles claimed by each seat.
-    // Begin by setting the number of claimed tiles for each seat to 0.
-    for (Seat* seat : mSeats)
-        seat->setNumClaimedTiles(0);
-
-    // Now loop over all of the tiles, if the tile is claimed increment the given seats count.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            tempTile = getTile(ii,jj);
-
-            // Check to see if the current tile is claimed by anyone.
-            if (tempTile->isClaimed())
-            {
-                // Increment the count of the seat who owns the tile.
-                tempTile->getSeat()->incrementNumClaimedTiles();
-            }
-        }
-    }
+    // Gold, claimed tiles, creatures and rooms counts are updated when they change. In debug,
+    // we check that they match a full recount
+#ifdef OD_DEBUG
+    checkSeatAggregates();
+#endif
 
     timeTaken = stopwatch.getMicroseconds();
     return timeTaken;
 }
 
-void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
+void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame, const Ogre::Vector3* viewPoint)
 {
+    OD_PROFILE_ZONE("Entity animations");
+    mNbAnimatedObjectsUpdated = 0;
+    mNbAnimatedObjectsReduced = 0;
+    mNbAnimatedObjectsCulled = 0;
+
     if(mIsPaused)
         return;
 
     if(getTurnNumber() <= 0)
         return;
 
-    // Update the animations on all AnimatedObjects
+    // On server side, there is nothing to display
+    if(isServerGameMap() || (viewPoint == nullptr))
+    {
+        for(MovableGameEntity* mge : mAnimatedObjects)
+            mge->update(timeSinceLastFrame);
+
+        mNbAnimatedObjectsUpdated = static_cast<uint32_t>(mAnimatedObjects.size());
+        return;
+    }
+
+    // Every entity is moved but the animations of the culled entities are only resynced when
+    // they get visible again and the ones of distant entities are updated every few frames.
+    // We use the entity index to spread the distant entities updates over the frames
+    ++mAnimationFrameNumber;
+    uint32_t index = 0;
     for(MovableGameEntity* mge : mAnimatedObjects)
+    {
+        bool updateNeeded;
+        if(mge->isCulled())
+        {
+            updateNeeded = false;
+            ++mNbAnimatedObjectsCulled;
+        }
+        else
+        {
+            Ogre::Real squaredDist = viewPoint->squaredDistance(mge->getPosition());
+            uint32_t updateInterval = 1;
+            if(squaredDist > ANIMATION_REDUCED_RATE_FAR_DIST * ANIMATION_REDUCED_RATE_FAR_DIST)
+                updateInterval = 4;
+            else if(squaredDist > ANIMATION_REDUCED_RATE_DIST * ANIMATION_REDUCED_RATE_DIST)
+                updateInterval = 2;
+
+            updateNeeded = ((mAnimationFrameNumber + index) % updateInterval) == 0;
+            if(updateNeeded)
+                ++mNbAnimatedObjectsUpdated;
+            else
+                ++mNbAnimatedObjectsReduced;
+        }
+        mge->setVisualUpdateNeeded(updateNeeded);
         mge->update(timeSinceLastFrame);
+        ++index;
+    }
 }
 
 void GameMap::playerIsFighting(Player* player, Tile* tile)
@@ -1334,6 +1436,22 @@ void GameMap::playerIsFighting(Player* player, Tile* tile)
     }
 }
 
+void GameMap::dealCombatDamage(GameEntity* attacker, GameEntity* target, double absoluteDamage, double physicalDamage,
+    double magicalDamage, double elementDamage, Tile* tileTakingDamage, bool ko, bool notifyPlayerIfHit)
+{
+    if(mCombatResolver.isCollecting() &&
+       (target->getObjectType() == GameEntityType::creature))
+    {
+        mCombatResolver.dealDamage(attacker, static_cast<Creature*>(target), absoluteDamage, physicalDamage,
+            magicalDamage, elementDamage, tileTakingDamage, ko, notifyPlayerIfHit);
+        return;
+    }
+
+    target->takeDamage(attacker, absoluteDamage, physicalDamage, magicalDamage, elementDamage, tileTakingDamage, ko);
+    if(notifyPlayerIfHit)
+        target->notifyFightPlayer(tileTakingDamage);
+}
+
 std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
     Tile*& chosenTile)
 {
@@ -1381,6 +1499,28 @@ std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart
     return returnList;
 }
 
+TileIndex& GameMap::getTileIndex()
+{
+    if(mTileIndex.isInitialized())
+        return mTileIndex;
+
+    mTileIndex.init(getMapSizeX(), getMapSizeY(), mSeats);
+    for(int yy = 0; yy < getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < getMapSizeX(); ++xx)
+        {
+            Tile* tile = getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->addTileStateListener(mTileIndex);
+            mTileIndex.refreshTile(*tile);
+        }
+    }
+
+    return mTileIndex;
+}
+
 bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd)
 {
     // If floodfill is not enabled, we cannot check if the path exists so we return true
@@ -1392,6 +1532,31 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     if(creature == nullptr)
         return false;
 
+    FloodFillType floodFill = getFloodFillTypeForCreature(creature);
+    if(creature->getDefinition()->isWorker())
+    {
+        // Workers can go on a tile if and only if the path is open for any creature. If it is closed, that
+        // means that a door is closed
+        for(Seat* seat : mSeats)
+        {
+            if(tileStart->isSameFloodFill(seat, floodFill, tileEnd))
+                continue;
+
+            return false;
+        }
+
+        return true;
+    }
+    else
+    {
+        // For fighters, we can test their seat only because if they reach a closed enemy door, they
+        // will attack it
+        return tileStart->isSameFloodFill(creature->getSeat(), floodFill, tileEnd);
+    }
+}
+
+FloodFillType GameMap::getFloodFillTypeForCreature(const Creature* creature)
+{
     FloodFillType floodFill = FloodFillType::ground;
     if((creature->getMoveSpeedGround() > 0.0) &&
         (creature->getMoveSpeedWater() > 0.0) &&
@@ -1409,27 +1574,62 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     {
         floodFill = FloodFillType::groundLava;
     }
+    return floodFill;
+}
 
-    if(creature->getDefinition()->isWorker())
+Building* GameMap::findClosestBuilding(const Creature* creature, Tile* tileStart, const std::vector<Building*>& buildings,
+    std::list<Tile*>* path)
+{
+    if(path != nullptr)
+        path->clear();
+
+    if((creature == nullptr) || (tileStart == nullptr) || buildings.empty())
+        return nullptr;
+
+    // The distance fields follow the floodfill. Without it, we search the paths
+    Building* building = nullptr;
+    if(mFloodFillEnabled)
     {
-        // Workers can go on a tile if and only if the path is open for any creature. If it is closed, that
-        // means that a door is closed
-        for(Seat* seat : mSeats)
-        {
-            if(tileStart->isSameFloodFill(seat, floodFill, tileEnd))
-                continue;
+        building = mBuildingDistanceFields.findClosestBuilding(creature->getSeat(),
+            getFloodFillTypeForCreature(creature), tileStart, buildings, path);
+    }
 
-            return false;
-        }
+    // Workers can only go where the path is open for every seat (see pathExists) while the fields
+    // are computed for their seat. In the rare cases where they differ, we search the paths
+    if(building != nullptr)
+    {
+        Tile* tileDest = ((path != nullptr) && !path->empty()) ? path->back() : building->getCoveredTile(0);
+        if(pathExists(creature, tileStart, tileDest))
+            return building;
 
-        return true;
+        if(path != nullptr)
+            path->clear();
     }
-    else
+    else if(mFloodFillEnabled)
+        return nullptr;
+
+    std::vector<Tile*> possibleDests;
+    for(Building* b : buildings)
     {
-        // For fighters, we can test their seat only because if they reach a closed enemy door, they
-        // will attack it
-        return tileStart->isSameFloodFill(creature->getSeat(), floodFill, tileEnd);
+        if(b->numCoveredTiles() <= 0)
+            continue;
+
+        Tile* tile = b->getCoveredTile(0);
+        if(!pathExists(creature, tileStart, tile))
+            continue;
+
+        possibleDests.push_back(tile);
     }
+
+    Tile* chosenTile = nullptr;
+    std::list<Tile*> tilePath = findBestPath(creature, tileStart, possibleDests, chosenTile);
+    if((chosenTile == nullptr) || tilePath.empty())
+        return nullptr;
+
+    if(path != nullptr)
+        *path = tilePath;
+
+    return chosenTile->getCoveringBuilding();
 }
 
 std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
@@ -1705,6 +1905,9 @@ Player* GameMap::getPlayerBySeat(Seat* seat) const
 std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce)
 {
     std::vector<GameEntity*> returnList;
+    // Buildings cover many tiles. We keep track of the ones already added instead of searching
+    // returnList that may contain many creatures during big fights
+    std::vector<Building*> buildingsAdded;
 
     // Loop over the visible tiles
     for (Tile* tile : visibleTiles)
@@ -1722,8 +1925,9 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
             if((building != nullptr) &&
                (!building->getSeat()->isAlliedSeat(seat)) &&
                (building->isAttackable(tile, seat)) &&
-               (std::find(returnList.begin(), returnList.end(), building) == returnList.end()))
+               (std::find(buildingsAdded.begin(), buildingsAdded.end(), building) == buildingsAdded.end()))
             {
+                buildingsAdded.push_back(building);
                 returnList.push_back(building);
             }
         }
@@ -1733,8 +1937,9 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
             Building* building = tile->getCoveringBuilding();
             if((building != nullptr) &&
                (building->getSeat()->isAlliedSeat(seat)) &&
-               (std::find(returnList.begin(), returnList.end(), building) == returnList.end()))
+               (std::find(buildingsAdded.begin(), buildingsAdded.end(), building) == buildingsAdded.end()))
             {
+                buildingsAdded.push_back(building);
                 returnList.push_back(building);
             }
         }
@@ -1812,6 +2017,7 @@ void GameMap::addRoom(Room *r)
     }
 
     mRooms.push_back(r);
+    notifyGoalEvent(GoalEvent::rooms);
 }
 
 void GameMap::removeRoom(Room *r)
@@ -1827,6 +2033,8 @@ void GameMap::removeRoom(Room *r)
     }
 
     mRooms.erase(it);
+    mBuildingDistanceFields.removeBuilding(r);
+    notifyGoalEvent(GoalEvent::rooms);
 }
 
 std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
@@ -1985,6 +2193,7 @@ void GameMap::removeTrap(Trap *t)
     }
 
     mTraps.erase(it);
+    mBuildingDistanceFields.removeBuilding(t);
 }
 
 bool GameMap::withdrawFromTreasuries(int gold, Seat* seat)
@@ -2152,6 +2361,12 @@ void GameMap::clearGoalsForAllSeats()
     mGoalsForAllSeats.clear();
 }
 
+void GameMap::notifyGoalEvent(uint32_t goalEvents)
+{
+    for (Seat* seat : mSeats)
+        seat->notifyGoalEvent(goalEvents);
+}
+
 bool GameMap::doFloodFill(Seat* seat, Tile* tile)
 {
     if (!mFloodFillEnabled)
@@ -2788,6 +3003,20 @@ void GameMap::consoleAskUnlockSkills()
     }
 }
 
+std::string GameMap::consoleGetAIStats(bool reset)
+{
+    std::string stats = mAiManager.getStatsString();
+    if(reset)
+        mAiManager.resetStats();
+
+    return stats;
+}
+
+void GameMap::consoleSetAITurnBudget(uint32_t budgetTiles)
+{
+    mAiManager.setTurnBudget(budgetTiles);
+}
+
 Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 {
     for (Creature* creature : mCreatures)
@@ -2803,6 +3032,7 @@ Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 
 void GameMap::updateVisibleEntities()
 {
+    OD_PROFILE_ZONE("Visible entities");
     // Notify what happened to entities on visible tiles
     for (int jj = 0; jj < getMapSizeY(); ++jj)
     {
@@ -2826,6 +3056,51 @@ void GameMap::fireRefreshEntities()
     }
 }
 
+void GameMap::fillStateHashCreatures(StateHash& stateHash, const Seat* seat) const
+{
+    stateHash.clearEntities();
+    for(Creature* creature : mCreatures)
+    {
+        // Creatures in hand are not hashed as they are not on the map
+        if(!creature->getIsOnMap())
+            continue;
+
+        if(isServerGameMap())
+        {
+            const std::vector<Seat*>& seats = creature->getSeatsWithVisionNotified();
+            if(std::find(seats.begin(), seats.end(), seat) == seats.end())
+                continue;
+        }
+
+        stateHash.setEntity(creature->getName(), creature->getStateHashValue());
+    }
+}
+
+void GameMap::fillStateHash(StateHash& stateHash) const
+{
+    stateHash.clear();
+    for(int yy = 0; yy < getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < getMapSizeX(); ++xx)
+        {
+            Tile* tile = getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            int seatId = (tile->getSeat() == nullptr) ? -1 : tile->getSeat()->getId();
+            stateHash.setTile(xx, yy, Tile::getStateHashValue(tile->getTileVisual(), seatId));
+        }
+    }
+
+    for(Creature* creature : mCreatures)
+    {
+        if(!creature->getIsOnMap())
+            continue;
+
+        stateHash.setEntity(creature->getName(), creature->getStateHashValue());
+    }
+}
+
 void GameMap::addSpell(Spell *spell)
 {
     OD_LOG_INF(serverStr() + "Adding spell " + spell->getName()
@@ -21,6 +21,10 @@
 #include "gamemap/TileContainer.h"
 
 #include "ai/AIManager.h"
+#include "gamemap/BuildingDistanceFields.h"
+#include "gamemap/CombatResolver.h"
+#include "gamemap/FloodFillVersions.h"
+#include "gamemap/TileIndex.h"
 
 #ifdef __MINGW32__
 #ifndef mode_t
@@ -51,6 +55,7 @@ class CreatureMood;
 class RenderedMovableEntity;
 class Room;
 class Spell;
+class StateHash;
 class TileSet;
 class TileSetValue;
 
@@ -161,6 +166,13 @@ public:
     std::vector<Creature*> getCreaturesByAlliedSeat(const Seat* seat) const;
     std::vector<Creature*> getCreaturesBySeat(const Seat* seat) const;
 
+    //! \brief Number of calls to path() since the game map was created
+    inline unsigned int getNbCallsToPath() const
+    { return mNumCallsTo_path; }
+
+    inline uint32_t getNbActiveObjects() const
+    { return static_cast<uint32_t>(mActiveObjects.size()); }
+
     inline const std::vector<Creature*>& getCreatures() const
     { return mCreatures; }
 
@@ -289,6 +301,7 @@ public:
 
     void clearFilledSeats();
     void clearAiManager();
+    void clearTileIndex();
 
     Seat* getSeatById(int id) const;
 
@@ -303,6 +316,9 @@ public:
     { return mGoalsForAllSeats; }
     void clearGoalsForAllSeats();
 
+    //! \brief Notifies every seat that the given GoalEvent happened
+    void notifyGoalEvent(uint32_t goalEvents);
+
     bool withdrawFromTreasuries(int gold, Seat* seat);
 
     inline const std::string& getLevelFileName() const
@@ -343,9 +359,40 @@ public:
 
     void doPlayerAITurn(double timeSinceLastTurn);
 
+    //! \brief Sets the number of tiles each AI can scan per turn (see AIManager::setTurnBudget)
+    inline void setAITurnBudget(uint32_t budgetTiles)
+    { mAiManager.setTurnBudget(budgetTiles); }
+
     //! \brief Tells whether a path exists between two tiles for the given creature.
     bool pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd);
 
+    //! \brief Returns the index of gold, marked for digging and claimable tiles. The index is
+    //! built on first call (once the map and the seats are loaded) and kept up to date afterwards.
+    //! It should only be used on the server game map.
+    TileIndex& getTileIndex();
+
+    /*! \brief Returns the building from buildings that is the closest to walk to from tileStart for the given
+     * creature or nullptr if none can be reached. Unlike findBestPath, no path is searched: the distance to each
+     * building is read in its distance field (computed once and kept until the floodfill or the building changes).
+     * If path is not null, it is filled with the walkable path from tileStart to the closest tile of the
+     * chosen building. It should only be used on the server game map.
+     */
+    Building* findClosestBuilding(const Creature* creature, Tile* tileStart, const std::vector<Building*>& buildings,
+        std::list<Tile*>* path);
+
+    inline const BuildingDistanceFields& getBuildingDistanceFields() const
+    { return mBuildingDistanceFields; }
+
+    //! \brief Deals damage in a fight (melee attack or missile). During the entities upkeep, damage dealt
+    //! to creatures is collected and applied once every entity has done its upkeep (see CombatResolver).
+    //! Otherwise, it is applied immediately with GameEntity::takeDamage. If notifyPlayerIfHit is true,
+    //! the player owning the target is notified of the fight
+    void dealCombatDamage(GameEntity* attacker, GameEntity* target, double absoluteDamage, double physicalDamage,
+        double magicalDamage, double elementDamage, Tile* tileTakingDamage, bool ko, bool notifyPlayerIfHit);
+
+    inline const CombatResolver& getCombatResolver() const
+    { return mCombatResolver; }
+
     /*! \brief Calculates the walkable path between tileStart and one of the possibleDests. This function
      * will choose the closest tile in possibleDests and return the path between tileStart and it.
      * If a path is found, it is returned and chosenTile is set to the chosen tile. If no path is found,
@@ -401,6 +448,18 @@ public:
      */
     void enableFloodFill();
 
+    //! \brief Called by the tiles when one of their floodfill values changed from oldColor to newColor
+    inline void notifyFloodFillChanged(uint32_t teamIndex, FloodFillType type, uint32_t oldColor, uint32_t newColor)
+    { mFloodFillVersions.notifyRegionChanged(teamIndex, type, oldColor, newColor); }
+
+    //! \brief Called by the tiles when all their floodfill values changed
+    inline void notifyFloodFillChanged()
+    { mFloodFillVersions.notifyAllChanged(); }
+
+    //! \brief Allows to know if data computed from the floodfill is still valid
+    inline const FloodFillVersions& getFloodFillVersions() const
+    { return mFloodFillVersions; }
+
     inline void setLocalPlayer(Player* player)
     { mLocalPlayer = player; }
 
@@ -417,7 +476,18 @@ public:
     { mLocalPlayerNick = nick; }
 
     //! \brief Updates the different entities animations.
-    void updateAnimations(Ogre::Real timeSinceLastFrame);
+    //! \param viewPoint Client side, position of the camera. If given, the animations of the culled entities
+    //! are not updated and the ones of the entities far from it are updated at a reduced rate
+    void updateAnimations(Ogre::Real timeSinceLastFrame, const Ogre::Vector3* viewPoint = nullptr);
+
+    //! \brief Number of animated entities updated, updated at a reduced rate (and skipped during the
+    //! last frame) and culled during the last call to updateAnimations
+    inline uint32_t getNbAnimatedObjectsUpdated() const
+    { return mNbAnimatedObjectsUpdated; }
+    inline uint32_t getNbAnimatedObjectsReduced() const
+    { return mNbAnimatedObjectsReduced; }
+    inline uint32_t getNbAnimatedObjectsCulled() const
+    { return mNbAnimatedObjectsCulled; }
 
     inline int64_t getTurnNumber() const
     { return mTurnNumber; }
@@ -455,6 +525,8 @@ public:
     void consoleSetLevelCreature(const std::string& creatureName, uint32_t level);
     void consoleAskToggleFOW();
     void consoleAskUnlockSkills();
+    std::string consoleGetAIStats(bool reset);
+    void consoleSetAITurnBudget(uint32_t budgetTiles);
 
     //! \brief This functions create unique names. They check that there
     //! is no entity with the same name before returning
@@ -496,6 +568,14 @@ public:
 
     void fireRefreshEntities();
 
+    //! \brief Sets the creatures of the given state hash (see StateHash). On server side, only the
+    //! creatures the given seat was notified about are set. On client side, seat is not used
+    void fillStateHashCreatures(StateHash& stateHash, const Seat* seat) const;
+
+    //! \brief Sets every tile and every creature on the map in the given state hash, whatever the
+    //! seats were notified about. It is used to compare the final state of 2 server runs
+    void fillStateHash(StateHash& stateHash) const;
+
     inline const std::vector<RenderedMovableEntity*>& getRenderedMovableEntities() const
     { return mRenderedMovableEntities; }
 
@@ -505,6 +585,9 @@ public:
     inline const std::string& getTileSetName() const
     { return mTileSetName; }
 
+    inline const TileSet* getTileSet() const
+    { return mTileSet; }
+
     //! \brief getMeshForDefaultTile returns a mesh for some default dirt tile. This
     //! is used as a workaround to avoid lightning issues
     const std::string& getMeshForDefaultTile() const;
@@ -607,6 +690,8 @@ private:
     //! \brief Tells whether the map color flood filling is enabled.
     bool mFloodFillEnabled;
 
+    FloodFillVersions mFloodFillVersions;
+
     //! When true, fog of war will work normally. When false, every connected client will see the whole map
     bool mIsFOWActivated;
 
@@ -618,6 +703,15 @@ private:
     //! \brief Debug member used to know how many call to pathfinding has been made within the same turn.
     unsigned int mNumCallsTo_path;
 
+    //! \brief Frames counted by updateAnimations to update distant entities at a reduced rate
+    uint32_t mAnimationFrameNumber;
+
+    //! \brief Debug members used to know how many animated entities were updated at full rate, at
+    //! a reduced rate and skipped because they were culled during the last frame
+    uint32_t mNbAnimatedObjectsUpdated;
+    uint32_t mNbAnimatedObjectsReduced;
+    uint32_t mNbAnimatedObjectsCulled;
+
     std::vector<RenderedMovableEntity*> mRenderedMovableEntities;
 
     std::vector<Spell*> mSpells;
@@ -627,16 +721,32 @@ private:
     //! AI Handling manager
     AIManager mAiManager;
 
+    //! \brief Index of the tiles workers and AI are looking for
+    TileIndex mTileIndex;
+
+    //! \brief Distance fields to the buildings creatures walk to
+    BuildingDistanceFields mBuildingDistanceFields;
+
+    //! \brief Damage dealt to creatures in fights during the current turn
+    CombatResolver mCombatResolver;
+
     //! Map tileset
     const TileSet* mTileSet;
     std::string mTileSetName;
 
     //! \brief Updates different entities states.
-    //! Updates active objects (creatures, rooms, ...), goals, count each team Workers, gold, mana and claimed tiles.
+    //! Updates active objects (creatures, rooms, ...), goals and mana.
     unsigned long int doMiscUpkeep(double timeSinceLastTurn);
 
+    //! \brief Recounts gold, rooms, creatures and claimed tiles for each seat and logs an error if
+    //! the aggregates maintained incrementally do not match. Used in debug only as it is costly
+    void checkSeatAggregates();
+
     //! \brief Resets the unique numbers
     void resetUniqueNumbers();
+
+    //! \brief Returns the floodfill type matching the tiles the given creature can walk on
+    static FloodFillType getFloodFillTypeForCreature(const Creature* creature);
 };
 
 #endif // GAMEMAP_H
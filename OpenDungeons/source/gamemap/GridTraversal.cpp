@@ -0,0 +1,137 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/GridTraversal.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+inline int getTileCoordinate(double coord)
+{
+    return static_cast<int>(std::floor(coord + 0.5));
+}
+}
+
+GridTraversal::GridTraversal() :
+    mX(0),
+    mY(0),
+    mEndX(0),
+    mEndY(0),
+    mStepX(0),
+    mStepY(0),
+    mTMaxX(0.0),
+    mTMaxY(0.0),
+    mTDeltaX(0.0),
+    mTDeltaY(0.0),
+    mNbStepsLeft(0),
+    mIsDone(true)
+{
+}
+
+void GridTraversal::init(double x1, double y1, double x2, double y2)
+{
+    mX = getTileCoordinate(x1);
+    mY = getTileCoordinate(y1);
+    mEndX = getTileCoordinate(x2);
+    mEndY = getTileCoordinate(y2);
+    mNbStepsLeft = static_cast<uint32_t>(std::abs(mEndX - mX) + std::abs(mEndY - mY));
+    mIsDone = false;
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    double deltaX = x2 - x1;
+    if(mEndX > mX)
+    {
+        mStepX = 1;
+        mTDeltaX = 1.0 / deltaX;
+        mTMaxX = (static_cast<double>(mX) + 0.5 - x1) / deltaX;
+    }
+    else if(mEndX < mX)
+    {
+        mStepX = -1;
+        mTDeltaX = -1.0 / deltaX;
+        mTMaxX = (static_cast<double>(mX) - 0.5 - x1) / deltaX;
+    }
+    else
+    {
+        mStepX = 0;
+        mTDeltaX = infinity;
+        mTMaxX = infinity;
+    }
+
+    double deltaY = y2 - y1;
+    if(mEndY > mY)
+    {
+        mStepY = 1;
+        mTDeltaY = 1.0 / deltaY;
+        mTMaxY = (static_cast<double>(mY) + 0.5 - y1) / deltaY;
+    }
+    else if(mEndY < mY)
+    {
+        mStepY = -1;
+        mTDeltaY = -1.0 / deltaY;
+        mTMaxY = (static_cast<double>(mY) - 0.5 - y1) / deltaY;
+    }
+    else
+    {
+        mStepY = 0;
+        mTDeltaY = infinity;
+        mTMaxY = infinity;
+    }
+}
+
+bool GridTraversal::next(int& x, int& y)
+{
+    if(mIsDone)
+        return false;
+
+    x = mX;
+    y = mY;
+    if(mNbStepsLeft == 0)
+    {
+        mIsDone = true;
+        return true;
+    }
+
+    // We move to the next tile. If we cannot move anymore on one axis (we reached the end tile
+    // coordinate), we move on the other one
+    bool moveX = (mX != mEndX) && ((mY == mEndY) || (mTMaxX <= mTMaxY));
+    bool moveY = (mY != mEndY) && ((mX == mEndX) || (mTMaxY <= mTMaxX));
+    if(moveX && moveY && (mNbStepsLeft >= 2))
+    {
+        mX += mStepX;
+        mTMaxX += mTDeltaX;
+        mY += mStepY;
+        mTMaxY += mTDeltaY;
+        mNbStepsLeft -= 2;
+    }
+    else if(moveX)
+    {
+        mX += mStepX;
+        mTMaxX += mTDeltaX;
+        --mNbStepsLeft;
+    }
+    else
+    {
+        mY += mStepY;
+        mTMaxY += mTDeltaY;
+        --mNbStepsLeft;
+    }
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRIDTRAVERSAL_H
+#define GRIDTRAVERSAL_H
+
+#include <cstdint>
+
+//! \brief Walks, in order, every tile crossed by a segment (Amanatides & Woo grid traversal). Like
+//! in the game map, tile (x, y) covers [x - 0.5, x + 0.5[ x [y - 0.5, y + 0.5[. When the segment goes
+//! exactly through a tile corner, the traversal goes to the diagonal tile.
+//! It does not allocate memory: tiles are computed one at a time when calling next.
+//! Typical use:
+//!     GridTraversal traversal;
+//!     traversal.init(x1, y1, x2, y2);
+//!     int x, y;
+//!     while(traversal.next(x, y))
+//!         ...
+class GridTraversal
+{
+public:
+    GridTraversal();
+
+    void init(double x1, double y1, double x2, double y2);
+
+    //! \brief Sets x and y to the next tile crossed by the segment and returns true. The first
+    //! tile is the one containing the start point and the last one contains the end point.
+    //! Returns false once every tile has been returned
+    bool next(int& x, int& y);
+
+private:
+    int mX;
+    int mY;
+    int mEndX;
+    int mEndY;
+    int mStepX;
+    int mStepY;
+    //! Position along the segment (from 0 to 1) of the next vertical/horizontal tile border
+    double mTMaxX;
+    double mTMaxY;
+    //! Distance along the segment (from 0 to 1) between 2 vertical/horizontal tile borders
+    double mTDeltaX;
+    double mTDeltaY;
+    //! Number of steps left to reach the end tile. It makes sure the traversal stops on
+    //! the end tile whatever the floating point errors
+    uint32_t mNbStepsLeft;
+    bool mIsDone;
+};
+
+#endif // GRIDTRAVERSAL_H
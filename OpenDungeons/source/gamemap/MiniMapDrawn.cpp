@@ -53,18 +53,34 @@ MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
            + mGrainSize - (static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_width) % mGrainSize)),
     mHeight(static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_height)
             + mGrainSize - (static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_height) % mGrainSize)),
-    mTiles(mWidth * mHeight, Color(0,0,0)),
-    mPixelBox(mWidth, mHeight, 1, Ogre::PF_R8G8B8),
+    mCosRotation(1.0),
+    mSinRotation(0.0),
     mMiniMapOgreTexture(Ogre::TextureManager::getSingletonPtr()->createManual(
             "miniMapOgreTexture",
             Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
             Ogre::TEX_TYPE_2D,
-            mWidth, mHeight, 0, Ogre::PF_R8G8B8,
+            mWidth, mHeight, 0, Ogre::PF_A8R8G8B8,
             Ogre::TU_DYNAMIC_WRITE_ONLY)),
     mPixelBuffer(mMiniMapOgreTexture->getBuffer()),
     mGameMap(*ODFrameListener::getSingleton().getClientGameMap()),
     mCameraManager(*ODFrameListener::getSingleton().getCameraManager())
 {
+    // We compute the colour of every tile once. Then, they will be updated when their state changes
+    mRasterizer.resize(mGameMap.getMapSizeX(), mGameMap.getMapSizeY());
+    const Player* localPlayer = mGameMap.getLocalPlayer();
+    for(int yy = 0; yy < mGameMap.getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < mGameMap.getMapSizeX(); ++xx)
+        {
+            Tile* tile = mGameMap.getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->addTileStateListener(*this);
+            mRasterizer.setTileColor(xx, yy, computeTileColor(*tile, localPlayer));
+        }
+    }
+
     CEGUI::Texture& miniMapTextureGui = static_cast<CEGUI::OgreRenderer*>(CEGUI::System::getSingletonPtr()
                                             ->getRenderer())->createTexture("miniMapTextureGui", mMiniMapOgreTexture);
 
@@ -87,6 +103,18 @@ MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
 
 MiniMapDrawn::~MiniMapDrawn()
 {
+    for(int yy = 0; yy < mGameMap.getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < mGameMap.getMapSizeX(); ++xx)
+        {
+            Tile* tile = mGameMap.getTile(xx, yy);
+            if(tile == nullptr)
+                continue;
+
+            tile->removeTileStateListener(*this);
+        }
+    }
+
     mMiniMapWindow->setProperty("Image", "");
     Ogre::TextureManager::getSingletonPtr()->remove("miniMapOgreTexture");
     CEGUI::ImageManager::getSingletonPtr()->destroy("MiniMapImageset");
@@ -117,136 +145,87 @@ void MiniMapDrawn::update(Ogre::Real timeSinceLastFrame, const std::vector<Ogre:
     mCosRotation = cos(rotation);
     mSinRotation = sin(rotation);
 
-    for (int ii = 0, mm = mCamera_2dPosition.x - mWidth / (2 * mGrainSize); ii < static_cast<int>(mWidth); ++mm, ii += mGrainSize)
+    MiniMapView view;
+    view.mWidth = mWidth;
+    view.mHeight = mHeight;
+    view.mGrainSize = static_cast<uint32_t>(mGrainSize);
+    view.mCenterX = mCamera_2dPosition.x;
+    view.mCenterY = mCamera_2dPosition.y;
+    view.mCosRotation = mCosRotation;
+    view.mSinRotation = mSinRotation;
+
+    // If the camera didn't move and no displayed tile changed, the texture is up to date
+    if(!mRasterizer.needsRender(view))
+        return;
+
+    mRasterizer.render(view, mPixels);
+
+    Ogre::PixelBox pixelBox(mWidth, mHeight, 1, Ogre::PF_A8R8G8B8, mPixels.data());
+    mPixelBuffer->blitFromMemory(pixelBox);
+}
+
+void MiniMapDrawn::tileStateChanged(Tile& tile)
+{
+    mRasterizer.setTileColor(tile.getX(), tile.getY(), computeTileColor(tile, mGameMap.getLocalPlayer()));
+}
+
+uint32_t MiniMapDrawn::computeTileColor(const Tile& tile, const Player* localPlayer)
+{
+    if (tile.getMarkedForDigging(localPlayer))
+        return MiniMapRasterizer::packColor(0xFF, 0xA8, 0x00);
+
+    switch (tile.getTileVisual())
     {
-        //NOTE: (0,0) is in the bottom left in the game map, top left in textures, so we are reversing y order here.
-        for (int jj = static_cast<int>(mHeight) - static_cast<int>(mGrainSize), nn = mCamera_2dPosition.y - mHeight / (2 * mGrainSize);
-             jj >= 0; ++nn, jj -= mGrainSize)
+        case TileVisual::claimedGround:
         {
-            // Applying rotation
-            int oo = mCamera_2dPosition.x + static_cast<int>((mm - mCamera_2dPosition.x) * mCosRotation - (nn - mCamera_2dPosition.y) * mSinRotation);
-            int pp = mCamera_2dPosition.y + static_cast<int>((mm - mCamera_2dPosition.x) * mSinRotation + (nn - mCamera_2dPosition.y) * mCosRotation);
-
-            /*FIXME: even if we use a THREE byte pixel format (PF_R8G8B8),
-             * for some reason it only works if we have FOUR increments
-             * (the empty one is the unused alpha channel)
-             * this is not how it is intended/expected
-             */
-            Tile* tile = mGameMap.getTile(oo, pp);
-            if(tile == nullptr)
-            {
-                drawPixel(ii, jj, 0x00, 0x00, 0x00);
-                continue;
-            }
+            const Seat* tempSeat = tile.getSeat();
+            if (tempSeat == nullptr)
+                return MiniMapRasterizer::packColor(0x5C, 0x37, 0x1B);
 
-            if (tile->getMarkedForDigging(mGameMap.getLocalPlayer()))
-            {
-                drawPixel(ii, jj, 0xFF, 0xA8, 0x00);
-                continue;
-            }
-
-            switch (tile->getTileVisual())
-            {
-                case TileVisual::claimedGround:
-                {
-                    Seat* tempSeat = tile->getSeat();
-                    if (tempSeat != nullptr)
-                    {
-                        Ogre::ColourValue color = tempSeat->getColorValue();
-                        drawPixel(ii, jj, color.r*200.0, color.g*200.0, color.b*200.0);
-                    }
-                    else
-                    {
-                        drawPixel(ii, jj, 0x5C, 0x37, 0x1B);
-                    }
-                    break;
-                }
-
-                case TileVisual::claimedFull:
-                {
-                    Seat* tempSeat = tile->getSeat();
-                    if (tempSeat != nullptr)
-                    {
-                        Ogre::ColourValue color = tempSeat->getColorValue();
-                        drawPixel(ii, jj, color.r*255.0, color.g*255.0, color.b*255.0);
-                    }
-                    else
-                    {
-                        drawPixel(ii, jj, 0x86, 0x50, 0x28);
-                    }
-                    break;
-                }
-
-                case TileVisual::waterGround:
-                    drawPixel(ii, jj, 0x21, 0x36, 0x7A);
-                    break;
-
-                case TileVisual::lavaGround:
-                    drawPixel(ii, jj, 0xB2, 0x22, 0x22);
-                    break;
-
-                case TileVisual::dirtGround:
-                    drawPixel(ii, jj, 0x3B, 0x1D, 0x08);
-                    break;
-
-                case TileVisual::dirtFull:
-                    drawPixel(ii, jj, 0x5B, 0x2D, 0x0C);
-                    break;
-
-                case TileVisual::rockGround:
-                    drawPixel(ii, jj, 0x30, 0x30, 0x30);
-                    break;
-
-                case TileVisual::rockFull:
-                    drawPixel(ii, jj, 0x41, 0x41, 0x41);
-                    break;
-
-                case TileVisual::goldGround:
-                    drawPixel(ii, jj, 0x3B, 0x1D, 0x08);
-                    break;
-
-                case TileVisual::goldFull:
-                    drawPixel(ii, jj, 0xB5, 0xB3, 0x2F);
-                    break;
-
-                case TileVisual::nullTileVisual:
-                    drawPixel(ii, jj, 0x00, 0x00, 0x00);
-                    break;
-
-                default:
-                    drawPixel(ii,jj,0x00,0xFF,0x7F);
-                    break;
-            }
+            const Ogre::ColourValue& color = tempSeat->getColorValue();
+            return MiniMapRasterizer::packColor(static_cast<uint8_t>(color.r * 200.0),
+                static_cast<uint8_t>(color.g * 200.0), static_cast<uint8_t>(color.b * 200.0));
         }
-    }
 
-    // Draw creatures on map.
-    // std::vector<Creature*>::iterator updatedCreatureIndex = mGameMap->creatures.begin();
-    // for(; updatedCreatureIndex < mGameMap->creatures.end(); ++updatedCreatureIndex)
-    // {
-    //     if((*updatedCreatureIndex)->getIsOnMap())
-    //     {
-    //         double  ii = (*updatedCreatureIndex)->getPosition().x;
-    //         double  jj = (*updatedCreatureIndex)->getPosition().y;
+        case TileVisual::claimedFull:
+        {
+            const Seat* tempSeat = tile.getSeat();
+            if (tempSeat == nullptr)
+                return MiniMapRasterizer::packColor(0x86, 0x50, 0x28);
 
-    //         drawPixel(ii, jj, 0x94, 0x0, 0x94);
-    //     }
-    // }
+            const Ogre::ColourValue& color = tempSeat->getColorValue();
+            return MiniMapRasterizer::packColor(static_cast<uint8_t>(color.r * 255.0),
+                static_cast<uint8_t>(color.g * 255.0), static_cast<uint8_t>(color.b * 255.0));
+        }
 
-    auto output = mPixelBuffer->lock(mPixelBox, Ogre::HardwareBuffer::HBL_NORMAL);
+        case TileVisual::waterGround:
+            return MiniMapRasterizer::packColor(0x21, 0x36, 0x7A);
 
-    size_t xx = 0;
-    size_t yy = 0;
-    for(const Color& color : mTiles)
-    {
-        // TODO: This is probably a bit inefficient at the moment.
-        output.setColourAt(Ogre::ColourValue(color.RR/255.0, color.GG/255.0, color.BB/255.0), xx, yy, 0);
-        ++xx;
-        if(xx == mWidth) {
-            xx = 0;
-            ++yy;
-        }
-    }
+        case TileVisual::lavaGround:
+            return MiniMapRasterizer::packColor(0xB2, 0x22, 0x22);
+
+        case TileVisual::dirtGround:
+            return MiniMapRasterizer::packColor(0x3B, 0x1D, 0x08);
+
+        case TileVisual::dirtFull:
+            return MiniMapRasterizer::packColor(0x5B, 0x2D, 0x0C);
+
+        case TileVisual::rockGround:
+            return MiniMapRasterizer::packColor(0x30, 0x30, 0x30);
 
-    mPixelBuffer->unlock();
+        case TileVisual::rockFull:
+            return MiniMapRasterizer::packColor(0x41, 0x41, 0x41);
+
+        case TileVisual::goldGround:
+            return MiniMapRasterizer::packColor(0x3B, 0x1D, 0x08);
+
+        case TileVisual::goldFull:
+            return MiniMapRasterizer::packColor(0xB5, 0xB3, 0x2F);
+
+        case TileVisual::nullTileVisual:
+            return MiniMapRasterizer::packColor(0x00, 0x00, 0x00);
+
+        default:
+            return MiniMapRasterizer::packColor(0x00, 0xFF, 0x7F);
+    }
 }
@@ -23,14 +23,16 @@
 #ifndef MINIMAPDRAWN_H_
 #define MINIMAPDRAWN_H_
 
+#include "entities/Tile.h"
 #include "gamemap/MiniMap.h"
+#include "gamemap/MiniMapRasterizer.h"
 
 #include <OgreHardwarePixelBuffer.h>
-#include <OgrePixelFormat.h>
 #include <OgreTexture.h>
 #include <OgreVector2.h>
 #include <OgreVector3.h>
 
+#include <cstdint>
 #include <vector>
 
 namespace CEGUI
@@ -40,30 +42,13 @@ namespace CEGUI
 
 class CameraManager;
 class GameMap;
-
-struct Color
-{
-public:
-    Ogre::uint8 RR;
-    Ogre::uint8 GG;
-    Ogre::uint8 BB;
-
-    Color():
-        RR(0),
-        GG(0),
-        BB(0)
-    {}
-
-    Color(Ogre::uint8 rr, Ogre::uint8 gg, Ogre::uint8 bb):
-        RR(rr),
-        GG(gg),
-        BB(bb)
-    {}
-};
+class Player;
 
 //! \brief The class handling the minimap seen top-right of the in-game screen
-//! FIXME: The pixel are displayed without taking in account the camera current roll value.
-class MiniMapDrawn : public MiniMap
+//! The colour of each tile is kept in a MiniMapRasterizer and updated when the tile state
+//! changes. The displayed image is only rendered and uploaded again when the camera moves
+//! or when a displayed tile changes.
+class MiniMapDrawn : public MiniMap, public TileStateListener
 {
 public:
     MiniMapDrawn(CEGUI::Window* miniMapWindow);
@@ -79,6 +64,11 @@ public:
 
     Ogre::Vector2 camera_2dPositionFromClick(int xx, int yy) override;
 
+    void tileStateChanged(Tile& tile) override;
+
+    //! \brief Returns the colour the given tile should have in the minimap for the given player
+    static uint32_t computeTileColor(const Tile& tile, const Player* localPlayer);
+
 private:
     CEGUI::Window* mMiniMapWindow;
 
@@ -92,26 +82,13 @@ private:
     Ogre::Vector2 mCamera_2dPosition;
     double mCosRotation, mSinRotation;
 
-    //!brief Vector containing colours to be drawn.
-    //NOTE: The tiles are laid out Y,X in the vector to iterate in the right order when drawing.
-    std::vector<Color> mTiles;
+    MiniMapRasterizer mRasterizer;
+    //! \brief Rendered image (mWidth x mHeight pixels in Ogre::PF_A8R8G8B8 format)
+    std::vector<uint32_t> mPixels;
 
-    Ogre::PixelBox mPixelBox;
     Ogre::TexturePtr mMiniMapOgreTexture;
     Ogre::HardwarePixelBufferSharedPtr mPixelBuffer;
 
-    inline void drawPixel(int xx, int yy, Ogre::uint8 RR, Ogre::uint8 GG, Ogre::uint8 BB)
-    {
-        for(int gg = 0; gg < mGrainSize; ++gg)
-        {
-            for(int hh = 0; hh < mGrainSize; ++hh)
-            {
-                mTiles[xx + gg + ((yy + hh) * mWidth)] = Color(RR, GG, BB);
-            }
-        }
-
-    }
-
     GameMap& mGameMap;
     CameraManager& mCameraManager;
 };
@@ -0,0 +1,167 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/MiniMapRasterizer.h"
+
+#include <algorithm>
+#include <limits>
+
+const uint32_t MiniMapRasterizer::OUTSIDE_COLOR = MiniMapRasterizer::packColor(0x00, 0x00, 0x00);
+
+MiniMapRasterizer::MiniMapRasterizer() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mDirtyXMin(std::numeric_limits<int>::max()),
+    mDirtyXMax(std::numeric_limits<int>::min()),
+    mDirtyYMin(std::numeric_limits<int>::max()),
+    mDirtyYMax(std::numeric_limits<int>::min()),
+    mHasRendered(false),
+    mRenderedXMin(0),
+    mRenderedXMax(0),
+    mRenderedYMin(0),
+    mRenderedYMax(0)
+{
+}
+
+void MiniMapRasterizer::resize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = std::max(mapSizeX, 0);
+    mMapSizeY = std::max(mapSizeY, 0);
+    mTileColors.assign(static_cast<size_t>(mMapSizeX) * static_cast<size_t>(mMapSizeY), OUTSIDE_COLOR);
+    // The next render has to redraw everything
+    mHasRendered = false;
+}
+
+bool MiniMapRasterizer::setTileColor(int xx, int yy, uint32_t color)
+{
+    if((xx < 0) || (xx >= mMapSizeX) || (yy < 0) || (yy >= mMapSizeY))
+        return false;
+
+    uint32_t& tileColor = mTileColors[xx + yy * mMapSizeX];
+    if(tileColor == color)
+        return false;
+
+    tileColor = color;
+    mDirtyXMin = std::min(mDirtyXMin, xx);
+    mDirtyXMax = std::max(mDirtyXMax, xx);
+    mDirtyYMin = std::min(mDirtyYMin, yy);
+    mDirtyYMax = std::max(mDirtyYMax, yy);
+    return true;
+}
+
+uint32_t MiniMapRasterizer::getTileColor(int xx, int yy) const
+{
+    if((xx < 0) || (xx >= mMapSizeX) || (yy < 0) || (yy >= mMapSizeY))
+        return OUTSIDE_COLOR;
+
+    return mTileColors[xx + yy * mMapSizeX];
+}
+
+bool MiniMapRasterizer::needsRender(const MiniMapView& view) const
+{
+    if(!mHasRendered || !(view == mLastView))
+        return true;
+
+    // No tile changed
+    if(mDirtyXMin > mDirtyXMax)
+        return false;
+
+    return (mDirtyXMin <= mRenderedXMax) && (mDirtyXMax >= mRenderedXMin)
+        && (mDirtyYMin <= mRenderedYMax) && (mDirtyYMax >= mRenderedYMin);
+}
+
+void MiniMapRasterizer::render(const MiniMapView& view, std::vector<uint32_t>& output)
+{
+    const uint32_t grainSize = std::max(view.mGrainSize, 1u);
+    const uint32_t nbColumns = view.mWidth / grainSize;
+    const uint32_t nbRows = view.mHeight / grainSize;
+    output.assign(static_cast<size_t>(view.mWidth) * static_cast<size_t>(view.mHeight), OUTSIDE_COLOR);
+
+    // Tile displayed by the first column/row before rotation
+    const int firstX = static_cast<int>(view.mCenterX - static_cast<float>(view.mWidth / (2 * grainSize)));
+    const int firstY = static_cast<int>(view.mCenterY - static_cast<float>(view.mHeight / (2 * grainSize)));
+
+    // The rotated tile of a cell is:
+    // x = center.x + (column.x - center.x) * cos - (row.y - center.y) * sin
+    // y = center.y + (column.x - center.x) * sin + (row.y - center.y) * cos
+    // Both terms only depend on the column or on the row so we compute them once
+    mColumnCos.resize(nbColumns);
+    mColumnSin.resize(nbColumns);
+    for(uint32_t col = 0; col < nbColumns; ++col)
+    {
+        float diff = static_cast<float>(firstX + static_cast<int>(col)) - view.mCenterX;
+        mColumnCos[col] = diff * view.mCosRotation;
+        mColumnSin[col] = diff * view.mSinRotation;
+    }
+    mRowCos.resize(nbRows);
+    mRowSin.resize(nbRows);
+    for(uint32_t row = 0; row < nbRows; ++row)
+    {
+        float diff = static_cast<float>(firstY + static_cast<int>(row)) - view.mCenterY;
+        mRowCos[row] = diff * view.mCosRotation;
+        mRowSin[row] = diff * view.mSinRotation;
+    }
+
+    int renderedXMin = std::numeric_limits<int>::max();
+    int renderedXMax = std::numeric_limits<int>::min();
+    int renderedYMin = std::numeric_limits<int>::max();
+    int renderedYMax = std::numeric_limits<int>::min();
+
+    mLine.resize(nbColumns * grainSize);
+    for(uint32_t row = 0; row < nbRows; ++row)
+    {
+        const double rowCos = mRowCos[row];
+        const double rowSin = mRowSin[row];
+        uint32_t* line = mLine.data();
+        for(uint32_t col = 0; col < nbColumns; ++col)
+        {
+            int xx = static_cast<int>(view.mCenterX + static_cast<float>(static_cast<int>(mColumnCos[col] - rowSin)));
+            int yy = static_cast<int>(view.mCenterY + static_cast<float>(static_cast<int>(mColumnSin[col] + rowCos)));
+            renderedXMin = std::min(renderedXMin, xx);
+            renderedXMax = std::max(renderedXMax, xx);
+            renderedYMin = std::min(renderedYMin, yy);
+            renderedYMax = std::max(renderedYMax, yy);
+
+            uint32_t color = OUTSIDE_COLOR;
+            if((xx >= 0) && (xx < mMapSizeX) && (yy >= 0) && (yy < mMapSizeY))
+                color = mTileColors[xx + yy * mMapSizeX];
+
+            std::fill(line, line + grainSize, color);
+            line += grainSize;
+        }
+
+        // (0,0) is at the bottom left of the game map and at the top left of the image
+        // so the first row is at the bottom of the image
+        uint32_t firstPixelY = view.mHeight - (row + 1) * grainSize;
+        for(uint32_t gg = 0; gg < grainSize; ++gg)
+        {
+            uint32_t* dest = output.data() + static_cast<size_t>(firstPixelY + gg) * view.mWidth;
+            std::copy(mLine.begin(), mLine.end(), dest);
+        }
+    }
+
+    mHasRendered = true;
+    mLastView = view;
+    mRenderedXMin = renderedXMin;
+    mRenderedXMax = renderedXMax;
+    mRenderedYMin = renderedYMin;
+    mRenderedYMax = renderedYMax;
+    mDirtyXMin = std::numeric_limits<int>::max();
+    mDirtyXMax = std::numeric_limits<int>::min();
+    mDirtyYMin = std::numeric_limits<int>::max();
+    mDirtyYMax = std::numeric_limits<int>::min();
+}
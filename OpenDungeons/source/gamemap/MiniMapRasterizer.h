@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MINIMAPRASTERIZER_H
+#define MINIMAPRASTERIZER_H
+
+#include <cstdint>
+#include <vector>
+
+//! \brief Parameters of the minimap view: size of the image, number of pixels per tile,
+//! tile displayed at the center and camera rotation
+struct MiniMapView
+{
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mGrainSize = 1;
+    float mCenterX = 0.0f;
+    float mCenterY = 0.0f;
+    double mCosRotation = 1.0;
+    double mSinRotation = 0.0;
+
+    bool operator==(const MiniMapView& other) const
+    {
+        return mWidth == other.mWidth
+            && mHeight == other.mHeight
+            && mGrainSize == other.mGrainSize
+            && mCenterX == other.mCenterX
+            && mCenterY == other.mCenterY
+            && mCosRotation == other.mCosRotation
+            && mSinRotation == other.mSinRotation;
+    }
+};
+
+//! \brief CPU side rasterizer of the minimap. It keeps an image of the whole map with one
+//! colour per tile, which is only updated when a tile changes, and renders the rotated
+//! view around the camera from it. The tiles changed since the last render are tracked
+//! in a dirty rectangle so that the view is only rendered again when it is needed.
+//! This class does not depend on the render system.
+class MiniMapRasterizer
+{
+public:
+    MiniMapRasterizer();
+
+    //! \brief Colours are stored as 0xAARRGGBB (which is the layout of Ogre::PF_A8R8G8B8)
+    static inline uint32_t packColor(uint8_t rr, uint8_t gg, uint8_t bb)
+    {
+        return 0xFF000000u
+            | (static_cast<uint32_t>(rr) << 16)
+            | (static_cast<uint32_t>(gg) << 8)
+            | static_cast<uint32_t>(bb);
+    }
+
+    //! \brief Colour of the pixels outside of the map
+    static const uint32_t OUTSIDE_COLOR;
+
+    //! \brief Resets the map image to the given size. Every tile is set to OUTSIDE_COLOR
+    void resize(int mapSizeX, int mapSizeY);
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    //! \brief Sets the colour of the given tile. If the colour changes, the tile is added
+    //! to the dirty rectangle. Returns true if the colour changed
+    bool setTileColor(int xx, int yy, uint32_t color);
+
+    //! \brief Returns the colour of the given tile or OUTSIDE_COLOR if it is not on the map
+    uint32_t getTileColor(int xx, int yy) const;
+
+    //! \brief Returns true if the given view is different from the last rendered one or if
+    //! tiles displayed in the last render changed since then
+    bool needsRender(const MiniMapView& view) const;
+
+    //! \brief Renders the given view in output (view.mWidth x view.mHeight pixels, row 0 being
+    //! the top of the image) and clears the dirty rectangle.
+    //! Each block of view.mGrainSize x view.mGrainSize pixels displays one tile. The rotation
+    //! is computed from per column and per row terms so that the inner loop is only a table
+    //! lookup, a subtraction and a fetch in the map image.
+    void render(const MiniMapView& view, std::vector<uint32_t>& output);
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    //! One colour per tile, indexed by x + y * mMapSizeX
+    std::vector<uint32_t> mTileColors;
+
+    //! Tiles changed since the last render. Empty if mDirtyXMin > mDirtyXMax
+    int mDirtyXMin;
+    int mDirtyXMax;
+    int mDirtyYMin;
+    int mDirtyYMax;
+
+    //! Last rendered view and bounding box of the tiles it displayed
+    bool mHasRendered;
+    MiniMapView mLastView;
+    int mRenderedXMin;
+    int mRenderedXMax;
+    int mRenderedYMin;
+    int mRenderedYMax;
+
+    //! Per column and per row terms of the rotation, kept to avoid allocations
+    std::vector<double> mColumnCos;
+    std::vector<double> mColumnSin;
+    std::vector<double> mRowCos;
+    std::vector<double> mRowSin;
+    //! One line of tiles, copied mGrainSize times in the output
+    std::vector<uint32_t> mLine;
+};
+
+#endif // MINIMAPRASTERIZER_H
@@ -0,0 +1,208 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/StateHash.h"
+
+namespace
+{
+    //! Finalizer of splitmix64. Spreads the bits of x over the whole result
+    inline uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    inline uint64_t getTileComponentHash(int x, int y, uint64_t value)
+    {
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+        return mix(mix(key) ^ value);
+    }
+
+    inline uint64_t getEntityComponentHash(const std::string& name, uint64_t value)
+    {
+        // FNV-1a
+        uint64_t key = 0xCBF29CE484222325ULL;
+        for(char c : name)
+        {
+            key ^= static_cast<uint8_t>(c);
+            key *= 0x100000001B3ULL;
+        }
+        return mix(mix(key) ^ value);
+    }
+
+    std::string componentValueToString(uint64_t value)
+    {
+        if(value == 0)
+            return "missing";
+
+        return std::to_string(value);
+    }
+
+    //! Returns the first key of the 2 maps whose value differs (a key missing in a map
+    //! has the value 0). Returns false if the maps are the same
+    template<typename Key>
+    bool findFirstDifference(const std::map<Key, uint64_t>& expected, const std::map<Key, uint64_t>& actual,
+        Key& key, uint64_t& expectedValue, uint64_t& actualValue)
+    {
+        auto itExpected = expected.begin();
+        auto itActual = actual.begin();
+        while((itExpected != expected.end()) || (itActual != actual.end()))
+        {
+            if((itActual == actual.end()) ||
+               ((itExpected != expected.end()) && (itExpected->first < itActual->first)))
+            {
+                key = itExpected->first;
+                expectedValue = itExpected->second;
+                actualValue = 0;
+                return true;
+            }
+
+            if((itExpected == expected.end()) || (itActual->first < itExpected->first))
+            {
+                key = itActual->first;
+                expectedValue = 0;
+                actualValue = itActual->second;
+                return true;
+            }
+
+            if(itExpected->second != itActual->second)
+            {
+                key = itExpected->first;
+                expectedValue = itExpected->second;
+                actualValue = itActual->second;
+                return true;
+            }
+
+            ++itExpected;
+            ++itActual;
+        }
+        return false;
+    }
+}
+
+StateHash::StateHash() :
+    mHash(0)
+{
+}
+
+void StateHash::setTile(int x, int y, uint64_t value)
+{
+    std::pair<int, int> coords(x, y);
+    auto it = mTiles.find(coords);
+    if(it != mTiles.end())
+    {
+        if(it->second == value)
+            return;
+
+        mHash ^= getTileComponentHash(x, y, it->second);
+        if(value == 0)
+        {
+            mTiles.erase(it);
+            return;
+        }
+
+        it->second = value;
+    }
+    else
+    {
+        if(value == 0)
+            return;
+
+        mTiles.emplace(coords, value);
+    }
+
+    mHash ^= getTileComponentHash(x, y, value);
+}
+
+void StateHash::setEntity(const std::string& name, uint64_t value)
+{
+    auto it = mEntities.find(name);
+    if(it != mEntities.end())
+    {
+        if(it->second == value)
+            return;
+
+        mHash ^= getEntityComponentHash(name, it->second);
+        if(value == 0)
+        {
+            mEntities.erase(it);
+            return;
+        }
+
+        it->second = value;
+    }
+    else
+    {
+        if(value == 0)
+            return;
+
+        mEntities.emplace(name, value);
+    }
+
+    mHash ^= getEntityComponentHash(name, value);
+}
+
+void StateHash::clearEntities()
+{
+    for(const std::pair<const std::string, uint64_t>& entity : mEntities)
+        mHash ^= getEntityComponentHash(entity.first, entity.second);
+
+    mEntities.clear();
+}
+
+void StateHash::clear()
+{
+    mHash = 0;
+    mTiles.clear();
+    mEntities.clear();
+}
+
+uint64_t StateHash::hashValues(std::initializer_list<int64_t> values)
+{
+    uint64_t hash = 0;
+    for(int64_t value : values)
+        hash = mix(hash ^ static_cast<uint64_t>(value)) + 0x9E3779B97F4A7C15ULL;
+
+    // 0 is used for missing components
+    return (hash == 0) ? 1 : hash;
+}
+
+std::string StateHash::getFirstDifference(const StateHash& expected, const StateHash& actual)
+{
+    uint64_t expectedValue;
+    uint64_t actualValue;
+    std::pair<int, int> coords;
+    if(findFirstDifference(expected.mTiles, actual.mTiles, coords, expectedValue, actualValue))
+    {
+        return "tile " + std::to_string(coords.first) + "," + std::to_string(coords.second)
+            + " expected=" + componentValueToString(expectedValue)
+            + " actual=" + componentValueToString(actualValue);
+    }
+
+    std::string name;
+    if(findFirstDifference(expected.mEntities, actual.mEntities, name, expectedValue, actualValue))
+    {
+        return "entity " + name + " expected=" + componentValueToString(expectedValue)
+            + " actual=" + componentValueToString(actualValue);
+    }
+
+    return std::string();
+}
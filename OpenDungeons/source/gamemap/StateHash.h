@@ -0,0 +1,73 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATEHASH_H
+#define STATEHASH_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+
+//! \brief Hash of the game state shared by the server and a client. It is used to check that the
+//! client gamemap is still what the server told it (see DesyncDetector).
+//! The state is made of components: tiles (identified by their coordinates) and entities (identified
+//! by their name). Each component has a value (0 meaning that the component is not in the state) and
+//! the hash is the xor of the hashes of every component (Zobrist hashing). That way, changing a
+//! component updates the hash without going through the other ones, and the hash does not depend on
+//! the order the components were set.
+class StateHash
+{
+public:
+    StateHash();
+
+    //! \brief Sets the value of the tile at the given coordinates. If value is 0, the tile is removed
+    void setTile(int x, int y, uint64_t value);
+
+    //! \brief Sets the value of the entity with the given name. If value is 0, the entity is removed
+    void setEntity(const std::string& name, uint64_t value);
+
+    //! \brief Removes every entity from the state. Tiles are kept
+    void clearEntities();
+
+    void clear();
+
+    inline uint64_t getHash() const
+    { return mHash; }
+
+    inline const std::map<std::pair<int, int>, uint64_t>& getTiles() const
+    { return mTiles; }
+
+    inline const std::map<std::string, uint64_t>& getEntities() const
+    { return mEntities; }
+
+    //! \brief Returns a component value computed from the given values. The result is never 0
+    static uint64_t hashValues(std::initializer_list<int64_t> values);
+
+    //! \brief Describes the first component that differs between the 2 states. Tiles are
+    //! compared first (ordered by coordinates) and then entities (ordered by name).
+    //! Returns an empty string if both states are the same
+    static std::string getFirstDifference(const StateHash& expected, const StateHash& actual);
+
+private:
+    uint64_t mHash;
+    std::map<std::pair<int, int>, uint64_t> mTiles;
+    std::map<std::string, uint64_t> mEntities;
+};
+
+#endif // STATEHASH_H
@@ -0,0 +1,222 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileIndex.h"
+
+#include "entities/Building.h"
+#include "entities/Tile.h"
+#include "game/Seat.h"
+
+#include <algorithm>
+
+void TileIndex::init(int sizeX, int sizeY, const std::vector<Seat*>& seats)
+{
+    clear();
+    mSeats = seats;
+
+    // Gold is global. The other kinds are per seat
+    uint32_t nbKeys = 1 + (static_cast<uint32_t>(TileIndexKind::nbKinds) - 1) * static_cast<uint32_t>(mSeats.size());
+    mGrid.init(sizeX, sizeY, nbKeys);
+    uint32_t nbTiles = static_cast<uint32_t>(mGrid.getSizeX() * mGrid.getSizeY());
+    mTiles.assign(nbTiles, nullptr);
+    mTileStates.assign(nbTiles, TileState());
+}
+
+void TileIndex::clear()
+{
+    mGrid.clear();
+    mSeats.clear();
+    mTiles.clear();
+    mTileStates.clear();
+}
+
+int TileIndex::getKey(TileIndexKind kind, const Seat* seat) const
+{
+    if(kind == TileIndexKind::gold)
+        return 0;
+
+    if(seat == nullptr)
+        return -1;
+
+    auto it = std::find(mSeats.begin(), mSeats.end(), seat);
+    if(it == mSeats.end())
+        return -1;
+
+    return static_cast<int>(getSeatKey(kind, static_cast<uint32_t>(it - mSeats.begin())));
+}
+
+uint32_t TileIndex::getSeatKey(TileIndexKind kind, uint32_t seatIndex) const
+{
+    return 1 + (static_cast<uint32_t>(kind) - 1) * static_cast<uint32_t>(mSeats.size()) + seatIndex;
+}
+
+bool TileIndex::isTileOfKindForSeat(const Tile& tile, TileIndexKind kind, Seat* seat)
+{
+    switch(kind)
+    {
+        case TileIndexKind::gold:
+            return (tile.getType() == TileType::gold) && (tile.getFullness() > 0.0);
+
+        case TileIndexKind::markedForDigging:
+            return (seat->getPlayer() != nullptr) && tile.getMarkedForDigging(seat->getPlayer());
+
+        case TileIndexKind::claimableGround:
+        {
+            if(tile.getFullness() > 0.0)
+                return false;
+            if(tile.isClaimedForSeat(seat))
+                return false;
+
+            // The covering building claimability is checked when claiming
+            if(tile.getCoveringBuilding() != nullptr)
+                return true;
+
+            return (tile.getType() == TileType::dirt) || (tile.getType() == TileType::gold);
+        }
+
+        case TileIndexKind::claimableWall:
+        {
+            if(tile.getFullness() <= 0.0)
+                return false;
+            if(tile.isClaimedForSeat(seat))
+                return false;
+
+            switch(tile.getType())
+            {
+                case TileType::lava:
+                case TileType::water:
+                case TileType::rock:
+                case TileType::gold:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+
+        default:
+            return false;
+    }
+}
+
+void TileIndex::refreshTile(Tile& tile)
+{
+    int x = tile.getX();
+    int y = tile.getY();
+    if((x < 0) || (y < 0) || (x >= mGrid.getSizeX()) || (y >= mGrid.getSizeY()))
+        return;
+
+    uint32_t pos = static_cast<uint32_t>(x + y * mGrid.getSizeX());
+    mTiles[pos] = &tile;
+    TileState& state = mTileStates[pos];
+    TileState newState;
+    newState.mIsKnown = true;
+    newState.mType = tile.getType();
+    newState.mIsFull = (tile.getFullness() > 0.0);
+    newState.mClaimedSeat = tile.isClaimed() ? tile.getSeat() : nullptr;
+    newState.mCoveringBuilding = tile.getCoveringBuilding();
+    newState.mNbPlayersMarking = tile.getNbPlayersMarkingTile();
+
+    // Gold depends on the type and fullness, marks only on the players marking the tile and
+    // claimability on the type, fullness, claimed seat and covering building
+    bool isGoldChanged = !state.mIsKnown || (state.mType != newState.mType)
+        || (state.mIsFull != newState.mIsFull);
+    bool isMarkChanged = !state.mIsKnown || (state.mNbPlayersMarking != newState.mNbPlayersMarking);
+    bool isClaimChanged = isGoldChanged || (state.mClaimedSeat != newState.mClaimedSeat)
+        || (state.mCoveringBuilding != newState.mCoveringBuilding);
+    state = newState;
+
+    if(isGoldChanged)
+        mGrid.setInIndex(0, x, y, isTileOfKindForSeat(tile, TileIndexKind::gold, nullptr));
+
+    for(uint32_t seatIndex = 0; seatIndex < mSeats.size(); ++seatIndex)
+    {
+        Seat* seat = mSeats[seatIndex];
+        if(isMarkChanged)
+        {
+            mGrid.setInIndex(getSeatKey(TileIndexKind::markedForDigging, seatIndex), x, y,
+                isTileOfKindForSeat(tile, TileIndexKind::markedForDigging, seat));
+        }
+
+        if(isClaimChanged)
+        {
+            mGrid.setInIndex(getSeatKey(TileIndexKind::claimableGround, seatIndex), x, y,
+                isTileOfKindForSeat(tile, TileIndexKind::claimableGround, seat));
+            mGrid.setInIndex(getSeatKey(TileIndexKind::claimableWall, seatIndex), x, y,
+                isTileOfKindForSeat(tile, TileIndexKind::claimableWall, seat));
+        }
+    }
+}
+
+bool TileIndex::isTileOfKind(const Tile& tile, TileIndexKind kind, const Seat* seat) const
+{
+    int key = getKey(kind, seat);
+    if(key < 0)
+        return false;
+
+    return mGrid.isInIndex(static_cast<uint32_t>(key), tile.getX(), tile.getY());
+}
+
+Tile* TileIndex::findClosestTile(TileIndexKind kind, const Seat* seat, int x, int y, int maxDistSquared,
+    const std::function<bool(Tile*)>& filter) const
+{
+    int key = getKey(kind, seat);
+    if(key < 0)
+        return nullptr;
+
+    int sizeX = mGrid.getSizeX();
+    std::function<bool(int, int)> gridFilter;
+    if(filter)
+    {
+        gridFilter = [&](int tileX, int tileY)
+        {
+            return filter(mTiles[tileX + tileY * sizeX]);
+        };
+    }
+
+    int pos = mGrid.findClosestTile(static_cast<uint32_t>(key), x, y, maxDistSquared, gridFilter);
+    if(pos < 0)
+        return nullptr;
+
+    return mTiles[pos];
+}
+
+void TileIndex::getTilesInRadius(TileIndexKind kind, const Seat* seat, int x, int y, int radius,
+    std::vector<Tile*>& tiles) const
+{
+    int key = getKey(kind, seat);
+    if(key < 0)
+        return;
+
+    std::vector<uint32_t> positions;
+    mGrid.getTilesInRadius(static_cast<uint32_t>(key), x, y, radius, positions);
+    for(uint32_t pos : positions)
+        tiles.push_back(mTiles[pos]);
+}
+
+uint32_t TileIndex::getNbTiles(TileIndexKind kind, const Seat* seat) const
+{
+    int key = getKey(kind, seat);
+    if(key < 0)
+        return 0;
+
+    return mGrid.getNbTiles(static_cast<uint32_t>(key));
+}
+
+void TileIndex::tileStateChanged(Tile& tile)
+{
+    refreshTile(tile);
+}
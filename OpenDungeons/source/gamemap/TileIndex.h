@@ -0,0 +1,125 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEINDEX_H
+#define TILEINDEX_H
+
+#include "entities/Tile.h"
+#include "gamemap/TileIndexGrid.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Building;
+class Seat;
+
+//! \brief The different kind of tiles that can be searched in the index. Gold tiles are
+//! global, the other kinds are indexed per seat
+enum class TileIndexKind
+{
+    //! Gold tiles that are not fully dug
+    gold,
+    //! Tiles marked for digging by the seat player
+    markedForDigging,
+    //! Ground tiles that might be claimable by the seat (not claimed for it yet). The exact
+    //! claimability depends on the neighbors and should be checked by the caller
+    claimableGround,
+    //! Wall tiles that might be claimable by the seat (not claimed for it yet). The exact
+    //! claimability depends on the neighbors and should be checked by the caller
+    claimableWall,
+    nbKinds
+};
+
+//! \brief Index of the tiles workers and AI are looking for (gold, marked for digging, claimable).
+//! The tiles of each kind are stored in a TileIndexGrid so that searching the tiles of a given
+//! kind around a position only visits the buckets near it instead of every tile.
+//! The index listens to the tiles state changes and updates the changed tile buckets
+//! immediately. It is meant to be used on the server game map.
+class TileIndex : public TileStateListener
+{
+public:
+    inline bool isInitialized() const
+    { return mGrid.isInitialized(); }
+
+    //! \brief Sets the map size and the seats to index. Every tile should be given with
+    //! refreshTile after that
+    void init(int sizeX, int sizeY, const std::vector<Seat*>& seats);
+    void clear();
+
+    //! \brief Recomputes the kinds of the given tile that depend on what changed since the last
+    //! refresh and updates the buckets accordingly. Most notifications come from creatures moving
+    //! between tiles and do not change any kind
+    void refreshTile(Tile& tile);
+
+    //! \brief Returns true if the given tile is indexed as being of the given kind for the given seat
+    bool isTileOfKind(const Tile& tile, TileIndexKind kind, const Seat* seat) const;
+
+    //! \brief Returns the closest tile of the given kind for the given seat (nullptr for gold) from
+    //! (x,y) that passes the filter (if any) with a squared distance lower or equal to
+    //! maxDistSquared (if >= 0). Tiles are visited by increasing bucket distance so the filter
+    //! should only be called on a few tiles. If several tiles are at the same distance, the first
+    //! one found is returned.
+    //! Filters can use GameMap::pathExists to only return reachable tiles.
+    Tile* findClosestTile(TileIndexKind kind, const Seat* seat, int x, int y, int maxDistSquared,
+        const std::function<bool(Tile*)>& filter) const;
+
+    //! \brief Fills tiles with every tile of the given kind for the given seat that is at squared
+    //! distance lower or equal to radius * radius from (x,y)
+    void getTilesInRadius(TileIndexKind kind, const Seat* seat, int x, int y, int radius,
+        std::vector<Tile*>& tiles) const;
+
+    //! \brief Returns the number of tiles of the given kind for the given seat
+    uint32_t getNbTiles(TileIndexKind kind, const Seat* seat) const;
+
+    void tileStateChanged(Tile& tile) override;
+
+private:
+    //! \brief Tile values the kinds depend on, as they were on the last refresh
+    struct TileState
+    {
+        bool mIsKnown = false;
+        TileType mType = TileType::nullTileType;
+        bool mIsFull = false;
+        const Seat* mClaimedSeat = nullptr;
+        const Building* mCoveringBuilding = nullptr;
+        uint32_t mNbPlayersMarking = 0;
+    };
+
+    //! \brief Tiles of each kind. Gold uses key 0 and the per seat kinds are stored at key
+    //! 1 + (kind - 1) * nbSeats + seat index
+    TileIndexGrid mGrid;
+
+    //! \brief Seats indexed
+    std::vector<Seat*> mSeats;
+
+    //! \brief Refreshed tiles (coordinates are stored as x + y * sizeX)
+    std::vector<Tile*> mTiles;
+
+    //! \brief Last refreshed state by tile (coordinates are stored as x + y * sizeX)
+    std::vector<TileState> mTileStates;
+
+    //! \brief Returns the key used for the given kind and seat or -1 if not indexed
+    int getKey(TileIndexKind kind, const Seat* seat) const;
+
+    //! \brief Returns the key used for the given per seat kind and the seat at the given index
+    uint32_t getSeatKey(TileIndexKind kind, uint32_t seatIndex) const;
+
+    static bool isTileOfKindForSeat(const Tile& tile, TileIndexKind kind, Seat* seat);
+};
+
+#endif // TILEINDEX_H
@@ -0,0 +1,194 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileIndexGrid.h"
+
+#include <algorithm>
+
+const int TileIndexGrid::BUCKET_SIZE = 8;
+
+TileIndexGrid::TileIndexGrid() :
+    mSizeX(0),
+    mSizeY(0),
+    mNbBucketsX(0),
+    mNbBucketsY(0)
+{
+}
+
+void TileIndexGrid::init(int sizeX, int sizeY, uint32_t nbKeys)
+{
+    clear();
+    if((sizeX <= 0) || (sizeY <= 0))
+        return;
+
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    mNbBucketsX = (sizeX + BUCKET_SIZE - 1) / BUCKET_SIZE;
+    mNbBucketsY = (sizeY + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+    uint32_t nbBuckets = static_cast<uint32_t>(mNbBucketsX * mNbBucketsY);
+    uint32_t nbTiles = static_cast<uint32_t>(sizeX * sizeY);
+    mBuckets.assign(nbKeys, std::vector<std::vector<uint32_t>>(nbBuckets));
+    mNbTiles.assign(nbKeys, 0);
+    mIsInIndex.assign(nbKeys, std::vector<uint8_t>(nbTiles, 0));
+}
+
+void TileIndexGrid::clear()
+{
+    mSizeX = 0;
+    mSizeY = 0;
+    mNbBucketsX = 0;
+    mNbBucketsY = 0;
+    mBuckets.clear();
+    mNbTiles.clear();
+    mIsInIndex.clear();
+}
+
+void TileIndexGrid::setInIndex(uint32_t key, int x, int y, bool isInIndex)
+{
+    if((key >= mIsInIndex.size()) || (x < 0) || (y < 0) || (x >= mSizeX) || (y >= mSizeY))
+        return;
+
+    uint32_t pos = static_cast<uint32_t>(x + y * mSizeX);
+    uint8_t& current = mIsInIndex[key][pos];
+    if((current != 0) == isInIndex)
+        return;
+
+    current = isInIndex ? 1 : 0;
+    int bucketIndex = (x / BUCKET_SIZE) + (y / BUCKET_SIZE) * mNbBucketsX;
+    std::vector<uint32_t>& bucket = mBuckets[key][bucketIndex];
+    if(isInIndex)
+    {
+        bucket.push_back(pos);
+        ++mNbTiles[key];
+        return;
+    }
+
+    auto it = std::find(bucket.begin(), bucket.end(), pos);
+    if(it == bucket.end())
+        return;
+
+    // The order in the bucket does not matter
+    *it = bucket.back();
+    bucket.pop_back();
+    --mNbTiles[key];
+}
+
+bool TileIndexGrid::isInIndex(uint32_t key, int x, int y) const
+{
+    if((key >= mIsInIndex.size()) || (x < 0) || (y < 0) || (x >= mSizeX) || (y >= mSizeY))
+        return false;
+
+    return mIsInIndex[key][x + y * mSizeX] != 0;
+}
+
+uint32_t TileIndexGrid::getNbTiles(uint32_t key) const
+{
+    if(key >= mNbTiles.size())
+        return 0;
+
+    return mNbTiles[key];
+}
+
+int TileIndexGrid::findClosestTile(uint32_t key, int x, int y, int maxDistSquared,
+    const std::function<bool(int, int)>& filter) const
+{
+    if((key >= mNbTiles.size()) || (mNbTiles[key] == 0))
+        return -1;
+
+    const std::vector<std::vector<uint32_t>>& buckets = mBuckets[key];
+    int bucketX = std::min(std::max(x, 0), mSizeX - 1) / BUCKET_SIZE;
+    int bucketY = std::min(std::max(y, 0), mSizeY - 1) / BUCKET_SIZE;
+    int maxRing = std::max(mNbBucketsX, mNbBucketsY);
+    int bestPos = -1;
+    int bestDistSquared = 0;
+    // We visit the buckets ring by ring around the bucket containing (x,y). Every tile in
+    // ring r is at least at (r - 1) * BUCKET_SIZE + 1 tiles away on one axis. Once that distance
+    // is greater than the best found, we can stop
+    for(int ring = 0; ring <= maxRing; ++ring)
+    {
+        int minDist = (ring == 0) ? 0 : (ring - 1) * BUCKET_SIZE + 1;
+        if((bestPos >= 0) && (minDist * minDist >= bestDistSquared))
+            break;
+        if((maxDistSquared >= 0) && (minDist * minDist > maxDistSquared))
+            break;
+
+        for(int dy = -ring; dy <= ring; ++dy)
+        {
+            int by = bucketY + dy;
+            if((by < 0) || (by >= mNbBucketsY))
+                continue;
+
+            // On the top and bottom rows of the ring, we take every bucket. Otherwise, only the sides
+            int stepX = ((dy == -ring) || (dy == ring)) ? 1 : std::max(2 * ring, 1);
+            for(int dx = -ring; dx <= ring; dx += stepX)
+            {
+                int bx = bucketX + dx;
+                if((bx < 0) || (bx >= mNbBucketsX))
+                    continue;
+
+                for(uint32_t pos : buckets[bx + by * mNbBucketsX])
+                {
+                    int tileX = static_cast<int>(pos) % mSizeX;
+                    int tileY = static_cast<int>(pos) / mSizeX;
+                    int diffX = tileX - x;
+                    int diffY = tileY - y;
+                    int distSquared = diffX * diffX + diffY * diffY;
+                    if((maxDistSquared >= 0) && (distSquared > maxDistSquared))
+                        continue;
+                    if((bestPos >= 0) && (distSquared >= bestDistSquared))
+                        continue;
+                    if(filter && !filter(tileX, tileY))
+                        continue;
+
+                    bestPos = static_cast<int>(pos);
+                    bestDistSquared = distSquared;
+                }
+            }
+        }
+    }
+
+    return bestPos;
+}
+
+void TileIndexGrid::getTilesInRadius(uint32_t key, int x, int y, int radius, std::vector<uint32_t>& tiles) const
+{
+    if((key >= mNbTiles.size()) || (mNbTiles[key] == 0))
+        return;
+
+    const std::vector<std::vector<uint32_t>>& buckets = mBuckets[key];
+    int bucketX1 = std::max(x - radius, 0) / BUCKET_SIZE;
+    int bucketY1 = std::max(y - radius, 0) / BUCKET_SIZE;
+    int bucketX2 = std::min(x + radius, mSizeX - 1) / BUCKET_SIZE;
+    int bucketY2 = std::min(y + radius, mSizeY - 1) / BUCKET_SIZE;
+    int radiusSquared = radius * radius;
+    for(int by = bucketY1; by <= bucketY2; ++by)
+    {
+        for(int bx = bucketX1; bx <= bucketX2; ++bx)
+        {
+            for(uint32_t pos : buckets[bx + by * mNbBucketsX])
+            {
+                int diffX = static_cast<int>(pos) % mSizeX - x;
+                int diffY = static_cast<int>(pos) / mSizeX - y;
+                if(diffX * diffX + diffY * diffY > radiusSquared)
+                    continue;
+
+                tiles.push_back(pos);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEINDEXGRID_H
+#define TILEINDEXGRID_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//! \brief Sets of tile positions stored in buckets of BUCKET_SIZE x BUCKET_SIZE tiles so that
+//! searching the tiles of a set around a position only visits the buckets near it instead of
+//! every tile. Each set is identified by a key. Positions are stored as x + y * sizeX.
+//! It does not depend on the tiles themselves so that it can be tested on its own. TileIndex
+//! uses it to index the tiles of each kind
+class TileIndexGrid
+{
+public:
+    static const int BUCKET_SIZE;
+
+    TileIndexGrid();
+
+    inline bool isInitialized() const
+    { return mSizeX > 0; }
+
+    inline int getSizeX() const
+    { return mSizeX; }
+
+    inline int getSizeY() const
+    { return mSizeY; }
+
+    //! \brief Sets the map size and the number of sets. Every set is empty after that
+    void init(int sizeX, int sizeY, uint32_t nbKeys);
+    void clear();
+
+    //! \brief Adds or removes the given position from the given set
+    void setInIndex(uint32_t key, int x, int y, bool isInIndex);
+
+    //! \brief Returns true if the given position is in the given set
+    bool isInIndex(uint32_t key, int x, int y) const;
+
+    //! \brief Returns the number of positions in the given set
+    uint32_t getNbTiles(uint32_t key) const;
+
+    //! \brief Returns the closest position of the given set from (x,y) that passes the filter
+    //! (if any) with a squared distance lower or equal to maxDistSquared (if >= 0), or -1 if
+    //! there is none. Buckets are visited by increasing distance so the filter should only be
+    //! called on a few positions. If several positions are at the same distance, the first one
+    //! found is returned.
+    int findClosestTile(uint32_t key, int x, int y, int maxDistSquared,
+        const std::function<bool(int, int)>& filter) const;
+
+    //! \brief Fills tiles with every position of the given set that is at squared distance lower
+    //! or equal to radius * radius from (x,y)
+    void getTilesInRadius(uint32_t key, int x, int y, int radius, std::vector<uint32_t>& tiles) const;
+
+private:
+    int mSizeX;
+    int mSizeY;
+    int mNbBucketsX;
+    int mNbBucketsY;
+
+    //! \brief Positions stored by key and bucket
+    std::vector<std::vector<std::vector<uint32_t>>> mBuckets;
+
+    //! \brief Number of positions stored by key
+    std::vector<uint32_t> mNbTiles;
+
+    //! \brief Position membership by key
+    std::vector<std::vector<uint8_t>> mIsInIndex;
+};
+
+#endif // TILEINDEXGRID_H
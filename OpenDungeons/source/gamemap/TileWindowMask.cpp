@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileWindowMask.h"
+
+#include <algorithm>
+
+TileWindowMask::TileWindowMask() :
+    mOriginX(0),
+    mOriginY(0),
+    mSize(0),
+    mNbTilesSet(0)
+{
+}
+
+void TileWindowMask::reset(int centerX, int centerY, int radius)
+{
+    radius = std::max(radius, 0);
+    mOriginX = centerX - radius;
+    mOriginY = centerY - radius;
+    mSize = 2 * radius + 1;
+    mNbTilesSet = 0;
+    uint32_t nbWords = (static_cast<uint32_t>(mSize * mSize) + 63) / 64;
+    // assign keeps the capacity
+    mBits.assign(nbWords, 0);
+}
+
+void TileWindowMask::clear()
+{
+    mSize = 0;
+    mNbTilesSet = 0;
+    mBits.clear();
+}
+
+void TileWindowMask::set(int x, int y)
+{
+    int localX = x - mOriginX;
+    int localY = y - mOriginY;
+    if((localX < 0) || (localY < 0) || (localX >= mSize) || (localY >= mSize))
+        return;
+
+    uint32_t bit = static_cast<uint32_t>(localX + localY * mSize);
+    uint64_t mask = static_cast<uint64_t>(1) << (bit % 64);
+    if((mBits[bit / 64] & mask) != 0)
+        return;
+
+    mBits[bit / 64] |= mask;
+    ++mNbTilesSet;
+}
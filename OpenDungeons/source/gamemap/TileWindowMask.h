@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEWINDOWMASK_H
+#define TILEWINDOWMASK_H
+
+#include <cstdint>
+#include <vector>
+
+//! \brief One bit per tile in a square window of the map centered on a given tile. It is meant
+//! to answer "is this tile in the set" in constant time for sets of tiles that are within a
+//! radius around a tile (like the tiles a creature can see). Tiles outside the window are never
+//! in the set. The memory is kept when reset so that refilling the mask every turn does not
+//! allocate as long as the radius does not grow.
+class TileWindowMask
+{
+public:
+    TileWindowMask();
+
+    //! \brief Empties the mask and moves the window so that it covers the tiles within
+    //! radius around (centerX, centerY)
+    void reset(int centerX, int centerY, int radius);
+
+    //! \brief Empties the mask. No tile is in the window anymore
+    void clear();
+
+    //! \brief Adds the given tile to the set. Does nothing if the tile is outside the window
+    void set(int x, int y);
+
+    //! \brief Returns true if the given tile has been set since the last reset
+    inline bool isSet(int x, int y) const
+    {
+        int localX = x - mOriginX;
+        int localY = y - mOriginY;
+        if((localX < 0) || (localY < 0) || (localX >= mSize) || (localY >= mSize))
+            return false;
+
+        uint32_t bit = static_cast<uint32_t>(localX + localY * mSize);
+        return (mBits[bit / 64] & (static_cast<uint64_t>(1) << (bit % 64))) != 0;
+    }
+
+    inline uint32_t getNbTilesSet() const
+    { return mNbTilesSet; }
+
+private:
+    int mOriginX;
+    int mOriginY;
+    //! Width and height of the window
+    int mSize;
+    uint32_t mNbTilesSet;
+    std::vector<uint64_t> mBits;
+};
+
+#endif // TILEWINDOWMASK_H
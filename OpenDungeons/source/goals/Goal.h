@@ -18,6 +18,7 @@
 #ifndef GOAL_H
 #define GOAL_H
 
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -26,6 +27,25 @@
 class Seat;
 class GameMap;
 
+//! \brief Game state changes that may change the state of a goal. Goals give the events they
+//! depend on so that they are only checked when one of them happened.
+namespace GoalEvent
+{
+    const uint32_t none = 0;
+    //! The number of claimed tiles of the seat changed
+    const uint32_t claimedTiles = 1 << 0;
+    //! The seat mined some gold
+    const uint32_t goldMined = 1 << 1;
+    //! A creature was added, removed, died or changed seat
+    const uint32_t creatures = 1 << 2;
+    //! A room was added, removed or changed seat
+    const uint32_t rooms = 1 << 3;
+    //! Goals depending on this are checked every turn. Used for goals that cannot tell
+    //! what they depend on
+    const uint32_t polling = 1u << 31;
+    const uint32_t all = 0xFFFFFFFF;
+}
+
 class Goal
 {
 public:
@@ -45,6 +65,11 @@ public:
     virtual bool isUnmet(const Seat& s, const GameMap& gameMap);
     virtual bool isFailed(const Seat&, const GameMap&);
 
+    //! \brief Returns the GoalEvent flags this goal depends on. The goal will only be checked
+    //! when one of these happens. By default, goals are checked every turn
+    virtual uint32_t getGoalEvents() const
+    { return GoalEvent::polling; }
+
     // Functions which cannot be overridden by child classes
     const std::string& getName() const
     { return mName; }
@@ -32,6 +32,8 @@ public:
     std::string getDescription(const Seat&);
     std::string getSuccessMessage(const Seat&);
     std::string getFailedMessage(const Seat&);
+    uint32_t getGoalEvents() const
+    { return GoalEvent::creatures; }
 
 private:
     std::string mCreatureName;
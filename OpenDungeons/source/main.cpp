@@ -47,13 +47,13 @@ INT WINAPI WinMain(HINSTANCE hInst, HINSTANCE, LPSTR strCmdLine, INT)
 int main(int argc, char** argv)
 #endif
 {
-	//AllocConsole();
-	//AttachConsole(GetCurrentProcessId());
-	//freopen("CON", "w", stdout);
-	//freopen("CON", "w", stderr);
-	//SetConsoleTitle("Debug console");
-
-	//MoveWindow(GetConsoleWindow(), 1300, 0, 550, 300, true);
+	//AllocConsole();
+	//AttachConsole(GetCurrentProcessId());
+	//freopen("CON", "w", stdout);
+	//freopen("CON", "w", stderr);
+	//SetConsoleTitle("Debug console");
+
+	//MoveWindow(GetConsoleWindow(), 1300, 0, 550, 300, true);
 	
     // To log segfaults
     StackTracePrint trace("crash.log");
@@ -91,7 +91,7 @@ int main(int argc, char** argv)
         }
 
         ODApplication od;
-        od.startGame(options);
+        return od.startGame(options);
     }
     catch (Ogre::Exception& e)
     {
@@ -101,5 +101,5 @@ int main(int argc, char** argv)
         std::cerr << "An exception has occurred: " << e.what();
 #endif
     }
-    return 0;
+    return 1;
 }
@@ -1,6 +1,8 @@
 #include "modes/ConsoleCommands.h"
 
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
+#include "entities/Tile.h"
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
@@ -15,13 +17,20 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/Profiler.h"
+#include "utils/ResourceManager.h"
 
 #include <OgreCamera.h>
+#include <OgreRenderWindow.h>
 #include <OgreSceneManager.h>
 
 #include <boost/algorithm/string/join.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <limits>
 
 namespace
 {
@@ -39,12 +48,15 @@ const std::string HELPMESSAGE =
         "\n\ttermwidth - Sets the terminal width."
         "\n\n==Cheats=="
         "\n\taddcreature - Adds a creature."
+        "\n\tstressspawn - Adds many creatures around a tile to measure the rendering cost."
         "\n\tsetcreaturelevel - Sets the level of a given creature."
         "\n\taddgold - Gives gold to one player."
         "\n\taddmana - Gives mana to one player."
         "\n\ticanseedeadpeople - Toggles on/off fog of war for every connected player."
         "\n\n==Developer\'s options=="
         "\n\tfps - Sets the maximum framerate cap."
+        "\n\tframestats - Displays the frame time statistics."
+        "\n\tprofiler - Enables the frame profiler or dumps it in a Chrome trace file."
         "\n\tambientlight - Sets the ambient light color."
         "\n\tnearclip - Sets the near clipping distance."
         "\n\tfarclip - Sets the far clipping distance."
@@ -56,7 +68,10 @@ const std::string HELPMESSAGE =
         "\n\tcatmullspline - Triggers the catmullspline camera movement type."
         "\n\tcirclearound - Triggers the circle camera movement type."
         "\n\tsetcamerafovy - Sets the camera vertical field of view aspect ratio value."
-        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap.";
+        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap."
+        "\n\taistats - Displays the CPU time used by each AI."
+        "\n\taibudget - Sets the number of tiles each AI can scan per turn."
+        "\n\tturnpacing - Displays the server turn overruns or sets the turns a client can be late.";
 
 //! \brief Template function to get/set a variable from the ODFrameListener object
 template<typename ValType, typename Getter, typename Setter>
@@ -150,6 +165,73 @@ Command::Result cFPS(const Command::ArgumentList_t& args, ConsoleInterface& c, A
     return Command::Result::SUCCESS;
 }
 
+Command::Result cFrameStats(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    Ogre::RenderWindow* window = ODFrameListener::getSingleton().getRenderWindow();
+    const Ogre::RenderTarget::FrameStats& stats = window->getStatistics();
+    c.print("\nLast FPS: " + Helper::toString(stats.lastFPS)
+        + "\nAverage FPS: " + Helper::toString(stats.avgFPS)
+        + "\nBest frame time: " + Helper::toString(static_cast<uint32_t>(stats.bestFrameTime)) + " ms"
+        + "\nWorst frame time: " + Helper::toString(static_cast<uint32_t>(stats.worstFrameTime)) + " ms"
+        + "\nBatches: " + Helper::toString(static_cast<uint32_t>(stats.batchCount)) + "\n");
+
+    if((args.size() >= 2) && (args[1] == "reset"))
+    {
+        window->resetStatistics();
+        c.print("Frame statistics reset\n");
+    }
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cProfiler(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    if(args.size() < 2)
+    {
+        c.print("\nProfiler is " + std::string(Profiler::isEnabled() ? "on" : "off") + "\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "on")
+    {
+        Profiler::setEnabled(true);
+        c.print("\nProfiler enabled\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "off")
+    {
+        Profiler::setEnabled(false);
+        c.print("\nProfiler disabled\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "clear")
+    {
+        Profiler::clear();
+        c.print("\nProfiler events cleared\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "dump")
+    {
+        std::string fileName = ResourceManager::getSingleton().getUserDataPath()
+            + ((args.size() >= 3) ? args[2] : std::string("profile.json"));
+        std::ofstream file(fileName);
+        if(!file.is_open())
+        {
+            c.print("\nCannot open " + fileName + "\n");
+            return Command::Result::FAILED;
+        }
+
+        uint32_t nbEvents = Profiler::writeChromeTrace(file);
+        c.print("\n" + Helper::toString(nbEvents) + " events written to " + fileName + "\n");
+        return Command::Result::SUCCESS;
+    }
+
+    c.print("\nUnknown profiler option: " + args[1] + "\n");
+    return Command::Result::INVALID_ARGUMENT;
+}
+
 Command::Result cSrvAddCreature(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
 {
     if (args.size() < 6)
@@ -179,6 +261,66 @@ Command::Result cSrvAddCreature(const Command::ArgumentList_t& args, ConsoleInte
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvStressSpawn(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    if (args.size() < 6)
+    {
+        c.print("Invalid number of arguments\n");
+        return Command::Result::INVALID_ARGUMENT;
+    }
+
+    int seatId = Helper::toInt(args[1]);
+    int nbCreatures = Helper::toInt(args[2]);
+    const std::string& className = args[3];
+    int xCenter = Helper::toInt(args[4]);
+    int yCenter = Helper::toInt(args[5]);
+
+    Seat* seat = gameMap.getSeatById(seatId);
+    if(seat == nullptr)
+    {
+        c.print("Unknown seat id=" + Helper::toString(seatId) + "\n");
+        return Command::Result::INVALID_ARGUMENT;
+    }
+
+    const CreatureDefinition* classToSpawn = gameMap.getClassDescription(className);
+    if(classToSpawn == nullptr)
+    {
+        c.print("Unknown creature class=" + className + "\n");
+        return Command::Result::INVALID_ARGUMENT;
+    }
+
+    // The creatures are placed one per tile, on the not full tiles of growing squares around
+    // the given tile
+    int nbSpawned = 0;
+    int maxRadius = std::max(gameMap.getMapSizeX(), gameMap.getMapSizeY());
+    for(int radius = 0; (radius <= maxRadius) && (nbSpawned < nbCreatures); ++radius)
+    {
+        for(int y = yCenter - radius; (y <= yCenter + radius) && (nbSpawned < nbCreatures); ++y)
+        {
+            for(int x = xCenter - radius; (x <= xCenter + radius) && (nbSpawned < nbCreatures); ++x)
+            {
+                // We only process the border of the square
+                if((std::abs(x - xCenter) != radius) && (std::abs(y - yCenter) != radius))
+                    continue;
+
+                Tile* tile = gameMap.getTile(x, y);
+                if((tile == nullptr) || tile->isFullTile())
+                    continue;
+
+                Ogre::Vector3 position(static_cast<Ogre::Real>(x), static_cast<Ogre::Real>(y), 0.0f);
+                Creature* creature = new Creature(&gameMap, classToSpawn, seat, position);
+                creature->addToGameMap();
+                creature->createMesh();
+                creature->setPosition(creature->getPosition());
+                ++nbSpawned;
+            }
+        }
+    }
+
+    c.print("Spawned " + Helper::toString(nbSpawned) + " creatures\n");
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cList(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager& mm)
 {
     ODFrameListener* frameListener = ODFrameListener::getSingletonPtr();
@@ -475,6 +617,83 @@ Command::Result cSrvUnlockSkills(const Command::ArgumentList_t& args, ConsoleInt
     return Command::Result::SUCCESS;
 }
 
+//! \brief Reads a positive number. Returns false if the text is not only made of digits or
+//! if the number is too big
+bool parseUInt32(const std::string& text, uint32_t& value)
+{
+    if(text.empty() || (text.size() > 10))
+        return false;
+
+    uint64_t number = 0;
+    for(char c : text)
+    {
+        if((c < '0') || (c > '9'))
+            return false;
+
+        number = number * 10 + static_cast<uint64_t>(c - '0');
+    }
+
+    if(number > std::numeric_limits<uint32_t>::max())
+        return false;
+
+    value = static_cast<uint32_t>(number);
+    return true;
+}
+
+Command::Result cSrvAIStats(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    bool reset = (args.size() >= 2) && (args[1] == "reset");
+    c.print(gameMap.consoleGetAIStats(reset) + "\n");
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvAIBudget(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    if(args.size() < 2)
+    {
+        c.print("Invalid number of arguments\n");
+        return Command::Result::INVALID_ARGUMENT;
+    }
+
+    uint32_t budget;
+    if(!parseUInt32(args[1], budget))
+    {
+        c.print("Invalid AI turn budget: " + args[1] + "\n");
+        return Command::Result::INVALID_ARGUMENT;
+    }
+
+    gameMap.consoleSetAITurnBudget(budget);
+    c.print("AI turn budget set to " + Helper::toString(budget) + " tiles\n");
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvTurnPacing(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    if((args.size() >= 2) && (args[1] == "window"))
+    {
+        if(args.size() < 3)
+        {
+            c.print("Invalid number of arguments\n");
+            return Command::Result::INVALID_ARGUMENT;
+        }
+
+        uint32_t maxTurnsInFlight;
+        if(!parseUInt32(args[2], maxTurnsInFlight) || (maxTurnsInFlight == 0))
+        {
+            c.print("Invalid number of turns: " + args[2] + "\n");
+            return Command::Result::INVALID_ARGUMENT;
+        }
+
+        ODServer::getSingleton().consoleSetMaxTurnsInFlight(maxTurnsInFlight);
+        c.print("Clients can now be " + Helper::toString(maxTurnsInFlight) + " turns late\n");
+        return Command::Result::SUCCESS;
+    }
+
+    bool reset = (args.size() >= 2) && (args[1] == "reset");
+    c.print(ODServer::getSingleton().consoleGetTurnPacingStats(reset));
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cKeys(const Command::ArgumentList_t&, ConsoleInterface& c, AbstractModeManager&)
 {
     c.print("|| Action               || US Keyboard layout ||     Mouse      ||\n\
@@ -530,6 +749,22 @@ void addConsoleCommands(ConsoleInterface& cl)
                   cFPS,
                   Command::cStubServer,
                   {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
+    cl.addCommand("framestats",
+                  "'framestats' displays the frame time statistics since the game started or since the last reset. "
+                  "If 'reset' is given, the statistics are reset after being displayed.\n\nExample:\n"
+                  "framestats reset",
+                  cFrameStats,
+                  Command::cStubServer,
+                  {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
+    cl.addCommand("profiler",
+                  "'profiler' enables or disables the frame profiler. While it is enabled, the time spent in the "
+                  "main parts of the client frame and of the server turn is displayed on screen. 'profiler clear' "
+                  "removes the recorded events and 'profiler dump [file]' writes them in the user data folder in "
+                  "the Chrome trace format (it can be opened in chrome://tracing).\n\nExample:\n"
+                  "profiler on\nprofiler dump profile.json",
+                  cProfiler,
+                  Command::cStubServer,
+                  {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
     cl.addCommand("nearclip",
                    "Sets the minimal viewpoint clipping distance. Objects nearer than that won't be rendered.\n\nE.g.: nearclip 3.0",
                    [](const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&) {
@@ -566,6 +801,13 @@ void addConsoleCommands(ConsoleInterface& cl)
                   cSendCmdToServer,
                   cSrvAddCreature,
                   {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
+    cl.addCommand("stressspawn",
+                  "'stressspawn' adds the given number of creatures of the given class and seat around the given tile. "
+                  "It can be used with 'framestats' to measure the rendering cost of big fights.\n\nExample:\n"
+                  "stressspawn 1 200 Troll 10 10\n\nThe above command adds 200 trolls for seat 1 around tile 10,10.",
+                  cSendCmdToServer,
+                  cSrvStressSpawn,
+                  {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
 
     std::string listDescription = "'list' (or 'ls' for short) is a utility which lists various types of information about the current game. "
             "Running list without an argument will produce a list of the lists available. "
@@ -697,6 +939,29 @@ void addConsoleCommands(ConsoleInterface& cl)
                    },
                    Command::cStubServer,
                    {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
+    cl.addCommand("aistats",
+                   "'aistats' displays, for each AI, the CPU time spent in each of its tasks. If 'reset' is given, "
+                   "the counters are reset after being displayed.\n\nExample:\n"
+                   "aistats reset",
+                   cSendCmdToServer,
+                   cSrvAIStats,
+                   {AbstractModeManager::ModeType::GAME});
+    cl.addCommand("aibudget",
+                   "'aibudget' sets the number of tiles each AI is allowed to scan per turn. Searches "
+                   "scanning more tiles are continued on next turn. 0 means no limit.\n\nExample:\n"
+                   "aibudget 4096",
+                   cSendCmdToServer,
+                   cSrvAIBudget,
+                   {AbstractModeManager::ModeType::GAME});
+    cl.addCommand("turnpacing",
+                   "'turnpacing' displays the server turn statistics: turns longer than the turn length (overruns), "
+                   "turns started back to back to catch up and turns delayed by late clients. If 'reset' is given, "
+                   "the counters are reset after being displayed. 'turnpacing window n' sets the number of turns "
+                   "a client can be late before the server waits for it (1 means lockstep).\n\nExample:\n"
+                   "turnpacing reset\nturnpacing window 3",
+                   cSendCmdToServer,
+                   cSrvTurnPacing,
+                   {AbstractModeManager::ModeType::GAME});
     cl.addCommand("unlockskills",
                    "Unlock all skills for every seats\n"
                    "unlockskills",
@@ -321,6 +321,11 @@ void GameEditorModeBase::syncTabButtonTooltips(const CEGUI::String& tabControlNa
     }
 }
 
+void GameEditorModeBase::printToConsole(const std::string& text)
+{
+    mConsole->printToConsole(text);
+}
+
 void GameEditorModeBase::enterConsole()
 {
     // We use a unique console instance.
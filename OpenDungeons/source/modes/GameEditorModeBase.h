@@ -116,6 +116,9 @@ public:
 
     //! \brief Leave the console.
     void leaveConsole();
+
+    //! \brief Displays the given text in the console.
+    void printToConsole(const std::string& text);
 protected:
     enum InputMode
     {
@@ -47,8 +47,9 @@ public:
     //! Used to call the corresponding Gui Sheet.
     void activate();
 
-private:
     void printToConsole(const std::string& text);
+
+private:
     bool executeCurrentPrompt(const CEGUI::EventArgs& e = {});
     bool characterEntered(const CEGUI::EventArgs& e = {});
 
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/DesyncDetector.h"
+
+DesyncDetector::DesyncDetector() :
+    mIsDesynced(false),
+    mNbDesyncs(0),
+    mReportTurn(-1),
+    mIsReportStateSet(false)
+{
+}
+
+void DesyncDetector::reset()
+{
+    mTurnHashes.clear();
+    mIsDesynced = false;
+    mNbDesyncs = 0;
+    mReportTurn = -1;
+    mReportState.clear();
+    mIsReportStateSet = false;
+}
+
+void DesyncDetector::turnSent(int64_t turn, const StateHash& stateHash)
+{
+    mTurnHashes.emplace_back(turn, stateHash.getHash());
+    if(turn != mReportTurn)
+        return;
+
+    mReportState = stateHash;
+    mIsReportStateSet = true;
+}
+
+DesyncDetector::Result DesyncDetector::turnAcknowledged(int64_t turn, uint64_t clientHash)
+{
+    while(!mTurnHashes.empty() && (mTurnHashes.front().first < turn))
+        mTurnHashes.pop_front();
+
+    if(mTurnHashes.empty() || (mTurnHashes.front().first != turn))
+        return Result::unknownTurn;
+
+    uint64_t serverHash = mTurnHashes.front().second;
+    mTurnHashes.pop_front();
+    if(serverHash == clientHash)
+    {
+        if(!mIsDesynced)
+            return Result::inSync;
+
+        mIsDesynced = false;
+        return Result::resynced;
+    }
+
+    if(mIsDesynced)
+        return Result::desynced;
+
+    mIsDesynced = true;
+    ++mNbDesyncs;
+    return Result::desyncStarted;
+}
+
+void DesyncDetector::askReport(int64_t turn)
+{
+    mReportTurn = turn;
+    mReportState.clear();
+    mIsReportStateSet = false;
+}
+
+bool DesyncDetector::checkReport(int64_t turn, const StateHash& clientState, std::string& difference)
+{
+    if((turn != mReportTurn) || !mIsReportStateSet)
+        return false;
+
+    difference = StateHash::getFirstDifference(mReportState, clientState);
+    mReportTurn = -1;
+    mReportState.clear();
+    mIsReportStateSet = false;
+    return true;
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DESYNCDETECTOR_H
+#define DESYNCDETECTOR_H
+
+#include "gamemap/StateHash.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+
+/*! \brief Server side. Checks that a client gamemap matches what the server notified to it.
+ * When a turn is started, the server keeps the hash of the state it notified to the client
+ * (see StateHash). When the client acknowledges the turn, it sends the hash of its own state
+ * which should be the same since it processed every message sent before the turn.
+ * A desync starts at the first acknowledged turn whose hashes differ and ends at the next one
+ * where they match again. When a desync starts, the server can ask the client to send its whole
+ * state with the next turn to find the first diverging tile or entity.
+ * This class does not depend on the network.
+ */
+class DesyncDetector
+{
+public:
+    enum class Result
+    {
+        unknownTurn,
+        inSync,
+        desyncStarted,
+        desynced,
+        resynced
+    };
+
+    DesyncDetector();
+
+    void reset();
+
+    //! \brief To be called when the given turn is sent to the client with the state it should have
+    //! when receiving it. If a report was asked for this turn, the state is kept
+    void turnSent(int64_t turn, const StateHash& stateHash);
+
+    //! \brief Compares the hash computed by the client for the given turn with the one of the server.
+    //! The hashes of this turn and the previous ones are forgotten
+    Result turnAcknowledged(int64_t turn, uint64_t clientHash);
+
+    //! \brief Keeps the state that will be sent with the given turn to compare it with the
+    //! state the client will report for this turn
+    void askReport(int64_t turn);
+
+    //! \brief Compares the state reported by the client with the one kept for the given turn. Returns
+    //! false if no report was asked for this turn. Otherwise, difference is set to the first diverging
+    //! component (empty if there is none)
+    bool checkReport(int64_t turn, const StateHash& clientState, std::string& difference);
+
+    inline bool isDesynced() const
+    { return mIsDesynced; }
+
+    //! \brief Number of desyncs started since the last reset
+    inline uint64_t getNbDesyncs() const
+    { return mNbDesyncs; }
+
+    //! \brief Number of turns sent and not acknowledged yet
+    inline uint32_t getNbTurnsPending() const
+    { return static_cast<uint32_t>(mTurnHashes.size()); }
+
+private:
+    std::deque<std::pair<int64_t, uint64_t>> mTurnHashes;
+    bool mIsDesynced;
+    uint64_t mNbDesyncs;
+
+    //! \brief Turn the client was asked to report its state for. -1 if none
+    int64_t mReportTurn;
+    //! \brief State sent with mReportTurn. Only filled once the turn is sent
+    StateHash mReportState;
+    bool mIsReportStateSet;
+};
+
+#endif // DESYNCDETECTOR_H
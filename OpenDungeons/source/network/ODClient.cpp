@@ -55,7 +55,8 @@ template<> ODClient* Ogre::Singleton<ODClient>::msSingleton = nullptr;
 
 ODClient::ODClient() :
     ODSocketClient(),
-    mIsPlayerConfig(false)
+    mIsPlayerConfig(false),
+    mIsStateHashReportAsked(false)
 {
 }
 
@@ -340,6 +341,8 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             // Now that the we have received all needed information, we can launch the requested mode
             OD_LOG_INF("Starting game map");
             gameMap->setGamePaused(false);
+            // Colorized materials are created before the entities so that we don't need to clone them during the game
+            RenderManager::getSingleton().rrPrewarmMaterialVariants(*gameMap);
             // Create ogre entities for the tiles, rooms, and creatures
             gameMap->createAllEntities();
 
@@ -408,6 +411,8 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
         case ServerNotificationType::newMap:
         {
             gameMap->clearAll();
+            mStateHash.clear();
+            mIsStateHashReportAsked = false;
             break;
         }
 
@@ -458,9 +463,16 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
             gameMap->clientUpKeep(turnNum);
             // We acknowledge the new turn to the server so that he knows we are
-            // ready for next one
+            // ready for next one. We also send the hash of our state so that he
+            // can check we are in sync
+            gameMap->fillStateHashCreatures(mStateHash, nullptr);
+            uint64_t stateHash = mStateHash.getHash();
+            bool hasStateReport = mIsStateHashReportAsked;
+            mIsStateHashReportAsked = false;
             ODPacket packSend;
-            packSend << ClientNotificationType::ackNewTurn << turnNum;
+            packSend << ClientNotificationType::ackNewTurn << turnNum << stateHash << hasStateReport;
+            if(hasStateReport)
+                exportStateHashReport(packSend);
             send(packSend);
 
             // For the first turn, we stop processing events because we want the gamemap to
@@ -799,6 +811,10 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
                 gameTile->updateFromPacket(packetReceived);
                 tiles.push_back(gameTile);
+
+                int seatId = (gameTile->getSeat() == nullptr) ? -1 : gameTile->getSeat()->getId();
+                mStateHash.setTile(gameTile->getX(), gameTile->getY(),
+                    Tile::getStateHashValue(gameTile->getTileVisual(), seatId));
             }
             gameMap->refreshBorderingTilesOf(tiles);
             break;
@@ -932,6 +948,23 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             getPlayer()->updateEvents(events);
             break;
         }
+        case ServerNotificationType::consoleMessage:
+        {
+            std::string msg;
+            OD_ASSERT_TRUE(packetReceived >> msg);
+            ModeManager* modeManager = frameListener->getModeManager();
+            ModeManager::ModeType modeType = modeManager->getCurrentModeType();
+            if((modeType != ModeManager::ModeType::GAME) &&
+               (modeType != ModeManager::ModeType::EDITOR))
+            {
+                break;
+            }
+
+            GameEditorModeBase* mode = static_cast<GameEditorModeBase*>(modeManager->getCurrentMode());
+            mode->printToConsole(msg);
+            break;
+        }
+
         case ServerNotificationType::setSpellCooldown:
         {
             SpellType spellType;
@@ -948,6 +981,12 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             break;
         }
 
+        case ServerNotificationType::askStateHashReport:
+        {
+            mIsStateHashReportAsked = true;
+            break;
+        }
+
         default:
         {
             OD_LOG_ERR("Unknown server command:"
@@ -1017,9 +1056,34 @@ void ODClient::refreshMainUI(const std::string& goalsString)
     // Note: Later, we can handle other modes here if necessary.
 }
 
+void ODClient::exportStateHashReport(ODPacket& packet) const
+{
+    // This should be read as in ODServer::checkClientStateReport
+    uint32_t nbTiles = mStateHash.getTiles().size();
+    packet << nbTiles;
+    for(const std::pair<const std::pair<int, int>, uint64_t>& tile : mStateHash.getTiles())
+    {
+        int32_t x = tile.first.first;
+        int32_t y = tile.first.second;
+        uint64_t value = tile.second;
+        packet << x << y << value;
+    }
+
+    uint32_t nbEntities = mStateHash.getEntities().size();
+    packet << nbEntities;
+    for(const std::pair<const std::string, uint64_t>& entity : mStateHash.getEntities())
+    {
+        std::string name = entity.first;
+        uint64_t value = entity.second;
+        packet << name << value;
+    }
+}
+
 bool ODClient::connect(const std::string& host, const int port, uint32_t timeout, const std::string& outputReplayFilename)
 {
     mIsPlayerConfig = false;
+    mStateHash.clear();
+    mIsStateHashReportAsked = false;
     // Start the server socket listener as well as the server socket thread
     if (ODClient::getSingleton().isConnected())
     {
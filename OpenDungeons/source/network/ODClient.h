@@ -20,6 +20,7 @@
 
 #include "network/ODSocketClient.h"
 #include "network/ClientNotification.h"
+#include "gamemap/StateHash.h"
 
 #include <OgreSingleton.h>
 
@@ -96,6 +97,9 @@ class ODClient: public Ogre::Singleton<ODClient>,
     //! \brief Refreshes the player's goals + main data
     void refreshMainUI(const std::string& goalsString);
 
+    //! \brief Writes the whole state hashed in mStateHash so that the server can find where we differ
+    void exportStateHashReport(ODPacket& packet) const;
+
     std::string mTmpReceivedString;
     std::string mLevelFilename;
 
@@ -104,6 +108,13 @@ class ODClient: public Ogre::Singleton<ODClient>,
     // true if the server told us we are allowed to configure the game. False otherwise
     bool mIsPlayerConfig;
 
+    //! \brief Hash of what the server notified to us. It is sent with the turn acknowledgements
+    //! so that the server can check we are in sync (see DesyncDetector)
+    StateHash mStateHash;
+
+    //! \brief true if the server asked us to send our whole state with the next turn acknowledgement
+    bool mIsStateHashReportAsked;
+
 };
 
 template<typename ...Args>
@@ -31,10 +31,15 @@
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
 #include "gamemap/MapHandler.h"
+#include "gamemap/StateHash.h"
 #include "modes/ConsoleCommands.h"
+#include "network/DesyncDetector.h"
 #include "network/ODClient.h"
+#include "network/ServerMetrics.h"
 #include "network/ServerMode.h"
 #include "network/ServerNotification.h"
+#include "network/SimulationBenchmark.h"
+#include "network/TurnScheduler.h"
 #include "rooms/RoomManager.h"
 #include "rooms/RoomType.h"
 #include "spells/SpellManager.h"
@@ -46,6 +51,8 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MasterServer.h"
+#include "utils/Profiler.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
 #include "ODApplication.h"
 
@@ -57,10 +64,24 @@
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 
 const std::string SAVEGAME_SKIRMISH_PREFIX = "SK-";
 const std::string SAVEGAME_MULTIPLAYER_PREFIX = "MP-";
 static const double MASTER_SERVER_UPDATE_PERIOD_MS = 30000.0;
+//! \brief Maximum number of turns started back to back when the server is late
+static const uint32_t MAX_CATCH_UP_TURNS = 4;
+//! \brief Default number of turns a client can be late before the server waits for it
+static const uint32_t DEFAULT_MAX_TURNS_IN_FLIGHT = 2;
+//! \brief The turn pacing is logged (if there were overruns or delays) every TURN_PACING_LOG_PERIOD turns
+static const uint64_t TURN_PACING_LOG_PERIOD = 60;
+//! \brief Seed used by the benchmark if none is given so that runs can be compared
+static const uint64_t BENCHMARK_DEFAULT_RANDOM_SEED = 1;
+//! \brief Number of tiles each AI can scan per turn during the benchmark. It does not depend on
+//! the default budget so that results of different builds can be compared
+static const uint32_t BENCHMARK_AI_TURN_BUDGET_TILES = 4096;
 static const int32_t MASTER_SERVER_STATUS_PENDING = 0;
 static const int32_t MASTER_SERVER_STATUS_STARTED = 1;
 static const int32_t MASTER_SERVER_STATUS_FINISHED = 2;
@@ -75,7 +96,15 @@ ODServer::ODServer() :
     mSeatsConfigured(false),
     mPlayerConfig(nullptr),
     mConsoleInterface(std::bind(&ODServer::printConsoleMsg, this, std::placeholders::_1)),
-    mMasterServerGameStatusUpdateTime(0)
+    mMasterServerGameStatusUpdateTime(0),
+    mMetricsWriteTime(0),
+    mBenchmark(nullptr),
+    mConsoleCommandPlayer(nullptr),
+    mRandomSeed(0),
+    mTurnScheduler(1000.0 / ODApplication::turnsPerSecond, MAX_CATCH_UP_TURNS),
+    mMaxTurnsInFlight(DEFAULT_MAX_TURNS_IN_FLIGHT),
+    mNbOverrunsLogged(0),
+    mNbTurnsDelayedLogged(0)
 {
     ConsoleCommands::addConsoleCommands(mConsoleInterface);
 }
@@ -113,8 +142,10 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     mServerMode = mode;
     mServerState = ServerState::StateConfiguration;
     mUniqueNumberPlayer = 0;
+
     GameMap* gameMap = mGameMap;
-    if (!gameMap->loadLevel(levelFilename))
+    uint64_t randomSeed = (mRandomSeed != 0) ? mRandomSeed : Random::generateSeed();
+    if (!loadServerLevel(levelFilename, randomSeed))
     {
         mServerMode = ServerMode::ModeNone;
         mServerState = ServerState::StateNone;
@@ -134,9 +165,80 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
         return false;
     }
 
-    // We configure what is fixed (fixed AI, faction or team). While iterating seats, we keep in mind if there is
-    // at least a human only seat. If yes, we configure all player type choosable to AI. If not, we configure all player
-    // type choosable to AI except the first one.
+    // We configure what is fixed (fixed AI, faction or team). We keep in mind if there is at least a human only
+    // seat. If yes, we configure all player type choosable to AI. If not, we configure all player type choosable
+    // to AI except the first one.
+    uint32_t nbSeatsHuman = configureFixedSeats();
+
+    if(useMasterServer)
+    {
+        LevelInfo info;
+        if(!MapHandler::getMapInfo(levelFilename, info))
+        {
+            info.mLevelName = "No name";
+            info.mLevelDescription = "No description";
+        }
+
+        const std::string& label = info.mLevelName;
+        const std::string& descr = info.mLevelDescription;
+        std::string uuid;
+        if(!MasterServer::registerGame(ODApplication::VERSION, creator, port, label, descr, uuid))
+        {
+            OD_LOG_ERR("Could not register the game in the master server !!!");
+            stopServer();
+            return false;
+        }
+
+        mMasterServerGameId = uuid;
+    }
+
+    // In single player, we use a default value for seats that can be chosen
+    if(mServerMode != ServerMode::ModeGameSinglePlayer)
+        return true;
+
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->isRogueSeat())
+            continue;
+
+        // Player faction to the first one defined
+        if(seat->getFaction().compare(Seat::PLAYER_FACTION_CHOICE) == 0)
+            seat->setConfigFactionIndex(0);
+
+        // Player type to AI
+        if(seat->getPlayerType().compare(Seat::PLAYER_TYPE_CHOICE) == 0)
+        {
+            // We set default AI value
+            if(nbSeatsHuman == 0)
+                ++nbSeatsHuman;
+            else
+                seat->setConfigPlayerId(Seat::aITypeToPlayerId(KeeperAIType::normal));
+        }
+
+        // Player team to first one available
+        const std::vector<int>& availableTeamIds = seat->getAvailableTeamIds();
+        if(availableTeamIds.size() > 1)
+            seat->setConfigTeamId(availableTeamIds.front());
+    }
+
+    return true;
+}
+
+bool ODServer::loadServerLevel(const std::string& levelFilename, uint64_t randomSeed)
+{
+    Random::seedStream(Random::Stream::simulation, randomSeed);
+    Random::seedStream(Random::Stream::ai, randomSeed);
+    OD_LOG_INF("Server random seed=" + Helper::toString(randomSeed));
+
+    // The level uses the simulation random numbers. The server thread is not started
+    // yet so we can use them from this thread
+    Random::StreamScope randomScope(Random::Stream::simulation);
+    return mGameMap->loadLevel(levelFilename);
+}
+
+uint32_t ODServer::configureFixedSeats()
+{
+    GameMap* gameMap = mGameMap;
     uint32_t nbSeatsHuman = 0;
     const std::vector<std::string>& factions = ConfigManager::getSingleton().getFactions();
     for(Seat* seat : gameMap->getSeats())
@@ -178,58 +280,103 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
         }
     }
 
-    if(useMasterServer)
-    {
-        LevelInfo info;
-        if(!MapHandler::getMapInfo(levelFilename, info))
-        {
-            info.mLevelName = "No name";
-            info.mLevelDescription = "No description";
-        }
+    return nbSeatsHuman;
+}
 
-        const std::string& label = info.mLevelName;
-        const std::string& descr = info.mLevelDescription;
-        std::string uuid;
-        if(!MasterServer::registerGame(ODApplication::VERSION, creator, port, label, descr, uuid))
-        {
-            OD_LOG_ERR("Could not register the game in the master server !!!");
-            stopServer();
-            return false;
-        }
+bool ODServer::runBenchmark(const std::string& levelFilename, uint32_t nbTurns, const std::string& resultFileName)
+{
+    OD_LOG_INF("Asked to run benchmark with levelFilename=" + levelFilename
+        + ", nbTurns=" + Helper::toString(nbTurns));
 
-        mMasterServerGameId = uuid;
+    if (isConnected())
+    {
+        OD_LOG_INF("Couldn't run benchmark: The server is already connected");
+        return false;
     }
 
-    // In single player, we use a default value for seats that can be chosen
-    if(mServerMode != ServerMode::ModeGameSinglePlayer)
-        return true;
+    mSeatsConfigured = false;
+    mServerMode = ServerMode::ModeGameMultiPlayer;
+    mServerState = ServerState::StateConfiguration;
+    mUniqueNumberPlayer = 0;
 
+    // Results of different runs should be comparable so we use always the same seed if none is given
+    GameMap* gameMap = mGameMap;
+    uint64_t randomSeed = (mRandomSeed != 0) ? mRandomSeed : BENCHMARK_DEFAULT_RANDOM_SEED;
+    if (!loadServerLevel(levelFilename, randomSeed))
+    {
+        mServerMode = ServerMode::ModeNone;
+        mServerState = ServerState::StateNone;
+        OD_LOG_INF("Couldn't run benchmark. The level file can't be loaded: " + levelFilename);
+        stopServer();
+        return false;
+    }
+
+    // Every seat that can be played is given to a normal keeper AI
+    configureFixedSeats();
     for(Seat* seat : gameMap->getSeats())
     {
         if(seat->isRogueSeat())
             continue;
 
-        // Player faction to the first one defined
-        if(seat->getFaction().compare(Seat::PLAYER_FACTION_CHOICE) == 0)
-            seat->setConfigFactionIndex(0);
+        if(seat->getConfigPlayerId() == -1)
+            seat->setConfigPlayerId(Seat::aITypeToPlayerId(KeeperAIType::normal));
 
-        // Player type to AI
-        if(seat->getPlayerType().compare(Seat::PLAYER_TYPE_CHOICE) == 0)
-        {
-            // We set default AI value
-            if(nbSeatsHuman == 0)
-                ++nbSeatsHuman;
-            else
-                seat->setConfigPlayerId(Seat::aITypeToPlayerId(KeeperAIType::normal));
-        }
+        if(seat->getConfigFactionIndex() == -1)
+            seat->setConfigFactionIndex(0);
 
-        // Player team to first one available
         const std::vector<int>& availableTeamIds = seat->getAvailableTeamIds();
-        if(availableTeamIds.size() > 1)
+        if((seat->getConfigTeamId() == -1) && !availableTeamIds.empty())
             seat->setConfigTeamId(availableTeamIds.front());
     }
 
-    return true;
+    mServerState = ServerState::StateGame;
+    createSeatsPlayers();
+    for(Player* player : gameMap->getPlayers())
+        player->getSeat()->setMapSize(gameMap->getMapSizeX(), gameMap->getMapSizeY());
+
+    for(Seat* seat : gameMap->getSeats())
+        seat->initSeat();
+
+    mSeatsConfigured = true;
+    gameMap->notifySeatsConfigured();
+    gameMap->setAITurnBudget(BENCHMARK_AI_TURN_BUDGET_TILES);
+
+    // There is no client so turns are computed back to back. Notifications are dropped
+    // when they are queued because the server is not connected
+    Random::StreamScope randomScope(Random::Stream::simulation);
+    launchGame();
+
+    SimulationBenchmark benchmark(levelFilename, randomSeed);
+    mBenchmark = &benchmark;
+    double turnLengthMs = 1000.0 / ODApplication::turnsPerSecond;
+    for(uint32_t i = 0; i < nbTurns; ++i)
+    {
+        sf::Clock turnClock;
+        startNewTurn(turnLengthMs * 0.95 / 1000.0);
+
+        sf::Clock notificationsClock;
+        processServerNotifications();
+        addMetricsPhase("notifications", notificationsClock);
+
+        benchmark.addTurnDuration(static_cast<double>(turnClock.getElapsedTime().asMicroseconds()) / 1000000.0);
+    }
+    mBenchmark = nullptr;
+
+    benchmark.setNbPathQueries(gameMap->getNbCallsToPath());
+    benchmark.setNbCreatures(static_cast<uint32_t>(gameMap->getCreatures().size()));
+    StateHash stateHash;
+    gameMap->fillStateHash(stateHash);
+    benchmark.setStateHash(stateHash.getHash());
+    benchmark.setPeakMemoryBytes(SimulationBenchmark::getProcessPeakMemoryBytes());
+    OD_LOG_INF("Benchmark done: " + Helper::toString(benchmark.getNbTurns()) + " turns in "
+        + Helper::toString(benchmark.getTotalSeconds()) + "s");
+
+    bool isWritten = benchmark.writeToFile(resultFileName);
+    if(!isWritten)
+        OD_LOG_ERR("Could not write benchmark results in " + resultFileName);
+
+    stopServer();
+    return isWritten;
 }
 
 void ODServer::queueServerNotification(ServerNotification* n)
@@ -281,7 +428,10 @@ void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std:
         return;
     }
 
-    if(mConsoleInterface.tryExecuteServerCommand(args, *gameMap) != Command::Result::SUCCESS)
+    mConsoleCommandPlayer = player;
+    Command::Result result = mConsoleInterface.tryExecuteServerCommand(args, *gameMap);
+    mConsoleCommandPlayer = nullptr;
+    if(result != Command::Result::SUCCESS)
     {
         std::string msg = "Cannot execute console command";
         for(const std::string& str : args)
@@ -301,19 +451,22 @@ void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std:
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
-void ODServer::startNewTurn(double timeSinceLastTurn)
+bool ODServer::startNewTurn(double timeSinceLastTurn)
 {
     GameMap* gameMap = mGameMap;
     int64_t turn = gameMap->getTurnNumber();
 
-    // We wait until every client acknowledge the turn to start the next one. This way, we ensure
-    // synchronisation is not too bad
+    // We wait until every client is at most mMaxTurnsInFlight turns late. This way, we ensure
+    // synchronisation is not too bad without having every client wait for the slowest one
+    // on every turn
     for (ODSocketClient* client : mSockClients)
     {
-        if(client->getLastTurnAck() != turn)
-            return;
+        if(turn - client->getLastTurnAck() >= static_cast<int64_t>(mMaxTurnsInFlight))
+            return false;
     }
 
+    OD_PROFILE_ZONE("Server turn");
+    sf::Clock phaseClock;
     gameMap->setTurnNumber(++turn);
 
     ServerNotification* serverNotification = new ServerNotification(
@@ -321,10 +474,27 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
     serverNotification->mPacket << turn;
     queueServerNotification(serverNotification);
 
+    // When a client receives the turn, it has processed everything sent before. We keep the hash of
+    // what was notified to it to compare with the one it will send back with the acknowledgement
+    for (ODSocketClient* client : mSockClients)
+    {
+        // Clients still being configured have no player or seat yet
+        Player* player = client->getPlayer();
+        if((player == nullptr) || (player->getSeat() == nullptr))
+            continue;
+
+        Seat* seat = player->getSeat();
+        StateHash& stateHash = seat->getStateHash();
+        gameMap->fillStateHashCreatures(stateHash, seat);
+        client->getDesyncDetector().turnSent(turn, stateHash);
+    }
+    addMetricsPhase("state_hash", phaseClock);
+
     if(mServerMode == ServerMode::ModeEditor)
         gameMap->updateVisibleEntities();
 
     gameMap->updateAnimations(timeSinceLastTurn);
+    addMetricsPhase("animations", phaseClock);
 
     // We notify the clients about what they got
     for (ODSocketClient* sock : mSockClients)
@@ -363,8 +533,10 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
             }
         }
     }
+    addMetricsPhase("player_refresh", phaseClock);
 
     gameMap->updateVisibleEntities();
+    addMetricsPhase("visible_entities", phaseClock);
     switch(mServerMode)
     {
         case ServerMode::ModeGameSinglePlayer:
@@ -372,7 +544,9 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
         case ServerMode::ModeGameLoaded:
         {
             gameMap->doTurn(timeSinceLastTurn);
+            addMetricsPhase("upkeep", phaseClock);
             gameMap->doPlayerAITurn(timeSinceLastTurn);
+            addMetricsPhase("ai", phaseClock);
             break;
         }
         case ServerMode::ModeEditor:
@@ -388,19 +562,232 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
 
     gameMap->fireRefreshEntities();
     gameMap->processDeletionQueues();
+    addMetricsPhase("refresh_entities", phaseClock);
+    return true;
+}
+
+void ODServer::checkClientStateHash(ODSocketClient* clientSocket, int64_t turn, uint64_t stateHash)
+{
+    DesyncDetector& desyncDetector = clientSocket->getDesyncDetector();
+    const std::string& nick = clientSocket->getPlayer()->getNick();
+    switch(desyncDetector.turnAcknowledged(turn, stateHash))
+    {
+        case DesyncDetector::Result::desyncStarted:
+        {
+            // The client will process the request before the next turn. It will send its state with
+            // the acknowledgement of this turn
+            int64_t reportTurn = mGameMap->getTurnNumber() + 1;
+            OD_LOG_WRN("Desync detected with player=" + nick + " at turn=" + Helper::toString(turn)
+                + ", asking the state of turn=" + Helper::toString(reportTurn));
+            desyncDetector.askReport(reportTurn);
+            ServerNotification* serverNotification = new ServerNotification(
+                ServerNotificationType::askStateHashReport, clientSocket->getPlayer());
+            queueServerNotification(serverNotification);
+            break;
+        }
+        case DesyncDetector::Result::resynced:
+            OD_LOG_INF("Player=" + nick + " is in sync again at turn=" + Helper::toString(turn));
+            break;
+        default:
+            break;
+    }
+}
+
+void ODServer::checkClientStateReport(ODSocketClient* clientSocket, int64_t turn, ODPacket& packetReceived)
+{
+    // This should read the state as sent by ODClient::exportStateHashReport
+    StateHash clientState;
+    uint32_t nbTiles;
+    OD_ASSERT_TRUE(packetReceived >> nbTiles);
+    while(nbTiles > 0)
+    {
+        --nbTiles;
+        int32_t x;
+        int32_t y;
+        uint64_t value;
+        OD_ASSERT_TRUE(packetReceived >> x >> y >> value);
+        clientState.setTile(x, y, value);
+    }
+    uint32_t nbEntities;
+    OD_ASSERT_TRUE(packetReceived >> nbEntities);
+    while(nbEntities > 0)
+    {
+        --nbEntities;
+        std::string name;
+        uint64_t value;
+        OD_ASSERT_TRUE(packetReceived >> name >> value);
+        clientState.setEntity(name, value);
+    }
+
+    const std::string& nick = clientSocket->getPlayer()->getNick();
+    std::string difference;
+    if(!clientSocket->getDesyncDetector().checkReport(turn, clientState, difference))
+    {
+        OD_LOG_ERR("Unexpected state report from player=" + nick + " at turn=" + Helper::toString(turn));
+        return;
+    }
+
+    if(difference.empty())
+    {
+        OD_LOG_INF("State reported by player=" + nick + " at turn=" + Helper::toString(turn)
+            + " is the same as the server one");
+        return;
+    }
+
+    OD_LOG_WRN("State reported by player=" + nick + " at turn=" + Helper::toString(turn)
+        + " first differs on " + difference);
+}
+
+void ODServer::logTurnPacing()
+{
+    if((mTurnScheduler.getNbTurns() % TURN_PACING_LOG_PERIOD) != 0)
+        return;
+
+    uint64_t nbOverruns = mTurnScheduler.getNbOverruns() - mNbOverrunsLogged;
+    uint64_t nbTurnsDelayed = mTurnScheduler.getNbTurnsDelayed() - mNbTurnsDelayedLogged;
+    mNbOverrunsLogged = mTurnScheduler.getNbOverruns();
+    mNbTurnsDelayedLogged = mTurnScheduler.getNbTurnsDelayed();
+    if((nbOverruns == 0) && (nbTurnsDelayed == 0))
+        return;
+
+    OD_LOG_WRN("Turn pacing: " + Helper::toString(nbOverruns) + " overruns and "
+        + Helper::toString(nbTurnsDelayed) + " delayed turns during the last "
+        + Helper::toString(TURN_PACING_LOG_PERIOD) + " turns, max turn duration="
+        + Helper::toString(mTurnScheduler.getMaxTurnDurationMs()) + "ms, turn length="
+        + Helper::toString(mTurnScheduler.getTurnLengthMs()) + "ms, dropped time="
+        + Helper::toString(mTurnScheduler.getDroppedTimeMs()) + "ms");
+}
+
+std::string ODServer::consoleGetTurnPacingStats(bool reset)
+{
+    const TurnScheduler& scheduler = mTurnScheduler;
+    double averageMs = (scheduler.getNbTurns() == 0) ? 0.0
+        : scheduler.getTotalTurnDurationMs() / static_cast<double>(scheduler.getNbTurns());
+    std::string stats = "Turn length: " + Helper::toString(scheduler.getTurnLengthMs()) + " ms"
+        + "\nTurns: " + Helper::toString(scheduler.getNbTurns())
+        + "\nAverage turn duration: " + Helper::toString(averageMs) + " ms"
+        + "\nMax turn duration: " + Helper::toString(scheduler.getMaxTurnDurationMs()) + " ms"
+        + "\nOverruns: " + Helper::toString(scheduler.getNbOverruns())
+        + "\nCatch up turns: " + Helper::toString(scheduler.getNbCatchUpTurns())
+        + "\nTurns delayed by late clients: " + Helper::toString(scheduler.getNbTurnsDelayed())
+        + "\nDropped time: " + Helper::toString(scheduler.getDroppedTimeMs()) + " ms"
+        + "\nMax turns in flight: " + Helper::toString(mMaxTurnsInFlight);
+
+    int64_t turn = mGameMap->getTurnNumber();
+    for(ODSocketClient* client : mSockClients)
+    {
+        if(client->getPlayer() == nullptr)
+            continue;
+
+        stats += "\n" + client->getPlayer()->getNick() + " is "
+            + Helper::toString(turn - client->getLastTurnAck()) + " turns late";
+    }
+
+    if(reset)
+    {
+        mTurnScheduler.resetStats();
+        mNbOverrunsLogged = 0;
+        mNbTurnsDelayedLogged = 0;
+    }
+
+    return stats + "\n";
+}
+
+void ODServer::consoleSetMaxTurnsInFlight(uint32_t maxTurnsInFlight)
+{
+    mMaxTurnsInFlight = std::max(maxTurnsInFlight, 1u);
+}
+
+void ODServer::addMetricsPhase(const char* phase, sf::Clock& clock)
+{
+    if((mMetrics == nullptr) && (mBenchmark == nullptr))
+        return;
+
+    double seconds = clock.restart().asSeconds();
+    if(mMetrics != nullptr)
+        mMetrics->addPhaseDuration(phase, seconds);
+    if(mBenchmark != nullptr)
+        mBenchmark->addPhaseDuration(phase, seconds);
+}
+
+void ODServer::updateMetrics(double turnDurationSeconds, double turnLengthMs)
+{
+    // Metrics are written about once per second
+    const double metricsWritePeriodMs = 1000.0;
+
+    GameMap* gameMap = mGameMap;
+    int64_t turn = gameMap->getTurnNumber();
+    mMetrics->addTurnDuration(turnDurationSeconds);
+    mMetrics->setTurnNumber(turn);
+    mMetrics->setNbCreatures(static_cast<uint32_t>(gameMap->getCreatures().size()));
+    mMetrics->setNbActiveEntities(gameMap->getNbActiveObjects());
+    mMetrics->setNbPathQueries(gameMap->getNbCallsToPath());
+    for(ODSocketClient* client : mSockClients)
+    {
+        if(client->getPlayer() == nullptr)
+            continue;
+
+        mMetrics->setClient(client->getPlayer()->getNick(), client->getNbBytesSent(),
+            turn - client->getLastTurnAck());
+    }
+    mMetrics->removeClientsNotUpdated();
+
+    mMetricsWriteTime += turnLengthMs;
+    if(mMetricsWriteTime < metricsWritePeriodMs)
+        return;
+
+    mMetricsWriteTime = 0.0;
+    if(!mMetrics->writeToFile(mMetricsFileName))
+        OD_LOG_WRN("Could not write metrics file " + mMetricsFileName);
+}
+
+void ODServer::setRandomSeed(uint64_t seed)
+{
+    mRandomSeed = seed;
+}
+
+void ODServer::setMetricsFile(const std::string& fileName)
+{
+    mMetricsFileName = fileName;
+    mMetricsWriteTime = 0.0;
+    if(fileName.empty())
+    {
+        mMetrics.reset();
+        return;
+    }
+
+    mMetrics.reset(new ServerMetrics);
+    OD_LOG_INF("Server metrics will be written in " + fileName);
 }
 
 void ODServer::serverThread()
 {
+    Profiler::setThreadName("Server");
+    Random::setThreadStream(Random::Stream::simulation);
     GameMap* gameMap = mGameMap;
     sf::Clock clock;
     double turnLengthMs = 1000.0 / ODApplication::turnsPerSecond;
+    mTurnScheduler.reset(turnLengthMs);
+    mNbOverrunsLogged = 0;
+    mNbTurnsDelayedLogged = 0;
+    bool isWaitingForClients = false;
     bool isClientConnected = true;
     while(isConnected() && isClientConnected)
     {
-        // doTask should return after the length of 1 turn even if their are communications. When
-        // it returns, we can launch next turn.
-        doTask(static_cast<int32_t>(turnLengthMs));
+        // doTask should return when the next turn is due even if their are communications. When
+        // it returns, we can launch the due turns.
+        // If a turn is due but a client is too late, we wait for its messages (at most a turn length)
+        // instead of polling the sockets until it acknowledges the turns
+        if(isWaitingForClients)
+        {
+            doTask(static_cast<int32_t>(std::ceil(turnLengthMs)), true);
+        }
+        else
+        {
+            int32_t timeoutMs = static_cast<int32_t>(std::ceil(mTurnScheduler.getTimeUntilNextTurnMs()));
+            doTask(std::max(1, timeoutMs));
+        }
+        double elapsedMs = static_cast<double>(clock.restart().asMicroseconds()) / 1000.0;
         // If all the clients are disconnected during a game, we close the server
         if((mServerState == ServerState::StateGame) &&
            (mSockClients.empty()))
@@ -422,76 +809,14 @@ void ODServer::serverThread()
                     MasterServer::updateGame(mMasterServerGameId, MASTER_SERVER_STATUS_STARTED);
                 }
 
-                // We configure the game for launching
-                const std::vector<Seat*>& seats = gameMap->getSeats();
-                for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                {
-                    for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                    {
-                        Tile* tile = gameMap->getTile(ii,jj);
-                        tile->setSeats(seats);
-                    }
-                }
-
-                // We set allied seats
-                for(Seat* seat : seats)
-                {
-                    for(Seat* alliedSeat : seats)
-                    {
-                        if(alliedSeat == seat)
-                            continue;
-                        if(!seat->isAlliedSeat(alliedSeat))
-                            continue;
-                        seat->addAlliedSeat(alliedSeat);
-                    }
-                }
-
-                // Every client is connected and ready, we can launch the game
-                // Send turn 0 to init the map
-                ServerNotification* serverNotification = new ServerNotification(
-                    ServerNotificationType::turnStarted, nullptr);
-                serverNotification->mPacket << static_cast<int64_t>(0);
-                queueServerNotification(serverNotification);
-
-                OD_LOG_INF("Server ready, starting game");
-                gameMap->setTurnNumber(0);
-                gameMap->setGamePaused(false);
-
-                // In editor mode, we give vision on all the gamemap tiles
-                if(mServerMode == ServerMode::ModeEditor)
-                {
-                    for (Seat* seat : gameMap->getSeats())
-                    {
-                        for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                        {
-                            for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                            {
-                                gameMap->getTile(ii,jj)->notifyVision(seat);
-                            }
-                        }
-
-                        seat->sendVisibleTiles();
-                    }
-                }
-
-                gameMap->createAllEntities();
-
-                // Fill starting gold
-                for(Seat* seat : gameMap->getSeats())
-                {
-                    if(seat->getPlayer() == nullptr)
-                        continue;
-
-                    if(seat->getGold() > 0)
-                        gameMap->addGoldToSeat(seat->getGold(), seat->getId());
-                }
+                launchGame();
             }
             else
             {
                 // We are still waiting for players
                 if(!mMasterServerGameId.empty())
                 {
-                    mMasterServerGameStatusUpdateTime += turnLengthMs;
+                    mMasterServerGameStatusUpdateTime += elapsedMs;
                     if(mMasterServerGameStatusUpdateTime >= MASTER_SERVER_UPDATE_PERIOD_MS)
                     {
                         mMasterServerGameStatusUpdateTime = 0.0;
@@ -510,9 +835,42 @@ void ODServer::serverThread()
         // to wait for server. If server is in advance, he might send commands before the
         // creatures arrive at their destination. That could result in weird issues like
         // creatures going through walls.
-        startNewTurn(static_cast<double>(clock.restart().asSeconds()) * 0.95);
+        // Turns use a fixed timestep. If the server is late (long turns or late clients), the
+        // due turns are started back to back (at most MAX_CATCH_UP_TURNS).
+        mTurnScheduler.addElapsedTime(elapsedMs);
+        bool isTurnStarted = false;
+        while(mTurnScheduler.isTurnDue())
+        {
+            sf::Clock turnClock;
+            if(!startNewTurn(turnLengthMs * 0.95 / 1000.0))
+            {
+                // A client is too late. We will try again after processing its messages
+                if(!isWaitingForClients)
+                    mTurnScheduler.turnDelayed();
 
-        processServerNotifications();
+                isWaitingForClients = true;
+                break;
+            }
+            isWaitingForClients = false;
+            isTurnStarted = true;
+
+            if(mMetrics != nullptr)
+                mMetrics->setNotificationQueueDepth(static_cast<uint32_t>(mServerNotificationQueue.size()));
+
+            sf::Clock notificationsClock;
+            processServerNotifications();
+            addMetricsPhase("notifications", notificationsClock);
+
+            double turnDurationMs = static_cast<double>(turnClock.getElapsedTime().asMicroseconds()) / 1000.0;
+            mTurnScheduler.turnDone(turnDurationMs);
+            logTurnPacing();
+            if(mMetrics != nullptr)
+                updateMetrics(turnDurationMs / 1000.0, turnLengthMs);
+        }
+
+        // Notifications queued while processing the client messages
+        if(!isTurnStarted)
+            processServerNotifications();
     }
 
     if(!mMasterServerGameId.empty())
@@ -522,8 +880,76 @@ void ODServer::serverThread()
     }
 }
 
+void ODServer::launchGame()
+{
+    GameMap* gameMap = mGameMap;
+    const std::vector<Seat*>& seats = gameMap->getSeats();
+    for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+    {
+        for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+        {
+            Tile* tile = gameMap->getTile(ii,jj);
+            tile->setSeats(seats);
+        }
+    }
+
+    // We set allied seats
+    for(Seat* seat : seats)
+    {
+        for(Seat* alliedSeat : seats)
+        {
+            if(alliedSeat == seat)
+                continue;
+            if(!seat->isAlliedSeat(alliedSeat))
+                continue;
+            seat->addAlliedSeat(alliedSeat);
+        }
+    }
+
+    // Every client is connected and ready, we can launch the game
+    // Send turn 0 to init the map
+    ServerNotification* serverNotification = new ServerNotification(
+        ServerNotificationType::turnStarted, nullptr);
+    serverNotification->mPacket << static_cast<int64_t>(0);
+    queueServerNotification(serverNotification);
+
+    OD_LOG_INF("Server ready, starting game");
+    gameMap->setTurnNumber(0);
+    gameMap->setGamePaused(false);
+
+    // In editor mode, we give vision on all the gamemap tiles
+    if(mServerMode == ServerMode::ModeEditor)
+    {
+        for (Seat* seat : gameMap->getSeats())
+        {
+            for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+            {
+                for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+                {
+                    gameMap->getTile(ii,jj)->notifyVision(seat);
+                }
+            }
+
+            seat->sendVisibleTiles();
+        }
+    }
+
+    gameMap->createAllEntities();
+
+    // Fill starting gold
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->getPlayer() == nullptr)
+            continue;
+
+        if(seat->getGold() > 0)
+            gameMap->addGoldToSeat(seat->getGold(), seat->getId());
+    }
+}
+
 void ODServer::processServerNotifications()
 {
+    OD_PROFILE_ZONE("Send notifications");
     GameMap* gameMap = mGameMap;
 
     bool running = true;
@@ -586,6 +1012,66 @@ void ODServer::processServerNotifications()
     }
 }
 
+void ODServer::createSeatsPlayers()
+{
+    GameMap* gameMap = mGameMap;
+    const std::vector<std::string>& factions = ConfigManager::getSingleton().getFactions();
+    for(Seat* seat : gameMap->getSeats())
+    {
+        // Rogue seat do not have to be configured
+        if(seat->isRogueSeat())
+            continue;
+
+        seat->setFaction(factions[seat->getConfigFactionIndex()]);
+
+        int seatId = seat->getId();
+        int32_t playerId = seat->getConfigPlayerId();
+        if(playerId == Seat::PLAYER_TYPE_INACTIVE_ID)
+        {
+            // It is an inactive player
+            Player* inactivePlayer = new Player(gameMap, 0);
+            inactivePlayer->setNick("Inactive AI " + Helper::toString(seatId));
+            gameMap->addPlayer(inactivePlayer);
+            seat->setPlayer(inactivePlayer);
+        }
+        else if(playerId < Seat::PLAYER_ID_HUMAN_MIN)
+        {
+            // It is an AI
+            KeeperAIType aiType = Seat::playerIdToAIType(playerId);
+            if(aiType >= KeeperAIType::nbAI)
+            {
+                OD_LOG_ERR("Wrong value for keeper seatId=" + Helper::toString(seat->getId())
+                    + ", ConfigPlayerId=" + Helper::toString(playerId));
+
+                // Default to normal
+                aiType = KeeperAIType::normal;
+            }
+            // We set player id = 0 for AI players. ID is only used during seat configuration phase
+            // During the game, one should use the seat ID to identify a player
+            Player* aiPlayer = new Player(gameMap, 0);
+            aiPlayer->setNick("Keeper AI " + KeeperAITypes::toString(aiType) + " " + Helper::toString(seatId));
+            gameMap->addPlayer(aiPlayer);
+            seat->setPlayer(aiPlayer);
+            gameMap->assignAI(*aiPlayer, aiType);
+        }
+        else
+        {
+            // Human player
+            for (ODSocketClient* client : mSockClients)
+            {
+                if((client->getState().compare("ready") == 0) &&
+                   (client->getPlayer()->getId() == seat->getConfigPlayerId()))
+                {
+                    seat->setPlayer(client->getPlayer());
+                    gameMap->addPlayer(client->getPlayer());
+                    break;
+                }
+            }
+        }
+        seat->setTeamId(seat->getConfigTeamId());
+    }
+}
+
 bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 {
     if (!clientSocket)
@@ -1007,61 +1493,7 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 
             mServerState = ServerState::StateGame;
 
-            const std::vector<std::string>& factions = ConfigManager::getSingleton().getFactions();
-            for(Seat* seat : gameMap->getSeats())
-            {
-                // Rogue seat do not have to be configured
-                if(seat->isRogueSeat())
-                    continue;
-
-                seat->setFaction(factions[seat->getConfigFactionIndex()]);
-
-                int seatId = seat->getId();
-                int32_t playerId = seat->getConfigPlayerId();
-                if(playerId == Seat::PLAYER_TYPE_INACTIVE_ID)
-                {
-                    // It is an inactive player
-                    Player* inactivePlayer = new Player(gameMap, 0);
-                    inactivePlayer->setNick("Inactive AI " + Helper::toString(seatId));
-                    gameMap->addPlayer(inactivePlayer);
-                    seat->setPlayer(inactivePlayer);
-                }
-                else if(playerId < Seat::PLAYER_ID_HUMAN_MIN)
-                {
-                    // It is an AI
-                    KeeperAIType aiType = Seat::playerIdToAIType(playerId);
-                    if(aiType >= KeeperAIType::nbAI)
-                    {
-                        OD_LOG_ERR("Wrong value for keeper seatId=" + Helper::toString(seat->getId())
-                            + ", ConfigPlayerId=" + Helper::toString(playerId));
-
-                        // Default to normal
-                        aiType = KeeperAIType::normal;
-                    }
-                    // We set player id = 0 for AI players. ID is only used during seat configuration phase
-                    // During the game, one should use the seat ID to identify a player
-                    Player* aiPlayer = new Player(gameMap, 0);
-                    aiPlayer->setNick("Keeper AI " + KeeperAITypes::toString(aiType) + " " + Helper::toString(seatId));
-                    gameMap->addPlayer(aiPlayer);
-                    seat->setPlayer(aiPlayer);
-                    gameMap->assignAI(*aiPlayer, aiType);
-                }
-                else
-                {
-                    // Human player
-                    for (ODSocketClient* client : mSockClients)
-                    {
-                        if((client->getState().compare("ready") == 0) &&
-                           (client->getPlayer()->getId() == seat->getConfigPlayerId()))
-                        {
-                            seat->setPlayer(client->getPlayer());
-                            gameMap->addPlayer(client->getPlayer());
-                            break;
-                        }
-                    }
-                }
-                seat->setTeamId(seat->getConfigTeamId());
-            }
+            createSeatsPlayers();
 
             // Now, we can disconnect the players that were not configured
             std::vector<ODSocketClient*> clientsToRemove;
@@ -1413,8 +1845,13 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
         case ClientNotificationType::ackNewTurn:
         {
             int64_t turn;
-            OD_ASSERT_TRUE(packetReceived >> turn);
+            uint64_t stateHash;
+            bool hasStateReport;
+            OD_ASSERT_TRUE(packetReceived >> turn >> stateHash >> hasStateReport);
             clientSocket->setLastTurnAck(turn);
+            checkClientStateHash(clientSocket, turn, stateHash);
+            if(hasStateReport)
+                checkClientStateReport(clientSocket, turn, packetReceived);
             break;
         }
 
@@ -2026,6 +2463,15 @@ int32_t ODServer::getNetworkPort() const
 void ODServer::printConsoleMsg(const std::string& text)
 {
     OD_LOG_INF("Console:" + text);
+
+    // We forward the output to the client that sent the command so that it is displayed in its console
+    if(mConsoleCommandPlayer == nullptr)
+        return;
+
+    ServerNotification *serverNotification = new ServerNotification(
+        ServerNotificationType::consoleMessage, mConsoleCommandPlayer);
+    serverNotification->mPacket << text;
+    queueServerNotification(serverNotification);
 }
 
 ODPacket& operator<<(ODPacket& os, const EventShortNoticeType& type)
@@ -20,10 +20,15 @@
 
 #include "ODSocketServer.h"
 #include "modes/ConsoleInterface.h"
+#include "network/TurnScheduler.h"
 
 #include <OgreSingleton.h>
 
+#include <memory>
+
 class ServerNotification;
+class ServerMetrics;
+class SimulationBenchmark;
 class GameMap;
 
 enum class ServerMode;
@@ -77,6 +82,13 @@ class ODServer: public Ogre::Singleton<ODServer>,
     bool startServer(const std::string& creator, const std::string& levelFilename, ServerMode mode, bool useMasterServer);
     void stopServer() override;
 
+    //! \brief Runs the given level without network to measure the simulation speed: every seat
+    //! is played by a normal keeper AI and nbTurns turns are computed back to back, without
+    //! waiting for the turn timer. The results are written in JSON in the given file (on the
+    //! standard output if empty). Should be called instead of startServer. Returns false if
+    //! the level could not be loaded or the results could not be written
+    bool runBenchmark(const std::string& levelFilename, uint32_t nbTurns, const std::string& resultFileName);
+
     //! \brief Adds a server notification to the server notification queue. The message will be sent to the concerned player
     void queueServerNotification(ServerNotification* n);
 
@@ -95,6 +107,23 @@ class ODServer: public Ogre::Singleton<ODServer>,
 
     int32_t getNetworkPort() const;
 
+    //! \brief Enables the export of the turn metrics. They will be periodically written in the given
+    //! file in the Prometheus text format. Should be called before starting the server
+    void setMetricsFile(const std::string& fileName);
+
+    //! \brief Sets the seed of the simulation random numbers. A game started with the same seed and
+    //! the same player commands plays the same way. If 0 (default), a new seed is used for each
+    //! game. Should be called before starting the server
+    void setRandomSeed(uint64_t seed);
+
+    //! \brief Returns the turn pacing statistics (overruns, catch up, late clients) as a string
+    //! for the console. Must be called from the server thread
+    std::string consoleGetTurnPacingStats(bool reset);
+
+    //! \brief Sets how many turns can be started without being acknowledged by a client.
+    //! 1 means that every client has to acknowledge a turn before the next one is started
+    void consoleSetMaxTurnsInFlight(uint32_t maxTurnsInFlight);
+
 protected:
     ODSocketClient* notifyNewConnection(sf::TcpListener& sockListener) override;
     bool notifyClientMessage(ODSocketClient *sock) override;
@@ -119,13 +148,63 @@ private:
     std::string mMasterServerGameId;
     double mMasterServerGameStatusUpdateTime;
 
+    //! \brief Turn metrics. Only allocated if enabled with setMetricsFile
+    std::unique_ptr<ServerMetrics> mMetrics;
+    std::string mMetricsFileName;
+    double mMetricsWriteTime;
+
+    //! \brief Results of the benchmark. Only set while runBenchmark is running
+    SimulationBenchmark* mBenchmark;
+
+    //! \brief Player who sent the console command being executed. Only set while the command
+    //! is executed. The console output is only sent to this player
+    Player* mConsoleCommandPlayer;
+
+    //! \brief Seed given by setRandomSeed
+    uint64_t mRandomSeed;
+
+    //! \brief Decides when turns are started. Only used from the server thread
+    TurnScheduler mTurnScheduler;
+    //! \brief Number of turns a client can be late before the server waits for it
+    uint32_t mMaxTurnsInFlight;
+    //! \brief Overruns and delayed turns since the last pacing log
+    uint64_t mNbOverrunsLogged;
+    uint64_t mNbTurnsDelayedLogged;
+
     void printConsoleMsg(const std::string& text);
 
     ODSocketClient* getClientFromPlayer(Player* player);
     ODSocketClient* getClientFromPlayerId(int32_t playerId);
 
-    //! \brief Called when a new turn started.
-    void startNewTurn(double timeSinceLastTurn);
+    //! \brief Seeds the server random numbers and loads the level. Returns false if the level
+    //! could not be loaded
+    bool loadServerLevel(const std::string& levelFilename, uint64_t randomSeed);
+
+    //! \brief Configures what is fixed by the level in the seats (AI, faction or team).
+    //! Returns the number of seats that can only be played by a human
+    uint32_t configureFixedSeats();
+
+    //! \brief Creates the players of the configured seats. Human players are taken from the
+    //! ready clients
+    void createSeatsPlayers();
+
+    //! \brief Once the seats are configured, sets up the gamemap for turn 0
+    void launchGame();
+
+    //! \brief Starts a new turn if no client is more than mMaxTurnsInFlight turns late.
+    //! Returns true if the turn was started
+    bool startNewTurn(double timeSinceLastTurn);
+
+    //! \brief Logs a summary of the turn overruns and delayed turns if there were some
+    void logTurnPacing();
+
+    //! \brief Compares the state hash sent by the client with a turn acknowledgement with the server
+    //! one. When a desync starts, the client is asked to report its whole state
+    void checkClientStateHash(ODSocketClient* clientSocket, int64_t turn, uint64_t stateHash);
+
+    //! \brief Reads the state reported by the client with a turn acknowledgement and logs the first
+    //! tile or creature that differs from the server state
+    void checkClientStateReport(ODSocketClient* clientSocket, int64_t turn, ODPacket& packetReceived);
 
     /*! \brief Monitors mServerNotificationQueue for new events and informs the clients about them.
      *
@@ -136,6 +215,13 @@ private:
      */
     void processServerNotifications();
 
+    //! \brief If the metrics or the benchmark are enabled, adds the time since the last call (or
+    //! since the clock was restarted) to the given phase and restarts the clock
+    void addMetricsPhase(const char* phase, sf::Clock& clock);
+
+    //! \brief Updates the metrics after a turn and writes them if needed
+    void updateMetrics(double turnDurationSeconds, double turnLengthMs);
+
     /*! \brief The function running in server-mode which listens for messages from an individual, already connected, client.
      *
      * This function receives TCP packets one at a time from a connected client,
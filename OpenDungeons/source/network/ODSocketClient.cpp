@@ -25,6 +25,11 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 
+const int32_t ODSocketClient::DEFAULT_MESSAGE_PROCESSING_BUDGET_MS = 8;
+
+//! \brief The receive thread waits for data with this timeout to regularly check if it should stop
+static const int32_t RECEIVE_WAIT_MS = 50;
+
 bool ODSocketClient::connect(const std::string& host, const int port, uint32_t timeout, const std::string& outputReplayFilename)
 {
     mSource = ODSource::none;
@@ -46,6 +51,10 @@ bool ODSocketClient::connect(const std::string& host, const int port, uint32_t t
     mReplayOutputStream.open(mOutputReplayFilename, std::ios::out | std::ios::binary);
     mGameClock.restart();
     mSource = ODSource::network;
+
+    mStopReceiving = false;
+    mReceiveThread = new sf::Thread(&ODSocketClient::receiveThread, this);
+    mReceiveThread->launch();
     return true;
 }
 
@@ -60,6 +69,8 @@ bool ODSocketClient::replay(const std::string& filename)
 
 void ODSocketClient::disconnect(bool keepReplay)
 {
+    // The receive thread uses the socket and the replay stream so we stop it first
+    stopReceiveThread();
     mPendingTimestamp = -1;
     ODSource src = mSource;
     mSource = ODSource::none;
@@ -142,7 +153,10 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
 
     sf::Socket::Status status = mSockClient.send(s.mPacket);
     if (status == sf::Socket::Done)
+    {
+        mNbBytesSent += s.mPacket.getDataSize();
         return ODComStatus::OK;
+    }
 
     OD_LOG_ERR("Could not send data from client status="
         + Helper::toString(status));
@@ -203,10 +217,90 @@ bool ODSocketClient::isConnected()
 
 void ODSocketClient::processClientSocketMessages()
 {
-    // If we receive message for a new turn, after processing every message,
-    // we will refresh what is needed
-    // We loop until no more data is available
-    while(isConnected() && processOneClientSocketMessage());
+    mNbMessagesProcessed = 0;
+    if(mReceiveThread == nullptr)
+    {
+        // Replays are read on the main thread. We loop until no more data is available
+        while(isConnected() && processOneClientSocketMessage())
+            ++mNbMessagesProcessed;
+
+        return;
+    }
+
+    // The messages are processed in the order they were received. A burst of messages (after
+    // a big dig for example) is spread over several frames instead of causing a hitch
+    sf::Clock clock;
+    while(isConnected())
+    {
+        if((mNbMessagesProcessed > 0) &&
+           (mMessageProcessingBudget != sf::Time::Zero) &&
+           (clock.getElapsedTime() >= mMessageProcessingBudget))
+        {
+            break;
+        }
+
+        ReceivedMessage message;
+        {
+            sf::Lock lock(mReceivedMessagesMutex);
+            if(mReceivedMessages.empty())
+                break;
+
+            message = mReceivedMessages.front();
+            mReceivedMessages.pop_front();
+        }
+
+        ++mNbMessagesProcessed;
+        if(message.mIsDisconnection)
+        {
+            playerDisconnected();
+            break;
+        }
+
+        if(!processMessage(message.mType, message.mPacket))
+            break;
+    }
+}
+
+uint32_t ODSocketClient::getNbPendingMessages()
+{
+    sf::Lock lock(mReceivedMessagesMutex);
+    return static_cast<uint32_t>(mReceivedMessages.size());
+}
+
+void ODSocketClient::receiveThread()
+{
+    while(!mStopReceiving)
+    {
+        if(!mSockSelector.wait(sf::milliseconds(RECEIVE_WAIT_MS)))
+            continue;
+
+        if(!mSockSelector.isReady(mSockClient))
+            continue;
+
+        ReceivedMessage message;
+        message.mIsDisconnection = (recv(message.mPacket) != ODComStatus::OK);
+        if(!message.mIsDisconnection)
+            OD_ASSERT_TRUE(message.mPacket >> message.mType);
+
+        sf::Lock lock(mReceivedMessagesMutex);
+        mReceivedMessages.push_back(message);
+        // If the connection is lost, there is nothing more to receive
+        if(message.mIsDisconnection)
+            return;
+    }
+}
+
+void ODSocketClient::stopReceiveThread()
+{
+    if(mReceiveThread == nullptr)
+        return;
+
+    mStopReceiving = true;
+    delete mReceiveThread; // Delete waits for the thread to finish
+    mReceiveThread = nullptr;
+
+    sf::Lock lock(mReceivedMessagesMutex);
+    mReceivedMessages.clear();
 }
 
 bool ODSocketClient::processOneClientSocketMessage()
@@ -18,10 +18,14 @@
 #ifndef ODSOCKETCLIENT_H
 #define ODSOCKETCLIENT_H
 
+#include "network/DesyncDetector.h"
 #include "network/ODPacket.h"
 
 #include <SFML/Network.hpp>
+#include <SFML/System.hpp>
 
+#include <atomic>
+#include <deque>
 #include <string>
 #include <cstdint>
 #include <fstream>
@@ -49,11 +53,19 @@ class ODSocketClient
             mSource(ODSource::none),
             mPlayer(nullptr),
             mLastTurnAck(-1),
-            mPendingTimestamp(-1)
+            mPendingTimestamp(-1),
+            mNbBytesSent(0),
+            mReceiveThread(nullptr),
+            mStopReceiving(false),
+            mMessageProcessingBudget(sf::milliseconds(DEFAULT_MESSAGE_PROCESSING_BUDGET_MS)),
+            mNbMessagesProcessed(0)
         {}
 
         virtual ~ODSocketClient()
-        {}
+        { stopReceiveThread(); }
+
+        //! \brief Default time allowed to process server messages in processClientSocketMessages
+        static const int32_t DEFAULT_MESSAGE_PROCESSING_BUDGET_MS;
 
         // Client initialization
         bool isConnected();
@@ -61,14 +73,33 @@ class ODSocketClient
         //! \brief Disconnect the client and tell whether to keep the replay file.
         virtual void disconnect(bool keepReplay = false);
 
-        /*! \brief This function should be called periodically. It will
+        /*! \brief This function should be called periodically. It processes the messages
+         * received from the server. When connected to a server, the messages are received
+         * by a dedicated thread and this function only applies the pending ones until the
+         * processing budget is spent. The remaining messages are processed on the next call.
+         * Messages are always processed in the order they were received.
          */
         void processClientSocketMessages();
 
+        //! \brief Sets the maximum time processClientSocketMessages can spend processing messages.
+        //! At least one message is processed on each call. If budget is sf::Time::Zero, every
+        //! pending message is processed
+        void setMessageProcessingBudget(const sf::Time& budget)
+        { mMessageProcessingBudget = budget; }
+
+        //! \brief Number of messages received from the server and not processed yet
+        uint32_t getNbPendingMessages();
+
+        //! \brief Number of messages processed during the last call to processClientSocketMessages
+        inline uint32_t getNbMessagesProcessed() const
+        { return mNbMessagesProcessed; }
+
         Player* getPlayer() { return mPlayer; }
         void setPlayer(Player* player) { mPlayer = player; }
         int64_t getLastTurnAck() { return mLastTurnAck; }
         void setLastTurnAck(int64_t lastTurnAck) { mLastTurnAck = lastTurnAck; }
+        //! \brief Server side. Checks the state hashes sent by the client with the turn acknowledgements
+        DesyncDetector& getDesyncDetector() { return mDesyncDetector; }
         const std::string& getState() {return mState;}
         bool isDataAvailable();
         int32_t getGameTimeMillis()
@@ -90,6 +121,10 @@ class ODSocketClient
          */
         ODComStatus send(ODPacket& s);
 
+        //! \brief Number of bytes successfully sent through this socket
+        inline uint64_t getNbBytesSent() const
+        { return mNbBytesSent; }
+
         /*! \brief Receives a packet through the network
          * ODPacket should preserve integrity. That means that if an ODSocketClient
          * sends an ODPacket, the server should receive exactly 1 similar ODPacket (same data,
@@ -109,13 +144,28 @@ class ODSocketClient
         {}
 
     private :
+        //! \brief Message received from the server by the receive thread. If mIsDisconnection
+        //! is true, the connection was lost and there is no packet
+        struct ReceivedMessage
+        {
+            ServerNotificationType mType;
+            ODPacket mPacket;
+            bool mIsDisconnection;
+        };
+
         bool processOneClientSocketMessage();
 
+        //! \brief Function of the receive thread. It receives the packets from the server, writes
+        //! them in the replay and decodes their type before queuing them in mReceivedMessages
+        void receiveThread();
+        void stopReceiveThread();
+
         ODSource mSource;
         sf::SocketSelector mSockSelector;
         sf::TcpSocket mSockClient;
         Player* mPlayer;
         int64_t mLastTurnAck;
+        DesyncDetector mDesyncDetector;
         std::string mState;
 
         sf::Clock mGameClock;
@@ -123,10 +173,22 @@ class ODSocketClient
         std::ofstream mReplayOutputStream;
         ODPacket mPendingPacket;
         int32_t mPendingTimestamp;
+        uint64_t mNbBytesSent;
 
         //! \brief the replay filename being written. Used to later optionally delete it
         //! if asked to.
         std::string mOutputReplayFilename;
+
+        //! \brief Thread receiving the server messages. Only used when the source is the network
+        sf::Thread* mReceiveThread;
+        std::atomic<bool> mStopReceiving;
+        //! \brief Messages received by mReceiveThread and waiting to be processed. Protected
+        //! by mReceivedMessagesMutex
+        std::deque<ReceivedMessage> mReceivedMessages;
+        sf::Mutex mReceivedMessagesMutex;
+
+        sf::Time mMessageProcessingBudget;
+        uint32_t mNbMessagesProcessed;
 };
 
 #endif // ODSOCKETCLIENT_H
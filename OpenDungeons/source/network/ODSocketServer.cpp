@@ -63,7 +63,7 @@ bool ODSocketServer::isConnected()
     return mIsConnected;
 }
 
-void ODSocketServer::doTask(int timeoutMs)
+void ODSocketServer::doTask(int timeoutMs, bool returnOnMessage)
 {
     mClockMainTask.restart();
     while((timeoutMs == 0) ||
@@ -121,6 +121,9 @@ void ODSocketServer::doTask(int timeoutMs)
                 }
             }
         }
+
+        if(returnOnMessage)
+            return;
     }
 }
 
@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/ServerMetrics.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+const std::vector<double> ServerMetrics::TURN_DURATION_BUCKETS =
+    {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0};
+
+ServerMetrics::ServerMetrics() :
+    mTurnDurationBuckets(TURN_DURATION_BUCKETS.size() + 1, 0),
+    mNbTurns(0),
+    mTurnDurationSum(0.0),
+    mTurnNumber(-1),
+    mNbCreatures(0),
+    mNbActiveEntities(0),
+    mNbPathQueries(0),
+    mNotificationQueueDepth(0)
+{
+}
+
+void ServerMetrics::addTurnDuration(double seconds)
+{
+    // The last bucket is +Inf
+    uint32_t index = static_cast<uint32_t>(std::lower_bound(TURN_DURATION_BUCKETS.begin(),
+        TURN_DURATION_BUCKETS.end(), seconds) - TURN_DURATION_BUCKETS.begin());
+    ++mTurnDurationBuckets[index];
+    ++mNbTurns;
+    mTurnDurationSum += seconds;
+}
+
+void ServerMetrics::addPhaseDuration(const std::string& phase, double seconds)
+{
+    for(Phase& p : mPhases)
+    {
+        if(p.mName != phase)
+            continue;
+
+        p.mTotalSeconds += seconds;
+        return;
+    }
+
+    mPhases.push_back({phase, seconds});
+}
+
+void ServerMetrics::setClient(const std::string& nick, uint64_t bytesSent, int64_t turnAckLag)
+{
+    for(Client& client : mClients)
+    {
+        if(client.mNick != nick)
+            continue;
+
+        client.mBytesSent = bytesSent;
+        client.mTurnAckLag = turnAckLag;
+        client.mIsUpdated = true;
+        return;
+    }
+
+    mClients.push_back({nick, bytesSent, turnAckLag, true});
+}
+
+void ServerMetrics::removeClientsNotUpdated()
+{
+    mClients.erase(std::remove_if(mClients.begin(), mClients.end(),
+        [](const Client& client) { return !client.mIsUpdated; }), mClients.end());
+    for(Client& client : mClients)
+        client.mIsUpdated = false;
+}
+
+std::string ServerMetrics::escapeLabelValue(const std::string& value)
+{
+    std::string ret;
+    ret.reserve(value.size());
+    for(char c : value)
+    {
+        switch(c)
+        {
+            case '\\':
+                ret += "\\\\";
+                break;
+            case '"':
+                ret += "\\\"";
+                break;
+            case '\n':
+                ret += "\\n";
+                break;
+            default:
+                ret += c;
+                break;
+        }
+    }
+    return ret;
+}
+
+void ServerMetrics::write(std::ostream& os) const
+{
+    os << "# HELP od_server_turns_total Number of turns computed by the server.\n"
+       << "# TYPE od_server_turns_total counter\n"
+       << "od_server_turns_total " << mNbTurns << "\n";
+
+    os << "# HELP od_server_turn_duration_seconds Time spent computing a turn.\n"
+       << "# TYPE od_server_turn_duration_seconds histogram\n";
+    uint64_t cumulated = 0;
+    for(uint32_t i = 0; i < TURN_DURATION_BUCKETS.size(); ++i)
+    {
+        cumulated += mTurnDurationBuckets[i];
+        os << "od_server_turn_duration_seconds_bucket{le=\"" << TURN_DURATION_BUCKETS[i] << "\"} "
+           << cumulated << "\n";
+    }
+    os << "od_server_turn_duration_seconds_bucket{le=\"+Inf\"} " << mNbTurns << "\n"
+       << "od_server_turn_duration_seconds_sum " << mTurnDurationSum << "\n"
+       << "od_server_turn_duration_seconds_count " << mNbTurns << "\n";
+
+    os << "# HELP od_server_phase_seconds_total Time spent in each phase of the turns.\n"
+       << "# TYPE od_server_phase_seconds_total counter\n";
+    for(const Phase& phase : mPhases)
+    {
+        os << "od_server_phase_seconds_total{phase=\"" << escapeLabelValue(phase.mName) << "\"} "
+           << phase.mTotalSeconds << "\n";
+    }
+
+    os << "# HELP od_server_turn_number Current turn number.\n"
+       << "# TYPE od_server_turn_number gauge\n"
+       << "od_server_turn_number " << mTurnNumber << "\n";
+
+    os << "# HELP od_server_creatures Number of creatures on the map.\n"
+       << "# TYPE od_server_creatures gauge\n"
+       << "od_server_creatures " << mNbCreatures << "\n";
+
+    os << "# HELP od_server_active_entities Number of entities with an upkeep.\n"
+       << "# TYPE od_server_active_entities gauge\n"
+       << "od_server_active_entities " << mNbActiveEntities << "\n";
+
+    os << "# HELP od_server_path_queries_total Number of path finding queries.\n"
+       << "# TYPE od_server_path_queries_total counter\n"
+       << "od_server_path_queries_total " << mNbPathQueries << "\n";
+
+    os << "# HELP od_server_notification_queue_depth Notifications queued during the last turn.\n"
+       << "# TYPE od_server_notification_queue_depth gauge\n"
+       << "od_server_notification_queue_depth " << mNotificationQueueDepth << "\n";
+
+    os << "# HELP od_server_client_sent_bytes_total Bytes sent to each client.\n"
+       << "# TYPE od_server_client_sent_bytes_total counter\n";
+    for(const Client& client : mClients)
+    {
+        os << "od_server_client_sent_bytes_total{player=\"" << escapeLabelValue(client.mNick) << "\"} "
+           << client.mBytesSent << "\n";
+    }
+
+    os << "# HELP od_server_client_turn_ack_lag Turns not acknowledged yet by each client.\n"
+       << "# TYPE od_server_client_turn_ack_lag gauge\n";
+    for(const Client& client : mClients)
+    {
+        os << "od_server_client_turn_ack_lag{player=\"" << escapeLabelValue(client.mNick) << "\"} "
+           << client.mTurnAckLag << "\n";
+    }
+}
+
+bool ServerMetrics::writeToFile(const std::string& fileName) const
+{
+    std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream file(tmpFileName, std::ios::out | std::ios::trunc);
+        if(!file.is_open())
+            return false;
+
+        write(file);
+        if(!file.good())
+            return false;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpFileName, fileName, ec);
+    return !ec;
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVERMETRICS_H
+#define SERVERMETRICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*! \brief Metrics of the server turns. They are written in the Prometheus text exposition
+ * format so that a dedicated server can be monitored by pointing the node exporter
+ * textfile collector (or any other scraper) at the written file.
+ * This class only stores and formats the values. It is filled by ODServer from the
+ * server thread and is not thread safe.
+ */
+class ServerMetrics
+{
+public:
+    //! \brief Upper bounds (in seconds) of the turn duration histogram buckets
+    static const std::vector<double> TURN_DURATION_BUCKETS;
+
+    ServerMetrics();
+
+    //! \brief Adds a computed turn to the turn duration histogram
+    void addTurnDuration(double seconds);
+
+    //! \brief Adds the time spent in the given phase of the turn. Phases are written in
+    //! the order they were first added
+    void addPhaseDuration(const std::string& phase, double seconds);
+
+    inline void setTurnNumber(int64_t turnNumber)
+    { mTurnNumber = turnNumber; }
+
+    inline void setNbCreatures(uint32_t nbCreatures)
+    { mNbCreatures = nbCreatures; }
+
+    inline void setNbActiveEntities(uint32_t nbActiveEntities)
+    { mNbActiveEntities = nbActiveEntities; }
+
+    inline void setNbPathQueries(uint64_t nbPathQueries)
+    { mNbPathQueries = nbPathQueries; }
+
+    inline void setNotificationQueueDepth(uint32_t depth)
+    { mNotificationQueueDepth = depth; }
+
+    //! \brief Sets the values of the given client. Clients are identified by their nick
+    void setClient(const std::string& nick, uint64_t bytesSent, int64_t turnAckLag);
+
+    //! \brief Removes the clients that were not updated since the last call to this function
+    void removeClientsNotUpdated();
+
+    //! \brief Writes the metrics in the Prometheus text format
+    void write(std::ostream& os) const;
+
+    //! \brief Writes the metrics in the given file. The file is written in a temporary file
+    //! first and then renamed so that a reader never sees a partial file
+    bool writeToFile(const std::string& fileName) const;
+
+    //! \brief Escapes a Prometheus label value
+    static std::string escapeLabelValue(const std::string& value);
+
+private:
+    struct Phase
+    {
+        std::string mName;
+        double mTotalSeconds;
+    };
+
+    struct Client
+    {
+        std::string mNick;
+        uint64_t mBytesSent;
+        int64_t mTurnAckLag;
+        bool mIsUpdated;
+    };
+
+    //! Number of turns per bucket (not cumulative)
+    std::vector<uint64_t> mTurnDurationBuckets;
+    uint64_t mNbTurns;
+    double mTurnDurationSum;
+
+    std::vector<Phase> mPhases;
+    std::vector<Client> mClients;
+
+    int64_t mTurnNumber;
+    uint32_t mNbCreatures;
+    uint32_t mNbActiveEntities;
+    uint64_t mNbPathQueries;
+    uint32_t mNotificationQueueDepth;
+};
+
+#endif // SERVERMETRICS_H
@@ -114,6 +114,10 @@ std::string ServerNotification::typeString(ServerNotificationType type)
             return "setSpellCooldown";
         case ServerNotificationType::playerEvents:
             return "playerEvents";
+        case ServerNotificationType::consoleMessage:
+            return "consoleMessage";
+        case ServerNotificationType::askStateHashReport:
+            return "askStateHashReport";
         case ServerNotificationType::exit:
             return "exit";
         default:
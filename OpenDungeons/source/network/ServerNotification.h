@@ -86,6 +86,10 @@ enum class ServerNotificationType
 
     playerEvents,
 
+    consoleMessage, // Output of a console command executed on the server
+
+    askStateHashReport, // Asks the client to send its whole state with the next turn acknowledgement (see DesyncDetector)
+
     exit
 };
 
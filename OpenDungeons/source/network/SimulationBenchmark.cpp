@@ -0,0 +1,229 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/SimulationBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#if WIN32 || _WINDOWS
+// With version 2, GetProcessMemoryInfo is in kernel32 and psapi does not have to be linked
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    //! JSON has no infinity or NaN. Durations are written with a fixed number of decimals
+    //! to keep the files easy to compare
+    std::string jsonNumber(double value)
+    {
+        if(!std::isfinite(value))
+            return "0";
+
+        std::ostringstream ss;
+        ss.setf(std::ios::fixed);
+        ss.precision(4);
+        ss << value;
+        return ss.str();
+    }
+}
+
+SimulationBenchmark::SimulationBenchmark(const std::string& level, uint64_t randomSeed) :
+    mLevel(level),
+    mRandomSeed(randomSeed),
+    mNbPathQueries(0),
+    mNbCreatures(0),
+    mStateHash(0),
+    mPeakMemoryBytes(0)
+{
+}
+
+void SimulationBenchmark::addTurnDuration(double seconds)
+{
+    mTurnDurations.push_back(seconds);
+}
+
+void SimulationBenchmark::addPhaseDuration(const std::string& phase, double seconds)
+{
+    for(Phase& p : mPhases)
+    {
+        if(p.mName != phase)
+            continue;
+
+        p.mTotalSeconds += seconds;
+        return;
+    }
+
+    mPhases.push_back({phase, seconds});
+}
+
+double SimulationBenchmark::getTotalSeconds() const
+{
+    double total = 0.0;
+    for(double seconds : mTurnDurations)
+        total += seconds;
+
+    return total;
+}
+
+double SimulationBenchmark::getTurnDurationPercentile(double percentile) const
+{
+    if(mTurnDurations.empty())
+        return 0.0;
+
+    // Nearest rank: the smallest duration such that at least percentile% of the turns
+    // are shorter or equal
+    std::vector<double> sorted(mTurnDurations);
+    std::sort(sorted.begin(), sorted.end());
+    double rank = std::ceil(percentile / 100.0 * static_cast<double>(sorted.size()));
+    uint32_t index = static_cast<uint32_t>(std::max(rank, 1.0)) - 1;
+    index = std::min(index, static_cast<uint32_t>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void SimulationBenchmark::write(std::ostream& os) const
+{
+    uint32_t nbTurns = getNbTurns();
+    double totalSeconds = getTotalSeconds();
+    double turnsPerSecond = (totalSeconds > 0.0) ? nbTurns / totalSeconds : 0.0;
+    double meanMs = (nbTurns > 0) ? totalSeconds * 1000.0 / nbTurns : 0.0;
+    double maxMs = mTurnDurations.empty() ? 0.0 :
+        *std::max_element(mTurnDurations.begin(), mTurnDurations.end()) * 1000.0;
+
+    os << "{\n";
+    os << "  \"level\": \"" << escapeJsonString(mLevel) << "\",\n";
+    os << "  \"seed\": " << mRandomSeed << ",\n";
+    os << "  \"turns\": " << nbTurns << ",\n";
+    os << "  \"total_seconds\": " << jsonNumber(totalSeconds) << ",\n";
+    os << "  \"turns_per_second\": " << jsonNumber(turnsPerSecond) << ",\n";
+    os << "  \"turn_ms\": {"
+       << "\"mean\": " << jsonNumber(meanMs)
+       << ", \"p50\": " << jsonNumber(getTurnDurationPercentile(50.0) * 1000.0)
+       << ", \"p99\": " << jsonNumber(getTurnDurationPercentile(99.0) * 1000.0)
+       << ", \"max\": " << jsonNumber(maxMs) << "},\n";
+
+    // Total and mean time per turn spent in each phase
+    os << "  \"phases_ms\": {";
+    for(uint32_t i = 0; i < mPhases.size(); ++i)
+    {
+        const Phase& phase = mPhases[i];
+        double totalMs = phase.mTotalSeconds * 1000.0;
+        os << ((i == 0) ? "\n" : ",\n");
+        os << "    \"" << escapeJsonString(phase.mName) << "\": {"
+           << "\"total\": " << jsonNumber(totalMs)
+           << ", \"per_turn\": " << jsonNumber((nbTurns > 0) ? totalMs / nbTurns : 0.0) << "}";
+    }
+    os << (mPhases.empty() ? "},\n" : "\n  },\n");
+
+    os << "  \"path_queries\": " << mNbPathQueries << ",\n";
+    os << "  \"creatures\": " << mNbCreatures << ",\n";
+    // JSON numbers cannot hold every 64 bits value so the hash is written as a string
+    std::ostringstream hash;
+    hash << std::hex << std::setw(16) << std::setfill('0') << mStateHash;
+    os << "  \"state_hash\": \"" << hash.str() << "\",\n";
+    os << "  \"peak_memory_bytes\": " << mPeakMemoryBytes << "\n";
+    os << "}\n";
+}
+
+bool SimulationBenchmark::writeToFile(const std::string& fileName) const
+{
+    if(fileName.empty())
+    {
+        write(std::cout);
+        std::cout.flush();
+        return std::cout.good();
+    }
+
+    std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+
+    write(file);
+    return file.good();
+}
+
+std::string SimulationBenchmark::escapeJsonString(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for(char c : value)
+    {
+        switch(c)
+        {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+            {
+                if(static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                    escaped += buffer;
+                }
+                else
+                    escaped += c;
+                break;
+            }
+        }
+    }
+    return escaped;
+}
+
+uint64_t SimulationBenchmark::getProcessPeakMemoryBytes()
+{
+#if WIN32 || _WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#if defined(__APPLE__)
+    // Bytes on OS X
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    // Kilobytes on Linux
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
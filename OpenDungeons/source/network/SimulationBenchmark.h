@@ -0,0 +1,97 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIMULATIONBENCHMARK_H
+#define SIMULATIONBENCHMARK_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*! \brief Results of a headless benchmark run by the server (see ODServer::runBenchmark): the
+ * turns are computed back to back, without waiting for the turn timer, and the results are
+ * written as a JSON object so that they can be compared between builds by a CI job.
+ * This class only stores and formats the values. It is not thread safe.
+ */
+class SimulationBenchmark
+{
+public:
+    SimulationBenchmark(const std::string& level, uint64_t randomSeed);
+
+    //! \brief Adds a computed turn
+    void addTurnDuration(double seconds);
+
+    //! \brief Adds the time spent in the given phase of the turn. Phases are written in
+    //! the order they were first added
+    void addPhaseDuration(const std::string& phase, double seconds);
+
+    inline void setNbPathQueries(uint64_t nbPathQueries)
+    { mNbPathQueries = nbPathQueries; }
+
+    inline void setNbCreatures(uint32_t nbCreatures)
+    { mNbCreatures = nbCreatures; }
+
+    //! \brief Hash of the game state at the end of the run (see GameMap::fillStateHash). Runs
+    //! with the same level and seed should end with the same hash
+    inline void setStateHash(uint64_t stateHash)
+    { mStateHash = stateHash; }
+
+    inline void setPeakMemoryBytes(uint64_t peakMemoryBytes)
+    { mPeakMemoryBytes = peakMemoryBytes; }
+
+    inline uint32_t getNbTurns() const
+    { return static_cast<uint32_t>(mTurnDurations.size()); }
+
+    //! \brief Time spent computing all the turns
+    double getTotalSeconds() const;
+
+    //! \brief Nearest rank percentile (between 0 and 100) of the turn durations in seconds.
+    //! Returns 0 if no turn was computed
+    double getTurnDurationPercentile(double percentile) const;
+
+    //! \brief Writes the results as a JSON object
+    void write(std::ostream& os) const;
+
+    //! \brief Writes the results in the given file. If the file name is empty, they are
+    //! written on the standard output
+    bool writeToFile(const std::string& fileName) const;
+
+    //! \brief Escapes a string to be written between quotes in JSON
+    static std::string escapeJsonString(const std::string& value);
+
+    //! \brief Peak resident memory of the process in bytes. 0 if it is not available on this platform
+    static uint64_t getProcessPeakMemoryBytes();
+
+private:
+    struct Phase
+    {
+        std::string mName;
+        double mTotalSeconds;
+    };
+
+    std::string mLevel;
+    uint64_t mRandomSeed;
+    std::vector<double> mTurnDurations;
+    std::vector<Phase> mPhases;
+    uint64_t mNbPathQueries;
+    uint32_t mNbCreatures;
+    uint64_t mStateHash;
+    uint64_t mPeakMemoryBytes;
+};
+
+#endif // SIMULATIONBENCHMARK_H
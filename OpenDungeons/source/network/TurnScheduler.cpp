@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/TurnScheduler.h"
+
+#include <algorithm>
+
+TurnScheduler::TurnScheduler(double turnLengthMs, uint32_t maxCatchUpTurns) :
+    mTurnLengthMs(turnLengthMs),
+    mMaxCatchUpTurns(std::max(maxCatchUpTurns, 1u)),
+    mAccumulatedMs(0.0)
+{
+    resetStats();
+}
+
+void TurnScheduler::reset(double turnLengthMs)
+{
+    mTurnLengthMs = turnLengthMs;
+    mAccumulatedMs = 0.0;
+    resetStats();
+}
+
+void TurnScheduler::addElapsedTime(double elapsedMs)
+{
+    mAccumulatedMs += elapsedMs;
+    double maxAccumulatedMs = mTurnLengthMs * static_cast<double>(mMaxCatchUpTurns);
+    if(mAccumulatedMs <= maxAccumulatedMs)
+        return;
+
+    mDroppedTimeMs += mAccumulatedMs - maxAccumulatedMs;
+    mAccumulatedMs = maxAccumulatedMs;
+}
+
+double TurnScheduler::getTimeUntilNextTurnMs() const
+{
+    return std::max(0.0, mTurnLengthMs - mAccumulatedMs);
+}
+
+void TurnScheduler::turnDone(double turnDurationMs)
+{
+    // If another turn was already due when this one started, it is a catch up turn
+    if(mAccumulatedMs >= 2.0 * mTurnLengthMs)
+        ++mNbCatchUpTurns;
+
+    mAccumulatedMs = std::max(0.0, mAccumulatedMs - mTurnLengthMs);
+
+    ++mNbTurns;
+    mTotalTurnDurationMs += turnDurationMs;
+    mMaxTurnDurationMs = std::max(mMaxTurnDurationMs, turnDurationMs);
+    if(turnDurationMs > mTurnLengthMs)
+        ++mNbOverruns;
+}
+
+void TurnScheduler::resetStats()
+{
+    mNbTurns = 0;
+    mNbOverruns = 0;
+    mMaxTurnDurationMs = 0.0;
+    mTotalTurnDurationMs = 0.0;
+    mNbCatchUpTurns = 0;
+    mNbTurnsDelayed = 0;
+    mDroppedTimeMs = 0.0;
+}
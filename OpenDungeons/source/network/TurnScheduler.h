@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TURNSCHEDULER_H
+#define TURNSCHEDULER_H
+
+#include <cstdint>
+
+/*! \brief Fixed timestep scheduler of the server turns.
+ * The elapsed time is added to an accumulator and a turn is due each time the accumulator
+ * holds a full turn length. When turns are late (a long turn or clients acknowledging turns
+ * late), the following turns are started back to back until the server caught up. To avoid
+ * an endless burst after a long stall, the accumulator is bounded to mMaxCatchUpTurns turns.
+ * The time above that bound is dropped, which slows down the simulation.
+ * It also measures the turns that took longer to compute than the turn length (overruns).
+ * This class does not depend on the network or on the clock used.
+ */
+class TurnScheduler
+{
+public:
+    TurnScheduler(double turnLengthMs, uint32_t maxCatchUpTurns);
+
+    //! \brief Resets the accumulator and the statistics and sets the turn length
+    void reset(double turnLengthMs);
+
+    inline double getTurnLengthMs() const
+    { return mTurnLengthMs; }
+
+    inline uint32_t getMaxCatchUpTurns() const
+    { return mMaxCatchUpTurns; }
+
+    //! \brief Adds real time to the accumulator
+    void addElapsedTime(double elapsedMs);
+
+    //! \brief Returns true if at least one turn should be started
+    inline bool isTurnDue() const
+    { return mAccumulatedMs >= mTurnLengthMs; }
+
+    //! \brief Time before the next turn is due. 0 if a turn is already due
+    double getTimeUntilNextTurnMs() const;
+
+    //! \brief To be called after a turn was computed with the time it took. Removes one
+    //! turn length from the accumulator
+    void turnDone(double turnDurationMs);
+
+    //! \brief To be called when a due turn could not be started (clients too late)
+    inline void turnDelayed()
+    { ++mNbTurnsDelayed; }
+
+    //! \brief Statistics since the last call to resetStats
+    inline uint64_t getNbTurns() const
+    { return mNbTurns; }
+
+    inline uint64_t getNbOverruns() const
+    { return mNbOverruns; }
+
+    inline double getMaxTurnDurationMs() const
+    { return mMaxTurnDurationMs; }
+
+    inline double getTotalTurnDurationMs() const
+    { return mTotalTurnDurationMs; }
+
+    //! \brief Number of turns started while another one was already due (catching up)
+    inline uint64_t getNbCatchUpTurns() const
+    { return mNbCatchUpTurns; }
+
+    inline uint64_t getNbTurnsDelayed() const
+    { return mNbTurnsDelayed; }
+
+    //! \brief Time dropped because the accumulator was full
+    inline double getDroppedTimeMs() const
+    { return mDroppedTimeMs; }
+
+    void resetStats();
+
+private:
+    double mTurnLengthMs;
+    uint32_t mMaxCatchUpTurns;
+    double mAccumulatedMs;
+
+    uint64_t mNbTurns;
+    uint64_t mNbOverruns;
+    double mMaxTurnDurationMs;
+    double mTotalTurnDurationMs;
+    uint64_t mNbCatchUpTurns;
+    uint64_t mNbTurnsDelayed;
+    double mDroppedTimeMs;
+};
+
+#endif // TURNSCHEDULER_H
@@ -176,6 +176,11 @@ void CreatureOverlayStatus::updateStatus(Ogre::Real timeSincelastFrame)
     mMovableTextOverlay->displayOverlay(statusId, -1);
 }
 
+void CreatureOverlayStatus::setVisible(bool visible)
+{
+    mMovableTextOverlay->setVisible(visible);
+}
+
 void CreatureOverlayStatus::update(Ogre::Real timeSincelastFrame)
 {
     // If the creature is not on map, we do not display the overlays
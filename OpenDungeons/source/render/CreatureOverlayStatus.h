@@ -41,6 +41,8 @@ public:
 
     void displayHealthOverlay(Ogre::Real timeToDisplay);
     void update(Ogre::Real timeSincelastFrame);
+    //! \brief Hides or shows the overlays. Note that update() shows them if the creature is on map
+    void setVisible(bool visible);
 
 private:
     void updateHealth();
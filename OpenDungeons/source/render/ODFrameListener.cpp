@@ -38,6 +38,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
+#include "utils/Profiler.h"
 
 #include <OgreCamera.h>
 #include <OgreRenderWindow.h>
@@ -87,13 +88,16 @@ ODFrameListener::ODFrameListener(const std::string& mainSceneFileName, Ogre::Ren
     mExitRequested(false),
     mCameraManager(mRenderManager->getSceneManager(), mGameMap.get(), renderWindow),
     mFpsLimiter(DEFAULT_FRAME_RATE),
-    mIsMainMenuCreated(false)
+    mIsMainMenuCreated(false),
+    mCullingStartNs(-1),
+    mProfilerOverlayUpdateNs(0)
 {
     OD_LOG_INF("Creating frame listener...");
 
     mRenderManager->createScene(mCameraManager.getViewport());
 
     mRenderManager->getSceneManager()->addRenderQueueListener(this);
+    mRenderManager->getSceneManager()->addListener(this);
     //Set initial mouse clipping size
     windowResized(mWindow);
 
@@ -129,6 +133,7 @@ ODFrameListener::~ODFrameListener()
     if (mInitialized)
         exitApplication();
 
+    mRenderManager->getSceneManager()->removeListener(this);
     mGameMap->clearAll();
 }
 
@@ -155,16 +160,30 @@ void ODFrameListener::exitApplication()
 
 void ODFrameListener::updateAnimations(Ogre::Real timeSinceLastFrame)
 {
+    OD_PROFILE_ZONE("Animations");
     updateMenuScene(timeSinceLastFrame);
     MusicPlayer::getSingleton().update(static_cast<float>(timeSinceLastFrame));
     mRenderManager->updateRenderAnimations(timeSinceLastFrame);
+    {
+        OD_PROFILE_ZONE("Tile chunks");
+        mRenderManager->updateTileChunks(*mGameMap);
+    }
     mGameMap->processDeletionQueues();
 
-    mGameMap->updateAnimations(timeSinceLastFrame);
+    Ogre::Camera* camera = mCameraManager.getActiveCamera();
+    if(camera == nullptr)
+    {
+        mGameMap->updateAnimations(timeSinceLastFrame);
+        return;
+    }
+
+    Ogre::Vector3 viewPoint = camera->getDerivedPosition();
+    mGameMap->updateAnimations(timeSinceLastFrame, &viewPoint);
 }
 
 bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
 {
+    OD_PROFILE_ZONE("Frame update");
     CEGUI::MouseCursor& mouseCursor = CEGUI::System::getSingleton().getDefaultGUIContext().getMouseCursor();
     CEGUI::Vector2<float> mousePos = mouseCursor.getDisplayIndependantPosition();
     RenderManager::getSingleton().moveCursor(mousePos.d_x, mousePos.d_y);
@@ -175,10 +194,16 @@ bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
     // Sleep to limit the framerate to the max value
     mFpsLimiter.sleepIfEarly();
 
-    CEGUI::System::getSingleton().injectTimePulse(evt.timeSinceLastFrame);
-    CEGUI::System::getSingleton().getDefaultGUIContext().injectTimePulse(evt.timeSinceLastFrame);
+    {
+        OD_PROFILE_ZONE("CEGUI update");
+        CEGUI::System::getSingleton().injectTimePulse(evt.timeSinceLastFrame);
+        CEGUI::System::getSingleton().getDefaultGUIContext().injectTimePulse(evt.timeSinceLastFrame);
+    }
 
-    mModeManager->update(evt);
+    {
+        OD_PROFILE_ZONE("Input and mode update");
+        mModeManager->update(evt);
+    }
 
     int64_t currentTurn = mGameMap->getTurnNumber();
 
@@ -210,8 +235,14 @@ bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
     printDebugInfo();
 
     mGameMap.get()->processDeletionQueues();
-    ODClient::getSingleton().processClientSocketMessages();
-    ODClient::getSingleton().processClientNotifications();
+    {
+        OD_PROFILE_ZONE("Network apply");
+        ODClient::getSingleton().processClientSocketMessages();
+    }
+    {
+        OD_PROFILE_ZONE("Network send");
+        ODClient::getSingleton().processClientNotifications();
+    }
 
     return mContinue;
 }
@@ -231,6 +262,7 @@ void ODFrameListener::renderQueueStarted(Ogre::uint8 queueGroupId, const Ogre::S
 {
     if(queueGroupId == RenderManager::OD_RENDER_QUEUE_ID_GUI && invocation.empty())
     {
+        OD_PROFILE_ZONE("CEGUI render");
         Ogre::Root::getSingleton().getRenderSystem()->clearFrameBuffer(Ogre::FBT_DEPTH);
         CEGUI::System::getSingleton().renderAllGUIContexts();
     }
@@ -241,6 +273,23 @@ void ODFrameListener::renderQueueStarted(Ogre::uint8 queueGroupId, const Ogre::S
     
 }
 
+void ODFrameListener::preFindVisibleObjects(Ogre::SceneManager*,
+    Ogre::SceneManager::IlluminationRenderStage, Ogre::Viewport*)
+{
+    // The culling starts and ends in different callbacks so we cannot use a zone
+    mCullingStartNs = Profiler::isEnabled() ? Profiler::nowNs() : -1;
+}
+
+void ODFrameListener::postFindVisibleObjects(Ogre::SceneManager*,
+    Ogre::SceneManager::IlluminationRenderStage, Ogre::Viewport*)
+{
+    if(mCullingStartNs < 0)
+        return;
+
+    Profiler::record("Culling", mCullingStartNs, Profiler::nowNs() - mCullingStartNs);
+    mCullingStartNs = -1;
+}
+
 bool ODFrameListener::quit(const CEGUI::EventArgs &)
 {
     requestExit();
@@ -285,6 +334,17 @@ void ODFrameListener::printDebugInfo()
         infoSS << "FPS: " << mWindow->getStatistics().lastFPS;
         infoSS << "\ntriangleCount: " << mWindow->getStatistics().triangleCount;
         infoSS << "\nBatches: " << mWindow->getStatistics().batchCount;
+        infoSS << "\nTile chunks: " << mRenderManager->getNbVisibleTileChunks() << "/" << mRenderManager->getNbTileChunks()
+            << " (batches: " << mRenderManager->getNbVisibleTileChunkBatches()
+            << ", rebuilt: " << mRenderManager->getNbTileChunksRebuilt() << ")";
+        infoSS << "\nScene lookups by name: " << mRenderManager->getNbStringLookupsLastFrame();
+        infoSS << "\nMaterial clones: " << mRenderManager->getNbMaterialClones()
+            << " (cache hit rate: " << static_cast<int>(mRenderManager->getMaterialCacheHitRate() * 100.0f) << "%)";
+        infoSS << "\nAnimated entities: " << mGameMap->getNbAnimatedObjectsUpdated()
+            << " (reduced rate: " << mGameMap->getNbAnimatedObjectsReduced()
+            << ", culled: " << mGameMap->getNbAnimatedObjectsCulled() << ")";
+        infoSS << "\nServer messages: " << ODClient::getSingleton().getNbMessagesProcessed()
+            << " processed, " << ODClient::getSingleton().getNbPendingMessages() << " pending";
         infoSS << "\nTurn number:  " << mGameMap->getTurnNumber();
         infoSS << "\nCursor:  " << mModeManager->getInputManager().mXPos << ", " << mModeManager->getInputManager().mYPos << std::endl;
         infoSS << printDebugInfoTail.str() << std::endl;
@@ -299,9 +359,39 @@ void ODFrameListener::printDebugInfo()
         }
     }
 
+    // The profiler zones are displayed while the profiler is enabled, even without the debug info
+    if(Profiler::isEnabled())
+    {
+        updateProfilerOverlay();
+        infoSS << mProfilerOverlayText;
+    }
+
     TextRenderer::getSingleton().setText("DebugMessages", infoSS.str());
 }
 
+void ODFrameListener::updateProfilerOverlay()
+{
+    const int64_t refreshPeriodNs = 500000000;
+    const int64_t statsPeriodNs = 1000000000;
+    int64_t now = Profiler::nowNs();
+    if(now - mProfilerOverlayUpdateNs < refreshPeriodNs)
+        return;
+
+    mProfilerOverlayUpdateNs = now;
+    std::vector<ProfilerZoneStats> stats;
+    Profiler::computeZoneStats(now - statsPeriodNs, stats);
+    std::stringstream ss;
+    ss.setf(std::ios::fixed);
+    ss.precision(2);
+    ss << "\n\nProfiler (last second: total ms, calls, max ms)";
+    for(const ProfilerZoneStats& zone : stats)
+    {
+        ss << "\n" << zone.mThreadName << " / " << zone.mName << ": " << zone.mTotalMs
+           << ", " << zone.mNbCalls << ", " << zone.mMaxMs;
+    }
+    mProfilerOverlayText = ss.str();
+}
+
 void ODFrameListener::initGameRenderer()
 {
     mRenderManager->initGameRenderer(mGameMap.get());
@@ -31,6 +31,7 @@
 #include <OgreSingleton.h>
 #include <OgrePrerequisites.h>
 #include <OgreRenderQueueListener.h>
+#include <OgreSceneManager.h>
 #include <OgreWindowEventUtilities.h>
 
 #include <sstream>
@@ -69,7 +70,8 @@ class ODFrameListener :
         public Ogre::Singleton<ODFrameListener>,
         public Ogre::FrameListener,
         public Ogre::WindowEventListener,
-        public Ogre::RenderQueueListener
+        public Ogre::RenderQueueListener,
+        public Ogre::SceneManager::Listener
 {
 
 friend class ODClient;
@@ -114,6 +116,12 @@ public:
     void renderQueueStarted(Ogre::uint8 queueGroupId, const Ogre::String& invocation,
         bool& skipThisInvocation) override;
 
+    //! \brief From Ogre::SceneManager::Listener. Used to profile the scene culling
+    void preFindVisibleObjects(Ogre::SceneManager* source,
+        Ogre::SceneManager::IlluminationRenderStage irs, Ogre::Viewport* v) override;
+    void postFindVisibleObjects(Ogre::SceneManager* source,
+        Ogre::SceneManager::IlluminationRenderStage irs, Ogre::Viewport* v) override;
+
     //! \brief Exit the game.
     bool quit(const CEGUI::EventArgs &e);
 
@@ -205,6 +213,17 @@ private:
 
     bool mIsMainMenuCreated;
 
+    //! \brief Start of the current scene culling. Set by preFindVisibleObjects if the profiler is enabled
+    int64_t mCullingStartNs;
+
+    //! \brief Profiler zones displayed with the debug info. They are refreshed periodically
+    //! to keep the overlay readable and cheap
+    std::string mProfilerOverlayText;
+    int64_t mProfilerOverlayUpdateNs;
+
+    //! \brief Computes mProfilerOverlayText from the zones recorded during the last second
+    void updateProfilerOverlay();
+
     //! \brief Actually exit application
     void exitApplication();
 
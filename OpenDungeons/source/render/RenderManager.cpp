@@ -43,8 +43,10 @@
 #include <OgreCamera.h>
 #include <OgreCompositorManager.h>
 #include <OgreEntity.h>
+#include <OgreManualObject.h>
 #include <OgreMaterialManager.h>
 #include <OgreMesh.h>
+#include <OgreMeshManager.h>
 #include <OgreMovableObject.h>
 #include <OgreParticleSystem.h>
 #include <OgrePrerequisites.h>
@@ -63,6 +65,8 @@
 #include <OgreOverlaySystem.h>
 #include <OgreShaderGenerator.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <sstream>
 
 template<> RenderManager* Ogre::Singleton<RenderManager>::msSingleton = nullptr;
@@ -79,6 +83,39 @@ const Ogre::Real KEEPER_HAND_CREATURE_PICKED_SCALE = 0.05f;
 
 const Ogre::ColourValue BASE_AMBIENT_VALUE = Ogre::ColourValue(0.3f, 0.3f, 0.3f);
 
+//! \brief Returns the vision to display for the given tile. We only mark vision on
+//! ground tiles (except lava and water)
+static bool getTileDisplayedVision(const Tile& tile)
+{
+    switch(tile.getTileVisual())
+    {
+        case TileVisual::claimedGround:
+        case TileVisual::dirtGround:
+        case TileVisual::goldGround:
+        case TileVisual::rockGround:
+            return tile.getLocalPlayerHasVision();
+        default:
+            return true;
+    }
+}
+
+//! \brief Loads a tile mesh with shadow buffers so that its vertices and indexes can be read back to
+//! be merged in the tile chunks. Reading a write only hardware buffer is undefined behaviour
+static Ogre::MeshPtr loadTileMesh(const std::string& meshName)
+{
+    Ogre::MeshPtr meshPtr = Ogre::MeshManager::getSingleton().load(meshName,
+        Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
+        Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, true, true);
+    // If the mesh was already loaded without shadow buffers (by an entity), we reload it with them
+    if(!meshPtr->isVertexBufferShadowed() || !meshPtr->isIndexBufferShadowed())
+    {
+        meshPtr->setVertexBufferPolicy(Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+        meshPtr->setIndexBufferPolicy(Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY, true);
+        meshPtr->reload();
+    }
+    return meshPtr;
+}
+
 RenderManager::RenderManager(Ogre::OverlaySystem* overlaySystem) :
     mHandAnimationState(nullptr),
     mViewport(nullptr),
@@ -90,7 +127,19 @@ RenderManager::RenderManager(Ogre::OverlaySystem* overlaySystem) :
     mFactorWidth(0.0f),
     mFactorHeight(0.0f),
     mCreatureTextOverlayDisplayed(false),
-    mHandKeeperHandVisibility(0)
+    mHandKeeperHandVisibility(0),
+    mTileChunksMapSizeX(0),
+    mTileChunksMapSizeY(0),
+    mNbTileChunksX(0),
+    mNbTileChunkTiles(0),
+    mNbTileChunks(0),
+    mNbTileChunksRebuilt(0),
+    mHandKeeperEntity(nullptr),
+    mNbStringLookups(0),
+    mNbStringLookupsLastFrame(0),
+    mNbMaterialClones(0),
+    mNbMaterialCacheHits(0),
+    mNbMaterialCacheMisses(0)
 {
     mSceneManager = Ogre::Root::getSingleton().createSceneManager("OctreeSceneManager", "SceneManager");
     mSceneManager->addRenderQueueListener(overlaySystem);
@@ -133,7 +182,7 @@ void RenderManager::initGameRenderer(GameMap* gameMap)
     //This is an ugly workaround for issue where destroying some entities messes
     //up the lighing for some of the rtshader materials.
     const std::string& defaultTileMesh = gameMap->getMeshForDefaultTile();
-    if(!mSceneManager->hasEntity(defaultTileMesh + "_dummyEnt"))
+    if(findEntityByName(defaultTileMesh + "_dummyEnt") == nullptr)
     {
         Ogre::SceneNode* dummyNode = mHandKeeperNode->createChildSceneNode(defaultTileMesh + "_dummyNode");
         dummyNode->setScale(Ogre::Vector3(0.00000001f, 0.00000001f, 0.00000001f));
@@ -159,7 +208,7 @@ void RenderManager::initGameRenderer(GameMap* gameMap)
             continue;
         }
         // We check if the mesh is already loaded. If not, we load it
-        if(mSceneManager->hasEntity(def->getClassName() + "_dummyEnt"))
+        if(findEntityByName(def->getClassName() + "_dummyEnt") != nullptr)
             continue;
 
         Ogre::SceneNode* dummyNode = mHandKeeperNode->createChildSceneNode(def->getClassName() + "_dummyNode");
@@ -215,6 +264,7 @@ void RenderManager::createScene(Ogre::Viewport* nViewport)
     Ogre::Entity* keeperHandEnt = mSceneManager->createEntity("keeperHandEnt", "Keeperhand.mesh");
     keeperHandEnt->setLightMask(0);
     keeperHandEnt->setCastShadows(false);
+    mHandKeeperEntity = keeperHandEnt;
     mHandAnimationState = keeperHandEnt->getAnimationState("Idle");
     mHandAnimationState->setTimePosition(0);
     mHandAnimationState->setLoop(true);
@@ -269,7 +319,7 @@ void RenderManager::removePointLightMenu(Ogre::Light* light)
 Ogre::Entity* RenderManager::addEntityMenu(const std::string& meshName, const std::string& entityName,
         const Ogre::Vector3& pos)
 {
-    if(mSceneManager->hasEntity(entityName))
+    if(findEntityByName(entityName) != nullptr)
     {
         OD_LOG_ERR("There is already an entity=" + entityName);
         return nullptr;
@@ -292,22 +342,22 @@ Ogre::Entity* RenderManager::addEntityMenu(const std::string& meshName, const st
 
 void RenderManager::removeEntityMenu(Ogre::Entity* ent)
 {
-    Ogre::SceneNode* entNode = mSceneManager->getSceneNode(ent->getName() + "_node");
+    Ogre::SceneNode* entNode = ent->getParentSceneNode();
     entNode->detachObject(ent);
     mMainMenuSceneNode->removeChild(entNode);
-    mSceneManager->destroySceneNode(entNode->getName());
+    mSceneManager->destroySceneNode(entNode);
     mSceneManager->destroyEntity(ent);
 }
 
 Ogre::AnimationState* RenderManager::setMenuEntityAnimation(const std::string& entityName, const std::string& animation, bool loop)
 {
-    if(!mSceneManager->hasEntity(entityName))
+    Ogre::Entity* ent = findEntityByName(entityName);
+    if(ent == nullptr)
     {
         OD_LOG_ERR("There is no entity=" + entityName);
         return nullptr;
     }
 
-    Ogre::Entity* ent = mSceneManager->getEntity(entityName);
     if(!ent->hasAnimationState(animation))
     {
         OD_LOG_ERR("Entity=" + ent->getName() + ", has no animation=" + animation);
@@ -326,13 +376,13 @@ bool RenderManager::updateMenuEntityAnimation(Ogre::AnimationState* animState, O
 Ogre::SceneNode* RenderManager::getMenuEntityNode(const std::string& entityName)
 {
     std::string nodeName = entityName + "_node";
-    if(!mSceneManager->hasSceneNode(nodeName))
+    Ogre::SceneNode* node = findSceneNodeByName(nodeName);
+    if(node == nullptr)
     {
         OD_LOG_ERR("No node for entityName=" + entityName + ", node name=" + nodeName);
         return nullptr;
     }
 
-    Ogre::SceneNode* node = mSceneManager->getSceneNode(nodeName);
     return node;
 }
 
@@ -379,7 +429,8 @@ void RenderManager::removeEntityParticleEffectMenu(Ogre::SceneNode* node,
 Ogre::ParticleSystem* RenderManager::addEntityParticleEffectBoneMenu(const std::string& entityName,
         const std::string& boneName, const std::string& particleName, const std::string& particleScript)
 {
-    if(!mSceneManager->hasEntity(entityName))
+    Ogre::Entity* ent = findEntityByName(entityName);
+    if(ent == nullptr)
     {
         OD_LOG_ERR("Cannot find entityName=" + entityName);
         return nullptr;
@@ -387,7 +438,6 @@ Ogre::ParticleSystem* RenderManager::addEntityParticleEffectBoneMenu(const std::
 
     Ogre::ParticleSystem* particleSystem = mSceneManager->createParticleSystem(particleName, particleScript);
 
-    Ogre::Entity* ent = mSceneManager->getEntity(entityName);
     ent->attachObjectToBone(boneName, particleSystem);
 
     return particleSystem;
@@ -396,13 +446,13 @@ Ogre::ParticleSystem* RenderManager::addEntityParticleEffectBoneMenu(const std::
 void RenderManager::removeEntityParticleEffectBoneMenu(const std::string& entityName,
         Ogre::ParticleSystem* particleSystem)
 {
-    if(!mSceneManager->hasEntity(entityName))
+    Ogre::Entity* ent = findEntityByName(entityName);
+    if(ent == nullptr)
     {
         OD_LOG_ERR("Cannot find entityName=" + entityName);
         return;
     }
 
-    Ogre::Entity* ent = mSceneManager->getEntity(entityName);
     ent->detachObjectFromBone(particleSystem);
     mSceneManager->destroyParticleSystem(particleSystem);
 }
@@ -430,13 +480,15 @@ const Ogre::Vector3& RenderManager::getMenuEntityScale(Ogre::SceneNode* node)
 
 void RenderManager::updateRenderAnimations(Ogre::Real timeSinceLastFrame)
 {
+    mNbStringLookupsLastFrame = mNbStringLookups;
+    mNbStringLookups = 0;
+
     if(mHandAnimationState != nullptr)
     {
         mHandAnimationState->addTime(timeSinceLastFrame);
         if(mHandAnimationState->hasEnded())
         {
-            Ogre::Entity* ent = mSceneManager->getEntity("keeperHandEnt");
-            mHandAnimationState = setEntityAnimation(ent, "Idle", true);
+            mHandAnimationState = setEntityAnimation(mHandKeeperEntity, "Idle", true);
         }
     }
 }
@@ -446,131 +498,36 @@ void RenderManager::rrRefreshTile(const Tile& tile, const GameMap& gameMap, cons
     if (tile.getEntityNode() == nullptr)
         return;
 
-    std::string tileName = tile.getOgreNamePrefix() + tile.getName();
-    bool displayTilesetMesh = tile.shouldDisplayTileMesh();
-    std::string meshName;
-
-    // We only mark vision on ground tiles (except lava and water)
-    bool vision = true;
-    switch(tile.getTileVisual())
-    {
-        case TileVisual::claimedGround:
-        case TileVisual::dirtGround:
-        case TileVisual::goldGround:
-        case TileVisual::rockGround:
-            vision = tile.getLocalPlayerHasVision();
-            break;
-        default:
-            break;
-    }
+    // The tile mesh is part of the chunk geometry
+    markTileChunkDirty(tile);
 
+    EntityRenderHandles& handles = getRenderHandles(tile);
+    bool vision = getTileDisplayedVision(tile);
     bool isMarked = tile.getMarkedForDigging(&localPlayer);
-    const TileSetValue& tileSetValue = gameMap.getMeshForTile(&tile);
-
-    // We display the tile mesh if needed
-    if(displayTilesetMesh)
-    {
-        // We compute the mesh
-        meshName = tileSetValue.getMeshName();
-    }
-
-    Ogre::Entity* tileMeshEnt = nullptr;
-    const std::string tileMeshName = tileName + "_tileMesh";
-    if(mSceneManager->hasEntity(tileMeshName))
-    {
-        tileMeshEnt = mSceneManager->getEntity(tileMeshName);
-        if(tileMeshEnt->getMesh()->getName().compare(meshName) != 0)
-        {
-            // Unlink and delete the old mesh
-            mSceneManager->getSceneNode(tileMeshName + "_node")->detachObject(tileMeshEnt);
-            mSceneManager->destroyEntity(tileMeshEnt);
-            tileMeshEnt = nullptr;
-        }
-    }
-
-    Ogre::SceneNode* tileMeshNode = nullptr;
-    std::string tileMeshNodeName = tileMeshName + "_node";
-    if(mSceneManager->hasSceneNode(tileMeshNodeName))
-        tileMeshNode = mSceneManager->getSceneNode(tileMeshNodeName);
-
-    if((tileMeshEnt == nullptr) && !meshName.empty())
-    {
-        tileMeshEnt = mSceneManager->createEntity(tileMeshName, meshName);
-        // If the node does not exist, we create it
-        if(tileMeshNode == nullptr)
-            tileMeshNode = tile.getEntityNode()->createChildSceneNode(tileMeshNodeName);
-        // Link the tile mesh back to the relevant scene node so OGRE will render it
-        tileMeshNode->attachObject(tileMeshEnt);
-
-        Ogre::MeshPtr meshPtr = tileMeshEnt->getMesh();
-        unsigned short src, dest;
-        if (!meshPtr->suggestTangentVectorBuildParams(Ogre::VES_TANGENT, src, dest))
-        {
-            meshPtr->buildTangentVectors(Ogre::VES_TANGENT, src, dest);
-        }
-    }
-
-    // We rescale and set the orientation that may have changed
-    if(tileMeshNode != nullptr)
-    {
-        tileMeshNode->resetOrientation();
-
-        // We rotate depending on the tileset
-        Ogre::Quaternion q;
-        if(tileSetValue.getRotationX() != 0.0f)
-            q = q * Ogre::Quaternion(Ogre::Degree(tileSetValue.getRotationX()), Ogre::Vector3::UNIT_X);
-
-        if(tileSetValue.getRotationY() != 0.0f)
-            q = q * Ogre::Quaternion(Ogre::Degree(tileSetValue.getRotationY()), Ogre::Vector3::UNIT_Y);
-
-        if(tileSetValue.getRotationZ() != 0.0f)
-            q = q * Ogre::Quaternion(Ogre::Degree(tileSetValue.getRotationZ()), Ogre::Vector3::UNIT_Z);
-
-        if(q != Ogre::Quaternion::IDENTITY)
-            tileMeshNode->rotate(q);
-    }
-
-    if(tileMeshEnt != nullptr)
-    {
-        // We replace the material if required by the tileset
-        if(!tileSetValue.getMaterialName().empty())
-            tileMeshEnt->setMaterialName(tileSetValue.getMaterialName());
-
-        Seat* seatColor = nullptr;
-        if(tile.shouldColorTileMesh())
-            seatColor = tile.getSeat();
-
-        colourizeEntity(tileMeshEnt, seatColor, isMarked, vision);
-    }
 
     // We display the custom mesh if there is one
-    const std::string customMeshName = tileName + "_customMesh";
-    meshName = tile.getMeshName();
-    Ogre::Entity* customMeshEnt = nullptr;
-    if(mSceneManager->hasEntity(customMeshName))
+    const std::string& meshName = tile.getMeshName();
+    Ogre::Entity* customMeshEnt = handles.mEntity;
+    if((customMeshEnt != nullptr) && (customMeshEnt->getMesh()->getName().compare(meshName) != 0))
     {
-        customMeshEnt = mSceneManager->getEntity(customMeshName);
-        if(customMeshEnt->getMesh()->getName().compare(meshName) != 0)
-        {
-            // Unlink and delete the old mesh
-            mSceneManager->getSceneNode(customMeshName + "_node")->detachObject(customMeshEnt);
-            mSceneManager->destroyEntity(customMeshEnt);
-            customMeshEnt = nullptr;
-        }
+        // Unlink and delete the old mesh
+        handles.mCustomMeshNode->detachObject(customMeshEnt);
+        mSceneManager->destroyEntity(customMeshEnt);
+        customMeshEnt = nullptr;
+        handles.mEntity = nullptr;
     }
 
     if((customMeshEnt == nullptr) && !meshName.empty())
     {
         // If the node does not exist, we create it
-        std::string customMeshNodeName = customMeshName + "_node";
-        Ogre::SceneNode* customMeshNode;
-        if(!mSceneManager->hasSceneNode(customMeshNodeName))
-            customMeshNode = tile.getEntityNode()->createChildSceneNode(customMeshNodeName);
-        else
-            customMeshNode = mSceneManager->getSceneNode(customMeshNodeName);
+        const std::string customMeshName = tile.getOgreNamePrefix() + tile.getName() + "_customMesh";
+        if(handles.mCustomMeshNode == nullptr)
+            handles.mCustomMeshNode = tile.getEntityNode()->createChildSceneNode(customMeshName + "_node");
 
         customMeshEnt = mSceneManager->createEntity(customMeshName, meshName);
+        handles.mEntity = customMeshEnt;
 
+        Ogre::SceneNode* customMeshNode = handles.mCustomMeshNode;
         customMeshNode->attachObject(customMeshEnt);
         customMeshNode->resetOrientation();
 
@@ -599,6 +556,23 @@ void RenderManager::rrCreateTile(Tile& tile, const GameMap& gameMap, const Playe
     tile.setParentSceneNode(node->getParentSceneNode());
     tile.setEntityNode(node);
     node->setPosition(static_cast<Ogre::Real>(tile.getX()), static_cast<Ogre::Real>(tile.getY()), 0);
+    mEntityRenderHandles[&tile] = EntityRenderHandles();
+
+    TileChunk* chunk = getTileChunk(tile);
+    if(chunk != nullptr)
+    {
+        if(chunk->mNbTiles == 0)
+        {
+            chunk->mObject = mSceneManager->createManualObject();
+            chunk->mNode = mTileSceneNode->createChildSceneNode();
+            chunk->mNode->attachObject(chunk->mObject);
+            chunk->mIsAttached = true;
+            ++mNbTileChunks;
+        }
+        ++chunk->mNbTiles;
+        ++mNbTileChunkTiles;
+        updateTileChunkAttachment(*chunk);
+    }
 
     rrRefreshTile(tile, gameMap, localPlayer);
 }
@@ -608,74 +582,397 @@ void RenderManager::rrDestroyTile(Tile& tile)
     if (tile.getEntityNode() == nullptr)
         return;
 
-    std::string tileName = tile.getOgreNamePrefix() + tile.getName();
-    std::string selectorName = tileName + "_selection_indicator";
-    if(mSceneManager->hasEntity(selectorName))
+    EntityRenderHandles& handles = getRenderHandles(tile);
+    if(handles.mSelectorEntity != nullptr)
     {
-        Ogre::SceneNode* selectorNode = mSceneManager->getSceneNode(selectorName + "Node");
-        Ogre::Entity* selectorEnt = mSceneManager->getEntity(selectorName);
+        Ogre::SceneNode* selectorNode = handles.mSelectorNode;
+        Ogre::Entity* selectorEnt = handles.mSelectorEntity;
         tile.getEntityNode()->removeChild(selectorNode);
         selectorNode->detachObject(selectorEnt);
         mSceneManager->destroySceneNode(selectorNode);
         mSceneManager->destroyEntity(selectorEnt);
     }
 
-    const std::string tileMeshName = tileName + "_tileMesh";
-    if(mSceneManager->hasSceneNode(tileMeshName + "_node"))
-    {
-        Ogre::SceneNode* tileMeshNode = mSceneManager->getSceneNode(tileMeshName + "_node");
-        if(mSceneManager->hasEntity(tileMeshName))
-        {
-            Ogre::Entity* ent = mSceneManager->getEntity(tileMeshName);
-            tileMeshNode->detachObject(ent);
-            mSceneManager->destroyEntity(ent);
-        }
-        tile.getEntityNode()->removeChild(tileMeshNode);
-        mSceneManager->destroySceneNode(tileMeshNode);
-    }
-
-    const std::string customMeshName = tileName + "_customMesh";
-    if(mSceneManager->hasSceneNode(customMeshName + "_node"))
+    if(handles.mCustomMeshNode != nullptr)
     {
-        Ogre::SceneNode* customMeshNode = mSceneManager->getSceneNode(customMeshName + "_node");
-        if(mSceneManager->hasEntity(customMeshName))
+        Ogre::SceneNode* customMeshNode = handles.mCustomMeshNode;
+        if(handles.mEntity != nullptr)
         {
-            Ogre::Entity* ent = mSceneManager->getEntity(customMeshName);
+            Ogre::Entity* ent = handles.mEntity;
             customMeshNode->detachObject(ent);
             mSceneManager->destroyEntity(ent);
         }
         tile.getEntityNode()->removeChild(customMeshNode);
         mSceneManager->destroySceneNode(customMeshNode);
     }
+    mEntityRenderHandles.erase(&tile);
 
     mSceneManager->destroySceneNode(tile.getEntityNode());
     tile.setParentSceneNode(nullptr);
     tile.setEntityNode(nullptr);
+
+    TileChunk* chunk = getTileChunk(tile);
+    if(chunk == nullptr)
+        return;
+
+    uint32_t tileIndex = static_cast<uint32_t>(tile.getX() + tile.getY() * mTileChunksMapSizeX);
+    if(mCulledTiles[tileIndex])
+    {
+        mCulledTiles[tileIndex] = false;
+        --chunk->mNbCulledTiles;
+    }
+
+    --mNbTileChunkTiles;
+    if(--chunk->mNbTiles == 0)
+        destroyTileChunk(*chunk);
+    else
+    {
+        markTileChunkDirty(tile);
+        updateTileChunkAttachment(*chunk);
+    }
+
+    // When the last tile is destroyed, we forget the chunk grid since the next map may have a different size
+    if(mNbTileChunkTiles == 0)
+    {
+        mTileChunks.clear();
+        mDirtyTileChunks.clear();
+        mCulledTiles.clear();
+        mTileChunksMapSizeX = 0;
+        mTileChunksMapSizeY = 0;
+        mNbTileChunksX = 0;
+    }
 }
 
-void RenderManager::rrTemporalMarkTile(Tile* curTile)
+void RenderManager::rrSetTileCulled(const Tile& tile, bool culled)
 {
-    Ogre::SceneManager* mSceneMgr = RenderManager::getSingletonPtr()->getSceneManager();
-    Ogre::Entity* ent;
+    if(tile.getEntityNode() == nullptr)
+        return;
 
-    bool bb = curTile->getSelected();
+    TileChunk* chunk = getTileChunk(tile);
+    if(chunk == nullptr)
+        return;
+
+    uint32_t tileIndex = static_cast<uint32_t>(tile.getX() + tile.getY() * mTileChunksMapSizeX);
+    if(mCulledTiles[tileIndex] == culled)
+        return;
+
+    mCulledTiles[tileIndex] = culled;
+    if(culled)
+        ++chunk->mNbCulledTiles;
+    else
+        --chunk->mNbCulledTiles;
 
-    std::string tileName = curTile->getOgreNamePrefix() + curTile->getName();
-    std::string selectorName = tileName + "_selection_indicator";
-    if (mSceneMgr->hasEntity(selectorName))
+    updateTileChunkAttachment(*chunk);
+}
+
+void RenderManager::updateTileChunks(const GameMap& gameMap)
+{
+    mNbTileChunksRebuilt = 0;
+    if(mDirtyTileChunks.empty())
+        return;
+
+    const Player* localPlayer = gameMap.getLocalPlayer();
+    if(localPlayer == nullptr)
+        return;
+
+    // Chunks that are not displayed are kept dirty and will be rebuilt when they are shown
+    std::size_t nbDirty = 0;
+    for(uint32_t chunkIndex : mDirtyTileChunks)
     {
-        ent = mSceneMgr->getEntity(selectorName);
+        TileChunk& chunk = mTileChunks[chunkIndex];
+        if(!chunk.mIsDirty)
+            continue;
+
+        if(!chunk.mIsAttached)
+        {
+            mDirtyTileChunks[nbDirty++] = chunkIndex;
+            continue;
+        }
+
+        rebuildTileChunk(chunk, chunkIndex, gameMap, *localPlayer);
+        ++mNbTileChunksRebuilt;
+    }
+    mDirtyTileChunks.resize(nbDirty);
+}
+
+uint32_t RenderManager::getNbVisibleTileChunks() const
+{
+    uint32_t nb = 0;
+    for(const TileChunk& chunk : mTileChunks)
+    {
+        if(chunk.mIsAttached)
+            ++nb;
+    }
+    return nb;
+}
+
+uint32_t RenderManager::getNbVisibleTileChunkBatches() const
+{
+    uint32_t nb = 0;
+    for(const TileChunk& chunk : mTileChunks)
+    {
+        if(chunk.mIsAttached)
+            nb += chunk.mNbBatches;
+    }
+    return nb;
+}
+
+RenderManager::TileChunk* RenderManager::getTileChunk(const Tile& tile)
+{
+    if(mTileChunks.empty())
+    {
+        const GameMap* gameMap = tile.getGameMap();
+        mTileChunksMapSizeX = gameMap->getMapSizeX();
+        mTileChunksMapSizeY = gameMap->getMapSizeY();
+        if((mTileChunksMapSizeX <= 0) || (mTileChunksMapSizeY <= 0))
+            return nullptr;
+
+        mNbTileChunksX = TileChunkMeshBuilder::chunkCoord(mTileChunksMapSizeX - 1) + 1;
+        int nbTileChunksY = TileChunkMeshBuilder::chunkCoord(mTileChunksMapSizeY - 1) + 1;
+        mTileChunks.resize(mNbTileChunksX * nbTileChunksY);
+        mCulledTiles.assign(mTileChunksMapSizeX * mTileChunksMapSizeY, false);
+    }
+
+    if((tile.getX() < 0) || (tile.getX() >= mTileChunksMapSizeX) ||
+       (tile.getY() < 0) || (tile.getY() >= mTileChunksMapSizeY))
+    {
+        OD_LOG_ERR("Tile out of the chunks grid tile=" + Tile::displayAsString(&tile));
+        return nullptr;
+    }
+
+    int chunkIndex = TileChunkMeshBuilder::chunkCoord(tile.getX())
+        + TileChunkMeshBuilder::chunkCoord(tile.getY()) * mNbTileChunksX;
+    return &mTileChunks[chunkIndex];
+}
+
+void RenderManager::markTileChunkDirty(const Tile& tile)
+{
+    TileChunk* chunk = getTileChunk(tile);
+    if((chunk == nullptr) || chunk->mIsDirty)
+        return;
+
+    chunk->mIsDirty = true;
+    mDirtyTileChunks.push_back(static_cast<uint32_t>(chunk - mTileChunks.data()));
+}
+
+void RenderManager::rebuildTileChunk(TileChunk& chunk, uint32_t chunkIndex, const GameMap& gameMap, const Player& localPlayer)
+{
+    chunk.mIsDirty = false;
+
+    int startX = static_cast<int>(chunkIndex % mNbTileChunksX) * TileChunkMeshBuilder::CHUNK_SIZE;
+    int startY = static_cast<int>(chunkIndex / mNbTileChunksX) * TileChunkMeshBuilder::CHUNK_SIZE;
+    int endX = std::min(startX + TileChunkMeshBuilder::CHUNK_SIZE, mTileChunksMapSizeX);
+    int endY = std::min(startY + TileChunkMeshBuilder::CHUNK_SIZE, mTileChunksMapSizeY);
+
+    mTileChunkMeshBuilder.clear();
+    TileChunkInstance instance;
+    for(int yy = startY; yy < endY; ++yy)
+    {
+        for(int xx = startX; xx < endX; ++xx)
+        {
+            const Tile* tile = gameMap.getTile(xx, yy);
+            if((tile == nullptr) || (tile->getEntityNode() == nullptr))
+                continue;
+
+            if(!tile->shouldDisplayTileMesh())
+                continue;
+
+            const TileSetValue& tileSetValue = gameMap.getMeshForTile(tile);
+            instance.mMesh = getTileChunkSourceMesh(tileSetValue.getMeshName());
+            if(instance.mMesh == nullptr)
+                continue;
+
+            instance.mX = static_cast<float>(xx);
+            instance.mY = static_cast<float>(yy);
+            instance.mRotationX = tileSetValue.getRotationX();
+            instance.mRotationY = tileSetValue.getRotationY();
+            instance.mRotationZ = tileSetValue.getRotationZ();
+            instance.mMaterialOverride = tileSetValue.getMaterialName();
+
+            instance.mVariant.mPlayerHasVision = getTileDisplayedVision(*tile);
+            instance.mVariant.mMarkedForDigging = tile->getMarkedForDigging(&localPlayer);
+            instance.mVariant.mSeatId = -1;
+            if(tile->shouldColorTileMesh() && (tile->getSeat() != nullptr))
+                instance.mVariant.mSeatId = tile->getSeat()->getId();
+
+            mTileChunkMeshBuilder.addInstance(instance);
+        }
+    }
+
+    chunk.mObject->clear();
+    chunk.mNbBatches = 0;
+    for(const TileChunkBatch& batch : mTileChunkMeshBuilder.getBatches())
+    {
+        if(batch.mIndices.empty())
+            continue;
+
+        const Seat* seat = nullptr;
+        if(batch.mVariant.mSeatId != -1)
+            seat = gameMap.getSeatById(batch.mVariant.mSeatId);
+
+        const std::string& materialName = colourizeMaterial(batch.mMaterialName, seat,
+            batch.mVariant.mMarkedForDigging, batch.mVariant.mPlayerHasVision);
+
+        chunk.mObject->estimateVertexCount(batch.mVertices.size());
+        chunk.mObject->estimateIndexCount(batch.mIndices.size());
+        chunk.mObject->begin(materialName, Ogre::RenderOperation::OT_TRIANGLE_LIST);
+        for(const TileChunkVertex& v : batch.mVertices)
+        {
+            chunk.mObject->position(v.mPosition[0], v.mPosition[1], v.mPosition[2]);
+            chunk.mObject->normal(v.mNormal[0], v.mNormal[1], v.mNormal[2]);
+            chunk.mObject->tangent(v.mTangent[0], v.mTangent[1], v.mTangent[2]);
+            chunk.mObject->textureCoord(v.mTexCoord[0], v.mTexCoord[1]);
+        }
+        for(uint32_t index : batch.mIndices)
+            chunk.mObject->index(index);
+
+        chunk.mObject->end();
+        ++chunk.mNbBatches;
     }
+}
+
+void RenderManager::destroyTileChunk(TileChunk& chunk)
+{
+    if(chunk.mIsAttached)
+        mTileSceneNode->removeChild(chunk.mNode);
+
+    chunk.mNode->detachObject(chunk.mObject);
+    mSceneManager->destroyManualObject(chunk.mObject);
+    mSceneManager->destroySceneNode(chunk.mNode);
+    chunk = TileChunk();
+    --mNbTileChunks;
+}
+
+void RenderManager::updateTileChunkAttachment(TileChunk& chunk)
+{
+    bool attach = (chunk.mNbCulledTiles < chunk.mNbTiles);
+    if(attach == chunk.mIsAttached)
+        return;
+
+    chunk.mIsAttached = attach;
+    if(attach)
+        mTileSceneNode->addChild(chunk.mNode);
     else
+        mTileSceneNode->removeChild(chunk.mNode);
+}
+
+const TileChunkSourceMesh* RenderManager::getTileChunkSourceMesh(const std::string& meshName)
+{
+    if(meshName.empty())
+        return nullptr;
+
+    auto it = mTileChunkSourceMeshes.find(meshName);
+    if(it != mTileChunkSourceMeshes.end())
+        return &it->second;
+
+    TileChunkSourceMesh& sourceMesh = mTileChunkSourceMeshes[meshName];
+    Ogre::MeshPtr meshPtr = loadTileMesh(meshName);
+    unsigned short srcTexCoord, destTexCoord;
+    if (!meshPtr->suggestTangentVectorBuildParams(Ogre::VES_TANGENT, srcTexCoord, destTexCoord))
     {
-        std::string tileNodeName = tileName + "_node";
-        ent = mSceneMgr->createEntity(selectorName, "SquareSelector.mesh");
+        meshPtr->buildTangentVectors(Ogre::VES_TANGENT, srcTexCoord, destTexCoord);
+    }
+
+    for(unsigned short i = 0; i < meshPtr->getNumSubMeshes(); ++i)
+    {
+        const Ogre::SubMesh* subMesh = meshPtr->getSubMesh(i);
+        if(subMesh->operationType != Ogre::RenderOperation::OT_TRIANGLE_LIST)
+        {
+            OD_LOG_WRN("Only triangle lists can be merged in tile chunks mesh=" + meshName);
+            continue;
+        }
+
+        const Ogre::VertexData* vertexData = subMesh->useSharedVertices ? meshPtr->sharedVertexData : subMesh->vertexData;
+        const Ogre::IndexData* indexData = subMesh->indexData;
+        if((vertexData == nullptr) || (indexData == nullptr))
+            continue;
+
+        sourceMesh.mSubMeshes.emplace_back();
+        TileChunkSourceMesh::SubMesh& dest = sourceMesh.mSubMeshes.back();
+        dest.mMaterialName = subMesh->getMaterialName();
+        dest.mVertices.resize(vertexData->vertexCount, TileChunkVertex());
+
+        // We read the elements we need. If some are missing, they are left to 0
+        struct ElementToRead
+        {
+            Ogre::VertexElementSemantic mSemantic;
+            std::size_t mOffset;
+            unsigned short mNbComponents;
+        };
+        const ElementToRead elements[] = {
+            {Ogre::VES_POSITION, offsetof(TileChunkVertex, mPosition), 3},
+            {Ogre::VES_NORMAL, offsetof(TileChunkVertex, mNormal), 3},
+            {Ogre::VES_TANGENT, offsetof(TileChunkVertex, mTangent), 3},
+            {Ogre::VES_TEXTURE_COORDINATES, offsetof(TileChunkVertex, mTexCoord), 2}
+        };
+        for(const ElementToRead& element : elements)
+        {
+            const Ogre::VertexElement* vertexElement = vertexData->vertexDeclaration->findElementBySemantic(element.mSemantic);
+            if(vertexElement == nullptr)
+                continue;
+
+            if(Ogre::VertexElement::getBaseType(vertexElement->getType()) != Ogre::VET_FLOAT1)
+            {
+                OD_LOG_WRN("Unexpected vertex element type for mesh=" + meshName);
+                continue;
+            }
+
+            unsigned short nbComponents = std::min(element.mNbComponents,
+                Ogre::VertexElement::getTypeCount(vertexElement->getType()));
+            Ogre::HardwareVertexBufferSharedPtr buffer = vertexData->vertexBufferBinding->getBuffer(vertexElement->getSource());
+            unsigned char* data = static_cast<unsigned char*>(buffer->lock(Ogre::HardwareBuffer::HBL_READ_ONLY));
+            data += vertexData->vertexStart * buffer->getVertexSize();
+            for(std::size_t v = 0; v < vertexData->vertexCount; ++v, data += buffer->getVertexSize())
+            {
+                float* values;
+                vertexElement->baseVertexPointerToElement(data, &values);
+                float* destValues = reinterpret_cast<float*>(reinterpret_cast<unsigned char*>(&dest.mVertices[v]) + element.mOffset);
+                for(unsigned short c = 0; c < nbComponents; ++c)
+                    destValues[c] = values[c];
+            }
+            buffer->unlock();
+        }
+
+        Ogre::HardwareIndexBufferSharedPtr indexBuffer = indexData->indexBuffer;
+        dest.mIndices.resize(indexData->indexCount);
+        if(indexBuffer->getType() == Ogre::HardwareIndexBuffer::IT_32BIT)
+        {
+            const uint32_t* indexes = static_cast<const uint32_t*>(indexBuffer->lock(Ogre::HardwareBuffer::HBL_READ_ONLY));
+            for(std::size_t k = 0; k < indexData->indexCount; ++k)
+                dest.mIndices[k] = indexes[indexData->indexStart + k];
+        }
+        else
+        {
+            const uint16_t* indexes = static_cast<const uint16_t*>(indexBuffer->lock(Ogre::HardwareBuffer::HBL_READ_ONLY));
+            for(std::size_t k = 0; k < indexData->indexCount; ++k)
+                dest.mIndices[k] = indexes[indexData->indexStart + k];
+        }
+        indexBuffer->unlock();
+    }
+
+    return &sourceMesh;
+}
+
+void RenderManager::rrTemporalMarkTile(Tile* curTile)
+{
+    if(curTile->getEntityNode() == nullptr)
+        return;
+
+    bool bb = curTile->getSelected();
+
+    EntityRenderHandles& handles = getRenderHandles(*curTile);
+    Ogre::Entity* ent = handles.mSelectorEntity;
+    if (ent == nullptr)
+    {
+        std::string selectorName = curTile->getOgreNamePrefix() + curTile->getName() + "_selection_indicator";
+        ent = mSceneManager->createEntity(selectorName, "SquareSelector.mesh");
         ent->setLightMask(0);
         ent->setCastShadows(false);
-        Ogre::SceneNode* tileNode = mSceneManager->getSceneNode(tileNodeName);
-        Ogre::SceneNode* selectorNode = tileNode->createChildSceneNode(selectorName + "Node");
+        Ogre::SceneNode* selectorNode = curTile->getEntityNode()->createChildSceneNode(selectorName + "Node");
         selectorNode->setInheritScale(false);
         selectorNode->attachObject(ent);
+        handles.mSelectorEntity = ent;
+        handles.mSelectorNode = selectorNode;
     }
 
     ent->setVisible(bb);
@@ -711,22 +1008,7 @@ void RenderManager::rrCreateRenderedMovableEntity(RenderedMovableEntity* rendere
 
     renderedMovableEntity->setParentSceneNode(node->getParentSceneNode());
     renderedMovableEntity->setEntityNode(node);
-
-    // If it is required, we hide the tile
-    if((renderedMovableEntity->getHideCoveredTile()) &&
-       (renderedMovableEntity->getOpacity() >= 1.0))
-    {
-        Tile* posTile = renderedMovableEntity->getPositionTile();
-        if(posTile == nullptr)
-            return;
-
-        std::string tileName = posTile->getOgreNamePrefix() + posTile->getName();
-        if (!mSceneManager->hasEntity(tileName))
-            return;
-
-        Ogre::Entity* entity = mSceneManager->getEntity(tileName);
-        entity->setVisible(false);
-    }
+    mEntityRenderHandles[renderedMovableEntity].mEntity = ent;
 
     if ((ent != nullptr) && (renderedMovableEntity->getOpacity() < 1.0f))
         setEntityOpacity(ent, renderedMovableEntity->getOpacity());
@@ -734,62 +1016,30 @@ void RenderManager::rrCreateRenderedMovableEntity(RenderedMovableEntity* rendere
 
 void RenderManager::rrDestroyRenderedMovableEntity(RenderedMovableEntity* curRenderedMovableEntity)
 {
-    std::string tempString = curRenderedMovableEntity->getOgreNamePrefix()
-                             + curRenderedMovableEntity->getName();
     Ogre::SceneNode* node = curRenderedMovableEntity->getEntityNode();
-    if(mSceneManager->hasEntity(tempString))
+    Ogre::Entity* ent = getRenderHandles(*curRenderedMovableEntity).mEntity;
+    if(ent != nullptr)
     {
-        Ogre::Entity* ent = mSceneManager->getEntity(tempString);
         node->detachObject(ent);
         mSceneManager->destroyEntity(ent);
     }
+    mEntityRenderHandles.erase(curRenderedMovableEntity);
     mSceneManager->destroySceneNode(node);
     curRenderedMovableEntity->setParentSceneNode(nullptr);
     curRenderedMovableEntity->setEntityNode(nullptr);
-
-    // If it was hidden, we display the tile
-    if(curRenderedMovableEntity->getHideCoveredTile())
-    {
-        Tile* posTile = curRenderedMovableEntity->getPositionTile();
-        if(posTile == nullptr)
-            return;
-
-        std::string tileName = posTile->getOgreNamePrefix() + posTile->getName();
-        if (!mSceneManager->hasEntity(tileName))
-            return;
-
-        Ogre::Entity* entity = mSceneManager->getEntity(tileName);
-        if (posTile->getCoveringBuilding() != nullptr)
-            entity->setVisible(posTile->getCoveringBuilding()->shouldDisplayGroundTile());
-        else
-            entity->setVisible(true);
-    }
 }
 
 void RenderManager::rrUpdateEntityOpacity(RenderedMovableEntity* entity)
 {
-    std::string entStr = entity->getOgreNamePrefix() + entity->getName();
-    Ogre::Entity* ogreEnt = mSceneManager->hasEntity(entStr) ? mSceneManager->getEntity(entStr) : nullptr;
+    auto it = mEntityRenderHandles.find(entity);
+    Ogre::Entity* ogreEnt = (it != mEntityRenderHandles.end()) ? it->second.mEntity : nullptr;
     if (ogreEnt == nullptr)
     {
-        OD_LOG_INF("Update opacity: Couldn't find entity: " + entStr);
+        OD_LOG_INF("Update opacity: Couldn't find entity: " + entity->getOgreNamePrefix() + entity->getName());
         return;
     }
 
     setEntityOpacity(ogreEnt, entity->getOpacity());
-
-    // We add the tile if it is required and the opacity is 1. Otherwise, we show it (in case the trap gets deactivated)
-    bool tileVisible = (!entity->getHideCoveredTile() || (entity->getOpacity() < 1.0f));
-    Tile* posTile = entity->getPositionTile();
-    if(posTile != nullptr)
-    {
-        std::string tileName = posTile->getOgreNamePrefix() + posTile->getName();
-        if (mSceneManager->hasEntity(tileName))
-        {
-            Ogre::Entity* ogreEntity = mSceneManager->getEntity(tileName);
-            ogreEntity->setVisible(tileVisible);
-        }
-    }
 }
 
 void RenderManager::rrCreateCreature(Creature* curCreature)
@@ -811,6 +1061,7 @@ void RenderManager::rrCreateCreature(Creature* curCreature)
     node->setPosition(curCreature->getPosition());
     node->attachObject(ent);
     curCreature->setParentSceneNode(node->getParentSceneNode());
+    mEntityRenderHandles[curCreature].mEntity = ent;
 
     Ogre::Camera* cam = mViewport->getCamera();
     CreatureOverlayStatus* creatureOverlay = new CreatureOverlayStatus(curCreature, ent, cam);
@@ -827,23 +1078,24 @@ void RenderManager::rrDestroyCreature(Creature* curCreature)
         curCreature->setOverlayStatus(nullptr);
     }
 
-    std::string creatureName = curCreature->getOgreNamePrefix() + curCreature->getName();
-    if (mSceneManager->hasEntity(creatureName))
+    auto it = mEntityRenderHandles.find(curCreature);
+    if (it != mEntityRenderHandles.end())
     {
         Ogre::SceneNode* creatureNode = curCreature->getEntityNode();
-        Ogre::Entity* ent = mSceneManager->getEntity(creatureName);
+        Ogre::Entity* ent = it->second.mEntity;
         creatureNode->detachObject(ent);
         mCreatureSceneNode->removeChild(creatureNode);
         curCreature->setParentSceneNode(nullptr);
         curCreature->setEntityNode(nullptr);
         mSceneManager->destroyEntity(ent);
-        mSceneManager->destroySceneNode(creatureNode->getName());
+        mSceneManager->destroySceneNode(creatureNode);
+        mEntityRenderHandles.erase(it);
     }
 }
 
 void RenderManager::rrOrientEntityToward(MovableGameEntity* gameEntity, const Ogre::Vector3& direction)
 {
-    Ogre::SceneNode* node = mSceneManager->getSceneNode(gameEntity->getOgreNamePrefix() + gameEntity->getName() + "_node");
+    Ogre::SceneNode* node = gameEntity->getEntityNode();
     Ogre::Vector3 tempVector = node->getOrientation() * Ogre::Vector3::NEGATIVE_UNIT_Y;
 
     // Work around 180 degree quaternion rotation quirk
@@ -872,7 +1124,8 @@ void RenderManager::rrScaleCreature(Creature& creature)
 
 void RenderManager::rrCreateWeapon(Creature* curCreature, const Weapon* curWeapon, const std::string& hand)
 {
-    Ogre::Entity* ent = mSceneManager->getEntity(curCreature->getOgreNamePrefix() + curCreature->getName());
+    EntityRenderHandles& handles = getRenderHandles(*curCreature);
+    Ogre::Entity* ent = handles.mEntity;
     std::string weaponName = curWeapon->getOgreNamePrefix() + hand;
     if(!ent->getSkeleton()->hasBone(weaponName))
     {
@@ -894,16 +1147,18 @@ void RenderManager::rrCreateWeapon(Creature* curCreature, const Weapon* curWeapo
 
     ent->attachObjectToBone(weaponBone->getName(), weaponEntity,
                             rotationQuaternion);
+    handles.mWeaponEntities[getWeaponHandIndex(hand)] = weaponEntity;
 }
 
 void RenderManager::rrDestroyWeapon(Creature* curCreature, const Weapon* curWeapon, const std::string& hand)
 {
-    std::string weaponEntityName = curWeapon->getOgreNamePrefix() + hand + "_" + curCreature->getName();
-    if(mSceneManager->hasEntity(weaponEntityName))
+    EntityRenderHandles& handles = getRenderHandles(*curCreature);
+    Ogre::Entity*& weaponEntity = handles.mWeaponEntities[getWeaponHandIndex(hand)];
+    if(weaponEntity != nullptr)
     {
-        Ogre::Entity* weaponEntity = mSceneManager->getEntity(weaponEntityName);
         weaponEntity->detachFromParent();
         mSceneManager->destroyEntity(weaponEntity);
+        weaponEntity = nullptr;
     }
 }
 
@@ -925,11 +1180,14 @@ void RenderManager::rrCreateMapLight(MapLight* curMapLight, bool displayVisual)
     curMapLight->setParentSceneNode(mapLightNode->getParentSceneNode());
     mapLightNode->setPosition(curMapLight->getPosition());
 
+    EntityRenderHandles& handles = mEntityRenderHandles[curMapLight];
+    handles.mLight = light;
     if (displayVisual)
     {
         // Create the MapLightIndicator mesh so the light can be drug around in the map editor.
         Ogre::Entity* lightEntity = mSceneManager->createEntity(mapLightName, "Lamp.mesh");
         mapLightNode->attachObject(lightEntity);
+        handles.mEntity = lightEntity;
     }
 
     // Create the "flicker_node" which moves around randomly relative to
@@ -941,40 +1199,37 @@ void RenderManager::rrCreateMapLight(MapLight* curMapLight, bool displayVisual)
 
 void RenderManager::rrDestroyMapLight(MapLight* curMapLight)
 {
-    std::string mapLightName = curMapLight->getOgreNamePrefix() + curMapLight->getName();
-    if (mSceneManager->hasLight(mapLightName + "_light"))
+    auto it = mEntityRenderHandles.find(curMapLight);
+    if (it != mEntityRenderHandles.end())
     {
-        Ogre::Light* light = mSceneManager->getLight(mapLightName + "_light");
-        Ogre::SceneNode* lightNode = mSceneManager->getSceneNode(mapLightName + "_node");
-        Ogre::SceneNode* lightFlickerNode = mSceneManager->getSceneNode(mapLightName
-                                            + "_flicker_node");
+        Ogre::Light* light = it->second.mLight;
+        Ogre::SceneNode* lightNode = curMapLight->getEntityNode();
+        Ogre::SceneNode* lightFlickerNode = curMapLight->getFlickerNode();
         lightFlickerNode->detachObject(light);
         mLightSceneNode->removeChild(lightNode);
         mSceneManager->destroyLight(light);
 
-        if (mSceneManager->hasEntity(mapLightName))
-        {
-            Ogre::Entity* mapLightIndicatorEntity = mSceneManager->getEntity(
-                mapLightName);
-            lightNode->detachObject(mapLightIndicatorEntity);
-        }
-        mSceneManager->destroySceneNode(lightFlickerNode->getName());
-        mSceneManager->destroySceneNode(lightNode->getName());
+        if (it->second.mEntity != nullptr)
+            lightNode->detachObject(it->second.mEntity);
+
+        mSceneManager->destroySceneNode(lightFlickerNode);
+        mSceneManager->destroySceneNode(lightNode);
+        mEntityRenderHandles.erase(it);
     }
 }
 
 void RenderManager::rrDestroyMapLightVisualIndicator(MapLight* curMapLight)
 {
-    std::string mapLightName = curMapLight->getOgreNamePrefix() + curMapLight->getName();
-    if (mSceneManager->hasLight(mapLightName + "_light"))
+    auto it = mEntityRenderHandles.find(curMapLight);
+    if (it != mEntityRenderHandles.end())
     {
-        Ogre::SceneNode* mapLightNode = mSceneManager->getSceneNode(mapLightName + "_node");
-        std::string mapLightIndicatorName = mapLightName;
-        if (mSceneManager->hasEntity(mapLightIndicatorName))
+        Ogre::SceneNode* mapLightNode = curMapLight->getEntityNode();
+        Ogre::Entity* mapLightIndicatorEntity = it->second.mEntity;
+        if (mapLightIndicatorEntity != nullptr)
         {
-            Ogre::Entity* mapLightIndicatorEntity = mSceneManager->getEntity(mapLightIndicatorName);
             mapLightNode->detachObject(mapLightIndicatorEntity);
             mSceneManager->destroyEntity(mapLightIndicatorEntity);
+            it->second.mEntity = nullptr;
             //NOTE: This line throws an error complaining 'scene node not found' that should not be happening.
             //mSceneManager->destroySceneNode(node->getName());
         }
@@ -983,7 +1238,7 @@ void RenderManager::rrDestroyMapLightVisualIndicator(MapLight* curMapLight)
 
 void RenderManager::rrPickUpEntity(GameEntity* curEntity, Player* localPlayer)
 {
-    Ogre::Entity* ent = mSceneManager->getEntity("keeperHandEnt");
+    Ogre::Entity* ent = mHandKeeperEntity;
     if(ent->hasAnimationState("Pickup"))
         mHandAnimationState = setEntityAnimation(ent, "Pickup", false);
 
@@ -1007,7 +1262,7 @@ void RenderManager::rrPickUpEntity(GameEntity* curEntity, Player* localPlayer)
 
 void RenderManager::rrDropHand(GameEntity* curEntity, Player* localPlayer)
 {
-    Ogre::Entity* ent = mSceneManager->getEntity("keeperHandEnt");
+    Ogre::Entity* ent = mHandKeeperEntity;
     if(ent->hasAnimationState("Drop"))
         mHandAnimationState = setEntityAnimation(ent, "Drop", false);
 
@@ -1052,7 +1307,7 @@ void RenderManager::rrRotateHand(Player* localPlayer)
     const std::vector<GameEntity*>& objectsInHand = localPlayer->getObjectsInHand();
     for (GameEntity* tmpEntity : objectsInHand)
     {
-        Ogre::SceneNode* tmpEntityNode = mSceneManager->getSceneNode(tmpEntity->getOgreNamePrefix() + tmpEntity->getName() + "_node");
+        Ogre::SceneNode* tmpEntityNode = tmpEntity->getEntityNode();
         tmpEntityNode->setPosition(static_cast<Ogre::Real>(i % 6 + 1), static_cast<Ogre::Real>(i / 6), static_cast<Ogre::Real>(0.0));
         ++i;
     }
@@ -1082,10 +1337,10 @@ void RenderManager::rrDestroyCreatureVisualDebug(Creature* curCreature, Tile* cu
     std::stringstream tempSS;
     tempSS << "Vision_indicator_" << curCreature->getName() << "_"
         << curTile->getX() << "_" << curTile->getY();
-    if (mSceneManager->hasEntity(tempSS.str()))
+    Ogre::Entity* visIndicatorEntity = findEntityByName(tempSS.str());
+    if (visIndicatorEntity != nullptr)
     {
-        Ogre::Entity* visIndicatorEntity = mSceneManager->getEntity(tempSS.str());
-        Ogre::SceneNode* visIndicatorNode = mSceneManager->getSceneNode(tempSS.str() + "_node");
+        Ogre::SceneNode* visIndicatorNode = visIndicatorEntity->getParentSceneNode();
 
         visIndicatorNode->detachAllObjects();
         mSceneManager->destroyEntity(visIndicatorEntity);
@@ -1117,10 +1372,10 @@ void RenderManager::rrDestroySeatVisionVisualDebug(int seatId, Tile* tile)
     std::stringstream tempSS;
     tempSS << "Seat_Vision_indicator" << seatId << "_"
         << tile->getX() << "_" << tile->getY();
-    if (mSceneManager->hasEntity(tempSS.str()))
+    Ogre::Entity* visIndicatorEntity = findEntityByName(tempSS.str());
+    if (visIndicatorEntity != nullptr)
     {
-        Ogre::Entity* visIndicatorEntity = mSceneManager->getEntity(tempSS.str());
-        Ogre::SceneNode* visIndicatorNode = mSceneManager->getSceneNode(tempSS.str() + "_node");
+        Ogre::SceneNode* visIndicatorNode = visIndicatorEntity->getParentSceneNode();
 
         visIndicatorNode->detachAllObjects();
         mSceneManager->destroyEntity(visIndicatorEntity);
@@ -1130,12 +1385,11 @@ void RenderManager::rrDestroySeatVisionVisualDebug(int seatId, Tile* tile)
 
 void RenderManager::rrSetObjectAnimationState(MovableGameEntity* curAnimatedObject, const std::string& animation, bool loop)
 {
-    std::string objectName = curAnimatedObject->getOgreNamePrefix()
-        + curAnimatedObject->getName();
-    if (!mSceneManager->hasEntity(objectName))
+    auto it = mEntityRenderHandles.find(curAnimatedObject);
+    if ((it == mEntityRenderHandles.end()) || (it->second.mEntity == nullptr))
         return;
 
-    Ogre::Entity* objectEntity = mSceneManager->getEntity(objectName);
+    Ogre::Entity* objectEntity = it->second.mEntity;
 
     // Can't animate entities without skeleton
     if (!objectEntity->hasSkeleton())
@@ -1278,21 +1532,91 @@ void RenderManager::colourizeEntity(Ogre::Entity *ent, const Seat* seat, bool ma
     {
         Ogre::SubEntity *tempSubEntity = ent->getSubEntity(i);
 
-        std::string materialName = tempSubEntity->getMaterialName();
-        // If the material name have been modified, we restore the original name
-        std::size_t index = materialName.find("##");
-        if(index != std::string::npos)
-            materialName = materialName.substr(0, index);
-
-        materialName = colourizeMaterial(materialName, seat, markedForDigging, playerHasVision);
-        tempSubEntity->setMaterialName(materialName);
+        // If the material have been modified, we use the original one
+        uint32_t materialId = getBaseMaterialId(tempSubEntity->getMaterial());
+        const MaterialVariant& variant = getMaterialVariant(materialId, seat, markedForDigging, playerHasVision);
+        if(tempSubEntity->getMaterial() != variant.mMaterial)
+            tempSubEntity->setMaterial(variant.mMaterial);
     }
 }
 
-std::string RenderManager::colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision)
+const std::string& RenderManager::colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision)
 {
-    if (seat == nullptr && !markedForDigging && playerHasVision)
-        return materialName;
+    return getMaterialVariant(getMaterialId(materialName), seat, markedForDigging, playerHasVision).mName;
+}
+
+uint32_t RenderManager::getMaterialId(const std::string& materialName)
+{
+    auto it = mMaterialIds.find(materialName);
+    if(it != mMaterialIds.end())
+        return it->second;
+
+    uint32_t materialId = static_cast<uint32_t>(mMaterialNames.size());
+    mMaterialIds.emplace(materialName, materialId);
+    mMaterialNames.push_back(materialName);
+    return materialId;
+}
+
+uint32_t RenderManager::getBaseMaterialId(const Ogre::MaterialPtr& material)
+{
+    auto it = mMaterialBaseIds.find(material.get());
+    if(it != mMaterialBaseIds.end())
+        return it->second;
+
+    // If the material name have been modified, we restore the original name
+    std::string materialName = material->getName();
+    std::size_t index = materialName.find("##");
+    if(index != std::string::npos)
+        materialName = materialName.substr(0, index);
+
+    uint32_t materialId = getMaterialId(materialName);
+    mMaterialBaseIds.emplace(material.get(), materialId);
+    return materialId;
+}
+
+const RenderManager::MaterialVariant& RenderManager::getMaterialVariant(uint32_t materialId, const Seat* seat,
+    bool markedForDigging, bool playerHasVision)
+{
+    MaterialVariantKey key;
+    key.mMaterialId = materialId;
+    key.mSeatId = (seat != nullptr) ? seat->getId() : -1;
+    // The dig mark hides the vision taint
+    if(markedForDigging)
+        key.mFlags = MaterialVariantKey::MARKED_FOR_DIGGING;
+    else if(!playerHasVision)
+        key.mFlags = MaterialVariantKey::NO_VISION;
+    else
+        key.mFlags = 0;
+
+    auto it = mMaterialVariants.find(key);
+    if(it != mMaterialVariants.end())
+    {
+        ++mNbMaterialCacheHits;
+        return it->second;
+    }
+
+    ++mNbMaterialCacheMisses;
+    MaterialVariant& variant = mMaterialVariants[key];
+    const std::string& materialName = mMaterialNames[materialId];
+    Ogre::MaterialPtr oldMaterial = Ogre::MaterialManager::getSingleton().getByName(materialName);
+#if defined(OGRE_VERSION) && OGRE_VERSION < 0x10A00
+    if (oldMaterial.isNull())
+#else
+    if (!oldMaterial)
+#endif
+    {
+        OD_LOG_ERR("Cannot find material=" + materialName);
+        variant.mName = materialName;
+        return variant;
+    }
+
+    if (seat == nullptr && key.mFlags == 0)
+    {
+        variant.mName = materialName;
+        variant.mMaterial = oldMaterial;
+        mMaterialBaseIds.emplace(oldMaterial.get(), materialId);
+        return variant;
+    }
 
     std::stringstream tempSS;
 
@@ -1311,30 +1635,26 @@ std::string RenderManager::colourizeMaterial(const std::string& materialName, co
     else if(!playerHasVision)
         tempSS << "novision_";
 
-    Ogre::MaterialPtr requestedMaterial = Ogre::MaterialManager::getSingleton().getByName(tempSS.str());
-
-    //cout << "\nCloning material:  " << tempSS.str();
+    variant.mName = tempSS.str();
+    Ogre::MaterialPtr requestedMaterial = Ogre::MaterialManager::getSingleton().getByName(variant.mName);
 
-    // If this texture has been copied and colourized, we can return
+    // If this texture has been copied and colourized (in a previous game), we can use it
 #if defined(OGRE_VERSION) && OGRE_VERSION < 0x10A00
     if (!requestedMaterial.isNull())
 #else
     if (requestedMaterial)
 #endif
-        return tempSS.str();
+    {
+        variant.mMaterial = requestedMaterial;
+        mMaterialBaseIds.emplace(requestedMaterial.get(), materialId);
+        return variant;
+    }
 
     // If not yet, then do so
+    ++mNbMaterialClones;
+    Ogre::MaterialPtr newMaterial = oldMaterial->clone(variant.mName);
+    bool cloned = mShaderGenerator->cloneShaderBasedTechniques(oldMaterial->getName(), oldMaterial->getGroup(), newMaterial->getName(), newMaterial->getGroup());
 
-    // Check to see if we find a seat with the requested color, if not then just use the original, uncolored material.
-    if (seat == nullptr && !markedForDigging && playerHasVision)
-        return materialName;
-
-    Ogre::MaterialPtr oldMaterial = Ogre::MaterialManager::getSingleton().getByName(materialName);
-
-    //std::cout << "\nMaterial does not exist, creating a new one.";
-    Ogre::MaterialPtr newMaterial = oldMaterial->clone(tempSS.str());
-	bool cloned = mShaderGenerator->cloneShaderBasedTechniques(oldMaterial->getName(), oldMaterial->getGroup(), newMaterial->getName(), newMaterial->getGroup());
-                                                            
     if(!cloned)
     {
         OD_LOG_ERR("Failed to clone rtss for material: " + materialName);
@@ -1383,15 +1703,75 @@ std::string RenderManager::colourizeMaterial(const std::string& materialName, co
         }
     }
 
-    return tempSS.str();
+    variant.mMaterial = newMaterial;
+    mMaterialBaseIds.emplace(newMaterial.get(), materialId);
+    return variant;
+}
+
+void RenderManager::rrPrewarmMaterialVariants(const GameMap& gameMap)
+{
+    // Variants are keyed by seat id. Since seat colors may change from one game to another,
+    // we forget the variants from the previous game (the cloned materials are kept by Ogre)
+    mMaterialVariants.clear();
+    uint32_t nbClones = mNbMaterialClones;
+
+    const TileSet* tileSet = gameMap.getTileSet();
+    if(tileSet == nullptr)
+        return;
+
+    // We list the materials used by the tileset
+    std::vector<uint32_t> materialIds;
+    for(uint32_t visual = 0; visual < static_cast<uint32_t>(TileVisual::countTileVisual); ++visual)
+    {
+        for(const TileSetValue& tileSetValue : tileSet->getTileValues(static_cast<TileVisual>(visual)))
+        {
+            if(!tileSetValue.getMaterialName().empty())
+            {
+                materialIds.push_back(getMaterialId(tileSetValue.getMaterialName()));
+                continue;
+            }
+
+            if(tileSetValue.getMeshName().empty())
+                continue;
+
+            Ogre::MeshPtr meshPtr = loadTileMesh(tileSetValue.getMeshName());
+            for(unsigned short i = 0; i < meshPtr->getNumSubMeshes(); ++i)
+                materialIds.push_back(getMaterialId(meshPtr->getSubMesh(i)->getMaterialName()));
+        }
+    }
+    std::sort(materialIds.begin(), materialIds.end());
+    materialIds.erase(std::unique(materialIds.begin(), materialIds.end()), materialIds.end());
+
+    std::vector<const Seat*> seats(gameMap.getSeats().begin(), gameMap.getSeats().end());
+    seats.push_back(nullptr);
+    for(uint32_t materialId : materialIds)
+    {
+        for(const Seat* seat : seats)
+        {
+            getMaterialVariant(materialId, seat, false, true);
+            getMaterialVariant(materialId, seat, true, true);
+            getMaterialVariant(materialId, seat, false, false);
+        }
+    }
+
+    OD_LOG_INF("Pre-warmed " + Helper::toString(mMaterialVariants.size()) + " material variants for "
+        + Helper::toString(materialIds.size()) + " tileset materials, cloned="
+        + Helper::toString(mNbMaterialClones - nbClones));
+}
+
+float RenderManager::getMaterialCacheHitRate() const
+{
+    uint64_t nbLookups = mNbMaterialCacheHits + mNbMaterialCacheMisses;
+    if(nbLookups == 0)
+        return 0.0f;
+
+    return static_cast<float>(mNbMaterialCacheHits) / static_cast<float>(nbLookups);
 }
 
 void RenderManager::rrCarryEntity(Creature* carrier, GameEntity* carried)
 {
-    Ogre::Entity* carrierEnt = mSceneManager->getEntity(carrier->getOgreNamePrefix() + carrier->getName());
-    Ogre::Entity* carriedEnt = mSceneManager->getEntity(carried->getOgreNamePrefix() + carried->getName());
-    Ogre::SceneNode* carrierNode = mSceneManager->getSceneNode(carrierEnt->getName() + "_node");
-    Ogre::SceneNode* carriedNode = mSceneManager->getSceneNode(carriedEnt->getName() + "_node");
+    Ogre::SceneNode* carrierNode = carrier->getEntityNode();
+    Ogre::SceneNode* carriedNode = carried->getEntityNode();
     carried->setParentNodeDetachFlags(
         EntityParentNodeAttach::DETACH_CARRIED, true);
     carriedNode->setInheritScale(false);
@@ -1402,10 +1782,8 @@ void RenderManager::rrCarryEntity(Creature* carrier, GameEntity* carried)
 
 void RenderManager::rrReleaseCarriedEntity(Creature* carrier, GameEntity* carried)
 {
-    Ogre::Entity* carrierEnt = mSceneManager->getEntity(carrier->getOgreNamePrefix() + carrier->getName());
-    Ogre::Entity* carriedEnt = mSceneManager->getEntity(carried->getOgreNamePrefix() + carried->getName());
-    Ogre::SceneNode* carrierNode = mSceneManager->getSceneNode(carrierEnt->getName() + "_node");
-    Ogre::SceneNode* carriedNode = mSceneManager->getSceneNode(carriedEnt->getName() + "_node");
+    Ogre::SceneNode* carrierNode = carrier->getEntityNode();
+    Ogre::SceneNode* carriedNode = carried->getEntityNode();
     carrierNode->removeChild(carriedNode);
     carried->setParentNodeDetachFlags(
         EntityParentNodeAttach::DETACH_CARRIED, false);
@@ -1560,7 +1938,7 @@ void RenderManager::moveWorldCoords(Ogre::Real x, Ogre::Real y)
 
 void RenderManager::entitySlapped()
 {
-    Ogre::Entity* ent = mSceneManager->getEntity("keeperHandEnt");
+    Ogre::Entity* ent = mHandKeeperEntity;
     if(ent->hasAnimationState("Slap"))
         mHandAnimationState = setEntityAnimation(ent, "Slap", false);
 }
@@ -1613,6 +1991,39 @@ void RenderManager::rrMinimapRendering(bool postRender)
     mLightSceneNode->setVisible(postRender);
 }
 
+RenderManager::EntityRenderHandles& RenderManager::getRenderHandles(const GameEntity& entity)
+{
+    auto it = mEntityRenderHandles.find(&entity);
+    if(it != mEntityRenderHandles.end())
+        return it->second;
+
+    OD_LOG_ERR("No render handles for entity=" + entity.getOgreNamePrefix() + entity.getName());
+    return mEntityRenderHandles[&entity];
+}
+
+uint32_t RenderManager::getWeaponHandIndex(const std::string& hand)
+{
+    return (hand == "L") ? 0 : 1;
+}
+
+Ogre::Entity* RenderManager::findEntityByName(const std::string& name)
+{
+    ++mNbStringLookups;
+    if(!mSceneManager->hasEntity(name))
+        return nullptr;
+
+    return mSceneManager->getEntity(name);
+}
+
+Ogre::SceneNode* RenderManager::findSceneNodeByName(const std::string& name)
+{
+    ++mNbStringLookups;
+    if(!mSceneManager->hasSceneNode(name))
+        return nullptr;
+
+    return mSceneManager->getSceneNode(name);
+}
+
 void RenderManager::changeRenderQueueRecursive(Ogre::SceneNode* node, uint8_t renderQueueId)
 {
     for(unsigned short i = 0; i < node->numAttachedObjects(); ++i)
@@ -22,10 +22,17 @@
 #ifndef RENDERMANAGER_H
 #define RENDERMANAGER_H
 
+#include "render/TileChunkMeshBuilder.h"
+
 #include <string>
 #include <OgreSingleton.h>
 #include <OgreMath.h>
+#include <OgrePrerequisites.h>
+#include <OgreSharedPtr.h>
 #include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 class GameMap;
 class Building;
@@ -42,6 +49,9 @@ class Weapon;
 namespace Ogre
 {
 class AnimationState;
+class Entity;
+class Light;
+class ManualObject;
 class OverlaySystem;
 class SceneManager;
 class SceneNode;
@@ -66,6 +76,28 @@ public:
     //! \brief Loop through the render requests in the queue and process them
     void updateRenderAnimations(Ogre::Real timeSinceLastFrame);
 
+    //! \brief Rebuilds the static geometry of the visible tile chunks that changed since the last frame
+    void updateTileChunks(const GameMap& gameMap);
+
+    //! \brief Tile chunks statistics displayed in the debug overlay
+    inline uint32_t getNbTileChunks() const
+    { return mNbTileChunks; }
+    uint32_t getNbVisibleTileChunks() const;
+    //! \brief Number of batches (draw calls) needed to draw the visible tile chunks
+    uint32_t getNbVisibleTileChunkBatches() const;
+    inline uint32_t getNbTileChunksRebuilt() const
+    { return mNbTileChunksRebuilt; }
+
+    //! \brief Number of scene objects looked up by name during the last frame. Game entities
+    //! objects are kept in mEntityRenderHandles so this should stay close to 0 in game
+    inline uint32_t getNbStringLookupsLastFrame() const
+    { return mNbStringLookupsLastFrame; }
+
+    //! \brief Material variants statistics displayed in the debug overlay
+    inline uint32_t getNbMaterialClones() const
+    { return mNbMaterialClones; }
+    float getMaterialCacheHitRate() const;
+
     //! \brief Initialize the renderer when a new game (Game or Editor) is launched
     void initGameRenderer(GameMap* gameMap);
     void stopGameRenderer(GameMap*);
@@ -100,6 +132,12 @@ public:
     void rrCreateTile(Tile& tile, const GameMap& gameMap, const Player& localPlayer);
     void rrDestroyTile(Tile& tile);
     void rrTemporalMarkTile(Tile* curTile);
+    //! \brief Creates the colorized variants of the tileset materials for every seat of the given map
+    //! so that no material has to be cloned during the game. Should be called when a map is loaded,
+    //! before the entities are created
+    void rrPrewarmMaterialVariants(const GameMap& gameMap);
+    //! \brief Called when the tile is culled or shown. The tile chunk is hidden when all its tiles are culled
+    void rrSetTileCulled(const Tile& tile, bool culled);
     void rrDetachEntity(GameEntity* curEntity);
     void rrAttachEntity(GameEntity* curEntity);
     void rrCreateRenderedMovableEntity(RenderedMovableEntity* curRenderedMovableEntity);
@@ -176,6 +214,60 @@ public:
     const Ogre::Vector3& getMenuEntityScale(Ogre::SceneNode* node);
 
 private:
+    //! \brief Ogre objects created for a game entity. They are kept to avoid looking them up
+    //! by name in the scene manager each time the entity is refreshed or moved. The entity
+    //! scene node itself is stored in the GameEntity.
+    struct EntityRenderHandles
+    {
+        //! Main entity (mesh of creatures and rendered movable entities, custom mesh of tiles
+        //! and visual indicator of map lights)
+        Ogre::Entity* mEntity = nullptr;
+        //! Tiles only
+        Ogre::SceneNode* mCustomMeshNode = nullptr;
+        Ogre::Entity* mSelectorEntity = nullptr;
+        Ogre::SceneNode* mSelectorNode = nullptr;
+        //! Creatures only. Weapons in the left and right hands
+        Ogre::Entity* mWeaponEntities[2] = {nullptr, nullptr};
+        //! Map lights only
+        Ogre::Light* mLight = nullptr;
+    };
+
+    //! \brief Returns the handles of the given entity. Logs an error if it has no handles
+    EntityRenderHandles& getRenderHandles(const GameEntity& entity);
+    static uint32_t getWeaponHandIndex(const std::string& hand);
+
+    //! \brief Looks up scene objects by name. They return nullptr if not found and are counted
+    //! in mNbStringLookups
+    Ogre::Entity* findEntityByName(const std::string& name);
+    Ogre::SceneNode* findSceneNodeByName(const std::string& name);
+
+    //! \brief The static tile meshes (from the tileset) are not rendered with one entity per tile
+    //! but merged in chunks of TileChunkMeshBuilder::CHUNK_SIZE x TileChunkMeshBuilder::CHUNK_SIZE
+    //! tiles with one batch per material variant. When a tile changes, its chunk is marked dirty
+    //! and rebuilt once in the next frame.
+    struct TileChunk
+    {
+        Ogre::SceneNode* mNode = nullptr;
+        Ogre::ManualObject* mObject = nullptr;
+        //! Number of tiles of the chunk having a mesh
+        uint32_t mNbTiles = 0;
+        //! Number of culled tiles of the chunk. If all tiles are culled, the chunk is detached
+        uint32_t mNbCulledTiles = 0;
+        uint32_t mNbBatches = 0;
+        bool mIsDirty = false;
+        bool mIsAttached = false;
+    };
+
+    //! \brief Returns the chunk containing the given tile. Creates the chunk grid if needed
+    TileChunk* getTileChunk(const Tile& tile);
+    void markTileChunkDirty(const Tile& tile);
+    void rebuildTileChunk(TileChunk& chunk, uint32_t chunkIndex, const GameMap& gameMap, const Player& localPlayer);
+    void destroyTileChunk(TileChunk& chunk);
+    void updateTileChunkAttachment(TileChunk& chunk);
+    //! \brief Returns the geometry of the given mesh. It is read from the mesh the first time
+    //! it is needed and then kept in mTileChunkSourceMeshes
+    const TileChunkSourceMesh* getTileChunkSourceMesh(const std::string& meshName);
+
     //! \brief Correctly places entities in hand next to the keeper hand
     void changeRenderQueueRecursive(Ogre::SceneNode* node, uint8_t renderQueueId);
 
@@ -186,13 +278,58 @@ private:
     //! \note If the material (wall tiles only) is marked for digging, a yellow color is added
     //! to the given color.
     //! \returns The new material name according to the current colorization.
-    std::string colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision);
+    const std::string& colourizeMaterial(const std::string& materialName, const Seat* seat, bool markedForDigging, bool playerHasVision);
 
     //! \brief Colorize an entity with the team corresponding color.
     //! \Note: if the entity is marked for digging (wall tiles only), then a yellow color
     //! is added to the current colorization.
     void colourizeEntity(Ogre::Entity* ent, const Seat* seat, bool markedForDigging, bool playerHasVision);
 
+    //! \brief Colorized version of a material
+    struct MaterialVariantKey
+    {
+        static const uint32_t MARKED_FOR_DIGGING = 0x01;
+        static const uint32_t NO_VISION = 0x02;
+
+        //! Index of the base material in mMaterialNames
+        uint32_t mMaterialId;
+        //! Seat whose color is used or -1 if not colored
+        int32_t mSeatId;
+        uint32_t mFlags;
+
+        bool operator==(const MaterialVariantKey& other) const
+        {
+            return mMaterialId == other.mMaterialId
+                && mSeatId == other.mSeatId
+                && mFlags == other.mFlags;
+        }
+    };
+
+    struct MaterialVariantKeyHash
+    {
+        std::size_t operator()(const MaterialVariantKey& key) const
+        {
+            return (static_cast<std::size_t>(key.mMaterialId) << 12)
+                ^ (static_cast<std::size_t>(key.mSeatId + 1) << 2)
+                ^ static_cast<std::size_t>(key.mFlags);
+        }
+    };
+
+    struct MaterialVariant
+    {
+        std::string mName;
+        Ogre::MaterialPtr mMaterial;
+    };
+
+    //! \brief Returns the id of the given base material name. Ids are allocated the first time a name is used
+    uint32_t getMaterialId(const std::string& materialName);
+    //! \brief Returns the id of the base material of the given material (which can be a variant)
+    uint32_t getBaseMaterialId(const Ogre::MaterialPtr& material);
+    //! \brief Returns the requested variant. If it is not in the cache, the material is cloned
+    //! and colorized
+    const MaterialVariant& getMaterialVariant(uint32_t materialId, const Seat* seat,
+        bool markedForDigging, bool playerHasVision);
+
     //! \brief Makes the material be transparent with the given opacity (0.0f - 1.0f)
     //! \returns The new material name according to the current opacity.
     std::string setMaterialOpacity(const std::string& materialName, float opacity);
@@ -233,6 +370,39 @@ private:
 
     //! Bit array to allow to display tile hand (= 0) or not (!= 0)
     uint32_t mHandKeeperHandVisibility;
+
+    //! Tile chunks grid. It is created with the first tile and cleared when the last one is destroyed
+    std::vector<TileChunk> mTileChunks;
+    int mTileChunksMapSizeX;
+    int mTileChunksMapSizeY;
+    int mNbTileChunksX;
+    uint32_t mNbTileChunkTiles;
+    uint32_t mNbTileChunks;
+    //! Indexes of the dirty chunks in mTileChunks
+    std::vector<uint32_t> mDirtyTileChunks;
+    //! Culling state of each tile (indexed by x + y * mTileChunksMapSizeX)
+    std::vector<bool> mCulledTiles;
+    std::map<std::string, TileChunkSourceMesh> mTileChunkSourceMeshes;
+    TileChunkMeshBuilder mTileChunkMeshBuilder;
+    //! Number of chunks rebuilt during the last call to updateTileChunks
+    uint32_t mNbTileChunksRebuilt;
+
+    std::unordered_map<const GameEntity*, EntityRenderHandles> mEntityRenderHandles;
+    Ogre::Entity* mHandKeeperEntity;
+
+    uint32_t mNbStringLookups;
+    uint32_t mNbStringLookupsLastFrame;
+
+    //! Material variants cache. Base material names are mapped to ids once and variants
+    //! are then looked up with MaterialVariantKey
+    std::unordered_map<std::string, uint32_t> mMaterialIds;
+    std::vector<std::string> mMaterialNames;
+    //! Base material id of the known materials (base materials and variants)
+    std::unordered_map<const Ogre::Material*, uint32_t> mMaterialBaseIds;
+    std::unordered_map<MaterialVariantKey, MaterialVariant, MaterialVariantKeyHash> mMaterialVariants;
+    uint32_t mNbMaterialClones;
+    uint64_t mNbMaterialCacheHits;
+    uint64_t mNbMaterialCacheMisses;
 };
 
 #endif // RENDERMANAGER_H
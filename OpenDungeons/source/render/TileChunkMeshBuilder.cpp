@@ -0,0 +1,163 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/TileChunkMeshBuilder.h"
+
+#include <cmath>
+
+const int TileChunkMeshBuilder::CHUNK_SIZE = 16;
+
+namespace
+{
+//! \brief 3x3 row major matrix
+struct Matrix3
+{
+    float m[3][3];
+
+    static Matrix3 identity()
+    {
+        return {{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    }
+
+    Matrix3 operator*(const Matrix3& other) const
+    {
+        Matrix3 ret;
+        for(int i = 0; i < 3; ++i)
+        {
+            for(int j = 0; j < 3; ++j)
+            {
+                ret.m[i][j] = m[i][0] * other.m[0][j]
+                    + m[i][1] * other.m[1][j]
+                    + m[i][2] * other.m[2][j];
+            }
+        }
+        return ret;
+    }
+
+    void transform(const float in[3], float out[3]) const
+    {
+        for(int i = 0; i < 3; ++i)
+            out[i] = m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2];
+    }
+};
+
+const float DEGREES_TO_RADIANS = 3.14159265358979323846f / 180.0f;
+
+//! \brief Builds the rotation matrix equivalent to rotating around X, then Y, then Z
+//! the way the tileset rotations are applied to the tile scene nodes
+Matrix3 computeRotation(float degX, float degY, float degZ)
+{
+    Matrix3 ret = Matrix3::identity();
+    if(degX != 0.0f)
+    {
+        float c = std::cos(degX * DEGREES_TO_RADIANS);
+        float s = std::sin(degX * DEGREES_TO_RADIANS);
+        ret = ret * Matrix3{{{1.0f, 0.0f, 0.0f}, {0.0f, c, -s}, {0.0f, s, c}}};
+    }
+    if(degY != 0.0f)
+    {
+        float c = std::cos(degY * DEGREES_TO_RADIANS);
+        float s = std::sin(degY * DEGREES_TO_RADIANS);
+        ret = ret * Matrix3{{{c, 0.0f, s}, {0.0f, 1.0f, 0.0f}, {-s, 0.0f, c}}};
+    }
+    if(degZ != 0.0f)
+    {
+        float c = std::cos(degZ * DEGREES_TO_RADIANS);
+        float s = std::sin(degZ * DEGREES_TO_RADIANS);
+        ret = ret * Matrix3{{{c, -s, 0.0f}, {s, c, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+    }
+    return ret;
+}
+}
+
+void TileChunkMeshBuilder::clear()
+{
+    mBatches.clear();
+}
+
+void TileChunkMeshBuilder::addInstance(const TileChunkInstance& instance)
+{
+    if(instance.mMesh == nullptr)
+        return;
+
+    Matrix3 rotation = computeRotation(instance.mRotationX, instance.mRotationY, instance.mRotationZ);
+    for(const TileChunkSourceMesh::SubMesh& subMesh : instance.mMesh->mSubMeshes)
+    {
+        if(subMesh.mIndices.empty())
+            continue;
+
+        const std::string& materialName = instance.mMaterialOverride.empty()
+            ? subMesh.mMaterialName
+            : instance.mMaterialOverride;
+        TileChunkBatch& batch = getBatch(materialName, instance.mVariant);
+
+        uint32_t baseIndex = static_cast<uint32_t>(batch.mVertices.size());
+        batch.mVertices.reserve(batch.mVertices.size() + subMesh.mVertices.size());
+        for(const TileChunkVertex& src : subMesh.mVertices)
+        {
+            TileChunkVertex dest;
+            rotation.transform(src.mPosition, dest.mPosition);
+            dest.mPosition[0] += instance.mX;
+            dest.mPosition[1] += instance.mY;
+            rotation.transform(src.mNormal, dest.mNormal);
+            rotation.transform(src.mTangent, dest.mTangent);
+            dest.mTexCoord[0] = src.mTexCoord[0];
+            dest.mTexCoord[1] = src.mTexCoord[1];
+            batch.mVertices.push_back(dest);
+        }
+
+        batch.mIndices.reserve(batch.mIndices.size() + subMesh.mIndices.size());
+        for(uint32_t index : subMesh.mIndices)
+            batch.mIndices.push_back(baseIndex + index);
+    }
+}
+
+uint32_t TileChunkMeshBuilder::getNbBatches() const
+{
+    uint32_t nb = 0;
+    for(const TileChunkBatch& batch : mBatches)
+    {
+        if(!batch.mIndices.empty())
+            ++nb;
+    }
+    return nb;
+}
+
+uint32_t TileChunkMeshBuilder::getNbVertices() const
+{
+    uint32_t nb = 0;
+    for(const TileChunkBatch& batch : mBatches)
+        nb += static_cast<uint32_t>(batch.mVertices.size());
+
+    return nb;
+}
+
+TileChunkBatch& TileChunkMeshBuilder::getBatch(const std::string& materialName, const TileChunkMaterialVariant& variant)
+{
+    // There are only a few different materials in a chunk so a linear search is fine
+    for(TileChunkBatch& batch : mBatches)
+    {
+        if((batch.mVariant == variant) && (batch.mMaterialName == materialName))
+            return batch;
+    }
+
+    mBatches.emplace_back();
+    TileChunkBatch& batch = mBatches.back();
+    batch.mMaterialName = materialName;
+    batch.mVariant = variant;
+    return batch;
+}
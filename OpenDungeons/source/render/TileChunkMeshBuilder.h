@@ -0,0 +1,123 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILECHUNKMESHBUILDER_H
+#define TILECHUNKMESHBUILDER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! \brief Vertex of a tile mesh as used by the chunk builder
+struct TileChunkVertex
+{
+    float mPosition[3];
+    float mNormal[3];
+    float mTangent[3];
+    float mTexCoord[2];
+};
+
+//! \brief Geometry of a tile mesh (one entry per sub mesh). It is extracted once per
+//! mesh by the renderer and shared by every tile using it
+struct TileChunkSourceMesh
+{
+    struct SubMesh
+    {
+        std::string mMaterialName;
+        std::vector<TileChunkVertex> mVertices;
+        std::vector<uint32_t> mIndices;
+    };
+
+    std::vector<SubMesh> mSubMeshes;
+};
+
+//! \brief Colorization of a tile material. Tiles sharing the same material and variant
+//! are merged in the same batch
+struct TileChunkMaterialVariant
+{
+    //! Id of the seat whose color should be used. -1 if the material is not colored
+    int mSeatId = -1;
+    bool mMarkedForDigging = false;
+    bool mPlayerHasVision = true;
+
+    bool operator==(const TileChunkMaterialVariant& other) const
+    {
+        return mSeatId == other.mSeatId
+            && mMarkedForDigging == other.mMarkedForDigging
+            && mPlayerHasVision == other.mPlayerHasVision;
+    }
+};
+
+//! \brief A tile mesh placed in a chunk
+struct TileChunkInstance
+{
+    const TileChunkSourceMesh* mMesh = nullptr;
+    //! Position of the tile
+    float mX = 0.0f;
+    float mY = 0.0f;
+    //! Rotation (in degrees) applied around X, then Y, then Z axis (same as the tileset)
+    float mRotationX = 0.0f;
+    float mRotationY = 0.0f;
+    float mRotationZ = 0.0f;
+    //! If not empty, replaces the material of every sub mesh
+    std::string mMaterialOverride;
+    TileChunkMaterialVariant mVariant;
+};
+
+//! \brief Merged geometry of every sub mesh sharing the same material and variant
+struct TileChunkBatch
+{
+    std::string mMaterialName;
+    TileChunkMaterialVariant mVariant;
+    std::vector<TileChunkVertex> mVertices;
+    std::vector<uint32_t> mIndices;
+};
+
+//! \brief Merges the static tile meshes of a chunk of CHUNK_SIZE x CHUNK_SIZE tiles into one
+//! batch per material variant so that a chunk can be drawn with a few draw calls instead of
+//! one entity per tile. This class only works on CPU side data and does not depend on the
+//! render system.
+class TileChunkMeshBuilder
+{
+public:
+    static const int CHUNK_SIZE;
+
+    //! \brief Returns the chunk coordinate containing the given tile coordinate
+    static inline int chunkCoord(int tileCoord)
+    { return tileCoord / CHUNK_SIZE; }
+
+    //! \brief Removes every batch
+    void clear();
+
+    //! \brief Transforms the instance mesh and appends it to the matching batches
+    void addInstance(const TileChunkInstance& instance);
+
+    inline const std::vector<TileChunkBatch>& getBatches() const
+    { return mBatches; }
+
+    //! \brief Number of non empty batches (which is the number of draw calls for the chunk)
+    uint32_t getNbBatches() const;
+
+    uint32_t getNbVertices() const;
+
+private:
+    TileChunkBatch& getBatch(const std::string& materialName, const TileChunkMaterialVariant& variant);
+
+    std::vector<TileChunkBatch> mBatches;
+};
+
+#endif // TILECHUNKMESHBUILDER_H
@@ -42,7 +42,12 @@
 
 Room::Room(GameMap* gameMap):
     Building(gameMap),
-    mNumActiveSpots(0)
+    mNumActiveSpots(0),
+    mAggregatesSeat(nullptr),
+    mAggregatesIsActive(false),
+    mAggregatesGold(0),
+    mAggregatesGoldStorage(0),
+    mIsCountedInSeat(false)
 {
 }
 
@@ -66,6 +71,8 @@ void Room::addToGameMap()
 {
     getGameMap()->addRoom(this);
     getGameMap()->addActiveObject(this);
+    mIsCountedInSeat = true;
+    updateSeatAggregates();
 }
 
 void Room::removeFromGameMap()
@@ -73,6 +80,8 @@ void Room::removeFromGameMap()
     fireEntityRemoveFromGameMap();
     getGameMap()->removeRoom(this);
     setIsOnMap(false);
+    mIsCountedInSeat = false;
+    updateSeatAggregates();
     for(Seat* seat : getGameMap()->getSeats())
     {
         for(Tile* tile : mCoveredTiles)
@@ -131,6 +140,9 @@ void Room::absorbRoom(Room *r)
     r->mCoveredTilesDestroyed.insert(r->mCoveredTilesDestroyed.end(), r->mCoveredTiles.begin(), r->mCoveredTiles.end());
     r->mCoveredTiles.clear();
 
+    updateSeatAggregates();
+    r->updateSeatAggregates();
+
     // We fire the dead event so that if there are creatures heading for this room or
     // whatever, we release them before the remove from gamemap event
     r->fireEntityDead();
@@ -675,6 +687,57 @@ void Room::repairRoom()
     }
 
     updateActiveSpots();
+    updateSeatAggregates();
+}
+
+bool Room::removeCoveredTile(Tile* t)
+{
+    if(!Building::removeCoveredTile(t))
+        return false;
+
+    updateSeatAggregates();
+    return true;
+}
+
+double Room::takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
+        Tile *tileTakingDamage, bool ko)
+{
+    double damageDone = Building::takeDamage(attacker, absoluteDamage, physicalDamage, magicalDamage, elementDamage,
+        tileTakingDamage, ko);
+    // A room is not counted anymore once its hp reached 0
+    updateSeatAggregates();
+    return damageDone;
+}
+
+void Room::updateSeatAggregates()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    Seat* seat = mIsCountedInSeat ? getSeat() : nullptr;
+    // Destroyed or absorbed rooms (without hp left) are not counted in getNbRooms but their gold still is.
+    // It must be the same condition as in GameMap::checkSeatAggregates
+    bool isActive = (seat != nullptr) && (getHP(nullptr) > 0.0);
+    int gold = (seat != nullptr) ? getTotalGoldStored() : 0;
+    int goldStorage = (seat != nullptr) ? getTotalGoldStorage() : 0;
+    if((seat == mAggregatesSeat) &&
+       (isActive == mAggregatesIsActive) &&
+       (gold == mAggregatesGold) &&
+       (goldStorage == mAggregatesGoldStorage))
+    {
+        return;
+    }
+
+    if(mAggregatesSeat != nullptr)
+        mAggregatesSeat->updateRoomAggregates(getType(), mAggregatesIsActive ? -1 : 0, -mAggregatesGold, -mAggregatesGoldStorage);
+
+    if(seat != nullptr)
+        seat->updateRoomAggregates(getType(), isActive ? 1 : 0, gold, goldStorage);
+
+    mAggregatesSeat = seat;
+    mAggregatesIsActive = isActive;
+    mAggregatesGold = gold;
+    mAggregatesGoldStorage = goldStorage;
 }
 
 bool Room::sortForMapSave(Room* r1, Room* r2)
@@ -92,6 +92,15 @@ public:
     //! \brief Sets the name, seat and associates the given tiles with the room
     virtual void setupRoom(const std::string& name, Seat* seat, const std::vector<Tile*>& tiles);
 
+    //! \brief Updates the seat economy aggregates (number of rooms, gold stored and gold storage) with the
+    //! current state of the room. Should be called when the room seat, covered tiles, hp or stored gold change.
+    //! Used on server side only
+    void updateSeatAggregates();
+
+    virtual bool removeCoveredTile(Tile* t) override;
+    double takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
+        Tile *tileTakingDamage, bool ko) override;
+
     //! \brief Checks on the neighboor tiles of the room if there are other rooms of the same type/same seat.
     //! if so, it aborbs them
     void checkForRoomAbsorbtion();
@@ -169,6 +178,16 @@ protected:
     //! \brief This function will be called when reordering room is needed (for example if another room has been absorbed)
     static void reorderRoomTiles(std::vector<Tile*>& tiles);
 private :
+    //! \brief Seat the room is currently counted in (nullptr if the room is not counted) and the values
+    //! that were added to its aggregates
+    Seat* mAggregatesSeat;
+    bool mAggregatesIsActive;
+    int mAggregatesGold;
+    int mAggregatesGoldStorage;
+
+    //! \brief true if the room is in the gamemap and should be counted in its seat aggregates
+    bool mIsCountedInSeat;
+
     void activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>& originalSpotTiles,
         const std::vector<Tile*>& newSpotTiles);
 
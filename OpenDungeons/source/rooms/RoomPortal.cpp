@@ -25,6 +25,7 @@
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
+#include "goals/Goal.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
@@ -148,6 +149,8 @@ void RoomPortal::claimForSeat(Seat* seat, Tile* tile, double danceRate)
 
     mClaimedValue = static_cast<double>(numCoveredTiles());
     setSeat(seat);
+    updateSeatAggregates();
+    getGameMap()->notifyGoalEvent(GoalEvent::rooms);
 
     for(Tile* tile : mCoveredTiles)
         tile->claimTile(seat);
@@ -199,6 +199,8 @@ void RoomPortalWave::claimForSeat(Seat* seat, Tile* tile, double danceRate)
     // In the case of RoomPortalWave, when it is claimed, it is destroyed
     for(std::pair<Tile* const, TileData*>& p : mTileData)
         p.second->mHP = 0.0;
+
+    updateSeatAggregates();
 }
 
 void RoomPortalWave::updateActiveSpots()
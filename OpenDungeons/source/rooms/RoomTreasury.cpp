@@ -344,6 +344,7 @@ int RoomTreasury::depositGold(int gold, Tile *tile)
         return wasDeposited;
 
     mGoldChanged = true;
+    updateSeatAggregates();
 
     // Tells the client to play a deposit gold sound. For now, we only send it to the players
     // with vision on tile
@@ -377,6 +378,7 @@ int RoomTreasury::withdrawGold(int gold)
         }
     }
 
+    updateSeatAggregates();
     return withdrawlAmount;
 }
 
@@ -41,6 +41,8 @@ ODClientTest::ODClientTest(const std::vector<PlayerInfo>& players, uint32_t inde
     mPlayers(players),
     mLocalPlayerIndex(indexLocalPlayer)
 {
+    // The tests expect every received message to be processed on each runFor loop
+    setMessageProcessingBudget(sf::Time::Zero);
     BOOST_CHECK(!players.empty());
     BOOST_CHECK(indexLocalPlayer < mPlayers.size());
     OD_LOG_INF("Local player is nick=" + mPlayers[mLocalPlayerIndex].mNick + ", id=" + Helper::toString(mPlayers[mLocalPlayerIndex].mPlayerId) + ", seatId=" + Helper::toString(mPlayers[mLocalPlayerIndex].mWantedSeatId));
@@ -383,8 +385,11 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             OD_LOG_INF("turnNum=" + Helper::toString(mTurnNum));
             handleTurnStarted(mTurnNum);
 
+            // The test client does not keep the gamemap. The server will see it as desynced
+            uint64_t stateHash = 0;
+            bool hasStateReport = false;
             ODPacket packSend;
-            packSend << ClientNotificationType::ackNewTurn << mTurnNum;
+            packSend << ClientNotificationType::ackNewTurn << mTurnNum << stateHash << hasStateReport;
             send(packSend);
             return true;
         }
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE BenchmarkDeterminism
+#include "BoostTestTargetConfig.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    //! Level, number of turns and seed of the runs. The level is played by 2 AIs
+    const std::string LEVEL = "TestMultiplayerSmall1v1.level";
+    const std::string NB_TURNS = "300";
+    const std::string SEED = "1234";
+
+    //! Runs the server benchmark and returns the JSON results. Returns an empty string if it failed
+    std::string runBenchmark(const std::string& executable, const boost::filesystem::path& resultFile)
+    {
+        std::string cmd = "\"" + executable + "\" --server " + LEVEL + " --benchmark " + NB_TURNS
+            + " --seed " + SEED + " --benchmarkfile \"" + resultFile.string() + "\"";
+        if(std::system(cmd.c_str()) != 0)
+            return std::string();
+
+        std::ifstream file(resultFile.string());
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    //! Returns the raw value of the given top level key in the benchmark results
+    std::string getValue(const std::string& json, const std::string& key)
+    {
+        std::string::size_type start = json.find("\"" + key + "\": ");
+        if(start == std::string::npos)
+            return std::string();
+
+        start += key.size() + 4;
+        return json.substr(start, json.find_first_of(",\n", start) - start);
+    }
+}
+
+//! The AI turn budget is counted in tiles and every random number comes from a seeded
+//! stream so 2 runs with the same seed should end in the same state.
+//! The game executable can be given as first argument. Like for the aa- tests, it is
+//! launched from the working directory where the game data is found.
+BOOST_AUTO_TEST_CASE(test_SameSeedSameState)
+{
+    boost::unit_test::master_test_suite_t& suite = boost::unit_test::framework::master_test_suite();
+    std::string executable = (suite.argc >= 2) ? suite.argv[1] : "./opendungeons";
+
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path();
+    boost::filesystem::path file1 = dir / boost::filesystem::unique_path("od-benchmark-%%%%%%%%.json");
+    boost::filesystem::path file2 = dir / boost::filesystem::unique_path("od-benchmark-%%%%%%%%.json");
+
+    std::string run1 = runBenchmark(executable, file1);
+    std::string run2 = runBenchmark(executable, file2);
+    boost::filesystem::remove(file1);
+    boost::filesystem::remove(file2);
+    BOOST_REQUIRE(!run1.empty());
+    BOOST_REQUIRE(!run2.empty());
+
+    BOOST_CHECK_EQUAL(getValue(run1, "turns"), NB_TURNS);
+    BOOST_CHECK_EQUAL(getValue(run1, "seed"), SEED);
+    BOOST_CHECK(!getValue(run1, "creatures").empty());
+    BOOST_CHECK(!getValue(run1, "state_hash").empty());
+    BOOST_CHECK_EQUAL(getValue(run1, "creatures"), getValue(run2, "creatures"));
+    BOOST_CHECK_EQUAL(getValue(run1, "state_hash"), getValue(run2, "state_hash"));
+}
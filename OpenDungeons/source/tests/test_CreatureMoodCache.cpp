@@ -0,0 +1,211 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "creaturemood/CreatureMood.h"
+#include "creaturemood/CreatureMoodCache.h"
+
+#define BOOST_TEST_MODULE CreatureMoodCache
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Mood depending on the hunger above a threshold, like CreatureMoodHunger
+class TestMoodHunger : public CreatureMood
+{
+public:
+    TestMoodHunger(int32_t startHunger, int32_t moodModifier) :
+        mStartHunger(startHunger),
+        mMoodModifier(moodModifier)
+    {}
+
+    const std::string& getModifierName() const override
+    { return mName; }
+
+    int32_t getMoodInput(const CreatureMoodInputs& inputs) const override
+    {
+        if(inputs.mHunger < mStartHunger)
+            return 0;
+
+        return inputs.mHunger - mStartHunger;
+    }
+
+    int32_t computeMood(int32_t moodInput) const override
+    { return moodInput * mMoodModifier; }
+
+    CreatureMood* clone() const override
+    { return new TestMoodHunger(*this); }
+
+private:
+    std::string mName = "Hunger";
+    int32_t mStartHunger;
+    int32_t mMoodModifier;
+};
+
+//! Mood depending on the visible allied creatures of a class, like CreatureMoodCreature
+class TestMoodCreature : public CreatureMood
+{
+public:
+    TestMoodCreature(const std::string& creatureClass, int32_t moodModifier) :
+        mCreatureClass(creatureClass),
+        mMoodModifier(moodModifier)
+    {}
+
+    const std::string& getModifierName() const override
+    { return mName; }
+
+    int32_t getMoodInput(const CreatureMoodInputs& inputs) const override
+    { return static_cast<int32_t>(inputs.getNbVisibleAlliedCreatures(mCreatureClass)); }
+
+    int32_t computeMood(int32_t moodInput) const override
+    { return moodInput * mMoodModifier; }
+
+    CreatureMood* clone() const override
+    { return new TestMoodCreature(*this); }
+
+private:
+    std::string mName = "Creature";
+    std::string mCreatureClass;
+    int32_t mMoodModifier;
+};
+
+//! Mood depending on the gold owed, like CreatureMoodFee
+class TestMoodFee : public CreatureMood
+{
+public:
+    TestMoodFee(int32_t moodModifier) :
+        mMoodModifier(moodModifier)
+    {}
+
+    const std::string& getModifierName() const override
+    { return mName; }
+
+    int32_t getMoodInput(const CreatureMoodInputs& inputs) const override
+    {
+        if(inputs.mOwedGold < 100)
+            return 0;
+
+        return inputs.mOwedGold / 100;
+    }
+
+    int32_t computeMood(int32_t moodInput) const override
+    { return moodInput * mMoodModifier; }
+
+    CreatureMood* clone() const override
+    { return new TestMoodFee(*this); }
+
+private:
+    std::string mName = "Fee";
+    int32_t mMoodModifier;
+};
+
+//! Deterministic pseudo random numbers so that the test always does the same thing
+uint32_t nextValue(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_VisibleAlliedCreatures)
+{
+    const std::string knight = "Knight";
+    const std::string wizard = "Wizard";
+    CreatureMoodInputs inputs;
+    inputs.addVisibleAlliedCreature(knight);
+    inputs.addVisibleAlliedCreature(wizard);
+    inputs.addVisibleAlliedCreature(knight);
+    // Another string with the same class name
+    inputs.addVisibleAlliedCreature(std::string("Knight"));
+    BOOST_CHECK_EQUAL(inputs.getNbVisibleAlliedCreatures("Knight"), 3);
+    BOOST_CHECK_EQUAL(inputs.getNbVisibleAlliedCreatures(wizard), 1);
+    BOOST_CHECK_EQUAL(inputs.getNbVisibleAlliedCreatures("Troll"), 0);
+    inputs.clearVisibleAlliedCreatures();
+    BOOST_CHECK_EQUAL(inputs.getNbVisibleAlliedCreatures(knight), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_CacheEquivalence)
+{
+    // Creatures with mood modifiers change values every turn like in a game. The cached mood should
+    // always be the same as the full recomputation
+    const std::vector<std::string> classes = {"Knight", "Wizard", "Troll", "DarkElf"};
+    std::vector<const CreatureMood*> moodsFighter = {
+        new TestMoodHunger(60, -1),
+        new TestMoodFee(-5),
+        new TestMoodCreature("Wizard", 3),
+        new TestMoodCreature("Troll", -4)};
+    std::vector<const CreatureMood*> moodsWorker = {
+        new TestMoodHunger(80, -2),
+        new TestMoodCreature("Knight", 2)};
+
+    const uint32_t nbCreatures = 100;
+    const uint32_t nbTurns = 500;
+    std::vector<CreatureMoodInputs> inputs(nbCreatures);
+    std::vector<CreatureMoodCache> caches(nbCreatures);
+    uint32_t seed = 42;
+    uint64_t nbMoodsComputedFull = 0;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(uint32_t i = 0; i < nbCreatures; ++i)
+        {
+            CreatureMoodInputs& creatureInputs = inputs[i];
+            // Hunger grows slowly and the creature eats sometimes
+            if((nextValue(seed) % 3) == 0)
+                creatureInputs.mHunger = std::min(100, creatureInputs.mHunger + 1);
+            if((nextValue(seed) % 200) == 0)
+                creatureInputs.mHunger = 0;
+            // Pay day every 100 turns and the creature gets paid later
+            if((turn % 100) == 0)
+                creatureInputs.mOwedGold += 150;
+            if((nextValue(seed) % 40) == 0)
+                creatureInputs.mOwedGold = 0;
+            // Allies come and go
+            if((nextValue(seed) % 10) == 0)
+            {
+                creatureInputs.clearVisibleAlliedCreatures();
+                uint32_t nbAllies = nextValue(seed) % 6;
+                for(uint32_t k = 0; k < nbAllies; ++k)
+                    creatureInputs.addVisibleAlliedCreature(classes[nextValue(seed) % classes.size()]);
+            }
+
+            // Some creatures change their definition during the game
+            const std::vector<const CreatureMood*>& moods = (((i % 2) == 0) || (turn < nbTurns / 2)) ? moodsFighter : moodsWorker;
+            int32_t cachedMood = caches[i].computeMoodModifiers(moods, creatureInputs);
+            int32_t fullMood = CreatureMoodCache::computeAllMoodModifiers(moods, creatureInputs);
+            BOOST_REQUIRE_EQUAL(cachedMood, fullMood);
+            nbMoodsComputedFull += moods.size();
+        }
+    }
+
+    uint64_t nbMoodsComputedCached = 0;
+    for(const CreatureMoodCache& cache : caches)
+        nbMoodsComputedCached += cache.getNbMoodsComputed();
+
+    BOOST_CHECK(nbMoodsComputedCached * 2 < nbMoodsComputedFull);
+    BOOST_TEST_MESSAGE(std::to_string(nbCreatures) + " creatures, " + std::to_string(nbTurns)
+        + " turns: full recomputation=" + std::to_string(nbMoodsComputedFull) + " modifiers computed, cached="
+        + std::to_string(nbMoodsComputedCached) + " modifiers computed");
+
+    for(const CreatureMood* mood : moodsFighter)
+        delete mood;
+    for(const CreatureMood* mood : moodsWorker)
+        delete mood;
+}
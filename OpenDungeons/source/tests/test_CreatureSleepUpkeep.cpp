@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entities/CreatureSleepUpkeep.h"
+
+#define BOOST_TEST_MODULE CreatureSleepUpkeep
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Does a sleeping turn like Creature::doUpkeep and CreatureActionSleep do
+void doSleepTurn(CreatureSleepUpkeep::State& state, const CreatureSleepUpkeep::Rates& rates, double hpHealPerTurn)
+{
+    state.mHp = std::min(rates.mMaxHp, state.mHp + hpHealPerTurn);
+    state.mWakefulness = std::max(0.0, state.mWakefulness - rates.mWakefulnessLostPerTurn);
+    state.mHunger = std::min(100.0, state.mHunger + rates.mHungerPerTurn);
+    state.mWakefulness = std::min(100.0, state.mWakefulness + rates.mWakefulnessGainedPerTurn);
+    state.mHp = std::min(rates.mMaxHp, state.mHp + rates.mHpPerTurn - hpHealPerTurn);
+}
+
+struct SleepResult
+{
+    uint32_t mNbTurnsSleeping;
+    uint32_t mNbFullUpkeeps;
+    CreatureSleepUpkeep::State mState;
+};
+
+//! Upkeeps a sleeping creature until it is rested. If nbUpkeepsSkippedMax is 0, every turn is a full upkeep
+SleepResult sleepUntilRested(CreatureSleepUpkeep::State state, const CreatureSleepUpkeep::Rates& rates,
+    double hpHealPerTurn, uint32_t nbUpkeepsSkippedMax)
+{
+    SleepResult result = {0, 0, state};
+    uint32_t nbUpkeepsToSkip = 0;
+    uint32_t nbUpkeepsSkipped = 0;
+    while(result.mNbTurnsSleeping < 10000)
+    {
+        ++result.mNbTurnsSleeping;
+        if(nbUpkeepsToSkip > 0)
+        {
+            --nbUpkeepsToSkip;
+            ++nbUpkeepsSkipped;
+            continue;
+        }
+
+        CreatureSleepUpkeep::applyTurns(result.mState, rates, nbUpkeepsSkipped);
+        nbUpkeepsSkipped = 0;
+        ++result.mNbFullUpkeeps;
+        doSleepTurn(result.mState, rates, hpHealPerTurn);
+        if(CreatureSleepUpkeep::isRested(result.mState, rates))
+            break;
+
+        if(nbUpkeepsSkippedMax > 0)
+            nbUpkeepsToSkip = CreatureSleepUpkeep::computeNbTurnsToSkip(result.mState, rates, nbUpkeepsSkippedMax);
+    }
+    return result;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_CanSkipTurns)
+{
+    CreatureSleepUpkeep::Rates rates = {100.0, 1.0, 0.5, 1.5, 0.2};
+    CreatureSleepUpkeep::State state = {50.0, 50.0, 10.0};
+    BOOST_CHECK(CreatureSleepUpkeep::canSkipTurns(state, rates));
+
+    // Wakefulness would be capped at 0 during the turn
+    state.mWakefulness = 0.25;
+    BOOST_CHECK(!CreatureSleepUpkeep::canSkipTurns(state, rates));
+    BOOST_CHECK_EQUAL(CreatureSleepUpkeep::computeNbTurnsToSkip(state, rates, 3), 0);
+    state.mWakefulness = 50.0;
+
+    // Decreasing values are not handled
+    rates.mHpPerTurn = -1.0;
+    BOOST_CHECK(!CreatureSleepUpkeep::canSkipTurns(state, rates));
+    rates.mHpPerTurn = 1.0;
+    rates.mWakefulnessLostPerTurn = 2.0;
+    BOOST_CHECK(!CreatureSleepUpkeep::canSkipTurns(state, rates));
+}
+
+BOOST_AUTO_TEST_CASE(test_ApplyTurns)
+{
+    CreatureSleepUpkeep::Rates rates = {100.0, 2.0, 0.5, 1.5, 0.25};
+    CreatureSleepUpkeep::State state = {90.0, 97.0, 99.5};
+    CreatureSleepUpkeep::applyTurns(state, rates, 3);
+    BOOST_CHECK_EQUAL(state.mHp, 96.0);
+    BOOST_CHECK_EQUAL(state.mWakefulness, 100.0);
+    BOOST_CHECK_EQUAL(state.mHunger, 100.0);
+    BOOST_CHECK(!CreatureSleepUpkeep::isRested(state, rates));
+
+    // The turn the creature gets rested is not skipped
+    state = {90.0, 90.0, 0.0};
+    BOOST_CHECK_EQUAL(CreatureSleepUpkeep::computeNbTurnsToSkip(state, rates, 3), 3);
+    state = {96.0, 98.0, 0.0};
+    BOOST_CHECK_EQUAL(CreatureSleepUpkeep::computeNbTurnsToSkip(state, rates, 3), 1);
+    state = {100.0, 99.0, 0.0};
+    BOOST_CHECK_EQUAL(CreatureSleepUpkeep::computeNbTurnsToSkip(state, rates, 3), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_SkippedUpkeepsEquivalence)
+{
+    // Creatures with various values sleep until they are rested with a full upkeep every turn and
+    // while skipping upkeeps. They should wake up at the same turn in the same state
+    const uint32_t nbUpkeepsSkippedMax = 3;
+    uint64_t nbTurns = 0;
+    uint64_t nbFullUpkeeps = 0;
+    for(uint32_t i = 0; i < 200; ++i)
+    {
+        double hpHealPerTurn = 0.25 * (i % 3);
+        CreatureSleepUpkeep::Rates rates = {50.0 + 10.0 * (i % 7), hpHealPerTurn + 0.5 * (i % 5),
+            0.125 * (i % 4), 1.5, 0.0625 * (i % 9)};
+        CreatureSleepUpkeep::State state = {1.0 + (i * 37) % 50, 0.5 + (i * 53) % 90, static_cast<double>((i * 11) % 100)};
+
+        SleepResult everyTurn = sleepUntilRested(state, rates, hpHealPerTurn, 0);
+        SleepResult skipping = sleepUntilRested(state, rates, hpHealPerTurn, nbUpkeepsSkippedMax);
+        BOOST_CHECK_EQUAL(everyTurn.mNbTurnsSleeping, skipping.mNbTurnsSleeping);
+        BOOST_CHECK_CLOSE(everyTurn.mState.mHp, skipping.mState.mHp, 1e-9);
+        BOOST_CHECK_CLOSE(everyTurn.mState.mWakefulness, skipping.mState.mWakefulness, 1e-9);
+        BOOST_CHECK_CLOSE(everyTurn.mState.mHunger + 1.0, skipping.mState.mHunger + 1.0, 1e-9);
+
+        // Same values should always give the same result
+        SleepResult skippingAgain = sleepUntilRested(state, rates, hpHealPerTurn, nbUpkeepsSkippedMax);
+        BOOST_CHECK_EQUAL(skippingAgain.mNbFullUpkeeps, skipping.mNbFullUpkeeps);
+        BOOST_CHECK_EQUAL(skippingAgain.mState.mHp, skipping.mState.mHp);
+
+        nbTurns += everyTurn.mNbTurnsSleeping;
+        nbFullUpkeeps += skipping.mNbFullUpkeeps;
+    }
+
+    BOOST_CHECK(nbFullUpkeeps * 2 < nbTurns);
+    BOOST_TEST_MESSAGE("200 sleeping creatures: " + std::to_string(nbTurns) + " turns sleeping, "
+        + std::to_string(nbFullUpkeeps) + " full upkeeps while skipping up to "
+        + std::to_string(nbUpkeepsSkippedMax) + " upkeeps");
+}
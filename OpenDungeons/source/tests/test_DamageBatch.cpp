@@ -0,0 +1,232 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/DamageBatch.h"
+
+#define BOOST_TEST_MODULE DamageBatch
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Fighter taking damage the way Creature::takeDamage does
+struct TestFighter
+{
+    double mHp;
+    double mMaxHp;
+    double mPhysicalDefense;
+    double mMagicalDefense;
+    double mElementDefense;
+    bool mKo;
+    uint32_t mOverlayHealthValue;
+    //! Number of times the fighter reacted to damage (overlay, death, flee...)
+    uint32_t mNbDamageUpdates;
+};
+
+struct TestHit
+{
+    uint32_t mTarget;
+    double mPhysicalDamage;
+    double mMagicalDamage;
+    bool mKo;
+};
+
+//! Same computation as Creature::computeCreatureOverlayHealthValue
+void computeOverlay(TestFighter& fighter)
+{
+    ++fighter.mNbDamageUpdates;
+    const uint32_t nbSteps = 6;
+    uint32_t value = 0;
+    if(fighter.mHp <= 0)
+        value = nbSteps + 1;
+    else
+    {
+        double healthStep = fighter.mMaxHp / static_cast<double>(nbSteps);
+        double tmpHealth = fighter.mMaxHp;
+        for(value = 0; value < nbSteps; ++value)
+        {
+            if(fighter.mHp >= tmpHealth)
+                break;
+
+            tmpHealth -= healthStep;
+        }
+    }
+    fighter.mOverlayHealthValue = value;
+}
+
+void takeDamage(TestFighter& fighter, const TestHit& hit)
+{
+    double physical = std::max(hit.mPhysicalDamage - fighter.mPhysicalDefense, 0.0);
+    double magical = std::max(hit.mMagicalDamage - fighter.mMagicalDefense, 0.0);
+    double element = std::max(0.0 - fighter.mElementDefense, 0.0);
+    double damageDone = std::min(fighter.mHp, 0.0 + physical + magical + element);
+    fighter.mHp -= damageDone;
+    if((fighter.mHp <= 0) && hit.mKo)
+    {
+        fighter.mHp = 1.0;
+        fighter.mKo = true;
+    }
+    computeOverlay(fighter);
+}
+
+std::vector<TestFighter> createArmies(uint32_t nbFighters)
+{
+    std::vector<TestFighter> fighters;
+    for(uint32_t i = 0; i < nbFighters; ++i)
+    {
+        // Enough HP for the battle to last most of the turns
+        double maxHp = 400.0 + (i % 7) * 100.0;
+        fighters.push_back({maxHp, maxHp, 1.0 + (i % 3), 0.5 * (i % 4), 1.0, false, 0, 0});
+    }
+    return fighters;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_Resolve)
+{
+    DamageBatch batch;
+    uint32_t target1 = batch.addTarget(10.0, 2.0, 0.0, 0.0);
+    uint32_t target2 = batch.addTarget(10.0, 0.0, 0.0, 0.0);
+    uint32_t target3 = batch.addTarget(10.0, 0.0, 0.0, 0.0);
+    // Defense lowers physical damage but not absolute damage
+    batch.addHit(target1, 1.0, 5.0, 0.0, 0.0, false);
+    batch.addHit(target1, 0.0, 1.0, 0.0, 0.0, false);
+    // The second hit kills, the third one is lost
+    batch.addHit(target2, 0.0, 6.0, 0.0, 0.0, false);
+    batch.addHit(target2, 0.0, 6.0, 0.0, 0.0, true);
+    batch.addHit(target2, 0.0, 6.0, 0.0, 0.0, false);
+    // KO hit: the following hits are ignored
+    batch.addHit(target3, 0.0, 0.0, 20.0, 0.0, true);
+    batch.addHit(target3, 0.0, 0.0, 20.0, 0.0, false);
+    batch.resolve();
+
+    BOOST_CHECK_EQUAL(batch.getHpLeft(target1), 6.0);
+    BOOST_CHECK_EQUAL(batch.getHitDamage(1), 0.0);
+    BOOST_CHECK_EQUAL(batch.getHpLeft(target2), 0.0);
+    BOOST_CHECK_EQUAL(batch.getHitDamage(3), 4.0);
+    BOOST_CHECK_EQUAL(batch.getHitDamage(4), 0.0);
+    BOOST_CHECK(batch.isKo(target2));
+    BOOST_CHECK(batch.isKo(target3));
+    BOOST_CHECK_EQUAL(batch.getHitDamage(6), 0.0);
+
+    // A killing blow that is not a KO hit
+    batch.clear();
+    target1 = batch.addTarget(5.0, 0.0, 0.0, 0.0);
+    batch.addHit(target1, 5.0, 0.0, 0.0, 0.0, false);
+    batch.addHit(target1, 5.0, 0.0, 0.0, 0.0, true);
+    batch.resolve();
+    BOOST_CHECK_EQUAL(batch.getHpLeft(target1), 0.0);
+    BOOST_CHECK(!batch.isKo(target1));
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkBattle)
+{
+    // 1000 fighters against 1000 fighters. Each turn, every fighter hits an enemy. We compare applying
+    // each hit immediately (with the overlay computed after each hit like in Creature::takeDamage) with
+    // the batch. Both should end with the same HP but the batch should react to damage (overlay, and in
+    // the game death, KO, flee and notifications) once per fighter hit instead of once per hit
+    const uint32_t nbFightersPerSide = 1000;
+    const uint32_t nbTurns = 50;
+    std::vector<TestFighter> fightersEager = createArmies(2 * nbFightersPerSide);
+    std::vector<TestFighter> fightersBatch = fightersEager;
+
+    std::vector<TestHit> hits;
+    hits.reserve(2 * nbFightersPerSide);
+    DamageBatch batch;
+    std::vector<uint32_t> targetIndexes(fightersBatch.size());
+    std::vector<uint32_t> fighterIndexes;
+    typedef std::chrono::steady_clock Clock;
+    double eagerMs = 0;
+    double batchMs = 0;
+    uint64_t nbUpdatesEager = 0;
+    uint64_t nbUpdatesBatch = 0;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        hits.clear();
+        for(uint32_t i = 0; i < fightersEager.size(); ++i)
+        {
+            // Focus fire on a few enemies so that some targets are hit several times
+            uint32_t firstEnemy = (i < nbFightersPerSide) ? nbFightersPerSide : 0;
+            uint32_t target = firstEnemy + ((i * 31 + turn * 7) % (nbFightersPerSide / 4));
+            hits.push_back({target, 3.0 + (i % 5), (i % 2) * 2.0, (i % 10) == 0});
+        }
+
+        Clock::time_point start = Clock::now();
+        for(const TestHit& hit : hits)
+        {
+            TestFighter& fighter = fightersEager[hit.mTarget];
+            if((fighter.mHp <= 0) || fighter.mKo)
+                continue;
+
+            takeDamage(fighter, hit);
+        }
+        eagerMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        batch.clear();
+        fighterIndexes.clear();
+        std::fill(targetIndexes.begin(), targetIndexes.end(), static_cast<uint32_t>(-1));
+        for(const TestHit& hit : hits)
+        {
+            TestFighter& fighter = fightersBatch[hit.mTarget];
+            if((fighter.mHp <= 0) || fighter.mKo)
+                continue;
+
+            uint32_t& targetIndex = targetIndexes[hit.mTarget];
+            if(targetIndex == static_cast<uint32_t>(-1))
+            {
+                targetIndex = batch.addTarget(fighter.mHp, fighter.mPhysicalDefense,
+                    fighter.mMagicalDefense, fighter.mElementDefense);
+                fighterIndexes.push_back(hit.mTarget);
+            }
+            batch.addHit(targetIndex, 0.0, hit.mPhysicalDamage, hit.mMagicalDamage, 0.0, hit.mKo);
+        }
+        batch.resolve();
+        for(uint32_t target = 0; target < batch.getNbTargets(); ++target)
+        {
+            TestFighter& fighter = fightersBatch[fighterIndexes[target]];
+            fighter.mHp = batch.getHpLeft(target);
+            if((fighter.mHp <= 0) && batch.isKo(target))
+            {
+                fighter.mHp = 1.0;
+                fighter.mKo = true;
+            }
+            computeOverlay(fighter);
+        }
+        batchMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    for(uint32_t i = 0; i < fightersEager.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(fightersEager[i].mHp, fightersBatch[i].mHp);
+        BOOST_CHECK_EQUAL(fightersEager[i].mKo, fightersBatch[i].mKo);
+        BOOST_CHECK_EQUAL(fightersEager[i].mOverlayHealthValue, fightersBatch[i].mOverlayHealthValue);
+        nbUpdatesEager += fightersEager[i].mNbDamageUpdates;
+        nbUpdatesBatch += fightersBatch[i].mNbDamageUpdates;
+    }
+    BOOST_CHECK(nbUpdatesBatch < nbUpdatesEager);
+
+    BOOST_TEST_MESSAGE(std::to_string(nbFightersPerSide) + " vs " + std::to_string(nbFightersPerSide)
+        + " fighters, " + std::to_string(nbTurns) + " turns: hits applied one by one=" + std::to_string(eagerMs)
+        + "ms (" + std::to_string(nbUpdatesEager) + " damage updates), batched hits=" + std::to_string(batchMs)
+        + "ms (" + std::to_string(nbUpdatesBatch) + " damage updates)");
+}
@@ -0,0 +1,412 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/DistanceField.h"
+#include "gamemap/FloodFillVersions.h"
+
+#define BOOST_TEST_MODULE DistanceField
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+namespace
+{
+//! Map where '#' tiles cannot be walked and digits are regions (closed doors separate regions).
+//! Other characters are in region 1
+class TestMap
+{
+public:
+    TestMap(const std::vector<std::string>& rows) :
+        mRows(rows)
+    {}
+
+    int getSizeX() const
+    { return static_cast<int>(mRows[0].size()); }
+
+    int getSizeY() const
+    { return static_cast<int>(mRows.size()); }
+
+    uint32_t getRegion(int x, int y) const
+    {
+        char c = mRows[y][x];
+        if(c == '#')
+            return 0;
+        if((c >= '2') && (c <= '9'))
+            return static_cast<uint32_t>(c - '0');
+        return 1;
+    }
+
+    void build(DistanceField& field, const std::vector<int>& sources) const
+    {
+        field.build(getSizeX(), getSizeY(), sources, [this](int x, int y) { return getRegion(x, y); });
+    }
+
+private:
+    std::vector<std::string> mRows;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_OpenGround)
+{
+    TestMap map({
+        ".....",
+        ".....",
+        "....."});
+    DistanceField field;
+    map.build(field, {0});
+    BOOST_CHECK_EQUAL(field.getDistance(0, 0), 0.0f);
+    BOOST_CHECK_EQUAL(field.getDistance(4, 0), 4.0f);
+    BOOST_CHECK_CLOSE(field.getDistance(2, 2), 2.0f * std::sqrt(2.0f), 0.001);
+    BOOST_CHECK_CLOSE(field.getDistance(4, 2), 2.0f + 2.0f * std::sqrt(2.0f), 0.001);
+    BOOST_CHECK_EQUAL(field.getNbTilesReached(), 15);
+    BOOST_CHECK(!field.isReachable(-1, 0));
+    BOOST_CHECK(!field.isReachable(5, 0));
+
+    std::vector<int> path;
+    field.getPathToSource(2, 2, path);
+    BOOST_CHECK(path == std::vector<int>({12, 6, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(test_WallsAndRegions)
+{
+    // Diagonals cannot cut wall corners and the region 2 (behind a closed door) is not reachable
+    TestMap map({
+        "..#22",
+        "#.#22",
+        "...##"});
+    DistanceField field;
+    map.build(field, {0});
+    BOOST_CHECK_EQUAL(field.getDistance(1, 1), 2.0f);
+    BOOST_CHECK_EQUAL(field.getDistance(0, 2), 4.0f);
+    // (1,1) to (2,2) would cut the corner of the wall at (2,1)
+    BOOST_CHECK_EQUAL(field.getDistance(2, 2), 4.0f);
+    BOOST_CHECK(!field.isReachable(2, 0));
+    BOOST_CHECK(!field.isReachable(3, 0));
+    BOOST_CHECK(!field.isReachable(4, 1));
+
+    std::vector<int> path;
+    field.getPathToSource(3, 0, path);
+    BOOST_CHECK(path.empty());
+    field.getPathToSource(0, 2, path);
+    BOOST_CHECK(path == std::vector<int>({10, 11, 6, 1, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(test_MultipleSources)
+{
+    TestMap map({
+        "..........",
+        "....##....",
+        ".........."});
+    DistanceField field;
+    // A source on a wall is ignored
+    map.build(field, {0, 9, 14});
+    BOOST_CHECK_EQUAL(field.getDistance(2, 0), 2.0f);
+    BOOST_CHECK_EQUAL(field.getDistance(7, 0), 2.0f);
+    BOOST_CHECK(!field.isReachable(4, 1));
+
+    std::vector<int> path;
+    field.getPathToSource(7, 0, path);
+    BOOST_CHECK_EQUAL(path.back(), 9);
+    BOOST_CHECK_EQUAL(field.getNextTile(9), -1);
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkHungryCreatures)
+{
+    // 150 creatures get hungry in the same turn on a 128x128 map with 4 hatcheries. Before the distance
+    // fields, each creature searched a path to each hatchery. We compare with a search from each creature
+    // (a distance field with the creature as single source) which is what a path search costs at best
+    const int sizeX = 128;
+    const int sizeY = 128;
+    const int nbCreatures = 150;
+    std::vector<std::string> rows(sizeY, std::string(sizeX, '.'));
+    for(int yy = 0; yy < sizeY; ++yy)
+    {
+        for(int xx = 0; xx < sizeX; ++xx)
+        {
+            // Walls with gaps to make the paths winding
+            if(((xx % 16) == 8) && ((yy % 32) != (xx % 32)))
+                rows[yy][xx] = '#';
+        }
+    }
+    TestMap map(rows);
+
+    std::vector<std::vector<int>> hatcheries;
+    const int hatcheryPositions[4][2] = {{10, 10}, {100, 20}, {30, 110}, {110, 100}};
+    for(const int* pos : hatcheryPositions)
+    {
+        std::vector<int> tiles;
+        for(int yy = pos[1]; yy < pos[1] + 3; ++yy)
+        {
+            for(int xx = pos[0]; xx < pos[0] + 3; ++xx)
+                tiles.push_back(xx + yy * sizeX);
+        }
+        hatcheries.push_back(tiles);
+    }
+
+    std::vector<int> creatures;
+    for(int i = 0; i < nbCreatures; ++i)
+    {
+        int index = (i * 7919) % (sizeX * sizeY);
+        if(map.getRegion(index % sizeX, index / sizeX) == 0)
+            ++index;
+        creatures.push_back(index);
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    std::vector<DistanceField> fields(hatcheries.size());
+    for(uint32_t i = 0; i < hatcheries.size(); ++i)
+        map.build(fields[i], hatcheries[i]);
+
+    std::vector<int> chosenWithFields;
+    std::vector<int> path;
+    for(int creature : creatures)
+    {
+        int chosen = -1;
+        float closestDist = DistanceField::UNREACHABLE;
+        for(uint32_t i = 0; i < fields.size(); ++i)
+        {
+            float dist = fields[i].getDistance(creature % sizeX, creature / sizeX);
+            if(dist >= closestDist)
+                continue;
+
+            chosen = static_cast<int>(i);
+            closestDist = dist;
+        }
+        chosenWithFields.push_back(chosen);
+        if(chosen >= 0)
+            fields[chosen].getPathToSource(creature % sizeX, creature / sizeX, path);
+    }
+    double fieldsMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::vector<int> chosenWithSearch;
+    DistanceField search;
+    for(int creature : creatures)
+    {
+        map.build(search, {creature});
+        int chosen = -1;
+        float closestDist = DistanceField::UNREACHABLE;
+        for(uint32_t i = 0; i < hatcheries.size(); ++i)
+        {
+            for(int tile : hatcheries[i])
+            {
+                float dist = search.getDistance(tile % sizeX, tile / sizeX);
+                if(dist >= closestDist)
+                    continue;
+
+                chosen = static_cast<int>(i);
+                closestDist = dist;
+            }
+        }
+        chosenWithSearch.push_back(chosen);
+    }
+    double searchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    BOOST_CHECK(chosenWithFields == chosenWithSearch);
+    BOOST_TEST_MESSAGE(std::to_string(nbCreatures) + " hungry creatures, 4 hatcheries: distance fields="
+        + std::to_string(fieldsMs) + "ms, one search per creature=" + std::to_string(searchMs) + "ms");
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkDigging)
+{
+    // 4 keepers dig in their own quadrant of a 128x128 map. Each has 3 buildings that 20 creatures
+    // look for every turn and one tile is dug somewhere every turn. We compare rebuilding every
+    // field after each floodfill change with rebuilding only the fields whose regions changed
+    // (like BuildingDistanceFields). Tiles are stored as floodfill colors (0 for walls) that are
+    // updated like GameMap::refreshFloodFill does
+    const int sizeX = 128;
+    const int sizeY = 128;
+    const int nbTurns = 300;
+    const int nbCreaturesPerTurn = 20;
+    const uint32_t teamIndex = 0;
+    const FloodFillType type = static_cast<FloodFillType>(0);
+    std::vector<uint32_t> colors(sizeX * sizeY, 0);
+    std::vector<std::vector<int>> buildings;
+    for(int keeper = 0; keeper < 4; ++keeper)
+    {
+        // Each keeper starts with a 24x24 dug area at the center of its quadrant
+        int startX = (keeper % 2) * (sizeX / 2) + 20;
+        int startY = (keeper / 2) * (sizeY / 2) + 20;
+        for(int yy = startY; yy < startY + 24; ++yy)
+        {
+            for(int xx = startX; xx < startX + 24; ++xx)
+                colors[xx + yy * sizeX] = static_cast<uint32_t>(keeper + 1);
+        }
+        for(int building = 0; building < 3; ++building)
+        {
+            std::vector<int> tiles;
+            for(int yy = startY + 2 + building * 7; yy < startY + 5 + building * 7; ++yy)
+            {
+                for(int xx = startX + 2; xx < startX + 5; ++xx)
+                    tiles.push_back(xx + yy * sizeX);
+            }
+            buildings.push_back(tiles);
+        }
+    }
+
+    FloodFillVersions versions;
+    auto getRegion = [&](int x, int y) { return colors[x + y * sizeX]; };
+    auto setColor = [&](int index, uint32_t color)
+    {
+        versions.notifyRegionChanged(teamIndex, type, colors[index], color);
+        colors[index] = color;
+    };
+    // Digs the wall tile the closest to the given position that is next to a dug tile. The tile
+    // takes the color of its neighbors and if they have different colors, the regions are merged
+    auto dig = [&](int x, int y)
+    {
+        for(int radius = 0; radius < sizeX; ++radius)
+        {
+            for(int yy = std::max(y - radius, 1); yy <= std::min(y + radius, sizeY - 2); ++yy)
+            {
+                for(int xx = std::max(x - radius, 1); xx <= std::min(x + radius, sizeX - 2); ++xx)
+                {
+                    int index = xx + yy * sizeX;
+                    if(colors[index] != 0)
+                        continue;
+
+                    std::vector<uint32_t> neighColors;
+                    for(int neigh : {index - 1, index + 1, index - sizeX, index + sizeX})
+                    {
+                        if((colors[neigh] != 0) &&
+                           (std::find(neighColors.begin(), neighColors.end(), colors[neigh]) == neighColors.end()))
+                        {
+                            neighColors.push_back(colors[neigh]);
+                        }
+                    }
+                    if(neighColors.empty())
+                        continue;
+
+                    setColor(index, neighColors[0]);
+                    for(uint32_t i = 1; i < neighColors.size(); ++i)
+                    {
+                        for(int tile = 0; tile < sizeX * sizeY; ++tile)
+                        {
+                            if(colors[tile] == neighColors[i])
+                                setColor(tile, neighColors[0]);
+                        }
+                    }
+                    return;
+                }
+            }
+        }
+    };
+
+    struct CachedField
+    {
+        DistanceField mField;
+        std::vector<uint32_t> mRegions;
+        uint64_t mVersion = 0;
+        bool mIsBuilt = false;
+    };
+    std::vector<CachedField> regionFields(buildings.size());
+    std::vector<DistanceField> globalFields(buildings.size());
+    uint64_t globalVersion = 0;
+    bool areGlobalFieldsBuilt = false;
+    uint32_t nbRegionBuilds = 0;
+    uint32_t nbGlobalBuilds = 0;
+    double regionMs = 0.0;
+    double globalMs = 0.0;
+    uint32_t nbDifferences = 0;
+    uint32_t seed = 12345;
+    auto nextRandom = [&seed]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 65536; };
+    typedef std::chrono::steady_clock Clock;
+    for(int turn = 0; turn < nbTurns; ++turn)
+    {
+        // One keeper digs a tile around its dungeon
+        int keeper = static_cast<int>(nextRandom() % 4);
+        dig((keeper % 2) * (sizeX / 2) + 32 + static_cast<int>(nextRandom() % 40) - 20,
+            (keeper / 2) * (sizeY / 2) + 32 + static_cast<int>(nextRandom() % 40) - 20);
+
+        std::vector<int> creatures;
+        for(int i = 0; i < nbCreaturesPerTurn; ++i)
+        {
+            int creatureKeeper = static_cast<int>(nextRandom() % 4);
+            int x = (creatureKeeper % 2) * (sizeX / 2) + 20 + static_cast<int>(nextRandom() % 24);
+            int y = (creatureKeeper / 2) * (sizeY / 2) + 20 + static_cast<int>(nextRandom() % 24);
+            creatures.push_back(x + y * sizeX);
+        }
+
+        // Every field is rebuilt when the floodfill changed
+        Clock::time_point start = Clock::now();
+        if(!areGlobalFieldsBuilt || (globalVersion != versions.getVersion()))
+        {
+            for(uint32_t i = 0; i < buildings.size(); ++i)
+            {
+                globalFields[i].build(sizeX, sizeY, buildings[i], getRegion);
+                ++nbGlobalBuilds;
+            }
+            globalVersion = versions.getVersion();
+            areGlobalFieldsBuilt = true;
+        }
+        std::vector<float> globalDistances;
+        for(int creature : creatures)
+        {
+            for(const DistanceField& field : globalFields)
+                globalDistances.push_back(field.getDistance(creature % sizeX, creature / sizeX));
+        }
+        globalMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // Only the fields whose regions changed are rebuilt
+        start = Clock::now();
+        for(uint32_t i = 0; i < buildings.size(); ++i)
+        {
+            CachedField& cached = regionFields[i];
+            bool isValid = cached.mIsBuilt;
+            for(uint32_t region : cached.mRegions)
+            {
+                if(!isValid)
+                    break;
+                isValid = !versions.hasRegionChanged(teamIndex, type, region, cached.mVersion);
+            }
+            if(isValid)
+                continue;
+
+            cached.mField.build(sizeX, sizeY, buildings[i], getRegion);
+            cached.mRegions.clear();
+            for(int tile : buildings[i])
+            {
+                if(std::find(cached.mRegions.begin(), cached.mRegions.end(), colors[tile]) == cached.mRegions.end())
+                    cached.mRegions.push_back(colors[tile]);
+            }
+            cached.mVersion = versions.getVersion();
+            cached.mIsBuilt = true;
+            ++nbRegionBuilds;
+        }
+        std::vector<float> regionDistances;
+        for(int creature : creatures)
+        {
+            for(const CachedField& cached : regionFields)
+                regionDistances.push_back(cached.mField.getDistance(creature % sizeX, creature / sizeX));
+        }
+        regionMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if(regionDistances != globalDistances)
+            ++nbDifferences;
+    }
+
+    // The fields must give the same distances while being built less often
+    BOOST_CHECK_EQUAL(nbDifferences, 0);
+    BOOST_CHECK_LT(nbRegionBuilds, nbGlobalBuilds);
+    BOOST_TEST_MESSAGE(std::to_string(nbTurns) + " turns with digging, 12 buildings: rebuild on any floodfill change="
+        + std::to_string(nbGlobalBuilds) + " builds, " + std::to_string(globalMs) + "ms, rebuild on region change="
+        + std::to_string(nbRegionBuilds) + " builds, " + std::to_string(regionMs) + "ms");
+}
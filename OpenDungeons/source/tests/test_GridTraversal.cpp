@@ -0,0 +1,281 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/GridTraversal.h"
+
+#define BOOST_TEST_MODULE GridTraversal
+#include "BoostTestTargetConfig.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+typedef std::vector<std::pair<int, int>> TileList;
+
+TileList traverse(double x1, double y1, double x2, double y2)
+{
+    TileList tiles;
+    GridTraversal traversal;
+    traversal.init(x1, y1, x2, y2);
+    int x;
+    int y;
+    while(traversal.next(x, y))
+        tiles.push_back(std::make_pair(x, y));
+
+    return tiles;
+}
+
+//! Returns true if the segment crosses the inside of the tile (or goes through one of its corners)
+bool segmentCrossesTile(double x1, double y1, double x2, double y2, int x, int y)
+{
+    // Liang-Barsky clipping against the tile square
+    double tMin = 0.0;
+    double tMax = 1.0;
+    const double deltas[2] = {x2 - x1, y2 - y1};
+    const double starts[2] = {x1, y1};
+    const double mins[2] = {x - 0.5, y - 0.5};
+    const double maxs[2] = {x + 0.5, y + 0.5};
+    for(int axis = 0; axis < 2; ++axis)
+    {
+        if(deltas[axis] == 0.0)
+        {
+            if((starts[axis] < mins[axis] - 1e-9) || (starts[axis] > maxs[axis] + 1e-9))
+                return false;
+            continue;
+        }
+        double t1 = (mins[axis] - starts[axis]) / deltas[axis];
+        double t2 = (maxs[axis] - starts[axis]) / deltas[axis];
+        if(t1 > t2)
+            std::swap(t1, t2);
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+    }
+    return tMin <= tMax + 1e-9;
+}
+
+//! The path the missiles used before: Bresenham line between rounded positions stored in a list
+std::list<std::pair<int, int>> tilesBetweenList(int x1, int y1, int x2, int y2)
+{
+    std::list<std::pair<int, int>> path;
+    int deltax = x2 - x1;
+    int deltay = y2 - y1;
+    int diffX = (x1 > x2) ? -1 : 1;
+    int diffY = (y1 > y2) ? -1 : 1;
+    double error = 0;
+    if(std::abs(deltax) >= std::abs(deltay))
+    {
+        double deltaerr = (deltax == 0) ? 0.0 : std::abs(static_cast<double>(deltay) / deltax);
+        int y = y1;
+        for(int x = x1; x != x2; x += diffX)
+        {
+            path.push_back(std::make_pair(x, y));
+            error += deltaerr;
+            if(error >= 0.5)
+            {
+                y += diffY;
+                error = error - 1.0;
+            }
+        }
+    }
+    else
+    {
+        double deltaerr = std::abs(static_cast<double>(deltax) / deltay);
+        int x = x1;
+        for(int y = y1; y != y2; y += diffY)
+        {
+            path.push_back(std::make_pair(x, y));
+            error += deltaerr;
+            if(error >= 0.5)
+            {
+                x += diffX;
+                error = error - 1.0;
+            }
+        }
+    }
+    path.push_back(std::make_pair(x2, y2));
+    return path;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_StraightLines)
+{
+    BOOST_CHECK(traverse(2.0, 3.0, 2.0, 3.0) == TileList({{2, 3}}));
+    BOOST_CHECK(traverse(2.0, 3.0, 2.4, 3.2) == TileList({{2, 3}}));
+    BOOST_CHECK(traverse(2.0, 3.0, 5.0, 3.0) == TileList({{2, 3}, {3, 3}, {4, 3}, {5, 3}}));
+    BOOST_CHECK(traverse(2.0, 3.0, 2.0, 0.6) == TileList({{2, 3}, {2, 2}, {2, 1}}));
+    BOOST_CHECK(traverse(0.2, 0.0, -1.6, 0.0) == TileList({{0, 0}, {-1, 0}, {-2, 0}}));
+}
+
+BOOST_AUTO_TEST_CASE(test_Diagonals)
+{
+    // Through the corners: diagonal moves
+    BOOST_CHECK(traverse(0.0, 0.0, 3.0, 3.0) == TileList({{0, 0}, {1, 1}, {2, 2}, {3, 3}}));
+    BOOST_CHECK(traverse(0.0, 0.0, -2.0, 2.0) == TileList({{0, 0}, {-1, 1}, {-2, 2}}));
+    // Close to the corner but not through it: the tile crossed is returned
+    BOOST_CHECK(traverse(0.0, 0.1, 1.0, 1.1) == TileList({{0, 0}, {0, 1}, {1, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(test_CrossedTiles)
+{
+    // Every tile crossed by the segment is returned once, in order, and every tile returned is crossed
+    for(int i = 0; i < 500; ++i)
+    {
+        double x1 = std::fmod(i * 1.37, 20.0) - 10.0;
+        double y1 = std::fmod(i * 2.71, 20.0) - 10.0;
+        double x2 = std::fmod(i * 3.14, 20.0) - 10.0;
+        double y2 = std::fmod(i * 0.57, 20.0) - 10.0;
+        TileList tiles = traverse(x1, y1, x2, y2);
+        BOOST_REQUIRE(!tiles.empty());
+        BOOST_CHECK(tiles.front() == std::make_pair(static_cast<int>(std::floor(x1 + 0.5)), static_cast<int>(std::floor(y1 + 0.5))));
+        BOOST_CHECK(tiles.back() == std::make_pair(static_cast<int>(std::floor(x2 + 0.5)), static_cast<int>(std::floor(y2 + 0.5))));
+        for(uint32_t k = 0; k < tiles.size(); ++k)
+        {
+            BOOST_CHECK(segmentCrossesTile(x1, y1, x2, y2, tiles[k].first, tiles[k].second));
+            if(k == 0)
+                continue;
+
+            BOOST_CHECK(std::abs(tiles[k].first - tiles[k - 1].first) <= 1);
+            BOOST_CHECK(std::abs(tiles[k].second - tiles[k - 1].second) <= 1);
+        }
+
+        int minX = static_cast<int>(std::floor(std::min(x1, x2) + 0.5));
+        int maxX = static_cast<int>(std::floor(std::max(x1, x2) + 0.5));
+        int minY = static_cast<int>(std::floor(std::min(y1, y2) + 0.5));
+        int maxY = static_cast<int>(std::floor(std::max(y1, y2) + 0.5));
+        uint32_t nbCrossed = 0;
+        for(int y = minY; y <= maxY; ++y)
+        {
+            for(int x = minX; x <= maxX; ++x)
+            {
+                // Tiles only touched on a corner are not always returned
+                if(segmentCrossesTile(x1, y1, x2, y2, x, y))
+                    ++nbCrossed;
+            }
+        }
+        BOOST_CHECK(tiles.size() <= nbCrossed);
+        BOOST_CHECK(tiles.size() + 2 * std::abs(maxX - minX) >= nbCrossed);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_Benchmark500Missiles)
+{
+    // 500 missiles flying over a 128x128 map where 1 tile out of 8 has a creature, during 200 turns.
+    // Before, each missile built the list of tiles crossed and, for each tile, a vector with the tile
+    // and a vector with the creatures found on it
+    const int mapSize = 128;
+    const uint32_t nbMissiles = 500;
+    const uint32_t nbTurns = 200;
+    const double speed = 6.0;
+    std::vector<uint32_t> nbCreatures(mapSize * mapSize, 0);
+    for(uint32_t i = 0; i < nbCreatures.size(); ++i)
+        nbCreatures[i] = ((i * 2654435761u) % 8 == 0) ? 1 : 0;
+
+    struct Missile
+    {
+        double mX;
+        double mY;
+        double mDirX;
+        double mDirY;
+    };
+    std::vector<Missile> missiles;
+    for(uint32_t i = 0; i < nbMissiles; ++i)
+    {
+        double angle = i * 0.731;
+        missiles.push_back({static_cast<double>(i % mapSize), static_cast<double>((i * 7) % mapSize),
+            std::cos(angle), std::sin(angle)});
+    }
+
+    auto moveMissile = [&](Missile& missile)
+    {
+        missile.mX += missile.mDirX * speed;
+        missile.mY += missile.mDirY * speed;
+        // Bounce on the map borders
+        if((missile.mX < 0) || (missile.mX > mapSize - 1))
+        {
+            missile.mDirX = -missile.mDirX;
+            missile.mX = std::min(std::max(missile.mX, 0.0), static_cast<double>(mapSize - 1));
+        }
+        if((missile.mY < 0) || (missile.mY > mapSize - 1))
+        {
+            missile.mDirY = -missile.mDirY;
+            missile.mY = std::min(std::max(missile.mY, 0.0), static_cast<double>(mapSize - 1));
+        }
+    };
+    auto roundCoord = [](double coord) { return static_cast<int>(std::floor(coord + 0.5)); };
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<Missile> missilesList = missiles;
+    uint64_t nbHitsList = 0;
+    Clock::time_point start = Clock::now();
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(Missile& missile : missilesList)
+        {
+            double destX = std::min(std::max(missile.mX + missile.mDirX * speed, 0.0), static_cast<double>(mapSize - 1));
+            double destY = std::min(std::max(missile.mY + missile.mDirY * speed, 0.0), static_cast<double>(mapSize - 1));
+            std::list<std::pair<int, int>> tiles = tilesBetweenList(roundCoord(missile.mX), roundCoord(missile.mY),
+                roundCoord(destX), roundCoord(destY));
+            for(const std::pair<int, int>& tile : tiles)
+            {
+                std::vector<uint32_t> tileVector;
+                tileVector.push_back(tile.first + tile.second * mapSize);
+                std::vector<uint32_t> creatures;
+                for(uint32_t index : tileVector)
+                {
+                    for(uint32_t k = 0; k < nbCreatures[index]; ++k)
+                        creatures.push_back(index);
+                }
+                nbHitsList += creatures.size();
+            }
+            moveMissile(missile);
+        }
+    }
+    double listMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::vector<Missile> missilesTraversal = missiles;
+    uint64_t nbHitsTraversal = 0;
+    start = Clock::now();
+    GridTraversal traversal;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(Missile& missile : missilesTraversal)
+        {
+            double destX = std::min(std::max(missile.mX + missile.mDirX * speed, 0.0), static_cast<double>(mapSize - 1));
+            double destY = std::min(std::max(missile.mY + missile.mDirY * speed, 0.0), static_cast<double>(mapSize - 1));
+            traversal.init(missile.mX, missile.mY, destX, destY);
+            int x;
+            int y;
+            while(traversal.next(x, y))
+                nbHitsTraversal += nbCreatures[x + y * mapSize];
+
+            moveMissile(missile);
+        }
+    }
+    double traversalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // The traversal finds at least the tiles found by the line (it also returns the tiles the line skips)
+    BOOST_CHECK(nbHitsTraversal >= nbHitsList);
+    BOOST_TEST_MESSAGE(std::to_string(nbMissiles) + " missiles, " + std::to_string(nbTurns) + " turns: tiles list="
+        + std::to_string(listMs) + "ms (" + std::to_string(nbHitsList) + " creatures hit), grid traversal="
+        + std::to_string(traversalMs) + "ms (" + std::to_string(nbHitsTraversal) + " creatures hit)");
+}
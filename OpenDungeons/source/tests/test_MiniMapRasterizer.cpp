@@ -0,0 +1,163 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/MiniMapRasterizer.h"
+
+#define BOOST_TEST_MODULE MiniMapRasterizer
+#include "BoostTestTargetConfig.h"
+
+#include <cmath>
+
+namespace
+{
+//! \brief Per pixel rasterizer previously used by MiniMapDrawn::update. The tile colours are
+//! read from the rasterizer map image instead of the game map
+std::vector<uint32_t> referenceRender(const MiniMapRasterizer& rasterizer, uint32_t width,
+    uint32_t height, int grainSize, float centerX, float centerY, double rotation)
+{
+    std::vector<uint32_t> tiles(width * height, MiniMapRasterizer::OUTSIDE_COLOR);
+    double cosRotation = cos(rotation);
+    double sinRotation = sin(rotation);
+
+    for (int ii = 0, mm = centerX - width / (2 * grainSize); ii < static_cast<int>(width); ++mm, ii += grainSize)
+    {
+        for (int jj = static_cast<int>(height) - static_cast<int>(grainSize), nn = centerY - height / (2 * grainSize);
+             jj >= 0; ++nn, jj -= grainSize)
+        {
+            int oo = centerX + static_cast<int>((mm - centerX) * cosRotation - (nn - centerY) * sinRotation);
+            int pp = centerY + static_cast<int>((mm - centerX) * sinRotation + (nn - centerY) * cosRotation);
+            uint32_t color = rasterizer.getTileColor(oo, pp);
+            for(int gg = 0; gg < grainSize; ++gg)
+            {
+                for(int hh = 0; hh < grainSize; ++hh)
+                    tiles[ii + gg + ((jj + hh) * width)] = color;
+            }
+        }
+    }
+    return tiles;
+}
+
+MiniMapView buildView(uint32_t width, uint32_t height, uint32_t grainSize, float centerX,
+    float centerY, double rotation)
+{
+    MiniMapView view;
+    view.mWidth = width;
+    view.mHeight = height;
+    view.mGrainSize = grainSize;
+    view.mCenterX = centerX;
+    view.mCenterY = centerY;
+    view.mCosRotation = cos(rotation);
+    view.mSinRotation = sin(rotation);
+    return view;
+}
+
+void fillMap(MiniMapRasterizer& rasterizer, int sizeX, int sizeY)
+{
+    rasterizer.resize(sizeX, sizeY);
+    for(int yy = 0; yy < sizeY; ++yy)
+    {
+        for(int xx = 0; xx < sizeX; ++xx)
+        {
+            rasterizer.setTileColor(xx, yy, MiniMapRasterizer::packColor(
+                static_cast<uint8_t>(xx * 7), static_cast<uint8_t>(yy * 13),
+                static_cast<uint8_t>((xx ^ yy) * 3)));
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_TileColors)
+{
+    MiniMapRasterizer rasterizer;
+    rasterizer.resize(4, 3);
+    BOOST_CHECK_EQUAL(rasterizer.getTileColor(1, 1), MiniMapRasterizer::OUTSIDE_COLOR);
+
+    uint32_t color = MiniMapRasterizer::packColor(0x12, 0x34, 0x56);
+    BOOST_CHECK_EQUAL(color, 0xFF123456u);
+    BOOST_CHECK(rasterizer.setTileColor(3, 2, color));
+    BOOST_CHECK(!rasterizer.setTileColor(3, 2, color));
+    BOOST_CHECK_EQUAL(rasterizer.getTileColor(3, 2), color);
+
+    // Outside of the map
+    BOOST_CHECK(!rasterizer.setTileColor(4, 0, color));
+    BOOST_CHECK(!rasterizer.setTileColor(0, -1, color));
+    BOOST_CHECK_EQUAL(rasterizer.getTileColor(-1, 0), MiniMapRasterizer::OUTSIDE_COLOR);
+    BOOST_CHECK_EQUAL(rasterizer.getTileColor(0, 3), MiniMapRasterizer::OUTSIDE_COLOR);
+}
+
+BOOST_AUTO_TEST_CASE(test_SameOutputAsReference)
+{
+    MiniMapRasterizer rasterizer;
+    fillMap(rasterizer, 50, 40);
+
+    const float centers[][2] = {{25.0f, 20.0f}, {3.4f, 7.8f}, {48.6f, 1.2f}, {-5.5f, 45.3f}};
+    const double rotations[] = {0.0, 0.3, -1.2, 3.14159, 2.5};
+    const uint32_t sizes[][3] = {{200, 160, 4}, {124, 96, 4}, {60, 90, 3}};
+    std::vector<uint32_t> output;
+    for(const uint32_t* size : sizes)
+    {
+        for(const float* center : centers)
+        {
+            for(double rotation : rotations)
+            {
+                MiniMapView view = buildView(size[0], size[1], size[2], center[0], center[1], rotation);
+                rasterizer.render(view, output);
+                std::vector<uint32_t> expected = referenceRender(rasterizer, size[0], size[1],
+                    static_cast<int>(size[2]), center[0], center[1], rotation);
+                BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+                BOOST_CHECK(output == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_RenderOnlyWhenNeeded)
+{
+    MiniMapRasterizer rasterizer;
+    fillMap(rasterizer, 100, 100);
+
+    // The view displays 10x10 tiles around (20, 20)
+    MiniMapView view = buildView(40, 40, 4, 20.0f, 20.0f, 0.0);
+    BOOST_CHECK(rasterizer.needsRender(view));
+
+    std::vector<uint32_t> output;
+    rasterizer.render(view, output);
+    BOOST_CHECK(!rasterizer.needsRender(view));
+
+    // A tile far from the view changes
+    BOOST_CHECK(rasterizer.setTileColor(80, 80, MiniMapRasterizer::packColor(1, 2, 3)));
+    BOOST_CHECK(!rasterizer.needsRender(view));
+
+    // A displayed tile changes
+    BOOST_CHECK(rasterizer.setTileColor(21, 19, MiniMapRasterizer::packColor(1, 2, 3)));
+    BOOST_CHECK(rasterizer.needsRender(view));
+    rasterizer.render(view, output);
+    BOOST_CHECK(!rasterizer.needsRender(view));
+
+    // The camera moves
+    view.mCenterX += 1.0f;
+    BOOST_CHECK(rasterizer.needsRender(view));
+    rasterizer.render(view, output);
+    view.mCosRotation = cos(0.1);
+    view.mSinRotation = sin(0.1);
+    BOOST_CHECK(rasterizer.needsRender(view));
+
+    // Resizing the map forces a new render
+    rasterizer.render(view, output);
+    rasterizer.resize(100, 100);
+    BOOST_CHECK(rasterizer.needsRender(view));
+}
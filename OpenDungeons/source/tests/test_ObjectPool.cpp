@@ -0,0 +1,295 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "creatureaction/CreatureAction.h"
+#include "utils/ObjectPool.h"
+
+#define BOOST_TEST_MODULE ObjectPool
+#include "BoostTestTargetConfig.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::atomic<uint64_t> nbGlobalAllocations(0);
+}
+
+// When gcc inlines the replaced operator delete next to a call to operator new, it only sees free
+// called on a pointer given by operator new and warns (-Wmismatched-new-delete). The array and
+// nothrow variants of the standard library call the replaced functions so they match too
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+// We count every allocation done with the global operator new
+void* operator new(std::size_t size)
+{
+    ++nbGlobalAllocations;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if(ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+TEST_NOINLINE void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_NOINLINE void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// CreatureAction only keeps a reference on its creature. Linking the real Creature would bring
+// the whole game in this test, so the test defines its own. It mimics a creature: every turn, it
+// pushes a walk action and a work action, executes them and pops them
+class Creature
+{
+public:
+    Creature() :
+        mNbWork(0),
+        mNbSteps(0)
+    {}
+
+    uint32_t mNbWork;
+    uint32_t mNbSteps;
+};
+
+namespace
+{
+const uint32_t NB_CREATURES = 200;
+const uint32_t NB_TURNS = 100;
+
+//! Actions dispatched like CreatureAction was before: the action returns a std::function binding
+//! a handler with its parameters. The handler gets copies so that it can pop the action. This
+//! dispatch is not in the game anymore so it is rebuilt here with the same layout as CreatureAction
+class BoundAction
+{
+public:
+    BoundAction(Creature& creature) :
+        mCreature(creature),
+        mNbTurns(0),
+        mNbTurnsActive(0)
+    {}
+    virtual ~BoundAction()
+    {}
+    virtual CreatureActionType getType() const = 0;
+    virtual std::function<bool()> action() = 0;
+    virtual uint32_t updateMoodModifier() const
+    { return CreatureMoodValues::Nothing; }
+protected:
+    Creature& mCreature;
+private:
+    int32_t mNbTurns;
+    int32_t mNbTurnsActive;
+};
+
+static_assert(sizeof(BoundAction) == sizeof(CreatureAction), "BoundAction should have the layout of CreatureAction");
+
+class BoundActionWork : public BoundAction
+{
+public:
+    BoundActionWork(Creature& creature, uint32_t roomId, uint32_t nbTurns) :
+        BoundAction(creature),
+        mRoomId(roomId),
+        mNbWorkTurns(nbTurns)
+    {}
+    CreatureActionType getType() const override
+    { return CreatureActionType::useRoom; }
+    std::function<bool()> action() override
+    { return std::bind(&BoundActionWork::handle, std::ref(mCreature), mRoomId, mNbWorkTurns); }
+    static bool handle(Creature& creature, uint32_t roomId, uint32_t nbTurns)
+    {
+        creature.mNbWork += nbTurns + roomId;
+        return true;
+    }
+private:
+    uint32_t mRoomId;
+    uint32_t mNbWorkTurns;
+};
+
+class BoundActionWalk : public BoundAction
+{
+public:
+    BoundActionWalk(Creature& creature, int x, int y, double speed) :
+        BoundAction(creature),
+        mX(x),
+        mY(y),
+        mSpeed(speed)
+    {}
+    CreatureActionType getType() const override
+    { return CreatureActionType::walkToTile; }
+    std::function<bool()> action() override
+    { return std::bind(&BoundActionWalk::handle, std::ref(mCreature), mX, mY, mSpeed); }
+    static bool handle(Creature& creature, int x, int y, double speed)
+    {
+        creature.mNbSteps += static_cast<uint32_t>(x + y + speed);
+        return false;
+    }
+private:
+    int mX;
+    int mY;
+    double mSpeed;
+};
+
+//! Actions dispatched like the game does now: they are real CreatureAction, so they are
+//! allocated from the ObjectPool and executed with a direct virtual call
+class PooledActionWork : public CreatureAction
+{
+public:
+    PooledActionWork(Creature& creature, uint32_t roomId, uint32_t nbTurns) :
+        CreatureAction(creature),
+        mRoomId(roomId),
+        mNbWorkTurns(nbTurns)
+    {}
+    CreatureActionType getType() const override
+    { return CreatureActionType::useRoom; }
+    bool execute() override
+    { return handle(mCreature, mRoomId, mNbWorkTurns); }
+    static bool handle(Creature& creature, uint32_t roomId, uint32_t nbTurns)
+    {
+        creature.mNbWork += nbTurns + roomId;
+        return true;
+    }
+private:
+    uint32_t mRoomId;
+    uint32_t mNbWorkTurns;
+};
+
+class PooledActionWalk : public CreatureAction
+{
+public:
+    PooledActionWalk(Creature& creature, int x, int y, double speed) :
+        CreatureAction(creature),
+        mX(x),
+        mY(y),
+        mSpeed(speed)
+    {}
+    CreatureActionType getType() const override
+    { return CreatureActionType::walkToTile; }
+    bool execute() override
+    { return handle(mCreature, mX, mY, mSpeed); }
+    static bool handle(Creature& creature, int x, int y, double speed)
+    {
+        creature.mNbSteps += static_cast<uint32_t>(x + y + speed);
+        return false;
+    }
+private:
+    int mX;
+    int mY;
+    double mSpeed;
+    // Makes this action use another size class than the work action
+    char mPadding[40];
+};
+
+template<typename Action, typename Work, typename Walk, typename Run>
+uint64_t runTurns(uint32_t firstTurn, uint32_t nbTurns, std::vector<Creature>& creatures,
+    std::vector<std::vector<std::unique_ptr<Action>>>& stacks, Run run)
+{
+    uint64_t nbAllocationsBefore = nbGlobalAllocations;
+    for(uint32_t turn = firstTurn; turn < firstTurn + nbTurns; ++turn)
+    {
+        for(uint32_t i = 0; i < creatures.size(); ++i)
+        {
+            std::vector<std::unique_ptr<Action>>& actions = stacks[i];
+            actions.emplace_back(std::unique_ptr<Action>(new Work(creatures[i], i, turn)));
+            actions.emplace_back(std::unique_ptr<Action>(new Walk(creatures[i], i, turn, 0.5)));
+            while(!actions.empty())
+            {
+                std::unique_ptr<Action> action = std::move(actions.back());
+                actions.pop_back();
+                run(*action);
+            }
+        }
+    }
+    return nbGlobalAllocations - nbAllocationsBefore;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_ReuseBlocks)
+{
+    uint64_t nbBlocksUsed = ObjectPool::getNbBlocksUsed();
+    void* block1 = ObjectPool::allocate(24);
+    void* block2 = ObjectPool::allocate(30);
+    BOOST_CHECK(block1 != block2);
+    BOOST_CHECK_EQUAL(ObjectPool::getNbBlocksUsed(), nbBlocksUsed + 2);
+    ObjectPool::deallocate(block1, 24);
+    // Same size class (17 to 32 bytes)
+    void* block3 = ObjectPool::allocate(17);
+    BOOST_CHECK(block3 == block1);
+    ObjectPool::deallocate(block2, 30);
+    ObjectPool::deallocate(block3, 17);
+    BOOST_CHECK_EQUAL(ObjectPool::getNbBlocksUsed(), nbBlocksUsed);
+
+    // Big objects are not pooled
+    uint64_t nbAllocations = nbGlobalAllocations;
+    void* bigBlock = ObjectPool::allocate(ObjectPool::MAX_POOLED_SIZE + 1);
+    BOOST_CHECK_EQUAL(nbGlobalAllocations, nbAllocations + 1);
+    ObjectPool::deallocate(bigBlock, ObjectPool::MAX_POOLED_SIZE + 1);
+    BOOST_CHECK_EQUAL(ObjectPool::getNbBlocksUsed(), nbBlocksUsed);
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkActionAllocations)
+{
+    // Each turn, every creature pushes, executes and pops 2 actions. Stacks are reserved so
+    // that only the actions allocations are counted
+    std::vector<Creature> boundCreatures(NB_CREATURES);
+    std::vector<std::vector<std::unique_ptr<BoundAction>>> boundStacks(NB_CREATURES);
+    for(std::vector<std::unique_ptr<BoundAction>>& actions : boundStacks)
+        actions.reserve(8);
+
+    std::vector<Creature> pooledCreatures(NB_CREATURES);
+    std::vector<std::vector<std::unique_ptr<CreatureAction>>> pooledStacks(NB_CREATURES);
+    for(std::vector<std::unique_ptr<CreatureAction>>& actions : pooledStacks)
+        actions.reserve(8);
+
+    uint64_t nbBound = runTurns<BoundAction, BoundActionWork, BoundActionWalk>(0, NB_TURNS, boundCreatures, boundStacks,
+        [](BoundAction& action)
+        {
+            std::function<bool()> func = action.action();
+            return func();
+        });
+
+    // The first turn fills the pool. After that, actions should not allocate anymore
+    auto runPooled = [](CreatureAction& action) { return action.execute(); };
+    runTurns<CreatureAction, PooledActionWork, PooledActionWalk>(0, 1, pooledCreatures, pooledStacks, runPooled);
+    uint64_t nbPooled = runTurns<CreatureAction, PooledActionWork, PooledActionWalk>(1, NB_TURNS - 1,
+        pooledCreatures, pooledStacks, runPooled);
+
+    BOOST_CHECK_EQUAL(nbPooled, 0);
+    BOOST_CHECK(nbBound > 0);
+    for(uint32_t i = 0; i < NB_CREATURES; ++i)
+    {
+        BOOST_CHECK_EQUAL(boundCreatures[i].mNbWork, pooledCreatures[i].mNbWork);
+        BOOST_CHECK_EQUAL(boundCreatures[i].mNbSteps, pooledCreatures[i].mNbSteps);
+    }
+
+    double nbCreatureTurns = static_cast<double>(NB_CREATURES) * NB_TURNS;
+    BOOST_TEST_MESSAGE(std::to_string(NB_CREATURES) + " creatures, " + std::to_string(NB_TURNS)
+        + " turns: std::function dispatch=" + std::to_string(nbBound / nbCreatureTurns)
+        + " allocations per creature per turn, pooled actions="
+        + std::to_string(nbPooled / (nbCreatureTurns - NB_CREATURES)) + " allocations per creature per turn");
+}
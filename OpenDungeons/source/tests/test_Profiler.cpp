@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/Profiler.h"
+
+#define BOOST_TEST_MODULE Profiler
+#include "BoostTestTargetConfig.h"
+
+#include <SFML/System.hpp>
+
+#include <sstream>
+
+namespace
+{
+const ProfilerZoneStats* findZone(const std::vector<ProfilerZoneStats>& stats,
+    const std::string& threadName, const std::string& name)
+{
+    for(const ProfilerZoneStats& zone : stats)
+    {
+        if((zone.mThreadName == threadName) && (zone.mName == name))
+            return &zone;
+    }
+    return nullptr;
+}
+
+void recordInOtherThread()
+{
+    Profiler::setThreadName("Other");
+    OD_PROFILE_ZONE("Other zone");
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_DisabledZonesAreNotRecorded)
+{
+    Profiler::clear();
+    Profiler::setEnabled(false);
+    {
+        OD_PROFILE_ZONE("Disabled");
+    }
+
+    std::vector<ProfilerZoneStats> stats;
+    Profiler::computeZoneStats(0, stats);
+    BOOST_CHECK(stats.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_ZoneStats)
+{
+    Profiler::clear();
+    Profiler::setEnabled(true);
+    Profiler::setThreadName("Main");
+    for(int i = 0; i < 3; ++i)
+    {
+        OD_PROFILE_ZONE("Outer");
+        OD_PROFILE_ZONE("Inner");
+    }
+    Profiler::record("Manual", Profiler::nowNs(), 2000000);
+    Profiler::record("Manual", Profiler::nowNs(), 1000000);
+    Profiler::record("Old", 0, 1000000);
+
+    std::vector<ProfilerZoneStats> stats;
+    Profiler::computeZoneStats(1, stats);
+    BOOST_CHECK_EQUAL(stats.size(), 3u);
+    BOOST_REQUIRE(findZone(stats, "Main", "Outer") != nullptr);
+    BOOST_CHECK_EQUAL(findZone(stats, "Main", "Outer")->mNbCalls, 3u);
+    BOOST_CHECK_EQUAL(findZone(stats, "Main", "Inner")->mNbCalls, 3u);
+    // Events started before the given time are ignored
+    BOOST_CHECK(findZone(stats, "Main", "Old") == nullptr);
+    // The zones are sorted by total time
+    BOOST_CHECK_EQUAL(stats.front().mName, "Manual");
+    BOOST_CHECK_CLOSE(stats.front().mTotalMs, 3.0, 0.001);
+    BOOST_CHECK_CLOSE(stats.front().mMaxMs, 2.0, 0.001);
+    Profiler::setEnabled(false);
+}
+
+BOOST_AUTO_TEST_CASE(test_RingBufferKeepsNewestEvents)
+{
+    Profiler::clear();
+    for(uint32_t i = 0; i < Profiler::RING_BUFFER_SIZE; ++i)
+        Profiler::record("Old", 1000 + i, 10);
+    for(uint32_t i = 0; i < 10; ++i)
+        Profiler::record("New", 100000 + i, 10);
+
+    std::vector<ProfilerZoneStats> stats;
+    Profiler::computeZoneStats(0, stats);
+    BOOST_REQUIRE_EQUAL(stats.size(), 2u);
+    uint32_t nbOld = (stats[0].mName == "Old") ? stats[0].mNbCalls : stats[1].mNbCalls;
+    uint32_t nbNew = (stats[0].mName == "New") ? stats[0].mNbCalls : stats[1].mNbCalls;
+    BOOST_CHECK_EQUAL(nbOld, Profiler::RING_BUFFER_SIZE - 10);
+    BOOST_CHECK_EQUAL(nbNew, 10u);
+}
+
+BOOST_AUTO_TEST_CASE(test_ChromeTrace)
+{
+    Profiler::clear();
+    Profiler::setEnabled(true);
+    Profiler::setThreadName("Main");
+    Profiler::record("Turn", 2000, 1500);
+    sf::Thread thread(&recordInOtherThread);
+    thread.launch();
+    thread.wait();
+    Profiler::setEnabled(false);
+
+    std::stringstream ss;
+    BOOST_CHECK_EQUAL(Profiler::writeChromeTrace(ss), 2u);
+    std::string trace = ss.str();
+    BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0u);
+    BOOST_CHECK(trace.find("\"name\":\"Turn\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":2.000,\"dur\":1.500")
+        != std::string::npos);
+    BOOST_CHECK(trace.find("\"args\":{\"name\":\"Main\"}") != std::string::npos);
+    BOOST_CHECK(trace.find("\"args\":{\"name\":\"Other\"}") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"Other zone\",\"ph\":\"X\",\"pid\":1,\"tid\":2") != std::string::npos);
+}
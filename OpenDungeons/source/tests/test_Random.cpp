@@ -20,8 +20,213 @@
 #define BOOST_TEST_MODULE Random
 #include "BoostTestTargetConfig.h"
 
+#include <SFML/System.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(test_Random)
 {
     Random::initialize();
     BOOST_CHECK (Random::Int(1, 2 ) <= 2);
 }
+
+BOOST_AUTO_TEST_CASE(test_Bounds)
+{
+    RandomGenerator generator(1234, 0);
+    bool minReached = false;
+    bool maxReached = false;
+    for(uint32_t i = 0; i < 10000; ++i)
+    {
+        int valueInt = generator.Int(-3, 3);
+        BOOST_REQUIRE(valueInt >= -3);
+        BOOST_REQUIRE(valueInt <= 3);
+        minReached = minReached || (valueInt == -3);
+        maxReached = maxReached || (valueInt == 3);
+
+        // Parameters can be given in any order
+        unsigned int valueUint = generator.Uint(10, 5);
+        BOOST_REQUIRE(valueUint >= 5);
+        BOOST_REQUIRE(valueUint <= 10);
+
+        double valueDouble = generator.Double(-1.5, 2.5);
+        BOOST_REQUIRE(valueDouble >= -1.5);
+        BOOST_REQUIRE(valueDouble < 2.5);
+    }
+    BOOST_CHECK(minReached);
+    BOOST_CHECK(maxReached);
+    BOOST_CHECK_EQUAL(generator.Int(7, 7), 7);
+    BOOST_CHECK_EQUAL(generator.Uint(0, 0), 0);
+
+    // Full ranges should not overflow
+    generator.Int(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    generator.Uint(0, std::numeric_limits<unsigned int>::max());
+}
+
+BOOST_AUTO_TEST_CASE(test_Determinism)
+{
+    // Same seed and stream give the same numbers
+    RandomGenerator generator1(42, 1);
+    RandomGenerator generator2(42, 1);
+    for(uint32_t i = 0; i < 1000; ++i)
+        BOOST_REQUIRE_EQUAL(generator1.next(), generator2.next());
+
+    // Another stream or seed gives other numbers
+    RandomGenerator generatorOtherStream(42, 2);
+    RandomGenerator generatorOtherSeed(43, 1);
+    generator1.seed(42, 1);
+    uint32_t nbSameStream = 0;
+    uint32_t nbSameSeed = 0;
+    for(uint32_t i = 0; i < 1000; ++i)
+    {
+        uint64_t value = generator1.next();
+        if(value == generatorOtherStream.next())
+            ++nbSameStream;
+        if(value == generatorOtherSeed.next())
+            ++nbSameSeed;
+    }
+    BOOST_CHECK_EQUAL(nbSameStream, 0);
+    BOOST_CHECK_EQUAL(nbSameSeed, 0);
+
+    // The batch generation gives the same numbers as single calls
+    std::vector<double> values(1000);
+    generator1.seed(7, 0);
+    generator2.seed(7, 0);
+    generator1.fillDouble(values.data(), static_cast<uint32_t>(values.size()), 5.0, -5.0);
+    for(double value : values)
+        BOOST_REQUIRE_EQUAL(value, generator2.Double(-5.0, 5.0));
+}
+
+BOOST_AUTO_TEST_CASE(test_Streams)
+{
+    // Numbers drawn from a stream do not change the other streams
+    Random::initialize(2016);
+    std::vector<int> simulation;
+    {
+        Random::StreamScope scope(Random::Stream::simulation);
+        for(uint32_t i = 0; i < 100; ++i)
+            simulation.push_back(Random::Int(0, 1000000));
+    }
+
+    Random::initialize(2016);
+    std::vector<int> simulationWithOtherStreams;
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        // The default stream is the cosmetic one
+        BOOST_REQUIRE(Random::getThreadStream() == Random::Stream::cosmetic);
+        Random::Double(0.0, 1.0);
+        {
+            Random::StreamScope scope(Random::Stream::ai);
+            Random::Uint(0, 10);
+        }
+        Random::StreamScope scope(Random::Stream::simulation);
+        simulationWithOtherStreams.push_back(Random::Int(0, 1000000));
+    }
+    BOOST_CHECK(simulation == simulationWithOtherStreams);
+
+    // Reseeding a stream restarts it
+    Random::seedStream(Random::Stream::simulation, 2016);
+    Random::StreamScope scope(Random::Stream::simulation);
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000000), simulation[0]);
+}
+
+BOOST_AUTO_TEST_CASE(test_Threads)
+{
+    // The server and the client threads draw numbers at the same time from their streams. Each
+    // thread should get the same numbers as if it was alone
+    const uint32_t nbValues = 200000;
+    auto drawValues = [nbValues](Random::Stream stream, std::vector<int>& values)
+    {
+        Random::setThreadStream(stream);
+        values.clear();
+        for(uint32_t i = 0; i < nbValues; ++i)
+            values.push_back(Random::Int(0, 1000));
+    };
+
+    Random::initialize(99);
+    std::vector<int> simulationAlone;
+    std::vector<int> cosmeticAlone;
+    drawValues(Random::Stream::simulation, simulationAlone);
+    drawValues(Random::Stream::cosmetic, cosmeticAlone);
+
+    Random::initialize(99);
+    std::vector<int> simulationThread;
+    std::vector<int> cosmeticThread;
+    sf::Thread server([&]() { drawValues(Random::Stream::simulation, simulationThread); });
+    sf::Thread client([&]() { drawValues(Random::Stream::cosmetic, cosmeticThread); });
+    server.launch();
+    client.launch();
+    server.wait();
+    client.wait();
+    BOOST_CHECK(simulationAlone == simulationThread);
+    BOOST_CHECK(cosmeticAlone == cosmeticThread);
+    Random::setThreadStream(Random::Stream::cosmetic);
+}
+
+BOOST_AUTO_TEST_CASE(test_Distribution)
+{
+    // Chi-squared test on 10 buckets. With 9 degrees of freedom, the value is above 27.88
+    // with a probability of 0.001
+    RandomGenerator generator(5, 0);
+    const uint32_t nbBuckets = 10;
+    const uint32_t nbValues = 100000;
+    std::vector<uint32_t> buckets(nbBuckets, 0);
+    double sum = 0.0;
+    for(uint32_t i = 0; i < nbValues; ++i)
+    {
+        ++buckets[generator.Uint(0, nbBuckets - 1)];
+        sum += generator.uniform();
+    }
+
+    double expected = static_cast<double>(nbValues) / nbBuckets;
+    double chiSquared = 0.0;
+    for(uint32_t count : buckets)
+        chiSquared += (count - expected) * (count - expected) / expected;
+    BOOST_CHECK_LT(chiSquared, 27.88);
+    BOOST_CHECK_CLOSE(sum / nbValues, 0.5, 1.0);
+
+    // Bits should be set half of the time
+    uint32_t nbBitsSet = 0;
+    for(uint32_t i = 0; i < 10000; ++i)
+    {
+        uint64_t value = generator.next();
+        for(uint32_t bit = 0; bit < 64; ++bit)
+            nbBitsSet += (value >> bit) & 1;
+    }
+    BOOST_CHECK_CLOSE(nbBitsSet / (10000.0 * 64.0), 0.5, 1.0);
+
+    // Gaussian numbers should be finite and centered on 0
+    Random::initialize(3);
+    double gaussianSum = 0.0;
+    for(uint32_t i = 0; i < 10000; ++i)
+    {
+        double value = Random::gaussianRandomDouble();
+        BOOST_REQUIRE(std::isfinite(value));
+        gaussianSum += value;
+    }
+    BOOST_CHECK_LT(std::abs(gaussianSum / 10000.0), 0.05);
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkBatch)
+{
+    const uint32_t nbValues = 1000000;
+    std::vector<double> values(nbValues);
+    RandomGenerator generator(11, 0);
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    for(double& value : values)
+        value = generator.Double(0.0, 10.0);
+    double singleMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    generator.fillDouble(values.data(), nbValues, 0.0, 10.0);
+    double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    for(double value : values)
+        BOOST_REQUIRE((value >= 0.0) && (value < 10.0));
+
+    BOOST_TEST_MESSAGE(std::to_string(nbValues) + " doubles: single calls=" + std::to_string(singleMs)
+        + "ms, batch=" + std::to_string(batchMs) + "ms");
+}
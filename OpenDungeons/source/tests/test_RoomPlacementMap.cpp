@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ai/RoomPlacementMap.h"
+
+#define BOOST_TEST_MODULE RoomPlacementMap
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Fills the map from rows where '.' is a ground tile and '#' a wall tile. The first row is y = 0
+void fillMap(RoomPlacementMap& map, const std::vector<std::string>& rows)
+{
+    map.resize(static_cast<int>(rows[0].size()), static_cast<int>(rows.size()));
+    for(int yy = 0; yy < map.getSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < map.getSizeX(); ++xx)
+        {
+            map.setGroundTile(xx, yy, rows[yy][xx] == '.');
+            map.setWallTile(xx, yy, rows[yy][xx] == '#');
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_FindPlacements)
+{
+    RoomPlacementMap map;
+    BOOST_CHECK(!map.isInitialized());
+    fillMap(map, {
+        "...#..",
+        "...#..",
+        "...x..",
+        "######"});
+    BOOST_CHECK(map.isInitialized());
+
+    BOOST_CHECK_EQUAL(map.countGroundTiles(0, 0, 5, 3), 15);
+    BOOST_CHECK_EQUAL(map.countGroundTiles(0, 0, 2, 2), 9);
+    // The rectangle is clipped to the map
+    BOOST_CHECK_EQUAL(map.countGroundTiles(-5, -5, 1, 0), 2);
+    BOOST_CHECK_EQUAL(map.countGroundTiles(6, 0, 10, 3), 0);
+
+    BOOST_CHECK(map.isGroundSquare(0, 0, 3));
+    BOOST_CHECK(map.isGroundSquare(4, 0, 2));
+    BOOST_CHECK(!map.isGroundSquare(4, 2, 2));
+    BOOST_CHECK(!map.isGroundSquare(1, 0, 3));
+    // Squares must be fully inside the map
+    BOOST_CHECK(!map.isGroundSquare(-1, 0, 2));
+    BOOST_CHECK(!map.isGroundSquare(5, 0, 2));
+
+    BOOST_CHECK(map.isWallTile(3, 0));
+    BOOST_CHECK(!map.isWallTile(3, 2));
+    BOOST_CHECK(!map.isWallTile(-1, 0));
+}
+
+BOOST_AUTO_TEST_CASE(test_InvalidatePlacements)
+{
+    RoomPlacementMap map;
+    fillMap(map, {
+        "....",
+        "....",
+        "....",
+        "...."});
+    BOOST_CHECK(map.isGroundSquare(1, 1, 3));
+
+    // A tile that is not ground anymore invalidates the squares covering it
+    map.setGroundTile(2, 2, false);
+    BOOST_CHECK(!map.isGroundSquare(1, 1, 3));
+    BOOST_CHECK(!map.isGroundSquare(2, 2, 2));
+    BOOST_CHECK(map.isGroundSquare(0, 0, 2));
+    BOOST_CHECK_EQUAL(map.countGroundTiles(0, 0, 3, 3), 15);
+
+    map.setGroundTile(2, 2, true);
+    BOOST_CHECK(map.isGroundSquare(1, 1, 3));
+    BOOST_CHECK_EQUAL(map.countGroundTiles(0, 0, 3, 3), 16);
+}
+
+BOOST_AUTO_TEST_CASE(test_DirtyTiles)
+{
+    RoomPlacementMap map;
+    map.resize(5, 4);
+    // After a resize, every tile has to be processed
+    BOOST_CHECK_EQUAL(map.getDirtyTiles().size(), 20);
+    map.clearDirtyTiles();
+    BOOST_CHECK(map.getDirtyTiles().empty());
+
+    // A tile and its neighbors are dirty, only once
+    map.setTileDirty(2, 2);
+    map.setTileDirty(2, 2);
+    std::vector<uint32_t> dirtyTiles = map.getDirtyTiles();
+    std::sort(dirtyTiles.begin(), dirtyTiles.end());
+    BOOST_CHECK(dirtyTiles == std::vector<uint32_t>({6, 7, 8, 11, 12, 13, 16, 17, 18}));
+
+    // Neighbors outside the map are ignored
+    map.clearDirtyTiles();
+    map.setTileDirty(0, 0);
+    dirtyTiles = map.getDirtyTiles();
+    std::sort(dirtyTiles.begin(), dirtyTiles.end());
+    BOOST_CHECK(dirtyTiles == std::vector<uint32_t>({0, 1, 5, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(test_MatchesTileCount)
+{
+    // The summed-area table gives the same counts as counting the tiles one by one
+    const int sizeX = 37;
+    const int sizeY = 23;
+    RoomPlacementMap map;
+    map.resize(sizeX, sizeY);
+    std::vector<bool> ground(sizeX * sizeY);
+    for(int i = 0; i < sizeX * sizeY; ++i)
+    {
+        ground[i] = ((i * 7919) % 5) != 0;
+        map.setGroundTile(i % sizeX, i / sizeX, ground[i]);
+    }
+
+    for(int y1 = 0; y1 < sizeY; y1 += 3)
+    {
+        for(int x1 = 0; x1 < sizeX; x1 += 4)
+        {
+            for(int size = 1; size <= 6; ++size)
+            {
+                int32_t expected = 0;
+                for(int yy = y1; yy < std::min(y1 + size, sizeY); ++yy)
+                {
+                    for(int xx = x1; xx < std::min(x1 + size, sizeX); ++xx)
+                        expected += ground[xx + yy * sizeX] ? 1 : 0;
+                }
+                BOOST_CHECK_EQUAL(map.countGroundTiles(x1, y1, x1 + size - 1, y1 + size - 1), expected);
+            }
+        }
+    }
+}
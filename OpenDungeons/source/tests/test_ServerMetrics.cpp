@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/ServerMetrics.h"
+
+#define BOOST_TEST_MODULE ServerMetrics
+#include "BoostTestTargetConfig.h"
+
+#include <sstream>
+
+namespace
+{
+bool contains(const std::string& str, const std::string& line)
+{
+    return str.find(line + "\n") != std::string::npos;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnDurationHistogram)
+{
+    ServerMetrics metrics;
+    metrics.addTurnDuration(0.0005);
+    metrics.addTurnDuration(0.004);
+    metrics.addTurnDuration(0.005);
+    metrics.addTurnDuration(2.0);
+
+    std::stringstream ss;
+    metrics.write(ss);
+    std::string str = ss.str();
+    BOOST_CHECK(contains(str, "# TYPE od_server_turn_duration_seconds histogram"));
+    // Buckets are cumulative and their upper bound is inclusive
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_bucket{le=\"0.001\"} 1"));
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_bucket{le=\"0.0025\"} 1"));
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_bucket{le=\"0.005\"} 3"));
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_bucket{le=\"1\"} 3"));
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_bucket{le=\"+Inf\"} 4"));
+    BOOST_CHECK(contains(str, "od_server_turn_duration_seconds_count 4"));
+    BOOST_CHECK(contains(str, "od_server_turns_total 4"));
+}
+
+BOOST_AUTO_TEST_CASE(test_PhasesAndGauges)
+{
+    ServerMetrics metrics;
+    metrics.addPhaseDuration("upkeep", 0.5);
+    metrics.addPhaseDuration("ai", 0.25);
+    metrics.addPhaseDuration("upkeep", 0.25);
+    metrics.setTurnNumber(42);
+    metrics.setNbCreatures(12);
+    metrics.setNbPathQueries(1234);
+
+    std::stringstream ss;
+    metrics.write(ss);
+    std::string str = ss.str();
+    BOOST_CHECK(contains(str, "od_server_phase_seconds_total{phase=\"upkeep\"} 0.75"));
+    BOOST_CHECK(contains(str, "od_server_phase_seconds_total{phase=\"ai\"} 0.25"));
+    BOOST_CHECK(str.find("phase=\"upkeep\"") < str.find("phase=\"ai\""));
+    BOOST_CHECK(contains(str, "od_server_turn_number 42"));
+    BOOST_CHECK(contains(str, "od_server_creatures 12"));
+    BOOST_CHECK(contains(str, "od_server_path_queries_total 1234"));
+}
+
+BOOST_AUTO_TEST_CASE(test_Clients)
+{
+    ServerMetrics metrics;
+    metrics.setClient("Keeper \"1\"", 100, 0);
+    metrics.setClient("Keeper2", 50, 3);
+    metrics.removeClientsNotUpdated();
+
+    std::stringstream ss;
+    metrics.write(ss);
+    std::string str = ss.str();
+    BOOST_CHECK(contains(str, "od_server_client_sent_bytes_total{player=\"Keeper \\\"1\\\"\"} 100"));
+    BOOST_CHECK(contains(str, "od_server_client_turn_ack_lag{player=\"Keeper2\"} 3"));
+
+    // Keeper2 disconnected
+    metrics.setClient("Keeper \"1\"", 150, 1);
+    metrics.removeClientsNotUpdated();
+    ss.str("");
+    metrics.write(ss);
+    str = ss.str();
+    BOOST_CHECK(contains(str, "od_server_client_sent_bytes_total{player=\"Keeper \\\"1\\\"\"} 150"));
+    BOOST_CHECK(str.find("Keeper2") == std::string::npos);
+
+    BOOST_CHECK_EQUAL(ServerMetrics::escapeLabelValue("a\\b\nc"), "a\\\\b\\nc");
+}
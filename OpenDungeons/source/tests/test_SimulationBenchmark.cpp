@@ -0,0 +1,104 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/SimulationBenchmark.h"
+
+#define BOOST_TEST_MODULE SimulationBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include <sstream>
+#include <string>
+
+BOOST_AUTO_TEST_CASE(test_Percentiles)
+{
+    SimulationBenchmark benchmark("level.level", 1);
+    BOOST_CHECK_EQUAL(benchmark.getTurnDurationPercentile(50.0), 0.0);
+
+    // Turns are not added in order: 1ms to 100ms
+    for(int i = 100; i >= 1; --i)
+        benchmark.addTurnDuration(i / 1000.0);
+
+    BOOST_CHECK_EQUAL(benchmark.getNbTurns(), 100);
+    BOOST_CHECK_CLOSE(benchmark.getTotalSeconds(), 5.05, 0.001);
+    BOOST_CHECK_CLOSE(benchmark.getTurnDurationPercentile(50.0), 0.050, 0.001);
+    BOOST_CHECK_CLOSE(benchmark.getTurnDurationPercentile(99.0), 0.099, 0.001);
+    BOOST_CHECK_CLOSE(benchmark.getTurnDurationPercentile(100.0), 0.100, 0.001);
+    BOOST_CHECK_CLOSE(benchmark.getTurnDurationPercentile(0.0), 0.001, 0.001);
+
+    // With few turns, p99 is the slowest one
+    SimulationBenchmark fewTurns("level.level", 1);
+    fewTurns.addTurnDuration(0.002);
+    fewTurns.addTurnDuration(0.010);
+    fewTurns.addTurnDuration(0.001);
+    BOOST_CHECK_CLOSE(fewTurns.getTurnDurationPercentile(99.0), 0.010, 0.001);
+    BOOST_CHECK_CLOSE(fewTurns.getTurnDurationPercentile(50.0), 0.002, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(test_Write)
+{
+    SimulationBenchmark benchmark("levels/skirmish/\"Test\".level", 42);
+    benchmark.addTurnDuration(0.010);
+    benchmark.addTurnDuration(0.030);
+    benchmark.addPhaseDuration("upkeep", 0.005);
+    benchmark.addPhaseDuration("ai", 0.001);
+    benchmark.addPhaseDuration("upkeep", 0.015);
+    benchmark.setNbPathQueries(1234);
+    benchmark.setNbCreatures(56);
+    benchmark.setStateHash(0xabc);
+    benchmark.setPeakMemoryBytes(1048576);
+
+    std::ostringstream ss;
+    benchmark.write(ss);
+    std::string json = ss.str();
+
+    BOOST_CHECK(json.find("\"level\": \"levels/skirmish/\\\"Test\\\".level\"") != std::string::npos);
+    BOOST_CHECK(json.find("\"seed\": 42,") != std::string::npos);
+    BOOST_CHECK(json.find("\"turns\": 2,") != std::string::npos);
+    BOOST_CHECK(json.find("\"turns_per_second\": 50.0000,") != std::string::npos);
+    BOOST_CHECK(json.find("\"turn_ms\": {\"mean\": 20.0000, \"p50\": 10.0000, \"p99\": 30.0000, \"max\": 30.0000}")
+        != std::string::npos);
+    // Phases are written in the order they were first added
+    std::string::size_type upkeepPos = json.find("\"upkeep\": {\"total\": 20.0000, \"per_turn\": 10.0000}");
+    std::string::size_type aiPos = json.find("\"ai\": {\"total\": 1.0000, \"per_turn\": 0.5000}");
+    BOOST_CHECK(upkeepPos != std::string::npos);
+    BOOST_CHECK(aiPos != std::string::npos);
+    BOOST_CHECK(upkeepPos < aiPos);
+    BOOST_CHECK(json.find("\"path_queries\": 1234,") != std::string::npos);
+    BOOST_CHECK(json.find("\"creatures\": 56,") != std::string::npos);
+    BOOST_CHECK(json.find("\"state_hash\": \"0000000000000abc\",") != std::string::npos);
+    BOOST_CHECK(json.find("\"peak_memory_bytes\": 1048576\n}") != std::string::npos);
+
+    // Without turns, nothing is divided by 0
+    SimulationBenchmark empty("level.level", 1);
+    std::ostringstream ssEmpty;
+    empty.write(ssEmpty);
+    BOOST_CHECK(ssEmpty.str().find("\"phases_ms\": {},") != std::string::npos);
+    BOOST_CHECK(ssEmpty.str().find("\"turns_per_second\": 0.0000,") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_EscapeJsonString)
+{
+    BOOST_CHECK_EQUAL(SimulationBenchmark::escapeJsonString("C:\\levels\\a.level"), "C:\\\\levels\\\\a.level");
+    BOOST_CHECK_EQUAL(SimulationBenchmark::escapeJsonString("a\tb\nc"), "a\\tb\\nc");
+    BOOST_CHECK_EQUAL(SimulationBenchmark::escapeJsonString(std::string(1, '\x01')), "\\u0001");
+}
+
+BOOST_AUTO_TEST_CASE(test_PeakMemory)
+{
+    // The process has at least used the memory of this test
+    BOOST_CHECK(SimulationBenchmark::getProcessPeakMemoryBytes() > 0);
+}
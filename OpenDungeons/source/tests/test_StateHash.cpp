@@ -0,0 +1,182 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/StateHash.h"
+#include "network/DesyncDetector.h"
+
+#define BOOST_TEST_MODULE StateHash
+#include "BoostTestTargetConfig.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_IncrementalHash)
+{
+    StateHash empty;
+    BOOST_CHECK_EQUAL(empty.getHash(), 0);
+
+    // The order components are set in does not matter
+    StateHash state1;
+    state1.setTile(1, 2, StateHash::hashValues({3, -1}));
+    state1.setTile(2, 1, StateHash::hashValues({4, 1}));
+    state1.setEntity("Creature1", StateHash::hashValues({1, 2, 10, 11}));
+    StateHash state2;
+    state2.setEntity("Creature1", StateHash::hashValues({1, 2, 10, 11}));
+    state2.setTile(2, 1, StateHash::hashValues({4, 1}));
+    state2.setTile(1, 2, StateHash::hashValues({3, -1}));
+    BOOST_CHECK_EQUAL(state1.getHash(), state2.getHash());
+    BOOST_CHECK(state1.getHash() != 0);
+
+    // Swapping the values of 2 tiles changes the hash
+    StateHash state3;
+    state3.setTile(1, 2, StateHash::hashValues({4, 1}));
+    state3.setTile(2, 1, StateHash::hashValues({3, -1}));
+    state3.setEntity("Creature1", StateHash::hashValues({1, 2, 10, 11}));
+    BOOST_CHECK(state1.getHash() != state3.getHash());
+
+    // Changing a component and setting it back gives the same hash
+    uint64_t hash = state1.getHash();
+    state1.setEntity("Creature1", StateHash::hashValues({1, 2, 10, 12}));
+    BOOST_CHECK(state1.getHash() != hash);
+    state1.setEntity("Creature1", StateHash::hashValues({1, 2, 10, 11}));
+    BOOST_CHECK_EQUAL(state1.getHash(), hash);
+
+    // 0 removes the component
+    state1.setTile(2, 1, 0);
+    BOOST_CHECK_EQUAL(state1.getTiles().size(), 1);
+    state1.setEntity("Creature2", 0);
+    BOOST_CHECK_EQUAL(state1.getEntities().size(), 1);
+    state1.clearEntities();
+    state1.setTile(1, 2, 0);
+    BOOST_CHECK_EQUAL(state1.getHash(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_FirstDifference)
+{
+    StateHash server;
+    server.setTile(0, 5, 10);
+    server.setTile(3, 2, 11);
+    server.setEntity("Creature1", 20);
+    server.setEntity("Creature2", 21);
+    StateHash client = server;
+    BOOST_CHECK_EQUAL(StateHash::getFirstDifference(server, client), "");
+
+    // Tiles are ordered by coordinates and checked before the entities
+    client.setEntity("Creature1", 22);
+    client.setTile(3, 2, 12);
+    client.setTile(2, 0, 13);
+    BOOST_CHECK_EQUAL(StateHash::getFirstDifference(server, client), "tile 2,0 expected=missing actual=13");
+    client.setTile(2, 0, 0);
+    BOOST_CHECK_EQUAL(StateHash::getFirstDifference(server, client), "tile 3,2 expected=11 actual=12");
+    client.setTile(3, 2, 11);
+    BOOST_CHECK_EQUAL(StateHash::getFirstDifference(server, client), "entity Creature1 expected=20 actual=22");
+    client.setEntity("Creature1", 0);
+    BOOST_CHECK_EQUAL(StateHash::getFirstDifference(server, client), "entity Creature1 expected=20 actual=missing");
+}
+
+BOOST_AUTO_TEST_CASE(test_DesyncDetector)
+{
+    DesyncDetector detector;
+    StateHash server;
+    server.setTile(1, 1, 5);
+    detector.turnSent(1, server);
+    detector.turnSent(2, server);
+    BOOST_CHECK_EQUAL(detector.getNbTurnsPending(), 2);
+
+    // The client acknowledges late turns
+    BOOST_CHECK(detector.turnAcknowledged(2, server.getHash()) == DesyncDetector::Result::inSync);
+    BOOST_CHECK_EQUAL(detector.getNbTurnsPending(), 0);
+    BOOST_CHECK(detector.turnAcknowledged(2, server.getHash()) == DesyncDetector::Result::unknownTurn);
+
+    // A creature stopped on another tile on the client
+    server.setEntity("Creature1", 7);
+    StateHash client = server;
+    client.setEntity("Creature1", 8);
+    detector.turnSent(3, server);
+    BOOST_CHECK(detector.turnAcknowledged(3, client.getHash()) == DesyncDetector::Result::desyncStarted);
+    BOOST_CHECK(detector.isDesynced());
+
+    // The report is asked for turn 5 while turn 4 was already sent
+    detector.askReport(5);
+    detector.turnSent(4, server);
+    detector.turnSent(5, server);
+    std::string difference;
+    BOOST_CHECK(!detector.checkReport(4, client, difference));
+    BOOST_CHECK(detector.turnAcknowledged(4, client.getHash()) == DesyncDetector::Result::desynced);
+    BOOST_CHECK(detector.turnAcknowledged(5, client.getHash()) == DesyncDetector::Result::desynced);
+    BOOST_CHECK(detector.checkReport(5, client, difference));
+    BOOST_CHECK_EQUAL(difference, "entity Creature1 expected=7 actual=8");
+    BOOST_CHECK(!detector.checkReport(5, client, difference));
+
+    client.setEntity("Creature1", 7);
+    detector.turnSent(6, server);
+    BOOST_CHECK(detector.turnAcknowledged(6, client.getHash()) == DesyncDetector::Result::resynced);
+    BOOST_CHECK(!detector.isDesynced());
+    BOOST_CHECK_EQUAL(detector.getNbDesyncs(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkTurnHash)
+{
+    // 128x128 map where 40 tiles change each turn (digging, claiming). The incremental hash only
+    // updates the changed tiles while the full hash goes through the whole map every turn
+    const int sizeX = 128;
+    const int sizeY = 128;
+    const int nbTurns = 200;
+    const int nbChangesPerTurn = 40;
+    std::vector<uint64_t> tiles(sizeX * sizeY, StateHash::hashValues({1, -1}));
+
+    StateHash incremental;
+    for(int i = 0; i < sizeX * sizeY; ++i)
+        incremental.setTile(i % sizeX, i / sizeX, tiles[i]);
+
+    typedef std::chrono::steady_clock Clock;
+    double incrementalMs = 0.0;
+    double fullMs = 0.0;
+    uint32_t seed = 12345;
+    for(int turn = 0; turn < nbTurns; ++turn)
+    {
+        std::vector<std::pair<int, uint64_t>> changes;
+        for(int change = 0; change < nbChangesPerTurn; ++change)
+        {
+            seed = seed * 1103515245 + 12345;
+            int index = static_cast<int>((seed >> 8) % (sizeX * sizeY));
+            int64_t tileVisual = (seed >> 4) % 5;
+            int64_t seatId = static_cast<int64_t>(seed % 3) - 1;
+            changes.emplace_back(index, StateHash::hashValues({tileVisual, seatId}));
+        }
+
+        Clock::time_point start = Clock::now();
+        for(const std::pair<int, uint64_t>& change : changes)
+            incremental.setTile(change.first % sizeX, change.first / sizeX, change.second);
+        incrementalMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        for(const std::pair<int, uint64_t>& change : changes)
+            tiles[change.first] = change.second;
+        StateHash full;
+        for(int i = 0; i < sizeX * sizeY; ++i)
+            full.setTile(i % sizeX, i / sizeX, tiles[i]);
+        fullMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        BOOST_REQUIRE_EQUAL(incremental.getHash(), full.getHash());
+    }
+
+    BOOST_TEST_MESSAGE(std::to_string(nbTurns) + " turns on a " + std::to_string(sizeX) + "x" + std::to_string(sizeY)
+        + " map: incremental hash=" + std::to_string(incrementalMs) + "ms, full hash=" + std::to_string(fullMs) + "ms");
+}
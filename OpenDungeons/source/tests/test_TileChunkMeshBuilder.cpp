@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/TileChunkMeshBuilder.h"
+
+#define BOOST_TEST_MODULE TileChunkMeshBuilder
+#include "BoostTestTargetConfig.h"
+
+namespace
+{
+//! \brief Builds a unit quad centered on the origin with one sub mesh
+TileChunkSourceMesh buildQuad(const std::string& materialName)
+{
+    TileChunkSourceMesh mesh;
+    mesh.mSubMeshes.emplace_back();
+    TileChunkSourceMesh::SubMesh& subMesh = mesh.mSubMeshes.back();
+    subMesh.mMaterialName = materialName;
+    const float corners[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+    for(const float* corner : corners)
+    {
+        TileChunkVertex v = {{corner[0], corner[1], 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f},
+            {corner[0] + 0.5f, corner[1] + 0.5f}};
+        subMesh.mVertices.push_back(v);
+    }
+    subMesh.mIndices = {0, 1, 2, 0, 2, 3};
+    return mesh;
+}
+
+TileChunkInstance buildInstance(const TileChunkSourceMesh& mesh, float x, float y)
+{
+    TileChunkInstance instance;
+    instance.mMesh = &mesh;
+    instance.mX = x;
+    instance.mY = y;
+    return instance;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_ChunkCoord)
+{
+    BOOST_CHECK_EQUAL(TileChunkMeshBuilder::chunkCoord(0), 0);
+    BOOST_CHECK_EQUAL(TileChunkMeshBuilder::chunkCoord(TileChunkMeshBuilder::CHUNK_SIZE - 1), 0);
+    BOOST_CHECK_EQUAL(TileChunkMeshBuilder::chunkCoord(TileChunkMeshBuilder::CHUNK_SIZE), 1);
+    BOOST_CHECK_EQUAL(TileChunkMeshBuilder::chunkCoord(3 * TileChunkMeshBuilder::CHUNK_SIZE + 2), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_SameMaterialIsMerged)
+{
+    TileChunkSourceMesh quad = buildQuad("Dirt");
+    TileChunkMeshBuilder builder;
+    builder.addInstance(buildInstance(quad, 0.0f, 0.0f));
+    builder.addInstance(buildInstance(quad, 1.0f, 0.0f));
+
+    BOOST_REQUIRE_EQUAL(builder.getNbBatches(), 1u);
+    const TileChunkBatch& batch = builder.getBatches().front();
+    BOOST_CHECK_EQUAL(batch.mMaterialName, "Dirt");
+    BOOST_CHECK_EQUAL(batch.mVertices.size(), 8u);
+    BOOST_REQUIRE_EQUAL(batch.mIndices.size(), 12u);
+    // The second quad indices are shifted by the number of vertices of the first one
+    BOOST_CHECK_EQUAL(batch.mIndices[6], 4u);
+    BOOST_CHECK_EQUAL(batch.mIndices[11], 7u);
+    // And its vertices are translated to the tile position
+    BOOST_CHECK_CLOSE(batch.mVertices[4].mPosition[0], 0.5f, 0.001f);
+    BOOST_CHECK_CLOSE(batch.mVertices[4].mPosition[1], -0.5f, 0.001f);
+    BOOST_CHECK_EQUAL(builder.getNbVertices(), 8u);
+}
+
+BOOST_AUTO_TEST_CASE(test_VariantsAndOverridesSplitBatches)
+{
+    TileChunkSourceMesh quad = buildQuad("Claimed");
+    TileChunkMeshBuilder builder;
+    TileChunkInstance instance = buildInstance(quad, 0.0f, 0.0f);
+    builder.addInstance(instance);
+
+    instance.mVariant.mSeatId = 2;
+    builder.addInstance(instance);
+    builder.addInstance(instance);
+
+    instance.mVariant.mMarkedForDigging = true;
+    builder.addInstance(instance);
+
+    instance.mMaterialOverride = "Gold";
+    builder.addInstance(instance);
+
+    BOOST_REQUIRE_EQUAL(builder.getNbBatches(), 4u);
+    const std::vector<TileChunkBatch>& batches = builder.getBatches();
+    BOOST_CHECK_EQUAL(batches[0].mVariant.mSeatId, -1);
+    BOOST_CHECK_EQUAL(batches[1].mVariant.mSeatId, 2);
+    BOOST_CHECK_EQUAL(batches[1].mVertices.size(), 8u);
+    BOOST_CHECK(batches[2].mVariant.mMarkedForDigging);
+    BOOST_CHECK_EQUAL(batches[2].mMaterialName, "Claimed");
+    BOOST_CHECK_EQUAL(batches[3].mMaterialName, "Gold");
+
+    builder.clear();
+    BOOST_CHECK_EQUAL(builder.getNbBatches(), 0u);
+    BOOST_CHECK_EQUAL(builder.getNbVertices(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_RotationIsApplied)
+{
+    TileChunkSourceMesh quad = buildQuad("Wall");
+    TileChunkMeshBuilder builder;
+    TileChunkInstance instance = buildInstance(quad, 5.0f, 7.0f);
+    instance.mRotationZ = 90.0f;
+    builder.addInstance(instance);
+
+    BOOST_REQUIRE_EQUAL(builder.getNbBatches(), 1u);
+    const TileChunkVertex& v = builder.getBatches().front().mVertices[1];
+    // (0.5, -0.5) rotated by 90 degrees around Z is (0.5, 0.5)
+    BOOST_CHECK_CLOSE(v.mPosition[0], 5.5f, 0.001f);
+    BOOST_CHECK_CLOSE(v.mPosition[1], 7.5f, 0.001f);
+    // The tangent is rotated too but not translated
+    BOOST_CHECK_SMALL(v.mTangent[0], 0.0001f);
+    BOOST_CHECK_CLOSE(v.mTangent[1], 1.0f, 0.001f);
+    BOOST_CHECK_CLOSE(v.mNormal[2], 1.0f, 0.001f);
+    BOOST_CHECK_CLOSE(v.mTexCoord[0], 1.0f, 0.001f);
+
+    // Like the scene node rotation, the combined rotation is qX * qZ. The normal (0, 0, 1) is
+    // not changed by the Z rotation and becomes (0, -1, 0) with the X one while the tangent
+    // becomes (0, 1, 0) with the Z rotation and (0, 0, 1) with the X one
+    builder.clear();
+    instance.mRotationX = 90.0f;
+    builder.addInstance(instance);
+    const TileChunkVertex& v2 = builder.getBatches().front().mVertices[0];
+    BOOST_CHECK_SMALL(v2.mNormal[0], 0.0001f);
+    BOOST_CHECK_CLOSE(v2.mNormal[1], -1.0f, 0.001f);
+    BOOST_CHECK_SMALL(v2.mNormal[2], 0.0001f);
+    BOOST_CHECK_SMALL(v2.mTangent[0], 0.0001f);
+    BOOST_CHECK_SMALL(v2.mTangent[1], 0.0001f);
+    BOOST_CHECK_CLOSE(v2.mTangent[2], 1.0f, 0.001f);
+}
+
+BOOST_AUTO_TEST_CASE(test_EmptyInstancesAreIgnored)
+{
+    TileChunkMeshBuilder builder;
+    builder.addInstance(TileChunkInstance());
+
+    TileChunkSourceMesh empty;
+    empty.mSubMeshes.emplace_back();
+    builder.addInstance(buildInstance(empty, 0.0f, 0.0f));
+
+    BOOST_CHECK_EQUAL(builder.getNbBatches(), 0u);
+    BOOST_CHECK(builder.getBatches().empty());
+}
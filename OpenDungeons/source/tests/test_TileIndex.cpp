@@ -0,0 +1,175 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileIndexGrid.h"
+
+#define BOOST_TEST_MODULE TileIndex
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+//! Returns the closest position of the given key by checking every tile, or -1
+int findClosestBruteForce(const TileIndexGrid& grid, uint32_t key, int x, int y, int maxDistSquared)
+{
+    int bestPos = -1;
+    int bestDistSquared = 0;
+    for(int yy = 0; yy < grid.getSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < grid.getSizeX(); ++xx)
+        {
+            if(!grid.isInIndex(key, xx, yy))
+                continue;
+
+            int distSquared = (xx - x) * (xx - x) + (yy - y) * (yy - y);
+            if((maxDistSquared >= 0) && (distSquared > maxDistSquared))
+                continue;
+            if((bestPos >= 0) && (distSquared >= bestDistSquared))
+                continue;
+
+            bestPos = xx + yy * grid.getSizeX();
+            bestDistSquared = distSquared;
+        }
+    }
+    return bestPos;
+}
+
+int distSquaredTo(const TileIndexGrid& grid, int pos, int x, int y)
+{
+    int diffX = pos % grid.getSizeX() - x;
+    int diffY = pos / grid.getSizeX() - y;
+    return diffX * diffX + diffY * diffY;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_SetInIndex)
+{
+    TileIndexGrid grid;
+    BOOST_CHECK(!grid.isInitialized());
+    grid.init(20, 10, 2);
+    BOOST_CHECK(grid.isInitialized());
+    BOOST_CHECK_EQUAL(grid.getNbTiles(0), 0);
+
+    grid.setInIndex(0, 3, 4, true);
+    grid.setInIndex(0, 19, 9, true);
+    // Adding a tile twice does not count it twice
+    grid.setInIndex(0, 3, 4, true);
+    BOOST_CHECK_EQUAL(grid.getNbTiles(0), 2);
+    BOOST_CHECK_EQUAL(grid.getNbTiles(1), 0);
+    BOOST_CHECK(grid.isInIndex(0, 3, 4));
+    BOOST_CHECK(!grid.isInIndex(1, 3, 4));
+
+    // Out of the map tiles and unknown keys are ignored
+    grid.setInIndex(0, 20, 0, true);
+    grid.setInIndex(0, -1, 0, true);
+    grid.setInIndex(5, 0, 0, true);
+    BOOST_CHECK_EQUAL(grid.getNbTiles(0), 2);
+    BOOST_CHECK(!grid.isInIndex(0, 20, 0));
+    BOOST_CHECK_EQUAL(grid.getNbTiles(5), 0);
+
+    grid.setInIndex(0, 3, 4, false);
+    grid.setInIndex(0, 3, 4, false);
+    BOOST_CHECK_EQUAL(grid.getNbTiles(0), 1);
+    BOOST_CHECK(!grid.isInIndex(0, 3, 4));
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 0, 0, -1, nullptr), 19 + 9 * 20);
+
+    grid.clear();
+    BOOST_CHECK(!grid.isInitialized());
+    BOOST_CHECK_EQUAL(grid.getNbTiles(0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_FindClosestTile)
+{
+    TileIndexGrid grid;
+    grid.init(40, 40, 1);
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 5, 5, -1, nullptr), -1);
+
+    // A tile in a far bucket is found even if the search starts in an empty one
+    grid.setInIndex(0, 35, 2, true);
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 0, 0, -1, nullptr), 35 + 2 * 40);
+
+    // A tile in the next bucket can be closer than a tile in the same bucket
+    grid.setInIndex(0, 0, 0, true);
+    grid.setInIndex(0, 8, 7, true);
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 7, 7, -1, nullptr), 8 + 7 * 40);
+
+    // The maximum distance is respected
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 20, 20, 100, nullptr), -1);
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 12, 7, 16, nullptr), 8 + 7 * 40);
+
+    // The filter is only called on tiles that could be the closest
+    int nbFilterCalls = 0;
+    auto filter = [&](int x, int y)
+    {
+        ++nbFilterCalls;
+        return (x != 8) || (y != 7);
+    };
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 7, 7, -1, filter), 0);
+    BOOST_CHECK_EQUAL(nbFilterCalls, 2);
+
+    // Positions outside of the map are allowed
+    BOOST_CHECK_EQUAL(grid.findClosestTile(0, 50, -10, -1, nullptr), 35 + 2 * 40);
+}
+
+BOOST_AUTO_TEST_CASE(test_MatchesBruteForce)
+{
+    std::mt19937 gen(42);
+    TileIndexGrid grid;
+    grid.init(37, 29, 2);
+    std::uniform_int_distribution<int> distX(0, grid.getSizeX() - 1);
+    std::uniform_int_distribution<int> distY(0, grid.getSizeY() - 1);
+    for(int i = 0; i < 60; ++i)
+        grid.setInIndex(0, distX(gen), distY(gen), true);
+    // Some tiles are removed to check the buckets stay consistent
+    for(int i = 0; i < 20; ++i)
+        grid.setInIndex(0, distX(gen), distY(gen), false);
+
+    std::uniform_int_distribution<int> distPos(-5, 40);
+    for(int i = 0; i < 500; ++i)
+    {
+        int x = distPos(gen);
+        int y = distPos(gen);
+        int maxDistSquared = (i % 2 == 0) ? -1 : (i % 100);
+        int expected = findClosestBruteForce(grid, 0, x, y, maxDistSquared);
+        int found = grid.findClosestTile(0, x, y, maxDistSquared, nullptr);
+        // If several tiles are at the same distance, any of them can be returned
+        BOOST_REQUIRE_EQUAL(found < 0, expected < 0);
+        if(found >= 0)
+        {
+            BOOST_CHECK(grid.isInIndex(0, found % grid.getSizeX(), found / grid.getSizeX()));
+            BOOST_CHECK_EQUAL(distSquaredTo(grid, found, x, y), distSquaredTo(grid, expected, x, y));
+        }
+
+        int radius = i % 12;
+        std::vector<uint32_t> tiles;
+        grid.getTilesInRadius(0, x, y, radius, tiles);
+        std::vector<uint32_t> expectedTiles;
+        for(int yy = 0; yy < grid.getSizeY(); ++yy)
+        {
+            for(int xx = 0; xx < grid.getSizeX(); ++xx)
+            {
+                if(grid.isInIndex(0, xx, yy) && ((xx - x) * (xx - x) + (yy - y) * (yy - y) <= radius * radius))
+                    expectedTiles.push_back(static_cast<uint32_t>(xx + yy * grid.getSizeX()));
+            }
+        }
+        std::sort(tiles.begin(), tiles.end());
+        BOOST_CHECK(tiles == expectedTiles);
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileWindowMask.h"
+
+#define BOOST_TEST_MODULE TileWindowMask
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct TestTile
+{
+    int mX;
+    int mY;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_SetAndCheck)
+{
+    TileWindowMask mask;
+    BOOST_CHECK(!mask.isSet(0, 0));
+
+    mask.reset(10, 20, 3);
+    mask.set(10, 20);
+    mask.set(7, 17);
+    mask.set(13, 23);
+    // Set twice
+    mask.set(13, 23);
+    // Outside the window
+    mask.set(14, 20);
+    BOOST_CHECK_EQUAL(mask.getNbTilesSet(), 3);
+    BOOST_CHECK(mask.isSet(10, 20));
+    BOOST_CHECK(mask.isSet(7, 17));
+    BOOST_CHECK(mask.isSet(13, 23));
+    BOOST_CHECK(!mask.isSet(11, 20));
+    BOOST_CHECK(!mask.isSet(14, 20));
+    BOOST_CHECK(!mask.isSet(6, 17));
+    BOOST_CHECK(!mask.isSet(-100, 20));
+
+    // Moving the window empties the mask
+    mask.reset(0, 0, 3);
+    BOOST_CHECK_EQUAL(mask.getNbTilesSet(), 0);
+    BOOST_CHECK(!mask.isSet(10, 20));
+    mask.set(-3, -3);
+    BOOST_CHECK(mask.isSet(-3, -3));
+
+    mask.clear();
+    BOOST_CHECK(!mask.isSet(-3, -3));
+}
+
+BOOST_AUTO_TEST_CASE(test_BenchmarkFight)
+{
+    // 100 creatures fight 100 creatures in a 40x40 area. Each turn, every creature checks which
+    // enemies are on a tile it can see, like Creature::searchBestTargetInList does. Visible tiles
+    // are the tiles within the sight radius (walls are ignored here)
+    const int sizeArea = 40;
+    const int sightRadius = 10;
+    const uint32_t nbCreaturesPerSide = 100;
+    const uint32_t nbTurns = 20;
+
+    std::vector<TestTile> tiles;
+    for(int yy = 0; yy < sizeArea; ++yy)
+    {
+        for(int xx = 0; xx < sizeArea; ++xx)
+            tiles.push_back({xx, yy});
+    }
+
+    std::vector<TestTile*> positions;
+    for(uint32_t i = 0; i < 2 * nbCreaturesPerSide; ++i)
+        positions.push_back(&tiles[(i * 7919) % tiles.size()]);
+
+    std::vector<std::vector<TestTile*>> visibleTiles(positions.size());
+    std::vector<TileWindowMask> masks(positions.size());
+    typedef std::chrono::steady_clock Clock;
+    double listMs = 0;
+    double maskMs = 0;
+    uint64_t nbSeenWithList = 0;
+    uint64_t nbSeenWithMask = 0;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        // Creatures move a bit every turn
+        for(uint32_t i = 0; i < positions.size(); ++i)
+        {
+            uint32_t index = static_cast<uint32_t>(positions[i] - tiles.data());
+            positions[i] = &tiles[(index + turn + i) % tiles.size()];
+        }
+
+        for(uint32_t i = 0; i < positions.size(); ++i)
+        {
+            visibleTiles[i].clear();
+            for(TestTile& tile : tiles)
+            {
+                int diffX = tile.mX - positions[i]->mX;
+                int diffY = tile.mY - positions[i]->mY;
+                if(diffX * diffX + diffY * diffY <= sightRadius * sightRadius)
+                    visibleTiles[i].push_back(&tile);
+            }
+        }
+
+        Clock::time_point start = Clock::now();
+        for(uint32_t i = 0; i < positions.size(); ++i)
+        {
+            uint32_t firstEnemy = (i < nbCreaturesPerSide) ? nbCreaturesPerSide : 0;
+            for(uint32_t k = firstEnemy; k < firstEnemy + nbCreaturesPerSide; ++k)
+            {
+                if(std::find(visibleTiles[i].begin(), visibleTiles[i].end(), positions[k]) != visibleTiles[i].end())
+                    ++nbSeenWithList;
+            }
+        }
+        listMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // Filling the mask is counted because it is done every turn when the visible tiles are computed
+        start = Clock::now();
+        for(uint32_t i = 0; i < positions.size(); ++i)
+        {
+            TileWindowMask& mask = masks[i];
+            mask.reset(positions[i]->mX, positions[i]->mY, sightRadius);
+            for(TestTile* tile : visibleTiles[i])
+                mask.set(tile->mX, tile->mY);
+
+            uint32_t firstEnemy = (i < nbCreaturesPerSide) ? nbCreaturesPerSide : 0;
+            for(uint32_t k = firstEnemy; k < firstEnemy + nbCreaturesPerSide; ++k)
+            {
+                if(mask.isSet(positions[k]->mX, positions[k]->mY))
+                    ++nbSeenWithMask;
+            }
+        }
+        maskMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    BOOST_CHECK_EQUAL(nbSeenWithList, nbSeenWithMask);
+    BOOST_CHECK(nbSeenWithMask > 0);
+    BOOST_TEST_MESSAGE(std::to_string(nbCreaturesPerSide) + " vs " + std::to_string(nbCreaturesPerSide)
+        + " creatures, " + std::to_string(nbTurns) + " turns: searching visible tiles="
+        + std::to_string(listMs) + "ms, visibility mask=" + std::to_string(maskMs) + "ms");
+}
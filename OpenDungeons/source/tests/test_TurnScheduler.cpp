@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/TurnScheduler.h"
+
+#define BOOST_TEST_MODULE TurnScheduler
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_Accumulation)
+{
+    TurnScheduler scheduler(100.0, 4);
+    BOOST_CHECK(!scheduler.isTurnDue());
+    BOOST_CHECK_CLOSE(scheduler.getTimeUntilNextTurnMs(), 100.0, 0.001);
+
+    scheduler.addElapsedTime(60.0);
+    BOOST_CHECK(!scheduler.isTurnDue());
+    BOOST_CHECK_CLOSE(scheduler.getTimeUntilNextTurnMs(), 40.0, 0.001);
+
+    // The remainder is kept for the next turn so that the server does not drift
+    scheduler.addElapsedTime(50.0);
+    BOOST_CHECK(scheduler.isTurnDue());
+    BOOST_CHECK_EQUAL(scheduler.getTimeUntilNextTurnMs(), 0.0);
+    scheduler.turnDone(5.0);
+    BOOST_CHECK(!scheduler.isTurnDue());
+    BOOST_CHECK_CLOSE(scheduler.getTimeUntilNextTurnMs(), 90.0, 0.001);
+    BOOST_CHECK_EQUAL(scheduler.getNbTurns(), 1);
+    BOOST_CHECK_EQUAL(scheduler.getNbCatchUpTurns(), 0);
+    BOOST_CHECK_EQUAL(scheduler.getNbOverruns(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_BoundedCatchUp)
+{
+    TurnScheduler scheduler(100.0, 4);
+    // A 1 second stall: only 4 turns are caught up, the rest is dropped
+    scheduler.addElapsedTime(1000.0);
+    BOOST_CHECK_CLOSE(scheduler.getDroppedTimeMs(), 600.0, 0.001);
+
+    uint32_t nbTurns = 0;
+    while(scheduler.isTurnDue())
+    {
+        scheduler.turnDone(10.0);
+        ++nbTurns;
+    }
+    BOOST_CHECK_EQUAL(nbTurns, 4);
+    BOOST_CHECK_EQUAL(scheduler.getNbTurns(), 4);
+    // The last turn was not a catch up one
+    BOOST_CHECK_EQUAL(scheduler.getNbCatchUpTurns(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_Overruns)
+{
+    TurnScheduler scheduler(100.0, 4);
+    scheduler.addElapsedTime(100.0);
+    scheduler.turnDone(150.0);
+    scheduler.addElapsedTime(150.0);
+    scheduler.turnDone(50.0);
+    scheduler.turnDelayed();
+
+    BOOST_CHECK_EQUAL(scheduler.getNbTurns(), 2);
+    BOOST_CHECK_EQUAL(scheduler.getNbOverruns(), 1);
+    BOOST_CHECK_EQUAL(scheduler.getNbTurnsDelayed(), 1);
+    BOOST_CHECK_CLOSE(scheduler.getMaxTurnDurationMs(), 150.0, 0.001);
+    BOOST_CHECK_CLOSE(scheduler.getTotalTurnDurationMs(), 200.0, 0.001);
+
+    // Resetting the statistics keeps the accumulated time
+    scheduler.resetStats();
+    BOOST_CHECK_EQUAL(scheduler.getNbTurns(), 0);
+    BOOST_CHECK_EQUAL(scheduler.getNbOverruns(), 0);
+    BOOST_CHECK_CLOSE(scheduler.getTimeUntilNextTurnMs(), 50.0, 0.001);
+}
@@ -24,7 +24,8 @@
     #include <Windows.h>
 #endif
 
-LogSinkConsole::LogSinkConsole()
+LogSinkConsole::LogSinkConsole(bool useErrorOutput) :
+    mUseErrorOutput(useErrorOutput)
 {
 
 }
@@ -50,7 +51,7 @@ void LogSinkConsole::write(LogMessageLevel level, const std::string& module, con
         << message
         << std::endl;
 
-    if (level >= LogMessageLevel::WARNING)
+    if (mUseErrorOutput || (level >= LogMessageLevel::WARNING))
         std::cerr << ss.str();
     else
         std::cout << ss.str();
@@ -23,10 +23,15 @@
 class LogSinkConsole : public LogSink
 {
 public:
-    LogSinkConsole();
+    //! \brief If useErrorOutput is true, every message is written on the error output. Otherwise,
+    //! only warnings and errors are
+    LogSinkConsole(bool useErrorOutput = false);
     ~LogSinkConsole();
 
     virtual void write(LogMessageLevel level, const std::string& module, const std::string& timestamp, const std::string& filename, int line, const std::string& message) override;
+
+private:
+    bool mUseErrorOutput;
 };
 
 #endif // _LOGSINKCONSOLE_H_
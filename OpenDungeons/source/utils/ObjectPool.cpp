@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ObjectPool.h"
+
+#include <SFML/System.hpp>
+
+#include <new>
+
+namespace
+{
+    //! A free block stores the next free block of its list
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    const std::size_t NB_FREE_LISTS = ObjectPool::MAX_POOLED_SIZE / ObjectPool::BLOCK_ALIGNMENT;
+
+    struct PoolData
+    {
+        PoolData() :
+            mNbChunksAllocated(0),
+            mNbBlocksUsed(0)
+        {
+            for(FreeBlock*& freeList : mFreeLists)
+                freeList = nullptr;
+        }
+
+        sf::Mutex mMutex;
+        FreeBlock* mFreeLists[NB_FREE_LISTS];
+        uint64_t mNbChunksAllocated;
+        uint64_t mNbBlocksUsed;
+    };
+
+    //! The pool is never destroyed because objects might be deleted during the static
+    //! destruction. The memory is given back to the system when the process exits.
+    PoolData& getPoolData()
+    {
+        static PoolData* poolData = new PoolData;
+        return *poolData;
+    }
+
+    inline std::size_t getFreeListIndex(std::size_t size)
+    {
+        return (size + ObjectPool::BLOCK_ALIGNMENT - 1) / ObjectPool::BLOCK_ALIGNMENT - 1;
+    }
+}
+
+namespace ObjectPool
+{
+
+void* allocate(std::size_t size)
+{
+    if((size == 0) || (size > MAX_POOLED_SIZE))
+        return ::operator new(size);
+
+    std::size_t index = getFreeListIndex(size);
+    PoolData& poolData = getPoolData();
+    sf::Lock lock(poolData.mMutex);
+    if(poolData.mFreeLists[index] == nullptr)
+    {
+        std::size_t blockSize = (index + 1) * BLOCK_ALIGNMENT;
+        char* chunk = static_cast<char*>(::operator new(blockSize * BLOCKS_PER_CHUNK));
+        for(uint32_t i = 0; i < BLOCKS_PER_CHUNK; ++i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+            block->mNext = poolData.mFreeLists[index];
+            poolData.mFreeLists[index] = block;
+        }
+        ++poolData.mNbChunksAllocated;
+    }
+
+    FreeBlock* block = poolData.mFreeLists[index];
+    poolData.mFreeLists[index] = block->mNext;
+    ++poolData.mNbBlocksUsed;
+    return block;
+}
+
+void deallocate(void* ptr, std::size_t size)
+{
+    if(ptr == nullptr)
+        return;
+
+    if((size == 0) || (size > MAX_POOLED_SIZE))
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    std::size_t index = getFreeListIndex(size);
+    PoolData& poolData = getPoolData();
+    sf::Lock lock(poolData.mMutex);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->mNext = poolData.mFreeLists[index];
+    poolData.mFreeLists[index] = block;
+    --poolData.mNbBlocksUsed;
+}
+
+uint64_t getNbChunksAllocated()
+{
+    PoolData& poolData = getPoolData();
+    sf::Lock lock(poolData.mMutex);
+    return poolData.mNbChunksAllocated;
+}
+
+uint64_t getNbBlocksUsed()
+{
+    PoolData& poolData = getPoolData();
+    sf::Lock lock(poolData.mMutex);
+    return poolData.mNbBlocksUsed;
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+//! \brief Memory for small objects that are created and destroyed very often (like the creature
+//! actions). Blocks are grouped by size (rounded to BLOCK_ALIGNMENT) and freed blocks are kept
+//! in a free list to be reused by the next object of the same size. So, once the pool has
+//! enough blocks, creating and destroying objects does not allocate any memory.
+//! The memory is never given back to the system.
+//! Classes use it by defining their operator new and operator delete:
+//!     static void* operator new(std::size_t size)
+//!     { return ObjectPool::allocate(size); }
+//!     static void operator delete(void* ptr, std::size_t size)
+//!     { ObjectPool::deallocate(ptr, size); }
+//! If the class is polymorphic, its destructor must be virtual so that the size given to
+//! operator delete is the one of the real object.
+//! It is thread safe.
+namespace ObjectPool
+{
+    //! \brief Objects bigger than this are allocated with the global operator new
+    const std::size_t MAX_POOLED_SIZE = 512;
+    const std::size_t BLOCK_ALIGNMENT = 16;
+    //! \brief Number of blocks allocated at once when a free list is empty
+    const uint32_t BLOCKS_PER_CHUNK = 32;
+
+    void* allocate(std::size_t size);
+    void deallocate(void* ptr, std::size_t size);
+
+    //! \brief Number of chunks allocated from the system since the start
+    uint64_t getNbChunksAllocated();
+
+    //! \brief Number of blocks currently used
+    uint64_t getNbBlocksUsed();
+}
+
+#endif // OBJECTPOOL_H
@@ -0,0 +1,269 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/Profiler.h"
+
+#include <SFML/System.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <memory>
+
+const uint32_t Profiler::RING_BUFFER_SIZE = 16384;
+
+namespace
+{
+//! \brief Events recorded by one thread. When the thread ends, the buffer is kept (so that its
+//! events can still be dumped) and reused by the next thread that records an event
+struct ThreadBuffer
+{
+    sf::Mutex mMutex;
+    uint32_t mThreadId = 0;
+    std::string mName;
+    std::vector<ProfilerEvent> mEvents;
+    //! Index where the next event will be written. Once the buffer is full, it is also the
+    //! oldest event
+    uint32_t mNextIndex = 0;
+    bool mInUse = false;
+
+    template<typename Function>
+    void forEachEvent(Function function) const
+    {
+        // The oldest events are after mNextIndex if the buffer wrapped
+        for(uint32_t i = mNextIndex; i < mEvents.size(); ++i)
+            function(mEvents[i]);
+        for(uint32_t i = 0; i < mNextIndex; ++i)
+            function(mEvents[i]);
+    }
+};
+
+struct ThreadBufferRegistry
+{
+    sf::Mutex mMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+};
+
+ThreadBufferRegistry& getRegistry()
+{
+    static ThreadBufferRegistry registry;
+    return registry;
+}
+
+//! \brief Releases the buffer of a thread when it ends
+struct ThreadBufferHolder
+{
+    ThreadBuffer* mBuffer = nullptr;
+
+    ~ThreadBufferHolder()
+    {
+        if(mBuffer == nullptr)
+            return;
+
+        sf::Lock lock(mBuffer->mMutex);
+        mBuffer->mInUse = false;
+    }
+};
+
+thread_local ThreadBufferHolder threadBufferHolder;
+
+std::atomic<bool> profilerEnabled(false);
+
+ThreadBuffer& getThreadBuffer()
+{
+    if(threadBufferHolder.mBuffer != nullptr)
+        return *threadBufferHolder.mBuffer;
+
+    ThreadBufferRegistry& registry = getRegistry();
+    sf::Lock lock(registry.mMutex);
+    ThreadBuffer* buffer = nullptr;
+    for(std::unique_ptr<ThreadBuffer>& b : registry.mBuffers)
+    {
+        sf::Lock lockBuffer(b->mMutex);
+        if(b->mInUse)
+            continue;
+
+        b->mInUse = true;
+        b->mName.clear();
+        buffer = b.get();
+        break;
+    }
+
+    if(buffer == nullptr)
+    {
+        registry.mBuffers.emplace_back(new ThreadBuffer);
+        buffer = registry.mBuffers.back().get();
+        buffer->mThreadId = static_cast<uint32_t>(registry.mBuffers.size());
+        buffer->mInUse = true;
+        buffer->mEvents.reserve(Profiler::RING_BUFFER_SIZE);
+    }
+
+    threadBufferHolder.mBuffer = buffer;
+    return *buffer;
+}
+
+std::string getThreadName(const ThreadBuffer& buffer)
+{
+    if(!buffer.mName.empty())
+        return buffer.mName;
+
+    return "Thread " + std::to_string(buffer.mThreadId);
+}
+
+void writeJsonString(std::ostream& os, const std::string& str)
+{
+    os << '"';
+    for(char c : str)
+    {
+        if((c == '"') || (c == '\\'))
+            os << '\\';
+        os << c;
+    }
+    os << '"';
+}
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    profilerEnabled = enabled;
+}
+
+bool Profiler::isEnabled()
+{
+    return profilerEnabled;
+}
+
+int64_t Profiler::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char* name, int64_t startNs, int64_t durationNs)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    sf::Lock lock(buffer.mMutex);
+    ProfilerEvent event = {name, startNs, durationNs};
+    if(buffer.mEvents.size() < RING_BUFFER_SIZE)
+        buffer.mEvents.push_back(event);
+    else
+        buffer.mEvents[buffer.mNextIndex] = event;
+
+    buffer.mNextIndex = (buffer.mNextIndex + 1) % RING_BUFFER_SIZE;
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    sf::Lock lock(buffer.mMutex);
+    buffer.mName = name;
+}
+
+void Profiler::clear()
+{
+    ThreadBufferRegistry& registry = getRegistry();
+    sf::Lock lock(registry.mMutex);
+    for(std::unique_ptr<ThreadBuffer>& buffer : registry.mBuffers)
+    {
+        sf::Lock lockBuffer(buffer->mMutex);
+        buffer->mEvents.clear();
+        buffer->mNextIndex = 0;
+    }
+}
+
+void Profiler::computeZoneStats(int64_t sinceNs, std::vector<ProfilerZoneStats>& stats)
+{
+    stats.clear();
+    ThreadBufferRegistry& registry = getRegistry();
+    sf::Lock lock(registry.mMutex);
+    for(std::unique_ptr<ThreadBuffer>& buffer : registry.mBuffers)
+    {
+        sf::Lock lockBuffer(buffer->mMutex);
+        // Zones are identified by their name pointer. Different literals with the same text
+        // are merged when sorting
+        std::map<const char*, ProfilerZoneStats> zones;
+        buffer->forEachEvent([&](const ProfilerEvent& event)
+        {
+            if(event.mStartNs < sinceNs)
+                return;
+
+            ProfilerZoneStats& zone = zones[event.mName];
+            double ms = static_cast<double>(event.mDurationNs) / 1000000.0;
+            zone.mNbCalls += 1;
+            zone.mTotalMs += ms;
+            zone.mMaxMs = std::max(zone.mMaxMs, ms);
+        });
+
+        std::vector<ProfilerZoneStats> threadStats;
+        for(std::pair<const char* const, ProfilerZoneStats>& p : zones)
+        {
+            std::string name(p.first);
+            auto it = std::find_if(threadStats.begin(), threadStats.end(),
+                [&name](const ProfilerZoneStats& s) { return s.mName == name; });
+            if(it == threadStats.end())
+            {
+                p.second.mThreadName = getThreadName(*buffer);
+                p.second.mName = name;
+                threadStats.push_back(p.second);
+                continue;
+            }
+            it->mNbCalls += p.second.mNbCalls;
+            it->mTotalMs += p.second.mTotalMs;
+            it->mMaxMs = std::max(it->mMaxMs, p.second.mMaxMs);
+        }
+
+        std::sort(threadStats.begin(), threadStats.end(),
+            [](const ProfilerZoneStats& a, const ProfilerZoneStats& b) { return a.mTotalMs > b.mTotalMs; });
+        stats.insert(stats.end(), threadStats.begin(), threadStats.end());
+    }
+}
+
+uint32_t Profiler::writeChromeTrace(std::ostream& os)
+{
+    uint32_t nbEvents = 0;
+    os << "{\"traceEvents\":[";
+    ThreadBufferRegistry& registry = getRegistry();
+    sf::Lock lock(registry.mMutex);
+    bool first = true;
+    os << std::fixed << std::setprecision(3);
+    for(std::unique_ptr<ThreadBuffer>& buffer : registry.mBuffers)
+    {
+        sf::Lock lockBuffer(buffer->mMutex);
+        // Thread name metadata
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->mThreadId
+           << ",\"args\":{\"name\":";
+        writeJsonString(os, getThreadName(*buffer));
+        os << "}}";
+
+        buffer->forEachEvent([&](const ProfilerEvent& event)
+        {
+            // Timestamps are in microseconds
+            os << ",\n{\"name\":";
+            writeJsonString(os, event.mName);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->mThreadId
+               << ",\"ts\":" << static_cast<double>(event.mStartNs) / 1000.0
+               << ",\"dur\":" << static_cast<double>(event.mDurationNs) / 1000.0 << "}";
+            ++nbEvents;
+        });
+    }
+    os << "\n]}\n";
+    return nbEvents;
+}
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! \brief Time spent in a profiler zone. The name must be a string literal (or at least
+//! live as long as the profiler) because only the pointer is kept
+struct ProfilerEvent
+{
+    const char* mName;
+    int64_t mStartNs;
+    int64_t mDurationNs;
+};
+
+//! \brief Statistics of the calls to a zone on a given thread
+struct ProfilerZoneStats
+{
+    std::string mThreadName;
+    std::string mName;
+    uint32_t mNbCalls = 0;
+    double mTotalMs = 0.0;
+    double mMaxMs = 0.0;
+};
+
+/*! \brief Lightweight scoped zone profiler. Zones are declared with OD_PROFILE_ZONE and
+ * recorded in a ring buffer owned by the calling thread, so recording only locks a mutex
+ * that is never contended except while the events are read.
+ * When the profiler is disabled (the default), a zone only costs a flag check.
+ */
+class Profiler
+{
+public:
+    //! \brief Number of events kept per thread. Older ones are overwritten
+    static const uint32_t RING_BUFFER_SIZE;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    //! \brief Monotonic clock used for the zones
+    static int64_t nowNs();
+
+    //! \brief Records an event on the calling thread buffer
+    static void record(const char* name, int64_t startNs, int64_t durationNs);
+
+    //! \brief Sets the name of the calling thread. It is displayed in the overlay and in the traces
+    static void setThreadName(const std::string& name);
+
+    //! \brief Removes the recorded events of every thread
+    static void clear();
+
+    //! \brief Fills stats with the zones that started after sinceNs, sorted by thread and
+    //! by decreasing total time
+    static void computeZoneStats(int64_t sinceNs, std::vector<ProfilerZoneStats>& stats);
+
+    //! \brief Writes the recorded events in the Chrome trace event format (JSON). It can be
+    //! opened in chrome://tracing. Returns the number of events written
+    static uint32_t writeChromeTrace(std::ostream& os);
+};
+
+//! \brief Records the time between its construction and its destruction in the profiler
+class ProfilerZone
+{
+public:
+    explicit ProfilerZone(const char* name) :
+        mName(Profiler::isEnabled() ? name : nullptr),
+        mStartNs(mName != nullptr ? Profiler::nowNs() : 0)
+    {}
+
+    ~ProfilerZone()
+    { end(); }
+
+    //! \brief Ends the zone before the end of the scope. Does nothing if already ended
+    void end()
+    {
+        if(mName != nullptr)
+            Profiler::record(mName, mStartNs, Profiler::nowNs() - mStartNs);
+
+        mName = nullptr;
+    }
+
+private:
+    ProfilerZone(const ProfilerZone&) = delete;
+    ProfilerZone& operator=(const ProfilerZone&) = delete;
+
+    const char* mName;
+    int64_t mStartNs;
+};
+
+#define OD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OD_PROFILE_CONCAT(a, b) OD_PROFILE_CONCAT_IMPL(a, b)
+//! \brief Profiles the enclosing scope. name must be a string literal
+#define OD_PROFILE_ZONE(name) ProfilerZone OD_PROFILE_CONCAT(odProfilerZone, __LINE__)(name)
+
+#endif // PROFILER_H
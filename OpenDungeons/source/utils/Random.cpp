@@ -24,87 +24,157 @@
 #include "utils/Helper.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
-#include <ctime>
 
-unsigned long myRandomSeed;
-const unsigned long MAX = 32768;
-
-static unsigned long randgen()
+namespace
 {
-    myRandomSeed = myRandomSeed * 1103515245 + 12345;
-    //TODO: What is the purpose of the cast?
-    unsigned long returnVal = static_cast<unsigned int>(myRandomSeed / 65536) % MAX;
+    //! \brief Used to initialize the generators state from a seed (see http://xoshiro.di.unimi.it)
+    uint64_t splitMix64(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    const uint32_t NB_STREAMS = static_cast<uint32_t>(Random::Stream::nbStreams);
 
-    return returnVal;
+    //! \brief Each stream is used by one thread at a time so the generators do not need any lock
+    RandomGenerator& getStreamGenerator(Random::Stream stream)
+    {
+        static RandomGenerator generators[NB_STREAMS];
+        return generators[static_cast<uint32_t>(stream)];
+    }
+
+    thread_local Random::Stream threadStream = Random::Stream::cosmetic;
 }
 
-//! \brief uniformly distributed number [0;1)
-static double uniform()
+RandomGenerator::RandomGenerator(uint64_t seed, uint64_t streamId)
 {
-    return randgen() * 1.0 / static_cast<double>(MAX);
+    this->seed(seed, streamId);
 }
 
-//! \brief uniformly distributed number [lo;hi)
-static double uniform(double lo, double hi)
+void RandomGenerator::seed(uint64_t seed, uint64_t streamId)
 {
-    return uniform() * (hi - lo) + lo;
+    // The stream id is mixed with the seed so that close seeds or streams give unrelated states
+    uint64_t splitMixState = seed ^ (streamId * 0xD1B54A32D192ED03ULL);
+    splitMixState = splitMix64(splitMixState);
+    for(uint64_t& state : mState)
+        state = splitMix64(splitMixState);
 }
 
-//! \brief random integer [lo;hi]
-static int randint(int lo, int hi)
+double RandomGenerator::Double(double min, double max)
 {
-    return static_cast<int>(uniform() * (hi - lo + 1) + lo);
+    if (min > max)
+        std::swap(min, max);
+
+    return uniform() * (max - min) + min;
+}
+
+int RandomGenerator::Int(int min, int max)
+{
+    if (min > max)
+        std::swap(min, max);
+
+    int64_t range = static_cast<int64_t>(max) - static_cast<int64_t>(min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(uniform() * range));
 }
 
-//! \brief random unsigned integer [lo;hi]
-static unsigned int randuint(unsigned int lo, unsigned int hi)
+unsigned int RandomGenerator::Uint(unsigned int min, unsigned int max)
 {
-    return static_cast<unsigned int>(uniform() * (hi - lo + 1) + lo);
+    if (min > max)
+        std::swap(min, max);
+
+    uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min) + 1;
+    return static_cast<unsigned int>(min + static_cast<uint64_t>(uniform() * range));
 }
 
+void RandomGenerator::fillDouble(double* values, uint32_t nbValues, double min, double max)
+{
+    if (min > max)
+        std::swap(min, max);
+
+    // The generator state is sequential. We generate the random bits by blocks and convert
+    // them in a loop without dependencies between values
+    const uint32_t BLOCK_SIZE = 64;
+    uint64_t bits[BLOCK_SIZE];
+    double range = max - min;
+    for(uint32_t start = 0; start < nbValues; start += BLOCK_SIZE)
+    {
+        uint32_t nbBits = std::min(BLOCK_SIZE, nbValues - start);
+        for(uint32_t i = 0; i < nbBits; ++i)
+            bits[i] = next();
+
+        double* blockValues = values + start;
+        for(uint32_t i = 0; i < nbBits; ++i)
+            blockValues[i] = toUniform(bits[i]) * range + min;
+    }
+}
 
 namespace Random
 {
 
 void initialize()
 {
-    myRandomSeed = static_cast<unsigned long>(std::time(0));
+    initialize(generateSeed());
 }
 
-double Double(double min, double max)
+void initialize(uint64_t seed)
 {
-    if (min > max)
-    {
-        std::swap(min, max);
-    }
+    for(uint32_t i = 0; i < NB_STREAMS; ++i)
+        seedStream(static_cast<Stream>(i), seed);
+}
 
-    return uniform(min, max);
+void seedStream(Stream stream, uint64_t seed)
+{
+    getStreamGenerator(stream).seed(seed, static_cast<uint64_t>(stream));
 }
 
-int Int(int min, int max)
+uint64_t generateSeed()
 {
-    if (min > max)
-    {
-        std::swap(min, max);
-    }
+    static std::atomic<uint64_t> nbSeedsGenerated(0);
+    uint64_t seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    uint64_t splitMixState = seed + (++nbSeedsGenerated);
+    return splitMix64(splitMixState);
+}
 
-    return randint(min, max);
+void setThreadStream(Stream stream)
+{
+    threadStream = stream;
 }
 
-unsigned int Uint(unsigned int min, unsigned int max)
+Stream getThreadStream()
 {
-    if (min > max)
-    {
-        std::swap(min, max);
-    }
+    return threadStream;
+}
+
+RandomGenerator& getThreadGenerator()
+{
+    return getStreamGenerator(threadStream);
+}
 
-    return randuint(min, max);
+double Double(double min, double max)
+{
+    return getThreadGenerator().Double(min, max);
+}
+
+int Int(int min, int max)
+{
+    return getThreadGenerator().Int(min, max);
+}
+
+unsigned int Uint(unsigned int min, unsigned int max)
+{
+    return getThreadGenerator().Uint(min, max);
 }
 
 double gaussianRandomDouble()
 {
-    return std::sqrt(-2.0 * log(Double(0.0, 1.0))) * cos(2.0 * PI * Double(0.0, 1.0));
+    RandomGenerator& generator = getThreadGenerator();
+    // We use 1 - uniform to avoid log(0)
+    return std::sqrt(-2.0 * std::log(1.0 - generator.uniform())) * std::cos(2.0 * PI * generator.uniform());
 }
 
 } // namespace Random
@@ -23,11 +23,116 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <cstdint>
+
+//! \brief Fast random number generator (xoshiro256**). Each generator is an independent stream:
+//! generators built with the same seed and stream id always give the same numbers and
+//! generators with different stream ids give unrelated numbers. A generator is not thread
+//! safe: it should be used by one thread only.
+class RandomGenerator
+{
+public:
+    RandomGenerator(uint64_t seed = 0, uint64_t streamId = 0);
+
+    //! \brief Restarts the generator with the given seed and stream
+    void seed(uint64_t seed, uint64_t streamId);
+
+    //! \brief Returns the next 64 random bits
+    inline uint64_t next()
+    {
+        const uint64_t result = rotl(mState[1] * 5, 7) * 9;
+        const uint64_t t = mState[1] << 17;
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= t;
+        mState[3] = rotl(mState[3], 45);
+        return result;
+    }
+
+    //! \brief Returns a uniformly distributed double in [0;1)
+    inline double uniform()
+    { return toUniform(next()); }
+
+    //! \brief Returns a uniformly distributed double in [min;max)
+    double Double(double min, double max);
+
+    //! \brief Returns a uniformly distributed integer in [min;max]
+    int Int(int min, int max);
+
+    //! \brief Returns a uniformly distributed unsigned integer in [min;max]
+    unsigned int Uint(unsigned int min, unsigned int max);
+
+    //! \brief Fills values with uniformly distributed doubles in [min;max). It gives the same
+    //! numbers as calling Double nbValues times but the random bits are generated first and
+    //! converted in a second loop the compiler can vectorize. It should be preferred by callers
+    //! that need many numbers at once
+    void fillDouble(double* values, uint32_t nbValues, double min, double max);
+
+    //! \brief Converts 64 random bits to a uniformly distributed double in [0;1)
+    static inline double toUniform(uint64_t bits)
+    { return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    static inline uint64_t rotl(uint64_t x, int k)
+    { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t mState[4];
+};
+
+//! \brief Random numbers used by the game. Each part of the game uses its own stream so that
+//! they do not interfere: the server simulation is reproducible for a given seed whatever the
+//! client does and the server and client threads never use the same generator.
+//! The functions below use the stream of the calling thread (cosmetic by default).
 namespace Random
 {
-    //! \brief initializes the semaphore and seeds the generator
+    enum class Stream
+    {
+        //! \brief Server game simulation (entities, rooms, traps, ...)
+        simulation,
+        //! \brief Keeper AI. It has its own stream so that changing the AI (or its turn budget)
+        //! does not change the random numbers used by the simulation
+        ai,
+        //! \brief Client side effects (lights, sounds, ...)
+        cosmetic,
+        nbStreams
+    };
+
+    //! \brief Seeds every stream from the current time
     void initialize();
 
+    //! \brief Seeds every stream from the given seed
+    void initialize(uint64_t seed);
+
+    //! \brief Seeds the given stream. It should not be called while another thread uses the stream
+    void seedStream(Stream stream, uint64_t seed);
+
+    //! \brief Returns a seed built from the current time. Two calls return different seeds
+    uint64_t generateSeed();
+
+    //! \brief Sets the stream used by the calling thread
+    void setThreadStream(Stream stream);
+    Stream getThreadStream();
+
+    //! \brief Returns the generator of the stream used by the calling thread
+    RandomGenerator& getThreadGenerator();
+
+    //! \brief Uses the given stream in the calling thread until the object is destroyed
+    class StreamScope
+    {
+    public:
+        StreamScope(Stream stream) :
+            mPreviousStream(getThreadStream())
+        { setThreadStream(stream); }
+
+        ~StreamScope()
+        { setThreadStream(mPreviousStream); }
+
+    private:
+        Stream mPreviousStream;
+    };
+
     /*! \brief generate a random double
      *
      *  \param min, max One or both can be negative
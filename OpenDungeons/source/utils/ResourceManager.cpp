@@ -87,6 +87,8 @@ const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
 ResourceManager::ResourceManager(boost::program_options::variables_map& options) :
         mServerMode(false),
         mForcedNetworkPort(-1),
+        mServerRandomSeed(0),
+        mBenchmarkNbTurns(0),
         mLogLevel(LogMessageLevel::NORMAL),
         mGameDataPath("./"),
         mUserDataPath("./"),
@@ -438,6 +440,36 @@ void ResourceManager::setupUserDataFolders(boost::program_options::variables_map
     if(itOption != options.end())
         mForcedNetworkPort = itOption->second.as<int32_t>();
 
+    itOption = options.find("metricsfile");
+    if(itOption != options.end())
+    {
+        // Relative paths are relative to the user data path
+        boost::filesystem::path metricsFile(itOption->second.as<std::string>());
+        if(metricsFile.is_absolute())
+            mServerMetricsFile = metricsFile.string();
+        else
+            mServerMetricsFile = mUserDataPath + metricsFile.string();
+    }
+
+    itOption = options.find("seed");
+    if(itOption != options.end())
+        mServerRandomSeed = itOption->second.as<uint64_t>();
+
+    itOption = options.find("benchmark");
+    if(itOption != options.end())
+        mBenchmarkNbTurns = itOption->second.as<uint32_t>();
+
+    itOption = options.find("benchmarkfile");
+    if(itOption != options.end())
+    {
+        // Relative paths are relative to the user data path
+        boost::filesystem::path benchmarkFile(itOption->second.as<std::string>());
+        if(benchmarkFile.is_absolute())
+            mBenchmarkFile = benchmarkFile.string();
+        else
+            mBenchmarkFile = mUserDataPath + benchmarkFile.string();
+    }
+
     itOption = options.find("loglevel");
     if(itOption != options.end())
         mLogLevel = static_cast<LogMessageLevel>(itOption->second.as<int32_t>());
@@ -599,6 +631,10 @@ void ResourceManager::buildCommandOptions(boost::program_options::options_descri
         ("appData", boost::program_options::value<std::string>(), "Sets appData to the given path (where logs, replays, ... are saved)")
         ("mscreator", boost::program_options::value<std::string>(), "Sets the creator for this map to connect to the master server. server/servercustom/serversave option needs to be on")
         ("port", boost::program_options::value<int32_t>(), "Sets the port used. Note that the port is used for both single and multi player")
+        ("metricsfile", boost::program_options::value<std::string>(), "Periodically writes the server turn metrics in the given file (Prometheus text format). server/servercustom/serversave option needs to be on")
+        ("seed", boost::program_options::value<uint64_t>(), "Sets the seed of the server random numbers to play a game again the same way. server/servercustom/serversave option needs to be on")
+        ("benchmark", boost::program_options::value<uint32_t>(), "Runs the given number of turns as fast as possible with every seat played by the AI and writes the timings in JSON. The console logs are written on the error output. server/servercustom/serversave option needs to be on")
+        ("benchmarkfile", boost::program_options::value<std::string>(), "Writes the benchmark results in the given file instead of the standard output. benchmark option needs to be on")
         ("loglevel", boost::program_options::value<int32_t>(), "Sets the log level (between 0=Trivial and 3=Critical)")
     ;
 }
@@ -148,6 +148,22 @@ public:
     inline int32_t getForcedNetworkPort() const
     { return mForcedNetworkPort; }
 
+    //! \brief File where the server metrics are written. Empty if they are not enabled
+    inline const std::string& getServerMetricsFile() const
+    { return mServerMetricsFile; }
+
+    //! \brief Seed of the server random numbers. 0 if a new one should be used for each game
+    inline uint64_t getServerRandomSeed() const
+    { return mServerRandomSeed; }
+
+    //! \brief Number of turns of the headless benchmark. 0 if the server should not run a benchmark
+    inline uint32_t getBenchmarkNbTurns() const
+    { return mBenchmarkNbTurns; }
+
+    //! \brief File where the benchmark results are written. Empty for the standard output
+    inline const std::string& getBenchmarkFile() const
+    { return mBenchmarkFile; }
+
     inline LogMessageLevel getLogLevel() const
     { return mLogLevel; }
 
@@ -159,6 +175,10 @@ private:
 
     //! \brief used when the network port is forced
     int32_t mForcedNetworkPort;
+    std::string mServerMetricsFile;
+    uint64_t mServerRandomSeed;
+    uint32_t mBenchmarkNbTurns;
+    std::string mBenchmarkFile;
 
     //! \brief The log level
     LogMessageLevel mLogLevel;